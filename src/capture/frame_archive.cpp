@@ -0,0 +1,299 @@
+/**
+ * @file capture/frame_archive.cpp
+ * @brief Archive writer (O_DIRECT / unbuffered positioned writes) and mapped reader
+ */
+
+#include "capture/frame_archive.h"
+#include <algorithm>
+#include <cstring>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = { 'P', 'O', 'N', 'G', 'A', 'R', 'C', '1' };
+constexpr char kFrameMagic[4] = { 'P', 'F', 'R', 'M' };
+constexpr uint64_t kGrowBytes = 256ull << 20;  // preallocation step
+
+static_assert(sizeof(ArchiveHeader) == 56 && sizeof(ArchiveHeader) <= kArchivePage, "archive header layout");
+static_assert(sizeof(ArchiveFrameHeader) == 24, "frame header layout");
+static_assert(sizeof(ArchiveIndexEntry) == 24, "index entry layout");
+
+uint64_t round_page(uint64_t v) { return (v + kArchivePage - 1) & ~(uint64_t)(kArchivePage - 1); }
+
+/// Zeroed, page-aligned block for the header and index writes (unbuffered I/O needs aligned memory)
+struct PageBuffer {
+    std::vector<uint8_t> storage;
+    uint8_t *data;
+    explicit PageBuffer(size_t bytes) : storage(bytes + kArchivePage, 0) {
+        const size_t misalign = (size_t)((uintptr_t)storage.data() % kArchivePage);
+        data = storage.data() + (misalign ? kArchivePage - misalign : 0);
+    }
+};
+
+} // namespace
+
+FrameArchiveWriter::~FrameArchiveWriter() {
+    std::string err;
+    close(err);
+}
+
+bool FrameArchiveWriter::is_open() const {
+#ifdef _WIN32
+    return handle != nullptr;
+#else
+    return fd >= 0;
+#endif
+}
+
+bool FrameArchiveWriter::open(const std::filesystem::path &path, int width, int height, int fps, ArchiveCodec codec,
+                              size_t max_payload, size_t reserve_frames, std::string &err) {
+    std::string ignored;
+    close(ignored);
+    hdr = ArchiveHeader{};
+    std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+    hdr.version = 1;
+    hdr.page = (uint32_t)kArchivePage;
+    hdr.width = (uint32_t)width;
+    hdr.height = (uint32_t)height;
+    hdr.fps = (uint32_t)fps;
+    hdr.codec = (uint32_t)codec;
+    stride = codec == ArchiveCodec::RawBgra ? kArchivePage + round_page(max_payload) : 0;
+    hdr.slot_stride = stride;
+    cursor = kArchivePage;
+    allocated = 0;
+    index.clear();
+
+#ifdef _WIN32
+    // Sector-aligned offsets, sizes and buffers are guaranteed by the page layout
+    HANDLE h = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING, nullptr);
+    unbuffered = h != INVALID_HANDLE_VALUE;
+    if (!unbuffered && GetLastError() == ERROR_INVALID_PARAMETER)
+        h = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE) { err = path.string() + ": cannot create (error " + std::to_string(GetLastError()) + ")"; return false; }
+    handle = h;
+#else
+    const int flags = O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC;
+    fd = -1;
+#ifdef O_DIRECT
+    fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+#endif
+    unbuffered = fd >= 0;
+    // tmpfs and some network file systems refuse O_DIRECT: fall back to the page cache
+    if (fd < 0) fd = ::open(path.c_str(), flags, 0644);
+    if (fd < 0) { err = path.string() + ": " + std::strerror(errno); return false; }
+#endif
+    if (!reserve(kArchivePage + (stride ? stride * (uint64_t)reserve_frames : kGrowBytes))) {
+        err = path.string() + ": cannot preallocate (disk full?)";
+        close(ignored);
+        return false;
+    }
+    if (!write_header()) {
+        err = path.string() + ": cannot write header";
+        close(ignored);
+        return false;
+    }
+    return true;
+}
+
+bool FrameArchiveWriter::reserve(uint64_t end) {
+    if (end <= allocated) return true;
+    // A full growth step may not fit where @p end still does: try that before giving up
+    for (uint64_t target : { std::max(end, allocated + kGrowBytes), end }) {
+#ifdef _WIN32
+        FILE_ALLOCATION_INFO info;
+        info.AllocationSize.QuadPart = (LONGLONG)target;
+        const bool full = !SetFileInformationByHandle((HANDLE)handle, FileAllocationInfo, &info, sizeof(info)) &&
+                          GetLastError() == ERROR_DISK_FULL;
+#elif defined(__linux__)
+        // Unlike posix_fallocate this never falls back to writing zeros
+        int rc;
+        do rc = fallocate(fd, 0, (off_t)allocated, (off_t)(target - allocated));
+        while (rc != 0 && errno == EINTR);
+        const bool full = rc != 0 && errno != EOPNOTSUPP && errno != ENOSYS;
+#else
+        const bool full = false;
+#endif
+        // Without preallocation support (EOPNOTSUPP, e.g. some network file systems) writes extend the file
+        if (!full) {
+            allocated = target;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FrameArchiveWriter::write_at(uint64_t offset, const uint8_t *data, size_t bytes) {
+#ifdef _WIN32
+    while (bytes > 0) {
+        const DWORD chunk = (DWORD)std::min<size_t>(bytes, 1u << 30);
+        OVERLAPPED ov{};
+        ov.Offset = (DWORD)offset;
+        ov.OffsetHigh = (DWORD)(offset >> 32);
+        DWORD done = 0;
+        if (!WriteFile((HANDLE)handle, data, chunk, &done, &ov) || done == 0) return false;
+        offset += done; data += done; bytes -= done;
+    }
+#else
+    while (bytes > 0) {
+        const ssize_t n = ::pwrite(fd, data, bytes, (off_t)offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        offset += (uint64_t)n; data += n; bytes -= (size_t)n;
+    }
+#endif
+    return true;
+}
+
+bool FrameArchiveWriter::write_header() {
+    PageBuffer page(kArchivePage);
+    std::memcpy(page.data, &hdr, sizeof(hdr));
+    return write_at(0, page.data, kArchivePage);
+}
+
+bool FrameArchiveWriter::write_slot(uint32_t idx, uint8_t *page, size_t payload_bytes, int width, int height) {
+    const uint64_t span = kArchivePage + round_page(payload_bytes);
+    uint64_t offset;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (!is_open() || (stride && span > stride)) return false;
+        offset = stride ? kArchivePage + (uint64_t)idx * stride : cursor;
+        if (!reserve(offset + (stride ? stride : span))) return false;
+        cursor = std::max(cursor, offset + span);
+    }
+    ArchiveFrameHeader fh{};
+    std::memcpy(fh.magic, kFrameMagic, sizeof(kFrameMagic));
+    fh.index = idx;
+    fh.bytes = (uint32_t)payload_bytes;
+    fh.width = (uint32_t)width;
+    fh.height = (uint32_t)height;
+    fh.codec = hdr.codec;
+    std::memset(page, 0, kArchivePage);
+    std::memcpy(page, &fh, sizeof(fh));
+    std::memset(page + kArchivePage + payload_bytes, 0, (size_t)(span - kArchivePage - payload_bytes));
+    if (!write_at(offset, page, (size_t)span)) return false;
+    std::lock_guard<std::mutex> lk(mtx);
+    index.push_back(ArchiveIndexEntry{ offset + kArchivePage, idx, (uint32_t)payload_bytes, (uint32_t)width, (uint32_t)height });
+    return true;
+}
+
+bool FrameArchiveWriter::close(std::string &err) {
+    if (!is_open()) return true;
+    std::sort(index.begin(), index.end(),
+              [](const ArchiveIndexEntry &a, const ArchiveIndexEntry &b) { return a.index < b.index; });
+    const size_t index_bytes = index.size() * sizeof(ArchiveIndexEntry);
+    hdr.frame_count = index.size();
+    hdr.index_offset = round_page(cursor);
+    bool ok = true;
+    if (index_bytes > 0) {
+        PageBuffer buf(round_page(index_bytes));
+        std::copy(index.begin(), index.end(), reinterpret_cast<ArchiveIndexEntry *>(buf.data));
+        ok = write_at(hdr.index_offset, buf.data, (size_t)round_page(index_bytes));
+    }
+    // The header goes last: an archive with a valid index_offset is complete
+    ok = ok && write_header();
+    const uint64_t end = hdr.index_offset + index_bytes;
+#ifdef _WIN32
+    FILE_END_OF_FILE_INFO eof;
+    eof.EndOfFile.QuadPart = (LONGLONG)end;
+    ok = SetFileInformationByHandle((HANDLE)handle, FileEndOfFileInfo, &eof, sizeof(eof)) && ok;
+    CloseHandle((HANDLE)handle);
+    handle = nullptr;
+#else
+    ok = ::ftruncate(fd, (off_t)end) == 0 && ok;
+    ok = ::close(fd) == 0 && ok;
+    fd = -1;
+#endif
+    index.clear();
+    if (!ok) err = "archive: writing the index failed";
+    return ok;
+}
+
+bool FrameArchiveReader::open(const std::filesystem::path &path, std::string &err) {
+    close();
+#ifdef _WIN32
+    HANDLE f = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (f == INVALID_HANDLE_VALUE) { err = path.string() + ": cannot open"; return false; }
+    file = f;
+    LARGE_INTEGER size{};
+    GetFileSizeEx(f, &size);
+    length = (size_t)size.QuadPart;
+    if (length >= kArchivePage) {
+        mapping = CreateFileMappingW(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) base = (const uint8_t *)MapViewOfFile((HANDLE)mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { err = path.string() + ": " + std::strerror(errno); return false; }
+    struct stat st{};
+    ::fstat(fd, &st);
+    length = (size_t)st.st_size;
+    if (length >= kArchivePage) {
+        void *p = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) base = (const uint8_t *)p;
+    }
+    ::close(fd);
+#endif
+    if (!base) { err = path.string() + ": not an archive (too short or cannot be mapped)"; close(); return false; }
+    std::memcpy(&hdr, base, sizeof(hdr));
+    if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0 || hdr.version != 1 || hdr.page != kArchivePage) {
+        err = path.string() + ": not a frame archive";
+        close();
+        return false;
+    }
+
+    const uint64_t index_end = hdr.index_offset + hdr.frame_count * sizeof(ArchiveIndexEntry);
+    if (hdr.index_offset != 0 && index_end <= length) {
+        for (uint64_t i = 0; i < hdr.frame_count; ++i) {
+            ArchiveIndexEntry e;
+            std::memcpy(&e, base + hdr.index_offset + i * sizeof(e), sizeof(e));
+            if (e.offset + e.bytes <= length) frames.push_back(Frame{ base + e.offset, e.bytes, e.index, (int)e.width, (int)e.height });
+        }
+        return true;
+    }
+
+    // No index (recording did not close): walk the slot headers
+    scanned = true;
+    uint64_t off = kArchivePage;
+    while (off + kArchivePage <= length) {
+        ArchiveFrameHeader fh;
+        std::memcpy(&fh, base + off, sizeof(fh));
+        const bool valid = std::memcmp(fh.magic, kFrameMagic, sizeof(kFrameMagic)) == 0 &&
+                           off + kArchivePage + fh.bytes <= length;
+        if (valid) frames.push_back(Frame{ base + off + kArchivePage, fh.bytes, fh.index, (int)fh.width, (int)fh.height });
+        if (hdr.slot_stride) off += hdr.slot_stride;
+        else if (valid) off += kArchivePage + round_page(fh.bytes);
+        else break;
+    }
+    std::sort(frames.begin(), frames.end(), [](const Frame &a, const Frame &b) { return a.index < b.index; });
+    return true;
+}
+
+void FrameArchiveReader::close() {
+#ifdef _WIN32
+    if (base) UnmapViewOfFile(base);
+    if (mapping) CloseHandle((HANDLE)mapping);
+    if (file) CloseHandle((HANDLE)file);
+    mapping = file = nullptr;
+#else
+    if (base) ::munmap((void *)base, length);
+#endif
+    base = nullptr;
+    length = 0;
+    hdr = ArchiveHeader{};
+    frames.clear();
+    scanned = false;
+}
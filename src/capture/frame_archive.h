@@ -0,0 +1,156 @@
+/**
+ * @file capture/frame_archive.h
+ * @brief Single-file frame archive: header, fixed-stride frame slots, index
+ *
+ * Layout (little endian, every part 4 KiB aligned):
+ *
+ *     [ArchiveHeader, one page]
+ *     [slot][slot] ... each slot:
+ *         [ArchiveFrameHeader, one page][payload, rounded up to a page]
+ *     [index: ArchiveIndexEntry x frame_count]   (written on close)
+ *
+ * Raw frames use fixed-stride slots: frame i lives at a fixed offset, so
+ * writer threads store frames in any order with positioned writes and no
+ * shared file cursor. QOI frames vary in size, so their slots are packed
+ * (slot_stride 0) and each write reserves its range under a lock. The
+ * file is preallocated in chunks and written with O_DIRECT on Linux
+ * (FILE_FLAG_NO_BUFFERING on Windows), which skips the page cache and
+ * the per-file metadata that thousands of frame files cost. If the
+ * recorder dies before close() the index is missing; readers then scan
+ * the slot headers instead.
+ *
+ * Readers map the file (mmap / MapViewOfFile) and hand out pointers into
+ * it; pong_archive exports archives to BMP/QOI files or Y4M.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// @brief Payload encoding of the frames in an archive
+enum class ArchiveCodec : uint32_t {
+    RawBgra = 0,  ///< Bottom-up 32 bpp BGRA, width x height (even-padded), like a DIB
+    Qoi = 1       ///< QOI file bytes (capture/qoi.h)
+};
+
+struct ArchiveHeader {
+    char magic[8];            ///< "PONGARC1"
+    uint32_t version;         ///< 1
+    uint32_t page;            ///< Alignment of every part (4096)
+    uint32_t width, height;   ///< Frame size (even)
+    uint32_t fps;
+    uint32_t codec;           ///< ArchiveCodec
+    uint64_t slot_stride;     ///< Bytes per slot, header page included; 0 = packed
+    uint64_t frame_count;     ///< Frames in the index (0 until closed)
+    uint64_t index_offset;    ///< File offset of the index (0 until closed)
+};
+
+/// @brief First bytes of each slot's header page
+struct ArchiveFrameHeader {
+    char magic[4];            ///< "PFRM"
+    uint32_t index;           ///< Frame number (slot number)
+    uint32_t bytes;           ///< Payload bytes
+    uint32_t width, height;
+    uint32_t codec;
+};
+
+struct ArchiveIndexEntry {
+    uint64_t offset;          ///< Payload offset in the file
+    uint32_t index;           ///< Frame number
+    uint32_t bytes;           ///< Payload bytes
+    uint32_t width, height;
+};
+
+constexpr size_t kArchivePage = 4096;
+
+/**
+ * @brief Archive writer; write_slot() may be called from several threads
+ */
+class FrameArchiveWriter {
+public:
+    FrameArchiveWriter() = default;
+    ~FrameArchiveWriter();
+    FrameArchiveWriter(const FrameArchiveWriter &) = delete;
+    FrameArchiveWriter &operator=(const FrameArchiveWriter &) = delete;
+
+    /**
+     * @param max_payload Largest payload a frame can have (sets the raw slot stride)
+     * @param reserve_frames Frames to preallocate room for up front (more is added in chunks)
+     */
+    bool open(const std::filesystem::path &path, int width, int height, int fps, ArchiveCodec codec,
+              size_t max_payload, size_t reserve_frames, std::string &err);
+    /**
+     * @brief Store frame @p index (raw: at its fixed slot; QOI: at the next free range)
+     * @param page Page-aligned buffer: one header page (filled in here) followed by the payload,
+     *             writable up to the next page boundary after it (the tail is zeroed)
+     */
+    bool write_slot(uint32_t index, uint8_t *page, size_t payload_bytes, int width, int height);
+    /// @brief Write the index and final header, trim the preallocation, close
+    bool close(std::string &err);
+    bool is_open() const;
+    /// @brief Whether writes bypass the page cache (O_DIRECT / no buffering)
+    bool direct() const { return unbuffered; }
+    uint64_t slot_stride() const { return stride; }
+
+private:
+    bool write_at(uint64_t offset, const uint8_t *data, size_t bytes);
+    bool write_header();
+    /// Make sure the file has room up to @p end (caller holds mtx); false when the disk is full
+    bool reserve(uint64_t end);
+
+#ifdef _WIN32
+    void *handle = nullptr;
+#else
+    int fd = -1;
+#endif
+    bool unbuffered = false;
+    ArchiveHeader hdr{};
+    uint64_t stride = 0;
+    uint64_t cursor = 0;      ///< Packed: end of the last reserved slot
+    uint64_t allocated = 0;   ///< Bytes preallocated on disk
+    std::mutex mtx;
+    std::vector<ArchiveIndexEntry> index;
+};
+
+/**
+ * @brief Read-only view of an archive through a file mapping
+ */
+class FrameArchiveReader {
+public:
+    struct Frame {
+        const uint8_t *data = nullptr;
+        size_t bytes = 0;
+        uint32_t index = 0;
+        int width = 0, height = 0;
+    };
+
+    FrameArchiveReader() = default;
+    ~FrameArchiveReader() { close(); }
+    FrameArchiveReader(const FrameArchiveReader &) = delete;
+    FrameArchiveReader &operator=(const FrameArchiveReader &) = delete;
+
+    bool open(const std::filesystem::path &path, std::string &err);
+    void close();
+
+    const ArchiveHeader &header() const { return hdr; }
+    ArchiveCodec codec() const { return (ArchiveCodec)hdr.codec; }
+    size_t size() const { return frames.size(); }
+    /// @brief i-th frame in frame order (gaps from dropped frames are skipped)
+    const Frame &frame(size_t i) const { return frames[i]; }
+    /// @brief True if the index was missing and frames were recovered from slot headers
+    bool recovered() const { return scanned; }
+
+private:
+    const uint8_t *base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void *file = nullptr, *mapping = nullptr;
+#endif
+    ArchiveHeader hdr{};
+    std::vector<Frame> frames;
+    bool scanned = false;
+};
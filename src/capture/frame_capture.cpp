@@ -0,0 +1,260 @@
+/**
+ * @file capture/frame_capture.cpp
+ * @brief Pooled frame slots and BMP / QOI / Y4M / archive writer threads
+ */
+
+#include "capture/frame_capture.h"
+#include "capture/qoi.h"
+#include "capture/yuv.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+constexpr size_t kAlign = 4096;       // pixel rows start page aligned
+static_assert(kAlign == kArchivePage, "archive slot header page sits right before the payload");
+
+/// Size @p v to @p bytes plus slack and return the page-aligned start that has a free page in front
+/// (BMP header / archive slot header) and room to round the payload up to a page
+uint8_t *page_after_header(std::vector<uint8_t> &v, size_t bytes) {
+    v.assign(bytes + 3 * kAlign, 0);
+    const uintptr_t base = (uintptr_t)v.data() + kAlign;
+    return (uint8_t *)((base + kAlign - 1) & ~(uintptr_t)(kAlign - 1));
+}
+
+void put_u16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+void put_u32(uint8_t *p, uint32_t v) { for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (8 * i)); }
+
+} // namespace
+
+// Written byte-wise, so no <windows.h>
+void write_bmp_header(uint8_t *h, int w, int ht) {
+    const uint32_t data = (uint32_t)w * 4u * (uint32_t)ht;
+    std::memset(h, 0, kBmpHeaderBytes);
+    h[0] = 'B'; h[1] = 'M';
+    put_u32(h + 2, (uint32_t)kBmpHeaderBytes + data);
+    put_u32(h + 10, (uint32_t)kBmpHeaderBytes);
+    put_u32(h + 14, 40);
+    put_u32(h + 18, (uint32_t)w);
+    put_u32(h + 22, (uint32_t)ht);
+    put_u16(h + 26, 1);
+    put_u16(h + 28, 32);
+    put_u32(h + 34, data);
+}
+
+FrameCapture::FrameCapture(int threads, int slots) {
+    pool.resize((size_t)std::max(slots, 1));
+    for (int i = 0; i < std::max(threads, 1); ++i) workers.emplace_back([this] { run(); });
+}
+
+FrameCapture::~FrameCapture() {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (std::thread &t : workers) t.join();
+}
+
+bool FrameCapture::start(const CaptureOptions &o, int width, int height, std::string &err) {
+    finish();
+    std::lock_guard<std::mutex> lk(mtx);
+    opt = o;
+    next_index = next_write = 0;
+    totals = CaptureStats{};
+    started = false;
+    if (width <= 0 || height <= 0) { err = "empty frame"; return false; }
+    // Reallocate only when the frame grows; slots keep their memory between recordings
+    if (padded(width) > max_w || padded(height) > max_h) {
+        max_w = std::max(max_w, padded(width));
+        max_h = std::max(max_h, padded(height));
+        const size_t bytes = (size_t)max_w * (size_t)max_h * 4;
+        for (CaptureFrame &f : pool) {
+            f.pixels = page_after_header(f.storage, bytes);
+            f.offset = (size_t)(f.pixels - f.storage.data());
+        }
+    }
+    const bool archive_qoi = opt.format == CaptureFormat::Archive && opt.archive_codec == ArchiveCodec::Qoi;
+    if (opt.format == CaptureFormat::Y4m) {
+        const bool ok = opt.stream.empty() ? y4m.open_file(opt.dir / "recording.y4m", width, height, opt.fps, err)
+                                           : y4m.open(opt.stream, width, height, opt.fps, err);
+        if (!ok) return false;
+    } else if (opt.format == CaptureFormat::Archive) {
+        const size_t payload = archive_qoi ? qoi_max_size(max_w, max_h) : (size_t)max_w * (size_t)max_h * 4;
+        if (!archive.open(opt.dir / "recording.pfa", max_w, max_h, opt.fps, opt.archive_codec, payload,
+                          (size_t)std::max(opt.fps, 1), err))
+            return false;
+        totals.direct_io = archive.direct();
+    }
+    started = true;
+    for (CaptureFrame &f : pool) {
+        if (opt.format == CaptureFormat::Y4m) {
+            f.encoded.resize(Y4mWriter::kFramePrefix + yuv420_size(width, height));
+            std::memcpy(f.encoded.data(), Y4mWriter::frame_prefix(), Y4mWriter::kFramePrefix);
+            f.out = f.encoded.data();
+        } else if (opt.format == CaptureFormat::Qoi) {
+            f.encoded.resize(qoi_max_size(max_w, max_h));
+            f.out = f.encoded.data();
+        } else if (archive_qoi) {
+            f.out = page_after_header(f.encoded, qoi_max_size(max_w, max_h));
+        } else {
+            f.encoded = std::vector<uint8_t>();
+            f.out = nullptr;
+        }
+    }
+    stream_w = width;
+    stream_h = height;
+    free_slots.clear();
+    for (CaptureFrame &f : pool) free_slots.push_back(&f);
+    return true;
+}
+
+CaptureFrame *FrameCapture::acquire() {
+    std::unique_lock<std::mutex> lk(mtx);
+    if (!started) return nullptr;
+    if (free_slots.empty()) {
+        const auto t0 = std::chrono::steady_clock::now();
+        ++totals.stalls;
+        cv.wait(lk, [this] { return !free_slots.empty(); });
+        totals.stall_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+    CaptureFrame *f = free_slots.back();
+    free_slots.pop_back();
+    f->width = max_w;
+    f->height = max_h;
+    return f;
+}
+
+void FrameCapture::submit(CaptureFrame *f) {
+    if (!f) return;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        f->width = std::min(f->width, max_w);
+        f->height = std::min(f->height, max_h);
+        f->index = next_index++;
+        queue.push_back(f);
+    }
+    cv.notify_all();
+}
+
+void FrameCapture::release(CaptureFrame *f) {
+    if (!f) return;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        free_slots.push_back(f);
+    }
+    cv.notify_all();
+}
+
+void FrameCapture::finish() {
+    std::unique_lock<std::mutex> lk(mtx);
+    cv.wait(lk, [this] { return queue.empty() && writing == 0; });
+    started = false;
+    y4m.close();
+    std::string err;
+    if (!archive.close(err)) ++totals.failed;
+}
+
+CaptureStats FrameCapture::stats() {
+    std::lock_guard<std::mutex> lk(mtx);
+    return totals;
+}
+
+void FrameCapture::run() {
+    std::unique_lock<std::mutex> lk(mtx);
+    for (;;) {
+        cv.wait(lk, [this] { return !queue.empty() || stopping; });
+        // Drain what was submitted before stopping so the last frames are not lost
+        if (queue.empty()) return;
+        CaptureFrame *f = queue.front();
+        queue.pop_front();
+        ++writing;
+        const bool stream = opt.format == CaptureFormat::Y4m;
+        const bool fits = !stream || (f->width == stream_w && f->height == stream_h);
+        lk.unlock();
+        // Encode in parallel with the other writers; a stream then waits for this frame's turn
+        using clock = std::chrono::steady_clock;
+        const auto t0 = clock::now();
+        const size_t bytes = fits ? encode_frame(*f) : 0;
+        const auto t1 = clock::now();
+        if (stream) {
+            lk.lock();
+            cv.wait(lk, [&] { return next_write == f->index; });
+            lk.unlock();
+        }
+        const auto t2 = clock::now();
+        const bool ok = fits && write_frame(*f, bytes);
+        const auto t3 = clock::now();
+        lk.lock();
+        --writing;
+        totals.encode_ms += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        totals.write_ms += std::chrono::duration<double, std::milli>(t3 - t2).count();
+        if (ok) {
+            ++totals.frames;
+            totals.bytes += bytes;
+            totals.raw_bytes += kBmpHeaderBytes + (uint64_t)padded(f->width) * 4u * (uint64_t)padded(f->height);
+        } else {
+            ++totals.failed;
+        }
+        if (stream) ++next_write;
+        free_slots.push_back(f);
+        cv.notify_all();
+    }
+}
+
+size_t FrameCapture::encode_frame(CaptureFrame &f) {
+    const int w = f.width, h = f.height, pw = padded(w), ph = padded(h);
+    switch (opt.format) {
+    case CaptureFormat::Y4m: {
+        // Bottom-up rows: start at the last one and walk upwards
+        const ptrdiff_t stride = (ptrdiff_t)w * 4;
+        bgra_to_yuv420(f.pixels + (ptrdiff_t)(h - 1) * stride, -stride, w, h,
+                       yuv420_planes(f.out + Y4mWriter::kFramePrefix, w, h));
+        return f.encoded.size();
+    }
+    case CaptureFormat::Qoi:
+        return qoi_encode_bgra_bottom_up(f.pixels, w, h, pw, ph, f.out);
+    case CaptureFormat::Archive:
+        if (opt.archive_codec == ArchiveCodec::Qoi) return qoi_encode_bgra_bottom_up(f.pixels, w, h, pw, ph, f.out);
+        break;  // raw: padded in place like a BMP, without the file header
+    case CaptureFormat::Bmp:
+        break;
+    }
+    const size_t src_stride = (size_t)w * 4, dst_stride = (size_t)pw * 4;
+    // Spread tightly packed rows to the padded stride, last row first so nothing is overwritten early
+    if (pw != w) {
+        for (int y = h - 1; y >= 0; --y) {
+            uint8_t *dst = f.pixels + (size_t)y * dst_stride;
+            std::memmove(dst, f.pixels + (size_t)y * src_stride, src_stride);
+            std::memset(dst + src_stride, 0, dst_stride - src_stride);
+        }
+    }
+    // Bottom-up: the extra row is the top one and stays black
+    if (ph != h) std::memset(f.pixels + (size_t)h * dst_stride, 0, dst_stride);
+    if (opt.format == CaptureFormat::Archive) return dst_stride * (size_t)ph;
+    write_bmp_header(f.pixels - kBmpHeaderBytes, pw, ph);
+    return kBmpHeaderBytes + dst_stride * (size_t)ph;
+}
+
+bool FrameCapture::write_frame(CaptureFrame &f, size_t bytes) {
+    if (opt.format == CaptureFormat::Y4m) return y4m.write_frame(f.out, bytes);
+    if (opt.format == CaptureFormat::Archive) {
+        uint8_t *payload = opt.archive_codec == ArchiveCodec::Qoi ? f.out : f.pixels;
+        return archive.write_slot((uint32_t)f.index, payload - kAlign, bytes, padded(f.width), padded(f.height));
+    }
+    const bool bmp = opt.format == CaptureFormat::Bmp;
+    const uint8_t *data = bmp ? f.pixels - kBmpHeaderBytes : f.out;
+    char name[32];
+    std::snprintf(name, sizeof(name), bmp ? "frame_%06d.bmp" : "frame_%06d.qoi", f.index);
+
+    // Unbuffered stream: the whole file goes out in one write from the slot
+    std::ofstream out;
+    out.rdbuf()->pubsetbuf(nullptr, 0);
+    out.open(opt.dir / name, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char *>(data), (std::streamsize)bytes);
+    return (bool)out;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file capture/frame_capture.h
+ * @brief Asynchronous recording of rendered frames to disk
+ *
+ * The game loop acquire()s a pooled frame slot, copies the back buffer
+ * into it (GetDIBits on Windows) and submit()s it; writer threads pad
+ * the frame to even dimensions (H.264 yuv420p needs them), put the file
+ * header in front of the pixels and write each file with a single
+ * unbuffered write. The pool is allocated once per recording, so a frame
+ * costs the loop one copy and no allocation. When every slot is queued
+ * or being written, acquire() blocks: that is the backpressure that keeps
+ * a slow disk from piling up memory, and the time spent there is
+ * reported as the loop's stall.
+ *
+ * Frames go out as one BMP or QOI (lossless, about a tenth of the size)
+ * file each, as a single Y4M stream (file, stdout or a pipe into an
+ * encoder), or into one preallocated frame archive written around the
+ * page cache (capture/frame_archive.h). Encoding runs on the writer threads, so more threads buy
+ * compression throughput; for Y4M they convert in parallel and then take
+ * turns in frame order.
+ */
+#pragma once
+
+#include "capture/frame_archive.h"
+#include "capture/y4m_writer.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// @brief Size of the header write_bmp_header() produces
+constexpr size_t kBmpHeaderBytes = 14 + 40;
+
+/// @brief BITMAPFILEHEADER + BITMAPINFOHEADER (kBmpHeaderBytes) for a bottom-up 32 bpp @p w x @p ht image
+void write_bmp_header(uint8_t *h, int w, int ht);
+
+/**
+ * @brief One pooled frame: 32-bit BGRA rows, bottom-up like a DIB
+ *
+ * The producer fills width x height pixels tightly packed (row stride
+ * width*4, which is what GetDIBits produces for 32 bpp); the writer
+ * spreads the rows to the padded stride in place and blacks out the
+ * padding column/row.
+ */
+struct CaptureFrame {
+    uint8_t *pixels = nullptr;  ///< Start of pixel data (page aligned, at least one page into the slot)
+    int width = 0, height = 0;  ///< Size the producer filled
+    int index = 0;              ///< Sequence number (file name)
+
+private:
+    friend class FrameCapture;
+    std::vector<uint8_t> storage;
+    size_t offset = 0;          ///< pixels - storage.data()
+    std::vector<uint8_t> encoded; ///< QOI file / Y4M "FRAME\n" + planes
+    uint8_t *out = nullptr;     ///< Encoded bytes in encoded (page aligned behind a free page for archives)
+};
+
+/// @brief Output container for a recording
+enum class CaptureFormat {
+    Bmp,   ///< frame_%06d.bmp per frame in CaptureOptions::dir
+    Qoi,   ///< frame_%06d.qoi per frame (lossless, compressed on the writer threads)
+    Y4m,   ///< One yuv420p stream; every frame must have the size given to start()
+    Archive ///< recording.pfa in CaptureOptions::dir: raw or QOI frames in one file
+};
+
+struct CaptureOptions {
+    CaptureFormat format = CaptureFormat::Bmp;
+    std::filesystem::path dir;  ///< Output directory (BMP frames; default Y4M location)
+    std::string stream;         ///< Y4M target: path, "-" (stdout) or "|command"; empty = dir/recording.y4m
+    int fps = 60;               ///< Y4M / archive frame rate
+    ArchiveCodec archive_codec = ArchiveCodec::RawBgra; ///< Archive payload encoding
+};
+
+/// @brief Counters for the recording summary / benchmark
+struct CaptureStats {
+    uint64_t frames = 0;        ///< Frames written
+    uint64_t failed = 0;        ///< Frames whose file could not be written
+    uint64_t bytes = 0;         ///< File bytes written
+    uint64_t raw_bytes = 0;     ///< What the written frames would take as BMP (compression ratio)
+    double write_ms = 0.0;      ///< Writer-thread time spent in file I/O (all threads)
+    double encode_ms = 0.0;     ///< Writer-thread time spent padding / compressing / converting
+    uint64_t stalls = 0;        ///< acquire() calls that found no free slot
+    double stall_ms = 0.0;      ///< Time acquire() blocked waiting for a free slot
+    bool direct_io = false;     ///< Archive writes bypass the page cache (O_DIRECT / no buffering)
+};
+
+class FrameCapture {
+public:
+    /**
+     * @param threads Writer threads (files are independent, so more than one overlaps I/O)
+     * @param slots Frames that may be in flight; bounds memory at slots x frame size
+     */
+    explicit FrameCapture(int threads = 2, int slots = 8);
+    ~FrameCapture();
+    FrameCapture(const FrameCapture &) = delete;
+    FrameCapture &operator=(const FrameCapture &) = delete;
+
+    /// @brief Start a recording of frames up to @p width x @p height; false (with @p err) if the output cannot be opened
+    bool start(const CaptureOptions &opt, int width, int height, std::string &err);
+    /// @brief Free slot to render into; blocks while all slots are in flight. nullptr when not started
+    /// @return Slot with width/height set to its capacity (the size given to start(), padded)
+    CaptureFrame *acquire();
+    /// @brief Queue @p f (filled with f->width x f->height pixels) for writing
+    void submit(CaptureFrame *f);
+    /// @brief Return an acquired slot without writing it (e.g. GetDIBits failed)
+    void release(CaptureFrame *f);
+    /// @brief Wait until every submitted frame is on disk; the pool stays allocated
+    void finish();
+    bool active() const { return started; }
+    CaptureStats stats();
+
+    /// @brief @p v rounded up to an even number of pixels
+    static int padded(int v) { return (v + 1) & ~1; }
+
+private:
+    void run();
+    /// Turn the slot's pixels into the bytes to write; returns their size
+    size_t encode_frame(CaptureFrame &f);
+    bool write_frame(CaptureFrame &f, size_t bytes);
+
+    CaptureOptions opt;
+    Y4mWriter y4m;
+    FrameArchiveWriter archive;
+    int max_w = 0, max_h = 0;
+    int stream_w = 0, stream_h = 0; ///< Size given to start() (the Y4M frame size)
+    bool started = false;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<CaptureFrame> pool;
+    std::vector<CaptureFrame *> free_slots;
+    std::deque<CaptureFrame *> queue;
+    int writing = 0;
+    int next_index = 0;
+    int next_write = 0;         ///< Y4M: index whose turn it is to be written
+    bool stopping = false;
+
+    CaptureStats totals;
+    std::vector<std::thread> workers;
+};
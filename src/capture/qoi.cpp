@@ -0,0 +1,136 @@
+/**
+ * @file capture/qoi.cpp
+ * @brief QOI encoder (BGRA DIB input) and decoder
+ */
+
+#include "capture/qoi.h"
+#include <cstring>
+
+namespace {
+
+constexpr uint8_t kOpIndex = 0x00, kOpDiff = 0x40, kOpLuma = 0x80, kOpRun = 0xc0;
+constexpr uint8_t kOpRgb = 0xfe, kOpRgba = 0xff, kMask2 = 0xc0;
+constexpr size_t kHeader = 14;
+constexpr uint8_t kEnd[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+struct Rgba {
+    uint8_t r, g, b, a;
+    bool operator==(const Rgba &o) const { return r == o.r && g == o.g && b == o.b && a == o.a; }
+};
+
+inline int hash(const Rgba &p) { return (p.r * 3 + p.g * 5 + p.b * 7 + p.a * 11) & 63; }
+
+void put_be32(uint8_t *p, uint32_t v) { p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v; }
+uint32_t get_be32(const uint8_t *p) { return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3]; }
+
+/// Encoder state over the pixel stream; pixels arrive row by row
+struct Encoder {
+    uint8_t *o;
+    Rgba index[64] = {};
+    Rgba prev{0, 0, 0, 255};
+    int run = 0;
+
+    void flush_run() {
+        if (run) { *o++ = (uint8_t)(kOpRun | (run - 1)); run = 0; }
+    }
+    void push(Rgba px) {
+        if (px == prev) {
+            if (++run == 62) flush_run();
+            return;
+        }
+        flush_run();
+        const int h = hash(px);
+        if (index[h] == px) {
+            *o++ = (uint8_t)(kOpIndex | h);
+        } else {
+            index[h] = px;
+            // Alpha is always 255 here, so RGBA ops never occur
+            const int8_t vr = (int8_t)(px.r - prev.r), vg = (int8_t)(px.g - prev.g), vb = (int8_t)(px.b - prev.b);
+            const int8_t vg_r = (int8_t)(vr - vg), vg_b = (int8_t)(vb - vg);
+            if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                *o++ = (uint8_t)(kOpDiff | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+            } else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8) {
+                *o++ = (uint8_t)(kOpLuma | (vg + 32));
+                *o++ = (uint8_t)((vg_r + 8) << 4 | (vg_b + 8));
+            } else {
+                *o++ = kOpRgb; *o++ = px.r; *o++ = px.g; *o++ = px.b;
+            }
+        }
+        prev = px;
+    }
+};
+
+} // namespace
+
+size_t qoi_max_size(int w, int h) { return (size_t)w * (size_t)h * 4 + kHeader + sizeof(kEnd); }
+
+size_t qoi_encode_bgra_bottom_up(const uint8_t *bgra, int w, int h, int pw, int ph, uint8_t *out) {
+    std::memcpy(out, "qoif", 4);
+    put_be32(out + 4, (uint32_t)pw);
+    put_be32(out + 8, (uint32_t)ph);
+    out[12] = 3;  // RGB
+    out[13] = 0;  // sRGB
+    Encoder e{out + kHeader};
+    const Rgba black{0, 0, 0, 255};
+    // Top-down: the padding row (if any) is the image's top row, then DIB rows last to first
+    for (int y = ph - 1; y >= 0; --y) {
+        if (y >= h) {
+            for (int x = 0; x < pw; ++x) e.push(black);
+            continue;
+        }
+        const uint8_t *row = bgra + (size_t)y * (size_t)w * 4;
+        for (int x = 0; x < w; ++x) e.push(Rgba{row[x * 4 + 2], row[x * 4 + 1], row[x * 4], 255});
+        for (int x = w; x < pw; ++x) e.push(black);
+    }
+    e.flush_run();
+    std::memcpy(e.o, kEnd, sizeof(kEnd));
+    return (size_t)(e.o + sizeof(kEnd) - out);
+}
+
+bool qoi_decode(const uint8_t *data, size_t size, int &w, int &h, std::vector<uint8_t> &rgba) {
+    if (size < kHeader + sizeof(kEnd) || std::memcmp(data, "qoif", 4) != 0) return false;
+    const uint32_t uw = get_be32(data + 4), uh = get_be32(data + 8);
+    if (uw == 0 || uh == 0 || uw > 1u << 15 || uh > 1u << 15) return false;
+    w = (int)uw; h = (int)uh;
+    const size_t n = (size_t)uw * uh;
+    rgba.resize(n * 4);
+    Rgba index[64] = {};
+    Rgba px{0, 0, 0, 255};
+    size_t p = kHeader;
+    const size_t end = size - sizeof(kEnd);
+    int run = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (run > 0) {
+            --run;
+        } else if (p < end) {
+            const uint8_t b1 = data[p++];
+            if (b1 == kOpRgb) {
+                if (p + 3 > end) return false;
+                px.r = data[p]; px.g = data[p + 1]; px.b = data[p + 2]; p += 3;
+            } else if (b1 == kOpRgba) {
+                if (p + 4 > end) return false;
+                px.r = data[p]; px.g = data[p + 1]; px.b = data[p + 2]; px.a = data[p + 3]; p += 4;
+            } else if ((b1 & kMask2) == kOpIndex) {
+                px = index[b1];
+            } else if ((b1 & kMask2) == kOpDiff) {
+                px.r = (uint8_t)(px.r + ((b1 >> 4) & 3) - 2);
+                px.g = (uint8_t)(px.g + ((b1 >> 2) & 3) - 2);
+                px.b = (uint8_t)(px.b + (b1 & 3) - 2);
+            } else if ((b1 & kMask2) == kOpLuma) {
+                if (p >= end) return false;
+                const uint8_t b2 = data[p++];
+                const int vg = (b1 & 0x3f) - 32;
+                px.r = (uint8_t)(px.r + vg - 8 + ((b2 >> 4) & 0x0f));
+                px.g = (uint8_t)(px.g + vg);
+                px.b = (uint8_t)(px.b + vg - 8 + (b2 & 0x0f));
+            } else {
+                run = b1 & 0x3f;
+            }
+            index[hash(px)] = px;
+        } else {
+            return false;
+        }
+        std::memcpy(&rgba[i * 4], &px, 4);
+    }
+    return true;
+}
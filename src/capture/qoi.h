@@ -0,0 +1,33 @@
+/**
+ * @file capture/qoi.h
+ * @brief QOI ("Quite OK Image") lossless encoder / decoder for recordings
+ *
+ * QOI compresses in a single pass with a 64-entry colour cache, runs and
+ * small deltas: a few times slower than a memcpy, far faster than
+ * deflate, and game frames (flat backgrounds, few colours) shrink by an
+ * order of magnitude. Recordings are encoded as 3-channel images since
+ * GDI leaves alpha undefined. See https://qoiformat.org/qoi-specification.pdf
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief Upper bound of an encoded w x h image (3 channels)
+size_t qoi_max_size(int w, int h);
+
+/**
+ * @brief Encode a bottom-up BGRA frame, padded with black to @p pw x @p ph
+ *
+ * @param bgra Tightly packed rows (stride w*4), last image row first (DIB order)
+ * @param out Destination of at least qoi_max_size(pw, ph) bytes
+ * @return Encoded size
+ */
+size_t qoi_encode_bgra_bottom_up(const uint8_t *bgra, int w, int h, int pw, int ph, uint8_t *out);
+
+/**
+ * @brief Decode to top-down RGBA
+ * @return false if @p data is not a valid QOI image
+ */
+bool qoi_decode(const uint8_t *data, size_t size, int &w, int &h, std::vector<uint8_t> &rgba);
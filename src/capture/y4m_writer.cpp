@@ -0,0 +1,75 @@
+/**
+ * @file capture/y4m_writer.cpp
+ * @brief Y4M header / frame output to files, stdout or a pipe
+ */
+
+#include "capture/y4m_writer.h"
+#include <cerrno>
+#include <cstring>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#define popen _popen
+#define pclose _pclose
+#endif
+
+bool Y4mWriter::open(const std::string &target, int w, int h, int fps, std::string &err) {
+    close();
+    if (target == "-") {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        f = stdout;
+        is_stdout = true;
+    } else if (!target.empty() && target[0] == '|') {
+#ifdef _WIN32
+        f = popen(target.c_str() + 1, "wb");
+#else
+        f = popen(target.c_str() + 1, "w");
+#endif
+        piped = f != nullptr;
+    } else {
+        return open_file(std::filesystem::path(target), w, h, fps, err);
+    }
+    if (!f) { err = target + ": " + std::strerror(errno); return false; }
+    return begin(w, h, fps, err);
+}
+
+bool Y4mWriter::open_file(const std::filesystem::path &path, int w, int h, int fps, std::string &err) {
+    close();
+#ifdef _WIN32
+    f = _wfopen(path.c_str(), L"wb");
+#else
+    f = std::fopen(path.c_str(), "wb");
+#endif
+    if (!f) { err = path.string() + ": " + std::strerror(errno); return false; }
+    return begin(w, h, fps, err);
+}
+
+bool Y4mWriter::begin(int w, int h, int fps, std::string &err) {
+    // Frames are written whole, so a buffer would only add a copy (stdout may already be in use)
+    if (!is_stdout) std::setvbuf(f, nullptr, _IONBF, 0);
+    char hdr[96];
+    // Progressive, square pixels, chroma centred in each 2x2 block (what box averaging gives)
+    const int n = std::snprintf(hdr, sizeof(hdr), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+                                (w + 1) & ~1, (h + 1) & ~1, fps > 0 ? fps : 60);
+    if (std::fwrite(hdr, 1, (size_t)n, f) != (size_t)n) {
+        err = std::strerror(errno);
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool Y4mWriter::write_frame(const uint8_t *frame, size_t bytes) {
+    return f && std::fwrite(frame, 1, bytes, f) == bytes;
+}
+
+void Y4mWriter::close() {
+    if (!f) return;
+    if (piped) pclose(f);
+    else if (is_stdout) std::fflush(f);
+    else std::fclose(f);
+    f = nullptr;
+    piped = is_stdout = false;
+}
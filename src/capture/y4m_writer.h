@@ -0,0 +1,51 @@
+/**
+ * @file capture/y4m_writer.h
+ * @brief YUV4MPEG2 (Y4M) stream output for recordings
+ *
+ * Y4M is a stream header followed by "FRAME\n" and raw yuv420p planes
+ * per frame, so a recording becomes one file (or a pipe straight into
+ * an encoder) instead of a directory of per-frame images. ffmpeg reads
+ * it with no options: `ffmpeg -i rec.y4m out.mp4`, or `... | ffmpeg -i -`.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+class Y4mWriter {
+public:
+    Y4mWriter() = default;
+    ~Y4mWriter() { close(); }
+    Y4mWriter(const Y4mWriter &) = delete;
+    Y4mWriter &operator=(const Y4mWriter &) = delete;
+
+    /**
+     * @brief Open a stream for padded @p w x @p h frames at @p fps
+     * @param target "-" for stdout, "|command" to pipe into a process, anything else is a file path
+     */
+    bool open(const std::string &target, int w, int h, int fps, std::string &err);
+    /// @brief Open a file (wide paths on Windows)
+    bool open_file(const std::filesystem::path &path, int w, int h, int fps, std::string &err);
+    /**
+     * @brief Write one frame
+     * @param frame "FRAME\n" followed by the planes; see frame_prefix()
+     * @param bytes Length including the prefix
+     */
+    bool write_frame(const uint8_t *frame, size_t bytes);
+    /// @brief Flush and close (waits for a piped process to exit)
+    void close();
+    bool is_open() const { return f != nullptr; }
+
+    /// @brief Per-frame marker; reserve this many bytes in front of the planes to write a frame in one call
+    static const char *frame_prefix() { return "FRAME\n"; }
+    static constexpr size_t kFramePrefix = 6;
+
+private:
+    bool begin(int w, int h, int fps, std::string &err);
+
+    std::FILE *f = nullptr;
+    bool piped = false;
+    bool is_stdout = false;
+};
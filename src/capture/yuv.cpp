@@ -0,0 +1,104 @@
+/**
+ * @file capture/yuv.cpp
+ * @brief Portable BGRA to yuv420p conversion and AVX2 dispatch
+ */
+
+#include "capture/yuv.h"
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+#if PONG_CAPTURE_AVX2
+/// Converts the first (w & ~31) pixels of a row pair; returns how many it did (yuv_avx2.cpp)
+int bgra_to_yuv420_pair_avx2(const uint8_t *r0, const uint8_t *r1, int w,
+                             uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v);
+#endif
+
+namespace {
+
+// Y = ((66R + 129G + 25B + 128) >> 8) + 16, U/V from the sum of a 2x2 block:
+// ((c * sum + 512) >> 10) + 128. Offsets are folded into the rounding term.
+inline uint8_t luma(int b, int g, int r) { return (uint8_t)((66 * r + 129 * g + 25 * b + 128 + (16 << 8)) >> 8); }
+inline uint8_t chroma_u(int b, int g, int r) { return (uint8_t)((-38 * r - 74 * g + 112 * b + 512 + (128 << 10)) >> 10); }
+inline uint8_t chroma_v(int b, int g, int r) { return (uint8_t)((112 * r - 94 * g - 18 * b + 512 + (128 << 10)) >> 10); }
+
+/// Row pair from pixel x0 (even) to the padded width; r1 == nullptr or x >= w is black
+void convert_pair(const uint8_t *r0, const uint8_t *r1, int w, int x0,
+                  uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v) {
+    static const uint8_t kBlack[4] = { 0, 0, 0, 0 };
+    const int pw = (w + 1) & ~1;
+    for (int x = x0; x < pw; x += 2) {
+        int sb = 0, sg = 0, sr = 0;
+        for (int dx = 0; dx < 2; ++dx) {
+            const uint8_t *p0 = x + dx < w ? r0 + (size_t)(x + dx) * 4 : kBlack;
+            const uint8_t *p1 = r1 && x + dx < w ? r1 + (size_t)(x + dx) * 4 : kBlack;
+            y0[x + dx] = luma(p0[0], p0[1], p0[2]);
+            y1[x + dx] = luma(p1[0], p1[1], p1[2]);
+            sb += p0[0] + p1[0]; sg += p0[1] + p1[1]; sr += p0[2] + p1[2];
+        }
+        u[x / 2] = chroma_u(sb, sg, sr);
+        v[x / 2] = chroma_v(sb, sg, sr);
+    }
+}
+
+bool cpu_has_avx2() {
+#if PONG_CAPTURE_AVX2 && (defined(__GNUC__) || defined(__clang__))
+    return __builtin_cpu_supports("avx2");
+#elif PONG_CAPTURE_AVX2 && defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 0);
+    if (r[0] < 7) return false;
+    __cpuid(r, 1);
+    // OSXSAVE + AVX, and the OS saves YMM state
+    if ((r[2] & (1 << 27)) == 0 || (r[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(r, 7, 0);
+    return (r[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+const bool g_avx2 = cpu_has_avx2();
+
+void convert(const uint8_t *top, ptrdiff_t stride, int w, int h, const YuvPlanes &out, bool simd) {
+    const int pw = (w + 1) & ~1, ph = (h + 1) & ~1;
+    for (int y = 0; y < ph; y += 2) {
+        const uint8_t *r0 = top + (ptrdiff_t)y * stride;
+        const uint8_t *r1 = y + 1 < h ? r0 + stride : nullptr;
+        uint8_t *y0 = out.y + (size_t)y * (size_t)pw, *y1 = y0 + pw;
+        uint8_t *u = out.u + (size_t)(y / 2) * (size_t)(pw / 2), *v = out.v + (size_t)(y / 2) * (size_t)(pw / 2);
+        int x = 0;
+#if PONG_CAPTURE_AVX2
+        if (simd && r1) x = bgra_to_yuv420_pair_avx2(r0, r1, w, y0, y1, u, v);
+#else
+        (void)simd;
+#endif
+        convert_pair(r0, r1, w, x, y0, y1, u, v);
+    }
+}
+
+} // namespace
+
+size_t yuv420_size(int w, int h) {
+    const size_t pw = (size_t)((w + 1) & ~1), ph = (size_t)((h + 1) & ~1);
+    return pw * ph + 2 * (pw / 2) * (ph / 2);
+}
+
+YuvPlanes yuv420_planes(uint8_t *buf, int w, int h) {
+    const size_t pw = (size_t)((w + 1) & ~1), ph = (size_t)((h + 1) & ~1);
+    YuvPlanes p;
+    p.y = buf;
+    p.u = buf + pw * ph;
+    p.v = p.u + (pw / 2) * (ph / 2);
+    return p;
+}
+
+void bgra_to_yuv420(const uint8_t *top, ptrdiff_t stride, int w, int h, const YuvPlanes &out) {
+    convert(top, stride, w, h, out, g_avx2);
+}
+
+void bgra_to_yuv420_scalar(const uint8_t *top, ptrdiff_t stride, int w, int h, const YuvPlanes &out) {
+    convert(top, stride, w, h, out, false);
+}
+
+const char *yuv_simd_path() { return g_avx2 ? "avx2" : "scalar"; }
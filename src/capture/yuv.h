@@ -0,0 +1,38 @@
+/**
+ * @file capture/yuv.h
+ * @brief BGRA to planar YUV 4:2:0 conversion for video recordings
+ *
+ * BT.601 limited range (what encoders assume for yuv420p), chroma from
+ * the average of each 2x2 block. The output is padded to even width and
+ * height with black, since 4:2:0 needs whole chroma blocks. The scalar
+ * and AVX2 paths use the same integer arithmetic and give identical
+ * bytes; the AVX2 one lives in yuv_avx2.cpp (built with AVX2 enabled)
+ * and is chosen at run time when the CPU has it.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// @brief Destination planes, each row-contiguous (Y: padded w x padded h, U/V: half that)
+struct YuvPlanes {
+    uint8_t *y = nullptr;
+    uint8_t *u = nullptr;
+    uint8_t *v = nullptr;
+};
+
+/// @brief Bytes of a padded w x h yuv420p frame
+size_t yuv420_size(int w, int h);
+/// @brief Plane pointers into a contiguous yuv420p buffer of yuv420_size(w, h) bytes
+YuvPlanes yuv420_planes(uint8_t *buf, int w, int h);
+
+/**
+ * @brief Convert a w x h BGRA image
+ * @param top First (top) row; for a bottom-up DIB pass the last row and a negative stride
+ * @param stride Bytes from one row to the next (may be negative)
+ */
+void bgra_to_yuv420(const uint8_t *top, ptrdiff_t stride, int w, int h, const YuvPlanes &out);
+/// @brief Same, forcing the portable path (benchmarks / cross-checks)
+void bgra_to_yuv420_scalar(const uint8_t *top, ptrdiff_t stride, int w, int h, const YuvPlanes &out);
+/// @brief Name of the path bgra_to_yuv420 uses on this CPU ("avx2" or "scalar")
+const char *yuv_simd_path();
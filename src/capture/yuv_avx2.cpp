@@ -0,0 +1,77 @@
+/**
+ * @file capture/yuv_avx2.cpp
+ * @brief AVX2 BGRA to yuv420p, 32 pixels x 2 rows per step
+ *
+ * Built with AVX2 enabled and only called after a CPU check, so it must
+ * not include headers whose inline functions other files also use (they
+ * could be emitted here with AVX2 encodings and picked by the linker).
+ * Arithmetic matches the scalar path in yuv.cpp exactly.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace {
+
+// madd coefficients per BGRA pixel (B, G, R, A) as 16-bit pairs
+inline __m256i coef(short b, short g, short r) { return _mm256_setr_epi16(b, g, r, 0, b, g, r, 0, b, g, r, 0, b, g, r, 0); }
+
+/// Per-pixel dot products of 8 pixels already widened to 16 bit (lo: q0,q1|q4,q5, hi: q2,q3|q6,q7) -> q0..3|q4..7
+inline __m256i dot8(__m256i lo, __m256i hi, __m256i c) {
+    return _mm256_hadd_epi32(_mm256_madd_epi16(lo, c), _mm256_madd_epi16(hi, c));
+}
+
+} // namespace
+
+int bgra_to_yuv420_pair_avx2(const uint8_t *r0, const uint8_t *r1, int w,
+                             uint8_t *y0, uint8_t *y1, uint8_t *u, uint8_t *v) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i cy = coef(25, 129, 66), cu = coef(112, -74, -38), cv = coef(-18, -94, 112);
+    const __m256i ybias = _mm256_set1_epi32(128 + (16 << 8));
+    const __m256i cbias = _mm256_set1_epi32(512 + (128 << 10));
+    // Undo the in-lane interleave of packs/packus: dword order 0,4,1,5,2,6,3,7
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    // Chroma words come out as pairs (c0c1, c4c5, c2c3, c6c7, ...) per lane after the permute
+    const __m256i pairs = _mm256_setr_epi8(0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15,
+                                           0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15);
+    const int n = w & ~31;
+    for (int x = 0; x < n; x += 32) {
+        __m256i ysum[2][4], usum[2], vsum[2];
+        for (int k = 0; k < 4; k += 2) {
+            __m256i pu[2], pv[2];
+            for (int j = 0; j < 2; ++j) {
+                const __m256i a = _mm256_loadu_si256((const __m256i *)(r0 + (size_t)(x + 8 * (k + j)) * 4));
+                const __m256i b = _mm256_loadu_si256((const __m256i *)(r1 + (size_t)(x + 8 * (k + j)) * 4));
+                const __m256i alo = _mm256_unpacklo_epi8(a, zero), ahi = _mm256_unpackhi_epi8(a, zero);
+                const __m256i blo = _mm256_unpacklo_epi8(b, zero), bhi = _mm256_unpackhi_epi8(b, zero);
+                ysum[0][k + j] = _mm256_srai_epi32(_mm256_add_epi32(dot8(alo, ahi, cy), ybias), 8);
+                ysum[1][k + j] = _mm256_srai_epi32(_mm256_add_epi32(dot8(blo, bhi, cy), ybias), 8);
+                // Vertical sums of the two rows, at most 510 per channel
+                const __m256i slo = _mm256_add_epi16(alo, blo), shi = _mm256_add_epi16(ahi, bhi);
+                pu[j] = dot8(slo, shi, cu);
+                pv[j] = dot8(slo, shi, cv);
+            }
+            // Horizontal pair sums: c0,c1,c4,c5 | c2,c3,c6,c7 (relative to this 16-pixel group)
+            usum[k / 2] = _mm256_srai_epi32(_mm256_add_epi32(_mm256_hadd_epi32(pu[0], pu[1]), cbias), 10);
+            vsum[k / 2] = _mm256_srai_epi32(_mm256_add_epi32(_mm256_hadd_epi32(pv[0], pv[1]), cbias), 10);
+        }
+        for (int r = 0; r < 2; ++r) {
+            const __m256i lo = _mm256_packs_epi32(ysum[r][0], ysum[r][1]);
+            const __m256i hi = _mm256_packs_epi32(ysum[r][2], ysum[r][3]);
+            const __m256i ybytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), order);
+            _mm256_storeu_si256((__m256i *)((r ? y1 : y0) + x), ybytes);
+        }
+        const __m256i u16 = _mm256_packs_epi32(usum[0], usum[1]);
+        const __m256i v16 = _mm256_packs_epi32(vsum[0], vsum[1]);
+        __m256i uv = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(u16, v16), order);
+        uv = _mm256_shuffle_epi8(uv, pairs);
+        _mm_storeu_si128((__m128i *)(u + x / 2), _mm256_castsi256_si128(uv));
+        _mm_storeu_si128((__m128i *)(v + x / 2), _mm256_extracti128_si256(uv, 1));
+    }
+    return n;
+}
+
+#endif
@@ -4,132 +4,270 @@
  */
 
 #include "console/game.h"
+#include "console/hires.h"
+#include "console/pt_view.h"
+#include "console/screen.h"
+#include "console/term_writer.h"
 #include "core/game_core.h"
+#include "metrics/game_metrics.h"
+#include "metrics/metrics_server.h"
+#ifndef _WIN32
+#include "ipc/input_ring.h"
+#include "ipc/state_export.h"
+#endif
 #include <chrono>
 #include <thread>
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <iostream>
-#include <cmath>
+#include <cstdio>
+
+static int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 Game::Game(int w, int h, Platform &platform)
 : width(w), height(h), platform(platform) {}
 
+Game::~Game() = default;
+
 void Game::process_input(GameCore &core) {
-    while (platform.kbhit()) {
-        int c = platform.getch();
-        if (c <= 0) break;
-        if (c == 'q' || c == 'Q') { running = false; }
-        if (c == 'w' || c == 'W') { core.move_left_by(-1.5); }
-        if (c == 's' || c == 'S') { core.move_left_by(1.5); }
-    if (c == '1') { core.set_mode(GameMode::Classic); }
-    if (c == '2') { core.set_mode(GameMode::ThreeEnemies); }
-    if (c == '3') { core.set_mode(GameMode::Obstacles); }
-    if (c == '4') { core.set_mode(GameMode::MultiBall); }
-        if (c == 0x1B) { // ESC seq
-            if (!platform.kbhit()) continue;
-            int b1 = platform.getch();
-            if (b1 == '[') {
-                if (!platform.kbhit()) continue;
-                int b2 = platform.getch();
-                if (b2 == 'A') { core.move_right_by(-1.5); }
-                if (b2 == 'B') { core.move_right_by(1.5); }
-            }
-        }
-        if (c == 0 || c == 0xE0) { // Windows arrow prefix
-            if (!platform.kbhit()) continue;
-            int code = platform.getch();
-            if (code == 72) { core.move_right_by(-1.5); }
-            if (code == 80) { core.move_right_by(1.5); }
+    // Events were read and timestamped by the platform's input thread; the
+    // age at this point is how long a key waited for the update that applies it.
+    // Paddle keys become timestamped commands that update() applies at the
+    // substep they happened in; everything else takes effect immediately.
+    const int64_t now = steady_ns();
+    frame_inputs.clear();
+    auto paddle = [&](PaddleSide side, double dy, int64_t t) {
+        PaddleCommand cmd;
+        cmd.sent_ns = t;
+        cmd.side = side;
+        cmd.kind = PaddleCommandKind::MoveBy;
+        cmd.value = dy;
+        frame_inputs.push_back(cmd);
+    };
+    KeyEvent ev;
+    while (platform.next_event(ev)) {
+        input_to_update.add_ns(now - ev.t_ns);
+        switch (ev.key) {
+            case Key::Up: paddle(PaddleSide::Right, -1.5, ev.t_ns); break;
+            case Key::Down: paddle(PaddleSide::Right, 1.5, ev.t_ns); break;
+            case Key::Char:
+                if (ev.mods & (kModCtrl | kModAlt)) break;
+                switch (ev.ch) {
+                    case 'q': case 'Q': running = false; break;
+                    case 'w': case 'W': paddle(PaddleSide::Left, -1.5, ev.t_ns); break;
+                    case 's': case 'S': paddle(PaddleSide::Left, 1.5, ev.t_ns); break;
+                    case '1': core.set_mode(GameMode::Classic); core.mark_input(ev.t_ns); break;
+                    case '2': core.set_mode(GameMode::ThreeEnemies); core.mark_input(ev.t_ns); break;
+                    case '3': core.set_mode(GameMode::Obstacles); core.mark_input(ev.t_ns); break;
+                    case '4': core.set_mode(GameMode::MultiBall); core.mark_input(ev.t_ns); break;
+                    default: break;
+                }
+                break;
+            default: break;
         }
     }
 }
 
-void Game::update(GameCore &core, double dt) { core.update(dt); }
+void Game::update(GameCore &core, double dt, int64_t frame_start_ns) {
+    core.update(dt, frame_inputs.data(), frame_inputs.size(), frame_start_ns);
+}
 
 void Game::render(GameCore &core) {
-    platform.set_cursor_visible(false);
-    std::string out;
-    out.reserve((width + 1) * (height + 1) + 128);
-    out += "\x1b[H"; // cursor home
     const GameState &gs = core.state();
-    int gw = gs.gw, gh = gs.gh;
-    for (int y = 0; y < gh; ++y) {
-        for (int x = 0; x < width; ++x) {
-            char ch = ' ';
-            if (x == width / 2 && (y % 2 == 0)) ch = '|';
-            // draw balls (multi-ball aware)
-            int cx = (int)std::round(gs.ball_x);
-            int cy = (int)std::round(gs.ball_y);
-            int ly0 = (int)std::round(gs.left_y);
-            if (x == 1 && y >= ly0 && y < ly0 + gs.paddle_h) ch = '|';
-            int ry0 = (int)std::round(gs.right_y);
-            if (x == gw - 2 && y >= ry0 && y < ry0 + gs.paddle_h) ch = '|';
-            // obstacles
-            if (gs.mode == GameMode::Obstacles) {
-                for (auto &ob : gs.obstacles) {
-                    int left = (int)std::round(ob.x - ob.w/2.0);
-                    int right = (int)std::round(ob.x + ob.w/2.0);
-                    int top = (int)std::round(ob.y - ob.h/2.0);
-                    int bottom = (int)std::round(ob.y + ob.h/2.0);
-                    if (x >= left && x <= right && y >= top && y <= bottom) ch = '#';
-                }
-            }
-            if (gs.mode == GameMode::ThreeEnemies) {
-                int halfW = gs.paddle_w/2;
-                int top_y = 1; int bottom_y = gh - 2;
-                int top_l = (int)std::round(gs.top_x) - halfW;
-                int top_r = (int)std::round(gs.top_x) + halfW;
-                int bottom_l = (int)std::round(gs.bottom_x) - halfW;
-                int bottom_r = (int)std::round(gs.bottom_x) + halfW;
-                if (y == top_y && x >= top_l && x <= top_r) ch = '=';
-                if (y == bottom_y && x >= bottom_l && x <= bottom_r) ch = '=';
-            }
-            // multi-balls
-            if (!gs.balls.empty()) {
-                for (size_t bi=0; bi<gs.balls.size(); ++bi) {
-                    int bx = (int)std::round(gs.balls[bi].x);
-                    int by = (int)std::round(gs.balls[bi].y);
-                    if (x == bx && y == by) ch = (bi==0?'O':'o');
-                }
-            } else {
-                if (x == cx && y == cy) ch = 'O';
-            }
-            out.push_back(ch);
-        }
-        out.push_back('\n');
-    }
-    const GameState &gs2 = core.state();
-    std::string score = std::to_string(gs2.score_left) + " - " + std::to_string(gs2.score_right);
-    out += score + "\n";
     std::string modeName;
     switch (gs.mode) {
         case GameMode::Classic: modeName = "Classic"; break;
         case GameMode::ThreeEnemies: modeName = "3 Enemies"; break;
         case GameMode::Obstacles: modeName = "Obstacles"; break;
         case GameMode::MultiBall: modeName = "MultiBall"; break;
+        case GameMode::ObstaclesMulti: modeName = "Obstacles+MultiBall"; break;
+    }
+    // Arena rows, then score, mode, controls and output statistics
+    const std::string hud[4] = {
+        std::to_string(gs.score_left) + " - " + std::to_string(gs.score_right),
+        "Mode: " + modeName + " | 1=Classic 2=3Enemies 3=Obstacles 4=MultiBall",
+        "Controls: W/S, Arrow keys (right paddle), Q quit" + latency_line,
+        output_line,
+    };
+    const int rows = gs.gh + 4;
+
+    frame_out.clear();
+    PresentStats ps;
+    if (style == ConsoleStyle::Ascii) {
+        if (frame.width() != width || frame.height() != rows) frame.resize(width, rows);
+        frame.clear();
+        draw_arena(gs, frame);
+        for (int i = 0; i < 4; ++i) frame.text(0, gs.gh + i, hud[i]);
+        ps = presenter.encode(frame, frame_out);
+    } else if (style == ConsoleStyle::PathTrace) {
+        if (!pt) pt.reset(new PathTraceView());
+        if (pt->image().width() != width || pt->image().height() != gs.gh * 2) pt->resize(width, gs.gh);
+        if (color_frame.width() != width || color_frame.height() != rows) color_frame.resize(width, rows);
+        pt->render(gs);
+        window_trace_ms += pt->trace_ms();
+        out_stats.trace_ms += pt->trace_ms();
+        pack_half_blocks(pt->image(), color_frame, gs.gh);
+        for (int i = 0; i < 4; ++i) {
+            for (int x = 0; x < width; ++x) color_frame.at(x, gs.gh + i) = ColorCell{' ', kArenaBackground, kArenaBackground};
+            color_frame.text(0, gs.gh + i, hud[i], kHudText, kArenaBackground);
+        }
+        ps = color_presenter.encode(color_frame, frame_out);
+    } else {
+        const int sx = style_pixels_x(style), sy = style_pixels_y(style);
+        if (pixels.width() != width * sx || pixels.height() != gs.gh * sy) pixels.resize(width * sx, gs.gh * sy);
+        if (color_frame.width() != width || color_frame.height() != rows) color_frame.resize(width, rows);
+        draw_arena_pixels(gs, pixels, sx, sy);
+        if (style == ConsoleStyle::Braille) pack_braille(pixels, kArenaBackground, color_frame, gs.gh);
+        else pack_half_blocks(pixels, color_frame, gs.gh);
+        for (int i = 0; i < 4; ++i) {
+            for (int x = 0; x < width; ++x) color_frame.at(x, gs.gh + i) = ColorCell{' ', kArenaBackground, kArenaBackground};
+            color_frame.text(0, gs.gh + i, hud[i], kHudText, kArenaBackground);
+        }
+        ps = color_presenter.encode(color_frame, frame_out);
+    }
+    // The path tracer hands the frame to the writer thread and starts tracing
+    // the next one while it drains; the other styles write synchronously.
+    // Input-to-photon: from the oldest input this frame reflects (gs.input_ns)
+    // until its bytes have been handed to the terminal.
+    int calls = 0;
+    if (writer) {
+        writer->submit(frame_out, gs.input_ns);
+        calls = (int)writer->take_syscalls();
+    } else if (!frame_out.empty()) {
+        calls = platform.write(frame_out.data(), frame_out.size());
+        if (gs.input_ns) photon.add_ns(steady_ns() - gs.input_ns);
+    }
+    if (ps.full) full_frame_bytes = ps.bytes;
+    out_stats.frames++;
+    out_stats.bytes += ps.bytes;
+    out_stats.syscalls += (uint64_t)calls;
+    window_frames++;
+    window_bytes += ps.bytes;
+    window_syscalls += (uint64_t)calls;
+
+    // Refresh the statistics line about once a second so it does not churn every frame
+    if (window_frames >= 60) {
+        const FramePacerStats fs = pacer.stats();
+        char line[128];
+        int n = std::snprintf(line, sizeof(line), "Out %.0f B/f, %.2f wr/f (full %zu B) | frame p50 %.1f p99 %.1f ms",
+                              (double)window_bytes / (double)window_frames,
+                              (double)window_syscalls / (double)window_frames, full_frame_bytes,
+                              fs.p50_ms, fs.p99_ms);
+        if (style == ConsoleStyle::PathTrace && n > 0 && (size_t)n < sizeof(line))
+            std::snprintf(line + n, sizeof(line) - (size_t)n, " | trace %.1f ms", window_trace_ms / (double)window_frames);
+        output_line = line;
+        if (writer) photon = writer->latency();
+        if (photon.count()) {
+            std::snprintf(line, sizeof(line), " | input->photon p50 %.1f p99 %.1f ms",
+                          photon.percentile_ms(0.5), photon.percentile_ms(0.99));
+            latency_line = line;
+        }
+        window_frames = window_bytes = window_syscalls = 0;
+        window_trace_ms = 0.0;
     }
-    out += "Mode: " + modeName + " | 1=Classic 2=3Enemies 3=Obstacles 4=MultiBall\n";
-    out += "Controls: W/S, Arrow keys (right paddle), Q quit\n";
-    std::cout << out << std::flush;
 }
 
 int Game::run() {
-    using clock = std::chrono::steady_clock;
-    auto last = clock::now();
-    const double target_dt = 1.0/60.0;
-    GameCore core;
-    core.state().gw = width; core.state().gh = height; core.state().paddle_h = paddle_h;
+    ArenaConfig arena; arena.width = width; arena.height = height;
+    GameCore core(arena);
+#ifndef _WIN32
+    StateExporter exporter;
+    if (!export_name.empty()) {
+        std::string err;
+        if (!exporter.open(export_name, err)) std::cerr << "state export disabled: " << err << "\n";
+    }
+    InputRingReader bot_input;
+    if (!input_name.empty()) {
+        std::string err;
+        if (bot_input.create(input_name, err)) {
+            core.set_command_source(&bot_input);
+            core.enable_right_ai(false);
+        } else {
+            std::cerr << "bot input disabled: " << err << "\n";
+        }
+    }
+#endif
+    MetricsRegistry registry;
+    MetricsServer metrics_server(registry);
+    std::unique_ptr<GameMetrics> metrics;
+    if (metrics_port) {
+        std::string err;
+        metrics.reset(new GameMetrics(registry));
+        if (metrics_server.start(metrics_port, err)) {
+            core.set_event_sink(metrics.get());
+        } else {
+            std::cerr << "metrics disabled: " << err << "\n";
+            metrics.reset();
+        }
+    }
+    platform.set_cursor_visible(false);
+    if (style == ConsoleStyle::PathTrace) writer.reset(new TerminalWriter(platform));
+    presenter.invalidate();
+    color_presenter.invalidate();
+    pacer.reset();
     while (running) {
-        auto now = clock::now();
-        std::chrono::duration<double> elapsed = now - last;
-        double dt = elapsed.count();
-        if (dt < target_dt) { std::this_thread::sleep_for(std::chrono::duration<double>(target_dt - dt)); continue; }
-        last = now;
+        const double dt = pacer.wait();
+        // This update simulates the interval that just ended, so inputs read
+        // during it map onto its substeps
+        const int64_t frame_start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            pacer.frame_start().time_since_epoch()).count() - (int64_t)(dt * 1e9);
         process_input(core);
-        update(core, dt);
+        update(core, dt, frame_start_ns);
+#ifndef _WIN32
+        exporter.publish(core.state());
+#endif
         render(core);
+        if (metrics) {
+            metrics->frame(dt, std::chrono::duration<double>(FramePacer::clock::now() - pacer.frame_start()).count(),
+                           pacer.missed_frames());
+            metrics->state(core.state());
+            if (pt && pt->stats()) metrics->render(*pt->stats());
+        }
     }
+    metrics_server.stop();
+    core.set_event_sink(nullptr);
+    double writer_stall_ms = -1.0;
+    if (writer) {
+        writer->flush();
+        writer_stall_ms = writer->stall_ms();
+        photon = writer->latency();
+        out_stats.syscalls += writer->take_syscalls();
+        writer.reset();
+    }
+    // Leave the shell prompt below the last frame rather than inside it
+    std::string below = "\x1b[" + std::to_string(core.state().gh + 5) + ";1H";
+    if (style != ConsoleStyle::Ascii) below += ColorDiffPresenter::reset();
+    platform.write(below.data(), below.size());
     platform.set_cursor_visible(true);
+#ifndef _WIN32
+    core.set_command_source(nullptr);
+#endif
+    if (out_stats.frames) {
+        std::cerr << "console: " << out_stats.frames << " frames, "
+                  << out_stats.bytes / out_stats.frames << " B/frame, "
+                  << (double)out_stats.syscalls / (double)out_stats.frames << " write()/frame";
+        if (writer_stall_ms >= 0.0)
+            std::cerr << ", trace " << out_stats.trace_ms / (double)out_stats.frames << " ms/frame, "
+                      << writer_stall_ms << " ms waiting on the terminal";
+        std::cerr << "\n";
+    }
+    const FramePacerStats fs = pacer.stats();
+    if (fs.frames) {
+        std::fprintf(stderr, "frames: %llu intervals, p50 %.2f ms, p99 %.2f ms, max %.2f ms, %llu missed\n",
+                     (unsigned long long)fs.frames, fs.p50_ms, fs.p99_ms, fs.max_ms, (unsigned long long)fs.missed);
+    }
+    if (input_to_update.count()) {
+        std::fprintf(stderr, "input: %llu keys, input-to-update p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+                     (unsigned long long)input_to_update.count(), input_to_update.percentile_ms(0.5),
+                     input_to_update.percentile_ms(0.99), input_to_update.max_ms());
+    }
+    if (photon.count()) {
+        std::fprintf(stderr, "input-to-photon: %llu frames, p50 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+                     (unsigned long long)photon.count(), photon.percentile_ms(0.5),
+                     photon.percentile_ms(0.99), photon.max_ms());
+    }
     return 0;
 }
@@ -6,17 +6,61 @@
 
 #include "platform/platform.h"
 #include "core/game_core.h"
+#include "core/frame_pacer.h"
+#include "console/hires.h"
+#include "console/screen.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class PathTraceView;
+class TerminalWriter;
 
 class Game {
 public:
     Game(int w, int h, Platform &platform);
+    ~Game();
+    /// @brief Publish every tick to the named shared-memory segment (POSIX; empty = off)
+    void set_state_export(const std::string &name) { export_name = name; }
+    /// @brief Drive the right paddle from the named bot input ring (POSIX; empty = off)
+    void set_bot_input(const std::string &name) { input_name = name; }
+    /// @brief Select ASCII, half-block, braille or path-traced output (all but ASCII need UTF-8 + truecolor)
+    void set_style(ConsoleStyle s) { style = s; }
+    /// @brief Serve metrics on 127.0.0.1:@p port while running (0 = off)
+    void set_metrics_port(uint16_t port) { metrics_port = port; }
     int run();
 private:
-    void update(GameCore &core, double dt);
+    void update(GameCore &core, double dt, int64_t frame_start_ns);
     void render(GameCore &core);
     void process_input(GameCore &core);
     int width, height;
     Platform &platform;
-    int paddle_h = 5;
     bool running = true;
+    std::string export_name;
+    std::string input_name;
+    uint16_t metrics_port = 0;
+
+    ScreenBuffer frame;          ///< Frame being rasterized
+    DiffPresenter presenter;     ///< Last presented frame + diff encoder
+    ConsoleStyle style = ConsoleStyle::Ascii;
+    PixelBuffer pixels;          ///< Sub-cell image (half-block / braille styles)
+    ColorScreen color_frame;     ///< Packed colour cells (half-block / braille styles)
+    ColorDiffPresenter color_presenter;
+    std::unique_ptr<PathTraceView> pt;      ///< Path tracer (PathTrace style)
+    std::unique_ptr<TerminalWriter> writer; ///< Writes frames while the next one is traced (PathTrace style)
+    std::string frame_out;       ///< Reused terminal output buffer
+    size_t full_frame_bytes = 0; ///< Size of the last full redraw, for comparison
+    struct {
+        uint64_t frames = 0, bytes = 0, syscalls = 0;
+        double trace_ms = 0.0;
+    } out_stats;                 ///< Totals, reported on exit
+    uint64_t window_frames = 0, window_bytes = 0, window_syscalls = 0;
+    double window_trace_ms = 0.0;
+    std::string output_line;     ///< HUD statistics line (refreshed ~1/s)
+    FramePacer pacer{60.0};      ///< 60 Hz frame deadlines + frame-time histogram
+    TimeHistogram input_to_update; ///< Key read -> start of the update that applies it
+    TimeHistogram photon;          ///< Oldest input a frame reflects -> frame written to the terminal
+    std::string latency_line;      ///< HUD input-to-photon summary (refreshed with output_line)
+    std::vector<PaddleCommand> frame_inputs; ///< Paddle keys read this frame, in arrival order
 };
@@ -0,0 +1,126 @@
+/**
+ * @file console/headless.cpp
+ * @brief Implementation of the terminal-free game loop
+ */
+
+#include "console/headless.h"
+#ifndef _WIN32
+#include "ipc/input_ring.h"
+#include "ipc/state_export.h"
+#include "core/state_stream.h"
+#include "core/time_histogram.h"
+#include "metrics/game_metrics.h"
+#include "metrics/metrics_server.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+static std::atomic<bool> g_headless_stop{false};
+
+static void headless_signal(int) { g_headless_stop.store(true); }
+
+int run_headless(const HeadlessConfig &cfg) {
+    using clock = std::chrono::steady_clock;
+    const int hz = cfg.hz > 0 ? cfg.hz : 1000;
+    const double dt = 1.0 / hz;
+    const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(dt));
+
+    GameCore core;
+    core.set_mode(cfg.mode);
+    core.enable_left_ai(true);
+
+    StateExporter exporter;
+    InputRingReader input;
+    std::string err;
+    if (!cfg.export_name.empty() && !exporter.open(cfg.export_name, err)) {
+        std::cerr << "state export: " << err << "\n";
+        return 1;
+    }
+    if (!cfg.input_name.empty()) {
+        if (!input.create(cfg.input_name, err)) {
+            std::cerr << "bot input: " << err << "\n";
+            return 1;
+        }
+        core.set_command_source(&input);
+        core.enable_right_ai(false);
+    }
+    StateStreamWriter recording;
+    const int record_fps = std::max(1, std::min(cfg.record_fps, hz));
+    if (!cfg.record_path.empty() && !recording.open(cfg.record_path, record_fps, err)) {
+        std::cerr << "record state: " << err << "\n";
+        return 1;
+    }
+
+    MetricsRegistry registry;
+    MetricsServer metrics_server(registry);
+    std::unique_ptr<GameMetrics> metrics;
+    if (cfg.metrics_port) {
+        metrics.reset(new GameMetrics(registry));
+        if (!metrics_server.start(cfg.metrics_port, err)) {
+            std::cerr << err << "\n";
+            return 1;
+        }
+        core.set_event_sink(metrics.get());
+    }
+
+    std::signal(SIGINT, headless_signal);
+    std::signal(SIGTERM, headless_signal);
+    std::cerr << "headless: " << hz << " Hz"
+              << (exporter.is_open() ? ", exporting " + cfg.export_name : std::string())
+              << (input.is_open() ? ", bot input " + cfg.input_name : std::string())
+              << (recording.is_open() ? ", recording " + cfg.record_path + " at " + std::to_string(record_fps) + " fps" : std::string())
+              << (metrics ? ", metrics on http://127.0.0.1:" + std::to_string(metrics_server.port()) + "/metrics" : std::string())
+              << "\n";
+
+    const auto start = clock::now();
+    auto next = start;
+    auto prev_tick = start;
+    uint64_t ticks = 0, late = 0;
+    // Headless "photon": the published state that first reflects a bot command
+    TimeHistogram input_to_publish;
+    while (!g_headless_stop.load(std::memory_order_relaxed)) {
+        const auto tick_start = clock::now();
+        core.update(dt);
+        exporter.publish(core.state());
+        // Sample the tick that crosses each recording frame boundary
+        if (recording.is_open() && (ticks + 1) * (uint64_t)record_fps / (uint64_t)hz != ticks * (uint64_t)record_fps / (uint64_t)hz)
+            recording.write(core.state());
+        if (core.state().input_ns) {
+            input_to_publish.add_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock::now().time_since_epoch()).count() - core.state().input_ns);
+        }
+        ++ticks;
+        next += period;
+        const auto now = clock::now();
+        if (metrics) {
+            metrics->frame(ticks > 1 ? std::chrono::duration<double>(tick_start - prev_tick).count() : dt,
+                           std::chrono::duration<double>(now - tick_start).count(), late);
+            metrics->state(core.state());
+            prev_tick = tick_start;
+        }
+        if (cfg.seconds > 0.0 && now - start >= std::chrono::duration<double>(cfg.seconds)) break;
+        if (now > next) { ++late; next = now; continue; }
+        std::this_thread::sleep_until(next);
+    }
+    metrics_server.stop();
+    core.set_event_sink(nullptr);
+    const GameState &gs = core.state();
+    std::cerr << "headless: " << ticks << " ticks (" << late << " late), score "
+              << gs.score_left << " - " << gs.score_right
+              << ", last bot command " << gs.last_command_id << "\n";
+    if (recording.is_open())
+        std::cerr << "headless: " << recording.frames() << " frames recorded to " << cfg.record_path << "\n";
+    if (input_to_publish.count()) {
+        std::fprintf(stderr, "headless: input-to-publish %llu ticks, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+                     (unsigned long long)input_to_publish.count(), input_to_publish.percentile_ms(0.5),
+                     input_to_publish.percentile_ms(0.99), input_to_publish.max_ms());
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,28 @@
+/**
+ * @file console/headless.h
+ * @brief Terminal-free game loop for bots and external tools (POSIX)
+ *
+ * Runs GameCore at a fixed tick rate without a Platform, exporting state
+ * to shared memory and/or taking right-paddle commands from the bot input
+ * ring, and optionally recording a GameState stream (core/state_stream.h)
+ * for offline re-rendering. The left paddle is played by the built-in AI.
+ */
+#pragma once
+
+#include "core/game_core.h"
+#include <cstdint>
+#include <string>
+
+struct HeadlessConfig {
+    int hz = 1000;                      ///< Ticks per second (fixed dt = 1/hz)
+    double seconds = 0.0;               ///< Run time (0 = until SIGINT/SIGTERM)
+    GameMode mode = GameMode::Classic;
+    std::string export_name;            ///< State segment (empty = no export)
+    std::string input_name;             ///< Bot input ring (empty = right AI plays)
+    std::string record_path;            ///< GameState stream for pong_rerender (empty = none)
+    int record_fps = 60;                ///< Frames per second sampled into the stream
+    uint16_t metrics_port = 0;          ///< Serve metrics on 127.0.0.1 (0 = off)
+};
+
+/// @brief Run until the configured time elapsed or a signal arrived; returns the exit code
+int run_headless(const HeadlessConfig &cfg);
@@ -0,0 +1,242 @@
+/**
+ * @file console/hires.cpp
+ * @brief Pixel rasterizer, half-block / braille packing and colour diff encoder
+ */
+
+#include "console/hires.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+void PixelBuffer::resize(int nw, int nh) {
+    w = std::max(nw, 0);
+    h = std::max(nh, 0);
+    stride = ((size_t)w + 7) & ~(size_t)7;
+    px.assign(stride * (size_t)h, 0);
+}
+
+void PixelBuffer::clear(Rgb c) { std::fill(px.begin(), px.end(), c); }
+
+void PixelBuffer::fill_rect(int x0, int y0, int x1, int y1, Rgb c) {
+    x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+    x1 = std::min(x1, w); y1 = std::min(y1, h);
+    for (int y = y0; y < y1; ++y) std::fill(row(y) + x0, row(y) + std::max(x0, x1), c);
+}
+
+void PixelBuffer::fill_ellipse(double x0, double y0, double x1, double y1, Rgb c) {
+    const double cx = (x0 + x1) * 0.5, cy = (y0 + y1) * 0.5;
+    const double rx = std::max((x1 - x0) * 0.5, 0.5), ry = std::max((y1 - y0) * 0.5, 0.5);
+    const int py0 = std::max((int)std::floor(cy - ry), 0), py1 = std::min((int)std::ceil(cy + ry), h);
+    const int px0 = std::max((int)std::floor(cx - rx), 0), px1 = std::min((int)std::ceil(cx + rx), w);
+    bool any = false;
+    for (int y = py0; y < py1; ++y) {
+        const double dy = (y + 0.5 - cy) / ry;
+        for (int x = px0; x < px1; ++x) {
+            const double dx = (x + 0.5 - cx) / rx;
+            if (dx * dx + dy * dy <= 1.0) { row(y)[x] = c; any = true; }
+        }
+    }
+    // Never let a small shape vanish between pixel centres
+    const int nx = (int)std::floor(cx), ny = (int)std::floor(cy);
+    if (!any && nx >= 0 && ny >= 0 && nx < w && ny < h) row(ny)[nx] = c;
+}
+
+void ColorScreen::resize(int nw, int nh) {
+    w = std::max(nw, 0);
+    h = std::max(nh, 0);
+    cells.assign((size_t)w * (size_t)h, ColorCell{});
+}
+
+void ColorScreen::clear(Rgb bg) { std::fill(cells.begin(), cells.end(), ColorCell{' ', bg, bg}); }
+
+void ColorScreen::text(int x, int y, const std::string &s, Rgb fg, Rgb bg) {
+    if (y < 0 || y >= h) return;
+    for (size_t i = 0; i < s.size(); ++i) {
+        const int cx = x + (int)i;
+        if (cx < 0 || cx >= w) continue;
+        at(cx, y) = s[i] == ' ' ? ColorCell{' ', bg, bg} : ColorCell{(uint32_t)(unsigned char)s[i], fg, bg};
+    }
+}
+
+int style_pixels_x(ConsoleStyle style) { return style == ConsoleStyle::Braille ? 2 : 1; }
+int style_pixels_y(ConsoleStyle style) {
+    return style == ConsoleStyle::Braille ? 4 : style == ConsoleStyle::Ascii ? 1 : 2;
+}
+
+void draw_arena_pixels(const GameState &gs, PixelBuffer &pb, int sx, int sy) {
+    const int gw = gs.gw, gh = gs.gh;
+    // Game-unit rectangle to pixels; at least one pixel in each direction
+    auto rect = [&](double x0, double y0, double x1, double y1, Rgb c) {
+        int px0 = (int)std::lround(x0 * sx), py0 = (int)std::lround(y0 * sy);
+        int px1 = std::max((int)std::lround(x1 * sx), px0 + 1);
+        int py1 = std::max((int)std::lround(y1 * sy), py0 + 1);
+        pb.fill_rect(px0, py0, px1, py1, c);
+    };
+    pb.clear(kArenaBackground);
+    const int mid = pb.width() / 2;
+    for (int y = 0; y < gh; y += 2) pb.fill_rect(mid, y * sy, mid + 1, (y + 1) * sy, 0x3A3A50);
+
+    rect(1, gs.left_y, 2, gs.left_y + gs.paddle_h, 0x40C0FF);
+    rect(gw - 2, gs.right_y, gw - 1, gs.right_y + gs.paddle_h, 0xFF9040);
+
+    if (gs.mode == GameMode::Obstacles) {
+        const Archetype &obs = gs.entities.obstacles();
+        for (size_t i = 0; i < obs.size(); ++i) {
+            const Position &op = obs.position[i]; const Shape &os = obs.shape[i];
+            rect(op.x - os.w/2.0, op.y - os.h/2.0, op.x + os.w/2.0, op.y + os.h/2.0, 0x6070A0);
+        }
+    }
+    gs.entities.each(Component::Position, [&](const Archetype &a) {
+        if (a.kind() != EntityKind::BlackHole && a.kind() != EntityKind::Custom) return;
+        const bool hole = a.kind() == EntityKind::BlackHole;
+        for (size_t i = 0; i < a.size(); ++i) {
+            const double r = hole && a.has(Component::Shape) ? a.shape[i].radius() : 0.5;
+            const double x = a.position[i].x, y = a.position[i].y;
+            pb.fill_ellipse((x - r) * sx, (y - r) * sy, (x + r) * sx, (y + r) * sy, hole ? 0x8040C0 : 0xA0A0A0);
+        }
+    });
+    if (gs.mode == GameMode::ThreeEnemies) {
+        const double halfW = gs.paddle_w / 2.0;
+        rect(gs.top_x - halfW, 1, gs.top_x + halfW, 2, 0x60E060);
+        rect(gs.bottom_x - halfW, gh - 2, gs.bottom_x + halfW, gh - 1, 0x60E060);
+    }
+    const Archetype &balls = gs.entities.balls();
+    auto ball = [&](double x, double y, double r, Rgb c) {
+        pb.fill_ellipse((x - r) * sx, (y - r) * sy, (x + r) * sx, (y + r) * sy, c);
+    };
+    if (!balls.empty()) {
+        for (size_t bi = 0; bi < balls.size(); ++bi) {
+            const double r = balls.shape[bi].w > 0.0 ? balls.shape[bi].radius() : 0.5;
+            ball(balls.position[bi].x, balls.position[bi].y, r, bi == 0 ? 0xFFFFFF : 0xFFD040);
+        }
+    } else {
+        ball(gs.ball_x, gs.ball_y, 0.5, 0xFFFFFF);
+    }
+}
+
+void pack_half_blocks(const PixelBuffer &pb, ColorScreen &out, int rows) {
+    const int w = std::min(out.width(), pb.width());
+    rows = std::min(rows, out.height());
+    for (int y = 0; y < rows && 2 * y < pb.height(); ++y) {
+        const Rgb *top = pb.row(2 * y);
+        const Rgb *bot = 2 * y + 1 < pb.height() ? pb.row(2 * y + 1) : top;
+        ColorCell *dst = out.row(y);
+        // Branch-free: equal halves become a blank with fg == bg, as ColorScreen expects
+        for (int x = 0; x < w; ++x) {
+            const Rgb t = top[x], b = bot[x];
+            dst[x].glyph = t == b ? 0x20u : 0x2580u;
+            dst[x].fg = t;
+            dst[x].bg = b;
+        }
+    }
+}
+
+static inline unsigned luma(Rgb c) {
+    return ((c >> 16) & 0xFF) * 2 + ((c >> 8) & 0xFF) * 5 + (c & 0xFF);
+}
+
+void pack_braille(const PixelBuffer &pb, Rgb bg, ColorScreen &out, int rows) {
+    // Dot bit for (dx, dy) within the 2x4 cell, per the Unicode braille layout
+    static const uint8_t kDot[4][2] = { {0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80} };
+    const int w = std::min(out.width(), pb.width() / 2);
+    rows = std::min(rows, out.height());
+    for (int y = 0; y < rows && 4 * y + 3 < pb.height(); ++y) {
+        const Rgb *r[4] = { pb.row(4*y), pb.row(4*y + 1), pb.row(4*y + 2), pb.row(4*y + 3) };
+        ColorCell *dst = out.row(y);
+        for (int x = 0; x < w; ++x) {
+            unsigned bits = 0, best = 0;
+            Rgb fg = bg;
+            for (int dy = 0; dy < 4; ++dy) {
+                for (int dx = 0; dx < 2; ++dx) {
+                    const Rgb p = r[dy][2*x + dx];
+                    if (p == bg) continue;
+                    bits |= kDot[dy][dx];
+                    const unsigned l = luma(p) + 1;
+                    if (l > best) { best = l; fg = p; }
+                }
+            }
+            dst[x] = bits ? ColorCell{0x2800u + bits, fg, bg} : ColorCell{' ', bg, bg};
+        }
+    }
+}
+
+static void append_utf8(std::string &out, uint32_t cp) {
+    if (cp < 0x80) { out.push_back((char)cp); return; }
+    if (cp < 0x800) {
+        out.push_back((char)(0xC0 | (cp >> 6)));
+    } else {
+        out.push_back((char)(0xE0 | (cp >> 12)));
+        out.push_back((char)(0x80 | ((cp >> 6) & 0x3F)));
+    }
+    out.push_back((char)(0x80 | (cp & 0x3F)));
+}
+
+void ColorDiffPresenter::emit(const ColorCell &c, std::string &out) {
+    const bool need_bg = !bg_known || cur_bg != c.bg;
+    const bool need_fg = c.glyph != ' ' && (!fg_known || cur_fg != c.fg);
+    if (need_fg || need_bg) {
+        char buf[48];
+        int n = 0;
+        if (need_fg && need_bg) {
+            n = std::snprintf(buf, sizeof(buf), "\x1b[38;2;%u;%u;%u;48;2;%u;%u;%um",
+                              (c.fg >> 16) & 0xFF, (c.fg >> 8) & 0xFF, c.fg & 0xFF,
+                              (c.bg >> 16) & 0xFF, (c.bg >> 8) & 0xFF, c.bg & 0xFF);
+        } else if (need_fg) {
+            n = std::snprintf(buf, sizeof(buf), "\x1b[38;2;%u;%u;%um",
+                              (c.fg >> 16) & 0xFF, (c.fg >> 8) & 0xFF, c.fg & 0xFF);
+        } else {
+            n = std::snprintf(buf, sizeof(buf), "\x1b[48;2;%u;%u;%um",
+                              (c.bg >> 16) & 0xFF, (c.bg >> 8) & 0xFF, c.bg & 0xFF);
+        }
+        out.append(buf, (size_t)n);
+        if (need_fg) { cur_fg = c.fg; fg_known = true; }
+        if (need_bg) { cur_bg = c.bg; bg_known = true; }
+    }
+    append_utf8(out, c.glyph);
+}
+
+PresentStats ColorDiffPresenter::encode(const ColorScreen &next, std::string &out) {
+    PresentStats st;
+    const size_t start = out.size();
+    const int w = next.width(), h = next.height();
+    char buf[32];
+
+    if (!valid || front.width() != w || front.height() != h) {
+        out += "\x1b[0m\x1b[H\x1b[2J";
+        fg_known = bg_known = false;
+        for (int y = 0; y < h; ++y) {
+            if (y) out += "\r\n";
+            const ColorCell *b = next.row(y);
+            for (int x = 0; x < w; ++x) emit(b[x], out);
+        }
+        st.full = true;
+        st.changed = (size_t)w * (size_t)h;
+    } else {
+        int cx = -1, cy = -1;
+        for (int y = 0; y < h; ++y) {
+            const ColorCell *a = front.row(y);
+            const ColorCell *b = next.row(y);
+            if (std::memcmp(a, b, sizeof(ColorCell) * (size_t)w) == 0) continue;
+            int x = 0;
+            while (x < w) {
+                if (a[x] == b[x]) { ++x; continue; }
+                int n;
+                if (cy == y && cx >= 0 && cx < x) n = std::snprintf(buf, sizeof(buf), "\x1b[%dC", x - cx);
+                else if (cy == y && cx == x) n = 0;
+                else n = std::snprintf(buf, sizeof(buf), "\x1b[%d;%dH", y + 1, x + 1);
+                out.append(buf, (size_t)n);
+                int e = x;
+                while (e < w && a[e] != b[e]) emit(b[e++], out);
+                st.changed += (size_t)(e - x);
+                cy = y;
+                cx = e < w ? e : -1;
+                x = e;
+            }
+        }
+    }
+    front = next;
+    valid = true;
+    st.bytes = out.size() - start;
+    return st;
+}
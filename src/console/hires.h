@@ -0,0 +1,133 @@
+/**
+ * @file console/hires.h
+ * @brief Sub-cell console rendering with half-block / braille glyphs and 24-bit colour
+ *
+ * The arena is drawn into a PixelBuffer at a multiple of the cell grid
+ * (1x2 pixels per cell for half blocks, 2x4 for braille), packed into a
+ * ColorScreen of (glyph, fg, bg) cells and sent through
+ * ColorDiffPresenter, which like DiffPresenter only emits cells that
+ * changed. Colour escapes are only written when the attribute differs
+ * from what the terminal already has, so the bytes per frame depend on
+ * how much moved, not on the sub-pixel resolution.
+ */
+#pragma once
+
+#include "console/screen.h"
+#include "core/game_core.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Console rendering style
+enum class ConsoleStyle {
+    Ascii,      ///< One character per game unit (ScreenBuffer / DiffPresenter)
+    HalfBlock,  ///< U+2580 with fg/bg colours: 1x2 pixels per cell
+    Braille,    ///< U+2800..U+28FF dots: 2x4 pixels per cell, one colour per cell
+    PathTrace   ///< Path-traced image shown as half blocks (console/pt_view.h)
+};
+
+/// @brief Packed 0x00RRGGBB colour
+using Rgb = uint32_t;
+
+/**
+ * @brief Offscreen RGB image
+ *
+ * Rows are contiguous with the stride padded to a multiple of 8 pixels
+ * so clears and packing loops run over whole vectors without tails.
+ */
+class PixelBuffer {
+public:
+    void resize(int w, int h);
+    void clear(Rgb c);
+    int width() const { return w; }
+    int height() const { return h; }
+    Rgb *row(int y) { return px.data() + (size_t)y * stride; }
+    const Rgb *row(int y) const { return px.data() + (size_t)y * stride; }
+    /// @brief Fill pixels [x0,x1) x [y0,y1), clipped
+    void fill_rect(int x0, int y0, int x1, int y1, Rgb c);
+    /// @brief Fill the pixels whose centres fall inside the ellipse bounded by [x0,x1) x [y0,y1)
+    void fill_ellipse(double x0, double y0, double x1, double y1, Rgb c);
+
+private:
+    int w = 0, h = 0;
+    size_t stride = 0;
+    std::vector<Rgb> px;
+};
+
+/// @brief One terminal cell: Unicode code point and colours
+struct ColorCell {
+    uint32_t glyph = ' ';
+    Rgb fg = 0;
+    Rgb bg = 0;
+    bool operator==(const ColorCell &o) const { return glyph == o.glyph && fg == o.fg && bg == o.bg; }
+    bool operator!=(const ColorCell &o) const { return !(*this == o); }
+};
+
+/**
+ * @brief Grid of ColorCells (the terminal-side frame)
+ *
+ * Cells showing a blank keep fg == bg so equal-looking cells compare equal.
+ */
+class ColorScreen {
+public:
+    void resize(int w, int h);
+    void clear(Rgb bg);
+    int width() const { return w; }
+    int height() const { return h; }
+    ColorCell &at(int x, int y) { return cells[(size_t)y * (size_t)w + (size_t)x]; }
+    const ColorCell &at(int x, int y) const { return cells[(size_t)y * (size_t)w + (size_t)x]; }
+    ColorCell *row(int y) { return cells.data() + (size_t)y * (size_t)w; }
+    const ColorCell *row(int y) const { return cells.data() + (size_t)y * (size_t)w; }
+    /// @brief Write ASCII text starting at (x, y), clipped at the right edge
+    void text(int x, int y, const std::string &s, Rgb fg, Rgb bg);
+
+private:
+    int w = 0, h = 0;
+    std::vector<ColorCell> cells;
+};
+
+/// @brief Arena colours used by draw_arena_pixels (also the HUD background)
+constexpr Rgb kArenaBackground = 0x0C0C14;
+constexpr Rgb kHudText = 0xC8C8C8;
+
+/// @brief Pixels per cell horizontally / vertically for @p style
+int style_pixels_x(ConsoleStyle style);
+int style_pixels_y(ConsoleStyle style);
+
+/**
+ * @brief Draw the arena with @p sx x @p sy pixels per game unit
+ *
+ * Same content and stacking order as draw_arena, with shapes at their
+ * real (fractional) sizes and positions.
+ */
+void draw_arena_pixels(const GameState &gs, PixelBuffer &pb, int sx, int sy);
+
+/// @brief Pack pixel rows 2y, 2y+1 into cell row y (first @p rows rows of @p out)
+void pack_half_blocks(const PixelBuffer &pb, ColorScreen &out, int rows);
+
+/// @brief Pack 2x4 pixel blocks into braille cells; pixels equal to @p bg are unlit
+void pack_braille(const PixelBuffer &pb, Rgb bg, ColorScreen &out, int rows);
+
+/**
+ * @brief Diff encoder for ColorScreen frames
+ *
+ * Tracks the terminal's cursor and current SGR colours across cells and
+ * frames; emits UTF-8 glyphs with 24-bit SGR only where needed.
+ */
+class ColorDiffPresenter {
+public:
+    /// @brief Append the bytes for @p next to @p out; @p next becomes the reference frame
+    PresentStats encode(const ColorScreen &next, std::string &out);
+    /// @brief Force a full redraw (and colour re-sync) on the next encode
+    void invalidate() { valid = false; }
+    /// @brief Bytes that restore default attributes (append on exit)
+    static const char *reset() { return "\x1b[0m"; }
+
+private:
+    void emit(const ColorCell &c, std::string &out);
+    ColorScreen front;
+    bool valid = false;
+    Rgb cur_fg = 0, cur_bg = 0;
+    bool fg_known = false, bg_known = false;
+};
@@ -1,19 +1,100 @@
 /**
  * @file console/main.cpp
  * @brief Entry point for the console version of PongCpp (moved to src/console)
+ *
+ * Options:
+ *   --export-state [NAME]   publish each tick to shared memory (POSIX, default /pong_state)
+ *   --bot-input [NAME]      right paddle driven by a bot through the input ring (POSIX, default /pong_input)
+ *   --headless              no terminal: fixed-rate loop for bots and tools (POSIX)
+ *   --hz N --seconds N      headless tick rate (default 1000) and run time (default: until Ctrl-C)
+ *   --record-state FILE     headless: record the GameState stream for pong_rerender
+ *   --record-fps N          frames per second sampled into that stream (default 60)
+ *   --metrics [PORT]        serve Prometheus metrics on http://127.0.0.1:PORT/metrics (default 9464)
+ *   --render STYLE          ascii (default), half (half blocks, 1x2) or braille (2x4); colour styles need UTF-8 + truecolor
+ *                           pt: path-traced arena as half blocks (x86 builds)
  */
 
 #include "platform/platform.h"
 #include "console/game.h"
+#include "console/headless.h"
+#include "ipc/input_ring.h"
+#include "ipc/state_shm.h"
+#include "metrics/metrics_server.h"
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <iostream>
 
-int main() {
+int main(int argc, char **argv) {
+    std::string export_name, input_name;
+    bool headless = false;
+    HeadlessConfig hcfg;
+    ConsoleStyle style = ConsoleStyle::Ascii;
+    uint16_t metrics_port = 0;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc && argv[i+1][0] != '-';
+        if (std::strcmp(argv[i], "--export-state") == 0) {
+            export_name = (has_value && argv[i+1][0] == '/') ? argv[++i] : kStateShmDefaultName;
+        } else if (std::strcmp(argv[i], "--bot-input") == 0) {
+            input_name = (has_value && argv[i+1][0] == '/') ? argv[++i] : kInputRingDefaultName;
+        } else if (std::strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (std::strcmp(argv[i], "--hz") == 0 && has_value) {
+            hcfg.hz = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && has_value) {
+            hcfg.seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--record-state") == 0 && has_value) {
+            hcfg.record_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--record-fps") == 0 && has_value) {
+            hcfg.record_fps = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--metrics") == 0) {
+            const int port = has_value ? std::atoi(argv[++i]) : kMetricsDefaultPort;
+            if (port <= 0 || port > 65535) { std::cerr << "--metrics: port must be 1..65535\n"; return 2; }
+            metrics_port = (uint16_t)port;
+        } else if (std::strcmp(argv[i], "--render") == 0 && has_value) {
+            const char *v = argv[++i];
+            if (std::strcmp(v, "half") == 0) style = ConsoleStyle::HalfBlock;
+            else if (std::strcmp(v, "braille") == 0) style = ConsoleStyle::Braille;
+            else if (std::strcmp(v, "ascii") == 0) style = ConsoleStyle::Ascii;
+            else if (std::strcmp(v, "pt") == 0) {
+#ifdef PONG_CONSOLE_PATH_TRACER
+                style = ConsoleStyle::PathTrace;
+#else
+                std::cerr << "--render pt: this build has no path tracer (x86 only)\n";
+                return 2;
+#endif
+            }
+            else { std::cerr << "unknown --render style '" << v << "' (ascii, half, braille, pt)\n"; return 2; }
+        }
+    }
+
+#ifndef _WIN32
+    if (!headless && !hcfg.record_path.empty()) {
+        std::cerr << "--record-state needs --headless\n";
+        return 2;
+    }
+    if (headless) {
+        hcfg.export_name = export_name;
+        hcfg.input_name = input_name;
+        hcfg.metrics_port = metrics_port;
+        return run_headless(hcfg);
+    }
+#else
+    if (headless || !export_name.empty() || !input_name.empty() || !hcfg.record_path.empty()) {
+        std::cerr << "--headless, --export-state, --bot-input and --record-state need a POSIX system\n";
+        return 2;
+    }
+#endif
+
     auto plat = createPlatform();
     if (!plat) {
         std::cerr << "Failed to create platform abstraction\n";
         return 1;
     }
     Game g(80, 24, *plat);
+    g.set_state_export(export_name);
+    g.set_bot_input(input_name);
+    g.set_style(style);
+    g.set_metrics_port(metrics_port);
     return g.run();
 }
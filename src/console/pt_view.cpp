@@ -0,0 +1,85 @@
+/**
+ * @file console/pt_view.cpp
+ * @brief Path-traced console view: SoftRenderer + ordered-dither quantization
+ */
+
+#include "console/pt_view.h"
+#ifdef PONG_CONSOLE_PATH_TRACER
+#include "render/soft_renderer.h"
+#include <algorithm>
+
+PathTraceView::PathTraceView() : sr(new SoftRenderer()) {
+    // Terminal preset: a few samples per pixel, fast-moving history (cells are
+    // large, so ghosting is more visible than noise) and lit paddles so they
+    // read at this resolution.
+    SRConfig cfg;
+    cfg.forceFullPixelRays = true;
+    cfg.raysPerFrame = 2;
+    cfg.maxBounces = 3;
+    cfg.internalScalePct = 100;
+    cfg.accumAlpha = 0.5f;
+    cfg.denoiseStrength = 0.6f;
+    cfg.emissiveIntensity = 4.0f;
+    cfg.paddleEmissiveIntensity = 0.6f;
+    sr->configure(cfg);
+}
+
+PathTraceView::~PathTraceView() = default;
+
+void PathTraceView::resize(int cols, int rows) {
+    sr->resize(cols, rows * 2);
+    sr->resetHistory();
+    img.resize(cols, rows * 2);
+}
+
+double PathTraceView::trace_ms() const { return sr->stats().msTotal; }
+const SRStats *PathTraceView::stats() const { return &sr->stats(); }
+
+void PathTraceView::render(const GameState &gs) {
+    sr->render(gs);
+    static const int kBayer4[4][4] = { {0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5} };
+    const int w = std::min(sr->width(), img.width()), h = std::min(sr->height(), img.height());
+    const uint32_t *src = sr->pixels();
+    // Quantize each channel to `levels` steps; the threshold offset per pixel
+    // comes from the Bayer matrix so gradients dither instead of banding. A
+    // channel keeps last frame's level while the new sample stays within one
+    // step of it, so sample noise in dark, flat areas does not toggle cells
+    // between neighbouring levels every frame.
+    const int step = 255 * 16 / (levels - 1);          // step size in 1/16 units
+    const int keep = step;
+    for (int y = 0; y < h; ++y) {
+        const uint32_t *s = src + (size_t)y * (size_t)sr->width();
+        Rgb *d = img.row(y);
+        for (int x = 0; x < w; ++x) {
+            const int t = kBayer4[y & 3][x & 3] * step / 16 - step / 2;   // in 1/16 units
+            Rgb out = 0;
+            for (int shift = 16; shift >= 0; shift -= 8) {
+                const int raw = (int)((s[x] >> shift) & 0xFF) * 16;
+                const int prev = (int)((d[x] >> shift) & 0xFF) * 16;
+                int v;
+                if (raw - prev < keep && prev - raw < keep) {
+                    v = prev / 16;
+                } else {
+                    int q = (raw + t + step / 2) / step;
+                    q = std::max(0, std::min(q, levels - 1));
+                    v = q * 255 / (levels - 1);
+                }
+                out |= (Rgb)v << shift;
+            }
+            d[x] = out;
+        }
+    }
+}
+
+#else
+
+class SoftRenderer {};   // never instantiated; completes the type for unique_ptr
+
+PathTraceView::PathTraceView() = default;
+PathTraceView::~PathTraceView() = default;
+void PathTraceView::resize(int cols, int rows) { img.resize(cols, rows * 2); }
+void PathTraceView::render(const GameState &) { img.clear(0); }
+double PathTraceView::trace_ms() const { return 0.0; }
+const SRStats *PathTraceView::stats() const { return nullptr; }
+
+#endif
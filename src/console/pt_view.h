@@ -0,0 +1,45 @@
+/**
+ * @file console/pt_view.h
+ * @brief Path-traced arena for the console frontend ('pong --render pt')
+ *
+ * Runs the shared SoftRenderer at the terminal's half-block resolution
+ * (one pixel per column, two per row), then quantizes its output with a
+ * 4x4 ordered dither to a fixed number of levels per channel. The
+ * tracer's sample noise mostly stays inside one quantization step, so
+ * still parts of the image keep the same cell colour from frame to frame
+ * and the colour diff only has to send what actually moved.
+ *
+ * Only built where the renderer's SSE paths compile (PONG_CONSOLE_PATH_TRACER).
+ */
+#pragma once
+
+#include "console/hires.h"
+#include "core/game_core.h"
+#include <memory>
+
+class SoftRenderer;
+struct SRStats;
+
+class PathTraceView {
+public:
+    PathTraceView();
+    ~PathTraceView();
+
+    /// @brief Size the trace to @p cols x (2 * @p rows) pixels; resets accumulation
+    void resize(int cols, int rows);
+    /// @brief Trace one frame of @p gs into image()
+    void render(const GameState &gs);
+    /// @brief Quantized output, ready for pack_half_blocks
+    const PixelBuffer &image() const { return img; }
+    /// @brief Levels per colour channel after dithering (2..256; 256 = no quantization)
+    void set_levels(int n) { levels = n < 2 ? 2 : n > 256 ? 256 : n; }
+    /// @brief Milliseconds spent tracing the last frame
+    double trace_ms() const;
+    /// @brief Renderer statistics of the last frame (nullptr without a path tracer)
+    const SRStats *stats() const;
+
+private:
+    std::unique_ptr<SoftRenderer> sr;
+    PixelBuffer img;
+    int levels = 16;
+};
@@ -0,0 +1,121 @@
+/**
+ * @file console/screen.cpp
+ * @brief Cell framebuffer, arena rasterizer and diff encoder
+ */
+
+#include "console/screen.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+void ScreenBuffer::resize(int nw, int nh, char fill) {
+    w = std::max(nw, 0);
+    h = std::max(nh, 0);
+    cells.assign((size_t)w * (size_t)h, fill);
+}
+
+void ScreenBuffer::clear(char fill) { std::fill(cells.begin(), cells.end(), fill); }
+
+void ScreenBuffer::fill_rect(int x0, int y0, int x1, int y1, char ch) {
+    x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+    x1 = std::min(x1, w - 1); y1 = std::min(y1, h - 1);
+    for (int y = y0; y <= y1; ++y)
+        for (int x = x0; x <= x1; ++x) cells[(size_t)y * (size_t)w + (size_t)x] = ch;
+}
+
+void ScreenBuffer::text(int x, int y, const std::string &s) {
+    for (size_t i = 0; i < s.size(); ++i) put(x + (int)i, y, s[i]);
+}
+
+void draw_arena(const GameState &gs, ScreenBuffer &fb) {
+    const int gw = gs.gw, gh = gs.gh;
+    for (int y = 0; y < gh; y += 2) fb.put(fb.width() / 2, y, '|');
+
+    const int ly0 = (int)std::round(gs.left_y);
+    fb.fill_rect(1, ly0, 1, ly0 + gs.paddle_h - 1, '|');
+    const int ry0 = (int)std::round(gs.right_y);
+    fb.fill_rect(gw - 2, ry0, gw - 2, ry0 + gs.paddle_h - 1, '|');
+
+    if (gs.mode == GameMode::Obstacles) {
+        const Archetype &obs = gs.entities.obstacles();
+        for (size_t i = 0; i < obs.size(); ++i) {
+            const Position &op = obs.position[i]; const Shape &os = obs.shape[i];
+            fb.fill_rect((int)std::round(op.x - os.w/2.0), (int)std::round(op.y - os.h/2.0),
+                         (int)std::round(op.x + os.w/2.0), (int)std::round(op.y + os.h/2.0), '#');
+        }
+    }
+    // black holes (any gravity source) and entity types without dedicated glyphs
+    gs.entities.each(Component::Position, [&](const Archetype &a) {
+        if (a.kind() != EntityKind::BlackHole && a.kind() != EntityKind::Custom) return;
+        const char glyph = a.kind() == EntityKind::BlackHole ? '@' : '*';
+        for (size_t i = 0; i < a.size(); ++i)
+            fb.put((int)std::round(a.position[i].x), (int)std::round(a.position[i].y), glyph);
+    });
+    if (gs.mode == GameMode::ThreeEnemies) {
+        const int halfW = gs.paddle_w/2;
+        const int tx = (int)std::round(gs.top_x), bx = (int)std::round(gs.bottom_x);
+        fb.fill_rect(tx - halfW, 1, tx + halfW, 1, '=');
+        fb.fill_rect(bx - halfW, gh - 2, bx + halfW, gh - 2, '=');
+    }
+    // multi-balls
+    const Archetype &balls = gs.entities.balls();
+    if (!balls.empty()) {
+        for (size_t bi = 0; bi < balls.size(); ++bi)
+            fb.put((int)std::round(balls.position[bi].x), (int)std::round(balls.position[bi].y), bi == 0 ? 'O' : 'o');
+    } else {
+        fb.put((int)std::round(gs.ball_x), (int)std::round(gs.ball_y), 'O');
+    }
+}
+
+static void append_escape(std::string &out, const char *fmt, int a, int b = 0) {
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), fmt, a, b);
+    if (n > 0) out.append(buf, (size_t)n);
+}
+
+PresentStats DiffPresenter::encode(const ScreenBuffer &next, std::string &out) {
+    PresentStats st;
+    const size_t start = out.size();
+    const int w = next.width(), h = next.height();
+
+    if (!valid || front.width() != w || front.height() != h) {
+        out += "\x1b[H\x1b[2J";
+        for (int y = 0; y < h; ++y) {
+            if (y) out += "\r\n";
+            out.append(next.row(y), (size_t)w);
+        }
+        st.full = true;
+        st.changed = (size_t)w * (size_t)h;
+    } else {
+        // Known cursor position; -1 when unknown (e.g. pending wrap after the last column)
+        int cx = -1, cy = -1;
+        for (int y = 0; y < h; ++y) {
+            const char *a = front.row(y);
+            const char *b = next.row(y);
+            if (std::memcmp(a, b, (size_t)w) == 0) continue;
+            int x = 0;
+            while (x < w) {
+                if (a[x] == b[x]) { ++x; continue; }
+                if (cy == y && cx >= 0 && cx <= x) {
+                    const int gap = x - cx;
+                    if (gap <= 4) out.append(b + cx, (size_t)gap);
+                    else append_escape(out, "\x1b[%dC", gap);
+                } else {
+                    append_escape(out, "\x1b[%d;%dH", y + 1, x + 1);
+                }
+                int e = x;
+                while (e < w && a[e] != b[e]) ++e;
+                out.append(b + x, (size_t)(e - x));
+                st.changed += (size_t)(e - x);
+                cy = y;
+                cx = e < w ? e : -1;
+                x = e;
+            }
+        }
+    }
+    front = next;
+    valid = true;
+    st.bytes = out.size() - start;
+    return st;
+}
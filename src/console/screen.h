@@ -0,0 +1,77 @@
+/**
+ * @file console/screen.h
+ * @brief Cell framebuffer and diff encoder for the console frontend
+ *
+ * A frame is rasterized into a ScreenBuffer once (O(cells + entities))
+ * and DiffPresenter turns it into the terminal bytes needed to get from
+ * the previously presented frame to this one: only changed cells are
+ * emitted, with cursor-movement escapes in between, so a typical frame
+ * is a few dozen bytes instead of the whole screen. The result is a
+ * single contiguous buffer meant to go out in one write().
+ */
+#pragma once
+
+#include "core/game_core.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Fixed-size grid of single-byte cells
+ */
+class ScreenBuffer {
+public:
+    void resize(int w, int h, char fill = ' ');
+    void clear(char fill = ' ');
+    int width() const { return w; }
+    int height() const { return h; }
+
+    char at(int x, int y) const { return cells[(size_t)y * (size_t)w + (size_t)x]; }
+    const char *row(int y) const { return cells.data() + (size_t)y * (size_t)w; }
+    void put(int x, int y, char ch) {
+        if (x >= 0 && y >= 0 && x < w && y < h) cells[(size_t)y * (size_t)w + (size_t)x] = ch;
+    }
+    /// @brief Fill the inclusive rectangle [x0,x1] x [y0,y1], clipped to the buffer
+    void fill_rect(int x0, int y0, int x1, int y1, char ch);
+    /// @brief Write @p s starting at (x, y), clipped at the right edge
+    void text(int x, int y, const std::string &s);
+
+private:
+    int w = 0, h = 0;
+    std::vector<char> cells;
+};
+
+/**
+ * @brief Rasterize the arena (field, paddles, obstacles, black holes, balls)
+ *
+ * Draws rows 0..gs.gh-1 in the same stacking order the console has always
+ * used: centre line, side paddles, obstacles, black holes, top/bottom
+ * paddles, balls on top.
+ */
+void draw_arena(const GameState &gs, ScreenBuffer &fb);
+
+/// @brief What DiffPresenter::encode produced for one frame
+struct PresentStats {
+    size_t bytes = 0;      ///< Bytes appended to the output
+    size_t changed = 0;    ///< Cells that differed from the previous frame
+    bool full = false;     ///< Whole screen was redrawn (first frame / resize)
+};
+
+/**
+ * @brief Encodes frames as the minimal update against the last one
+ *
+ * Keeps a copy of the last presented frame. Cursor moves use CUP, or CUF
+ * when staying on the same row; short runs of unchanged cells between
+ * two changes are re-sent instead, which is cheaper than an escape.
+ */
+class DiffPresenter {
+public:
+    /// @brief Append the bytes for @p next to @p out; @p next becomes the reference frame
+    PresentStats encode(const ScreenBuffer &next, std::string &out);
+    /// @brief Forget the reference frame so the next encode redraws everything
+    void invalidate() { valid = false; }
+
+private:
+    ScreenBuffer front;
+    bool valid = false;
+};
@@ -0,0 +1,72 @@
+/**
+ * @file console/term_writer.cpp
+ * @brief Background terminal writer
+ */
+
+#include "console/term_writer.h"
+#include <chrono>
+
+TerminalWriter::TerminalWriter(Platform &p) : platform(p), worker([this] { run(); }) {}
+
+TerminalWriter::~TerminalWriter() {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+static int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TerminalWriter::submit(std::string &frame, int64_t input_ns) {
+    if (frame.empty()) return;
+    std::unique_lock<std::mutex> lk(mtx);
+    if (has_pending) {
+        const auto t0 = std::chrono::steady_clock::now();
+        cv.wait(lk, [this] { return !has_pending; });
+        stalled_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+    pending.swap(frame);
+    frame.clear();
+    pending_input_ns = input_ns;
+    has_pending = true;
+    lk.unlock();
+    cv.notify_all();
+}
+
+void TerminalWriter::flush() {
+    std::unique_lock<std::mutex> lk(mtx);
+    cv.wait(lk, [this] { return !has_pending && !busy; });
+}
+
+TimeHistogram TerminalWriter::latency() {
+    std::lock_guard<std::mutex> lk(mtx);
+    return photon;
+}
+
+void TerminalWriter::run() {
+    std::string writing;
+    std::unique_lock<std::mutex> lk(mtx);
+    for (;;) {
+        cv.wait(lk, [this] { return has_pending || stopping; });
+        // Drain what was submitted before stopping so the last frame is not lost
+        if (!has_pending) return;
+        writing.swap(pending);
+        const int64_t input_ns = pending_input_ns;
+        has_pending = false;
+        busy = true;
+        lk.unlock();
+        cv.notify_all();
+        const int calls = platform.write(writing.data(), writing.size());
+        syscalls.fetch_add((uint64_t)calls, std::memory_order_relaxed);
+        writing.clear();
+        const int64_t done = steady_ns();
+        lk.lock();
+        if (input_ns) photon.add_ns(done - input_ns);
+        busy = false;
+        cv.notify_all();
+    }
+}
@@ -0,0 +1,58 @@
+/**
+ * @file console/term_writer.h
+ * @brief Background thread that writes finished frames to the terminal
+ *
+ * Lets the frontend prepare frame N+1 (e.g. path tracing it) while frame
+ * N is still going out over a slow link. One frame can wait while another
+ * is being written; submit() blocks only when both slots are taken, which
+ * is the backpressure that keeps the game from running ahead of the
+ * terminal. Frames can carry the timestamp of the oldest input they
+ * reflect; the writer records input-to-photon latency when the write
+ * completes.
+ */
+#pragma once
+
+#include "platform/platform.h"
+#include "core/time_histogram.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class TerminalWriter {
+public:
+    explicit TerminalWriter(Platform &platform);
+    ~TerminalWriter();
+    TerminalWriter(const TerminalWriter &) = delete;
+    TerminalWriter &operator=(const TerminalWriter &) = delete;
+
+    /// @brief Queue @p frame for writing; swaps in an empty buffer (reuses its capacity)
+    /// @param input_ns Oldest input the frame reflects (steady ns, 0 = none)
+    void submit(std::string &frame, int64_t input_ns = 0);
+    /// @brief Block until everything submitted has been written
+    void flush();
+    /// @brief write() calls issued since the last call
+    uint64_t take_syscalls() { return syscalls.exchange(0, std::memory_order_relaxed); }
+    /// @brief Total milliseconds submit() spent waiting for the terminal
+    double stall_ms() const { return stalled_ms; }
+    /// @brief Copy of the input-to-photon latencies of written frames
+    TimeHistogram latency();
+
+private:
+    void run();
+
+    Platform &platform;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::string pending;
+    int64_t pending_input_ns = 0;
+    TimeHistogram photon;
+    bool has_pending = false;
+    bool busy = false;
+    bool stopping = false;
+    std::atomic<uint64_t> syscalls{0};
+    double stalled_ms = 0.0;
+    std::thread worker;
+};
@@ -0,0 +1,70 @@
+/**
+ * @file arena.h
+ * @brief Arena dimensions and derived sizing for GameCore
+ *
+ * This file defines the ArenaConfig structure which makes the playfield
+ * size a first-class configuration. Paddle sizes, obstacle layout and
+ * spawn offsets are derived from it so arenas can grow from the classic
+ * 80x24 field up to thousands of units across.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Playfield dimensions and entity sizing
+ *
+ * All sizing fields use 0 to mean "derive from the arena dimensions".
+ * The classic 80x24 field is the reference size: at that size every
+ * derived value matches the historical hard-coded constants, so the
+ * default configuration behaves exactly like the original game.
+ *
+ * Larger arenas are treated as a grid of reference-sized tiles. Paddles
+ * grow with the arena height, and the obstacle pattern is repeated once
+ * per tile so obstacle density stays constant as the field grows.
+ */
+struct ArenaConfig {
+    int width = 80;          ///< Arena width in game units
+    int height = 24;         ///< Arena height in game units
+    int paddle_h = 0;        ///< Vertical paddle height (0 = 5/24 of height)
+    int paddle_w = 0;        ///< Horizontal paddle width (0 = 10/80 of width)
+    int obstacle_count = 0;  ///< Obstacle count (0 = 3 per reference tile)
+
+    static constexpr int kRefWidth = 80;   ///< Reference (classic) arena width
+    static constexpr int kRefHeight = 24;  ///< Reference (classic) arena height
+
+    /// @brief Horizontal scale relative to the reference arena
+    double scale_x() const { return width / (double)kRefWidth; }
+
+    /// @brief Vertical scale relative to the reference arena
+    double scale_y() const { return height / (double)kRefHeight; }
+
+    /// @brief Uniform scale used for radial spawn offsets (min of both axes)
+    double scale() const { return std::min(scale_x(), scale_y()); }
+
+    /// @brief Number of reference tiles along X (at least 1)
+    int tiles_x() const { return std::max(1, width / kRefWidth); }
+
+    /// @brief Number of reference tiles along Y (at least 1)
+    int tiles_y() const { return std::max(1, height / kRefHeight); }
+
+    /**
+     * @brief Return a copy with dimensions clamped and all auto fields resolved
+     *
+     * Width and height are clamped to a minimum that still fits paddles and
+     * the obstacle margins. Any sizing field left at 0 is filled in from the
+     * arena dimensions.
+     */
+    ArenaConfig resolved() const {
+        ArenaConfig r = *this;
+        r.width = std::max(r.width, 20);
+        r.height = std::max(r.height, 8);
+        if (r.paddle_h <= 0) r.paddle_h = std::max(1, (int)std::lround(5.0 * r.scale_y()));
+        if (r.paddle_w <= 0) r.paddle_w = std::max(1, (int)std::lround(10.0 * r.scale_x()));
+        if (r.paddle_h > r.height) r.paddle_h = r.height;
+        if (r.obstacle_count <= 0) r.obstacle_count = 3 * r.tiles_x() * r.tiles_y();
+        return r;
+    }
+};
@@ -0,0 +1,103 @@
+/**
+ * @file entity_store.cpp
+ * @brief Implementation of the archetype component store
+ */
+
+#include "entity_store.h"
+
+Archetype::Archetype(const ArchetypeDesc &desc) : desc_(desc) {}
+
+size_t Archetype::add(const EntityInit &init) {
+    if (has(Component::Position)) position.push_back(init.position);
+    if (has(Component::Velocity)) velocity.push_back(init.velocity);
+    if (has(Component::Shape)) shape.push_back(init.shape);
+    if (has(Component::GravitySource)) gravity.push_back(init.gravity);
+    if (has(Component::AIController)) ai.push_back(init.ai);
+    if (has(Component::SpawnPoint)) spawn.push_back(init.spawn);
+    return count++;
+}
+
+template <class T>
+static void swap_remove(std::vector<T> &col, size_t index) {
+    if (col.empty()) return;
+    col[index] = col.back();
+    col.pop_back();
+}
+
+void Archetype::remove(size_t index) {
+    if (index >= count) return;
+    swap_remove(position, index);
+    swap_remove(velocity, index);
+    swap_remove(shape, index);
+    swap_remove(gravity, index);
+    swap_remove(ai, index);
+    swap_remove(spawn, index);
+    --count;
+}
+
+void Archetype::clear() {
+    position.clear();
+    velocity.clear();
+    shape.clear();
+    gravity.clear();
+    ai.clear();
+    spawn.clear();
+    count = 0;
+}
+
+void Archetype::reserve(size_t n) {
+    if (has(Component::Position)) position.reserve(n);
+    if (has(Component::Velocity)) velocity.reserve(n);
+    if (has(Component::Shape)) shape.reserve(n);
+    if (has(Component::GravitySource)) gravity.reserve(n);
+    if (has(Component::AIController)) ai.reserve(n);
+    if (has(Component::SpawnPoint)) spawn.reserve(n);
+}
+
+EntityStore::EntityStore() {
+    namespace C = Component;
+    ArchetypeDesc ball;
+    ball.name = "ball";
+    ball.kind = EntityKind::Ball;
+    ball.mask = C::Position | C::Velocity | C::Shape | C::SpawnPoint;
+    ball.gravity_scale = 1.0;
+    ball.bounds = BoundsPolicy::BallWalls;
+
+    ArchetypeDesc obstacle;
+    obstacle.name = "obstacle";
+    obstacle.kind = EntityKind::Obstacle;
+    obstacle.mask = C::Position | C::Velocity | C::Shape;
+    obstacle.bounds = BoundsPolicy::ReflectInset;
+    obstacle.inset_x = 5.0;
+    obstacle.inset_y = 1.0;
+
+    ArchetypeDesc blackhole;
+    blackhole.name = "blackhole";
+    blackhole.kind = EntityKind::BlackHole;
+    blackhole.mask = C::Position | C::Velocity | C::Shape | C::GravitySource;
+    blackhole.bounds = BoundsPolicy::ClampReflect;
+    blackhole.inset_x = 5.0;
+    blackhole.inset_y = 5.0;
+
+    ArchetypeDesc paddle;
+    paddle.name = "paddle";
+    paddle.kind = EntityKind::Paddle;
+    paddle.mask = C::Position | C::Shape | C::AIController;
+
+    archetypes.reserve(kBuiltinArchetypeCount);
+    archetypes.emplace_back(ball);
+    archetypes.emplace_back(obstacle);
+    archetypes.emplace_back(blackhole);
+    archetypes.emplace_back(paddle);
+}
+
+ArchetypeId EntityStore::add_archetype(const ArchetypeDesc &desc) {
+    archetypes.emplace_back(desc);
+    return (ArchetypeId)(archetypes.size() - 1);
+}
+
+size_t EntityStore::entity_count() const {
+    size_t n = 0;
+    for (const auto &a : archetypes) n += a.size();
+    return n;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file entity_store.h
+ * @brief Archetype-based component storage for GameCore entities
+ *
+ * Balls, obstacles, black holes and paddles are stored as archetypes:
+ * each archetype owns one dense array per component it declares
+ * (structure of arrays). Simulation systems and renderers iterate those
+ * arrays directly and select archetypes by component mask, so a new
+ * entity type only needs an archetype registration to be moved, pulled
+ * by gravity, kept inside the arena and drawn.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief Bit set of components present on an archetype
+using ComponentMask = uint32_t;
+
+/**
+ * @brief Component bits used to build and query archetypes
+ */
+namespace Component {
+constexpr ComponentMask Position      = 1u << 0; ///< Position column
+constexpr ComponentMask Velocity      = 1u << 1; ///< Velocity column
+constexpr ComponentMask Shape         = 1u << 2; ///< Collision / render shape column
+constexpr ComponentMask GravitySource = 1u << 3; ///< Gravitational attractor column
+constexpr ComponentMask AIController  = 1u << 4; ///< Autonomous steering column
+constexpr ComponentMask SpawnPoint    = 1u << 5; ///< Last respawn location column
+}
+
+/// @brief Entity centre in game units
+struct Position {
+    double x = 0.0;
+    double y = 0.0;
+};
+
+/// @brief Entity velocity in game units per second
+struct Velocity {
+    double vx = 0.0;
+    double vy = 0.0;
+};
+
+/// @brief Shape primitive used for collision and drawing
+enum class ShapeKind : uint8_t {
+    Circle,  ///< Disc of diameter w (h ignored)
+    Box,     ///< Axis-aligned rectangle w x h centred on the position
+    Capsule  ///< Rectangle w x h with rounded ends along its long axis
+};
+
+/// @brief Entity extent (centred on Position)
+struct Shape {
+    ShapeKind kind = ShapeKind::Circle;
+    double w = 1.0;  ///< Width (diameter for circles)
+    double h = 1.0;  ///< Height (ignored for circles)
+
+    /// @brief Radius of a circle shape
+    double radius() const { return w * 0.5; }
+};
+
+/**
+ * @brief Gravitational attractor (black holes)
+ *
+ * Uses simplified Newtonian gravity (F = strength / r^2) limited to an
+ * influence radius. See gravity_force() in black_hole.h.
+ */
+struct GravitySource {
+    double strength = 500.0;   ///< Gravitational strength (not actual mass)
+    double influence = 100.0;  ///< Maximum distance for gravitational effect
+};
+
+/// @brief Arena side an AI-controlled paddle defends
+enum class PaddleSide : uint8_t { Left = 0, Right = 1, Top = 2, Bottom = 3 };
+
+/**
+ * @brief Autonomous steering state
+ *
+ * The AI system moves the entity along the axis parallel to its side,
+ * tracking the closest ball heading towards that side.
+ */
+struct AIController {
+    PaddleSide side = PaddleSide::Right;  ///< Side being defended
+    bool enabled = false;                 ///< Steering active this frame
+    double speed = 25.0;                  ///< Maximum tracking speed (units/s)
+    bool difficulty_scaled = true;        ///< Multiply speed by the AI difficulty setting
+};
+
+/// @brief Location of the last respawn (used to avoid respawning into a black hole)
+struct SpawnPoint {
+    double x = 0.0;
+    double y = 0.0;
+};
+
+/// @brief Broad category used by game rules and renderers for styling
+enum class EntityKind : uint8_t { Ball, Obstacle, BlackHole, Paddle, Custom };
+
+/**
+ * @brief How the bounds system keeps an archetype inside the arena
+ */
+enum class BoundsPolicy : uint8_t {
+    None,          ///< Not constrained
+    ReflectInset,  ///< Flip velocity when the shape leaves the inset rectangle (obstacles)
+    ClampReflect,  ///< Clamp centre inside shape radius + inset and reflect (black holes)
+    BallWalls      ///< Reflect off top/bottom walls at 0 and height-1 (balls)
+};
+
+/**
+ * @brief Static description used to register an archetype
+ */
+struct ArchetypeDesc {
+    const char *name = "custom";                 ///< Debug / stats name
+    EntityKind kind = EntityKind::Custom;        ///< Rule and render category
+    ComponentMask mask = Component::Position;    ///< Components stored
+    double gravity_scale = 0.0;                  ///< Response to gravity sources (0 = unaffected)
+    BoundsPolicy bounds = BoundsPolicy::None;    ///< Arena containment rule
+    double inset_x = 0.0;                        ///< Horizontal inset for the bounds policy
+    double inset_y = 0.0;                        ///< Vertical inset for the bounds policy
+};
+
+/**
+ * @brief Initial component values for a new entity
+ *
+ * Only the components present in the archetype mask are stored.
+ */
+struct EntityInit {
+    Position position;
+    Velocity velocity;
+    Shape shape;
+    GravitySource gravity;
+    AIController ai;
+    SpawnPoint spawn;
+};
+
+/**
+ * @brief Dense component storage for one combination of components
+ *
+ * Every column declared in the mask has exactly size() elements; columns
+ * for absent components stay empty. Entity handles are plain indices and
+ * are only stable until the next remove() on the same archetype.
+ */
+class Archetype {
+public:
+    explicit Archetype(const ArchetypeDesc &desc);
+
+    const char *name() const { return desc_.name; }
+    EntityKind kind() const { return desc_.kind; }
+    ComponentMask mask() const { return desc_.mask; }
+    BoundsPolicy bounds() const { return desc_.bounds; }
+    double inset_x() const { return desc_.inset_x; }
+    double inset_y() const { return desc_.inset_y; }
+
+    /// @brief Gravity response factor (mutable so modes can toggle it)
+    double gravity_scale() const { return desc_.gravity_scale; }
+    void set_gravity_scale(double s) { desc_.gravity_scale = s; }
+
+    /// @brief True when every component in @p required is stored
+    bool has(ComponentMask required) const { return (desc_.mask & required) == required; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    /**
+     * @brief Append an entity
+     *
+     * @param init Initial component values (unused components ignored)
+     * @return Index of the new entity
+     */
+    size_t add(const EntityInit &init);
+
+    /// @brief Remove an entity by swapping the last one into its slot
+    void remove(size_t index);
+
+    /// @brief Remove all entities (capacity kept)
+    void clear();
+
+    /// @brief Reserve capacity in every stored column
+    void reserve(size_t n);
+
+    /// @name Component columns (dense, size() elements when stored)
+    /// @{
+    std::vector<Position> position;
+    std::vector<Velocity> velocity;
+    std::vector<Shape> shape;
+    std::vector<GravitySource> gravity;
+    std::vector<AIController> ai;
+    std::vector<SpawnPoint> spawn;
+    /// @}
+
+private:
+    ArchetypeDesc desc_;
+    size_t count = 0;
+};
+
+/// @brief Index of an archetype inside an EntityStore
+using ArchetypeId = uint32_t;
+
+/// @brief Archetypes registered by every EntityStore, in this order
+enum BuiltinArchetype : ArchetypeId {
+    kBallArchetype = 0,    ///< Position, Velocity, Shape, SpawnPoint
+    kObstacleArchetype,    ///< Position, Velocity, Shape
+    kBlackHoleArchetype,   ///< Position, Velocity, Shape, GravitySource
+    kPaddleArchetype,      ///< Position, Shape, AIController (slots indexed by PaddleSide)
+    kBuiltinArchetypeCount
+};
+
+/**
+ * @brief Collection of archetypes making up the game world
+ *
+ * The built-in archetypes are always present at fixed ids; additional
+ * entity types are registered with add_archetype() and are picked up by
+ * every system whose component requirements they satisfy.
+ */
+class EntityStore {
+public:
+    EntityStore();
+
+    /**
+     * @brief Register a new archetype
+     *
+     * @param desc Archetype description
+     * @return Id used to add entities and look the archetype up
+     */
+    ArchetypeId add_archetype(const ArchetypeDesc &desc);
+
+    Archetype &archetype(ArchetypeId id) { return archetypes[id]; }
+    const Archetype &archetype(ArchetypeId id) const { return archetypes[id]; }
+    size_t archetype_count() const { return archetypes.size(); }
+
+    /// @name Built-in archetype shortcuts
+    /// @{
+    Archetype &balls() { return archetypes[kBallArchetype]; }
+    const Archetype &balls() const { return archetypes[kBallArchetype]; }
+    Archetype &obstacles() { return archetypes[kObstacleArchetype]; }
+    const Archetype &obstacles() const { return archetypes[kObstacleArchetype]; }
+    Archetype &blackholes() { return archetypes[kBlackHoleArchetype]; }
+    const Archetype &blackholes() const { return archetypes[kBlackHoleArchetype]; }
+    Archetype &paddles() { return archetypes[kPaddleArchetype]; }
+    const Archetype &paddles() const { return archetypes[kPaddleArchetype]; }
+    /// @}
+
+    /// @brief Visit every archetype storing all components in @p required
+    template <class F>
+    void each(ComponentMask required, F &&fn) {
+        for (auto &a : archetypes) if (a.has(required)) fn(a);
+    }
+
+    /// @brief Visit every archetype storing all components in @p required (read-only)
+    template <class F>
+    void each(ComponentMask required, F &&fn) const {
+        for (const auto &a : archetypes) if (a.has(required)) fn(a);
+    }
+
+    /// @brief Total number of entities across archetypes
+    size_t entity_count() const;
+
+private:
+    std::vector<Archetype> archetypes;
+};
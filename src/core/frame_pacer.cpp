@@ -0,0 +1,120 @@
+/**
+ * @file frame_pacer.cpp
+ * @brief Implementation of FramePacer
+ */
+
+#include "frame_pacer.h"
+#include <algorithm>
+#include <thread>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#elif defined(__linux__)
+#include <cerrno>
+#include <time.h>
+#endif
+
+// The OS timer is asked to wake this much before the deadline; the rest is
+// spent yielding, which absorbs the usual wake-up latency without burning a
+// core for the whole frame. Windows timers are coarser.
+#if defined(_WIN32)
+static constexpr std::chrono::microseconds kSpinMargin{1000};
+#else
+static constexpr std::chrono::microseconds kSpinMargin{200};
+#endif
+
+FramePacer::FramePacer(double hz) {
+    set_rate(hz);
+#if defined(_WIN32)
+    // High-resolution timers (Windows 10 1803+) wake within ~0.5 ms; older
+    // systems fall back to a regular waitable timer.
+    HANDLE h = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    if (!h) h = CreateWaitableTimerW(nullptr, TRUE, nullptr);
+    timer = h;
+#endif
+}
+
+FramePacer::~FramePacer() {
+#if defined(_WIN32)
+    if (timer) CloseHandle((HANDLE)timer);
+#endif
+}
+
+void FramePacer::set_rate(double hz) {
+    period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / std::max(hz, 1.0)));
+    anchored = false;
+}
+
+void FramePacer::reset() { anchored = false; }
+
+void FramePacer::sleep_until(clock::time_point t) {
+    const clock::time_point coarse = t - kSpinMargin;
+    if (clock::now() < coarse) {
+#if defined(__linux__)
+        // libstdc++/libc++ steady_clock is CLOCK_MONOTONIC, so its epoch can be
+        // handed to the kernel as an absolute deadline directly.
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(coarse.time_since_epoch()).count();
+        timespec ts;
+        ts.tv_sec = (time_t)(ns / 1000000000);
+        ts.tv_nsec = (long)(ns % 1000000000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+#elif defined(_WIN32)
+        // Waitable timers take relative due times in 100 ns units (negative)
+        const auto rel = std::chrono::duration_cast<std::chrono::nanoseconds>(coarse - clock::now()).count();
+        LARGE_INTEGER due;
+        due.QuadPart = -(LONGLONG)(rel / 100);
+        if (timer && due.QuadPart < 0 && SetWaitableTimer((HANDLE)timer, &due, 0, nullptr, nullptr, FALSE))
+            WaitForSingleObject((HANDLE)timer, INFINITE);
+        else
+            std::this_thread::sleep_until(coarse);
+#else
+        std::this_thread::sleep_until(coarse);
+#endif
+    }
+    while (clock::now() < t) std::this_thread::yield();
+}
+
+double FramePacer::wait() {
+    if (!anchored) {
+        // First frame on a new grid: start it now, nothing to wait for
+        anchored = true;
+        last = clock::now();
+        next = last + period;
+        return std::chrono::duration<double>(period).count();
+    }
+    sleep_until(next);
+    const clock::time_point now = clock::now();
+    if (now - next > period) {
+        // More than a whole frame late (stall, debugger, suspended terminal):
+        // re-anchor instead of rushing through the missed deadlines.
+        ++missed;
+        next = now;
+    }
+    next += period;
+
+    const double dt = std::chrono::duration<double>(now - last).count();
+    last = now;
+    intervals.add_ms(dt * 1000.0);
+    return dt;
+}
+
+FramePacerStats FramePacer::stats() const {
+    FramePacerStats st;
+    st.frames = intervals.count();
+    st.missed = missed;
+    st.mean_ms = intervals.mean_ms();
+    st.p50_ms = intervals.percentile_ms(0.50);
+    st.p99_ms = intervals.percentile_ms(0.99);
+    st.max_ms = intervals.max_ms();
+    return st;
+}
+
+void FramePacer::clear_stats() {
+    intervals.clear();
+    missed = 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file frame_pacer.h
+ * @brief Absolute-deadline frame pacing with a frame-time histogram
+ *
+ * Replaces "sleep for (target - elapsed), then re-check" loops: those
+ * accumulate every wake-up's scheduling slop, so the rate drifts and
+ * jitters. FramePacer keeps a fixed grid of deadlines (start + n *
+ * period), sleeps until shortly before the next one with an absolute
+ * timer (clock_nanosleep(TIMER_ABSTIME) on Linux, a high-resolution
+ * waitable timer on Windows) and spin-yields the remaining margin, so a
+ * late wake-up delays one frame but does not shift the ones after it.
+ */
+
+#pragma once
+
+#include "time_histogram.h"
+#include <chrono>
+#include <cstdint>
+
+/// @brief Frame-interval distribution since the last FramePacer::clear_stats
+struct FramePacerStats {
+    uint64_t frames = 0;   ///< Intervals recorded
+    uint64_t missed = 0;   ///< Frames that started more than one period late (grid re-anchored)
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+};
+
+/**
+ * @brief Paces a loop to a fixed rate using absolute deadlines
+ *
+ * Call wait() once per frame; it returns the time since the previous
+ * frame started, which is what the simulation should advance by.
+ */
+class FramePacer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    /// @param hz Target rate (clamped to >= 1)
+    explicit FramePacer(double hz = 60.0);
+    ~FramePacer();
+    FramePacer(const FramePacer &) = delete;
+    FramePacer &operator=(const FramePacer &) = delete;
+
+    /// @brief Change the rate; the deadline grid restarts at the next wait()
+    void set_rate(double hz);
+    /// @brief Restart the deadline grid from now (after a pause or an unpaced stretch)
+    void reset();
+    /// @brief Block until the next deadline; returns seconds since the previous frame start
+    double wait();
+    /// @brief When the current frame started (the last wait() return)
+    clock::time_point frame_start() const { return last; }
+
+    FramePacerStats stats() const;
+    void clear_stats();
+    /// @brief Missed frames since the last clear_stats() (cheap, unlike stats())
+    uint64_t missed_frames() const { return missed; }
+
+private:
+    void sleep_until(clock::time_point t);
+
+    clock::duration period;
+    clock::time_point next;
+    clock::time_point last;
+    bool anchored = false;
+
+    TimeHistogram intervals{50, 2000};   ///< 50 us bins up to 100 ms
+    uint64_t missed = 0;
+    void *timer = nullptr;   ///< Windows waitable timer handle
+};
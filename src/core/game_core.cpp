@@ -1,245 +1,379 @@
 /**
  * @file game_core.cpp
  * @brief Implementation of core game logic and physics
- * 
+ *
  * This file implements the GameCore class with realistic Pong physics
  * including ball-paddle collision with spin effects, AI behavior,
  * and stable numerical integration using substepping.
  */
 
 #include "game_core.h"
+#include "system_scheduler.h"
 #include <cmath>
 #include <algorithm>
 #include <random>
 
-GameCore::GameCore() { reset(); }
+GameCore::GameCore(const ArenaConfig &arena) : arena_cfg(arena.resolved()) { reset(); }
+
+void GameCore::set_arena(const ArenaConfig &arena) {
+    arena_cfg = arena.resolved();
+    reset();
+}
 
 void GameCore::reset() {
-    // Initialize game dimensions and paddle size
-    s.gw = 80; s.gh = 24; s.paddle_h = 5;
-    
-    // Center paddles vertically
-    s.left_y = s.gh/2.0 - s.paddle_h/2.0;
-    s.right_y = s.left_y;
-    
+    // Initialize game dimensions and paddle size from the arena configuration
+    s.gw = arena_cfg.width; s.gh = arena_cfg.height; s.paddle_h = arena_cfg.paddle_h;
+    s.paddle_w = arena_cfg.paddle_w;
+
+    // Center paddles (vertical ones vertically, horizontal ones for ThreeEnemies horizontally)
+    reset_paddles();
+
     // Center ball (primary)
     s.ball_x = s.gw/2.0; s.ball_y = s.gh/2.0;
     vx = 20.0; vy = 10.0; // legacy
-    s.balls.clear();
-    s.balls.push_back({s.ball_x, s.ball_y, vx, vy});
-
-    // Horizontal paddles (ThreeEnemies)
-    s.top_x = s.gw/2.0; s.bottom_x = s.gw/2.0; s.paddle_w = 10;
+    Archetype &balls = s.entities.balls();
+    balls.clear();
+    EntityInit ball;
+    ball.position = { s.ball_x, s.ball_y };
+    ball.velocity = { vx, vy };
+    ball.shape = { ShapeKind::Circle, 1.2, 1.2 };
+    balls.add(ball);
 
     // Obstacles
-    s.obstacles.clear();
+    s.entities.obstacles().clear();
     if (s.mode == GameMode::Obstacles || s.mode == GameMode::ObstaclesMulti) {
-        // three moving vertical-ish blocks in center
-        int count = 3;
-        for (int i=0;i<count;++i) {
-            double fx = s.gw/2.0 + (i-1)*10.0;
-            double fy = s.gh/2.0 + (i-1)*2.0;
-            Obstacle ob; ob.x = fx; ob.y = fy; ob.w = 4; ob.h = 3; ob.vx = (i-1)*5.0; ob.vy = (i%2==0?5.0:-5.0);
-            s.obstacles.push_back(ob);
-        }
+        spawn_obstacles(true);
     }
     if (s.mode == GameMode::MultiBall || s.mode == GameMode::ObstaclesMulti) {
         // spawn additional balls
         for (int i=0;i<2;i++) spawn_ball(0.9 + 0.2*i);
     }
-    
+
     // Black holes are set by apply_mode_config, not reset
     // but we clear them here to be safe
-    s.blackholes.clear();
-    
+    s.entities.blackholes().clear();
+
     // Reset scores
     s.score_left = 0; s.score_right = 0;
-    
+
     // Store initial paddle positions for velocity calculations
     prev_left_y = s.left_y;
     prev_right_y = s.right_y;
-    
+    trail = PaddleTrail{};
+
+    sim_time = 0.0;
+
     // Reset speed mode tracking
     low_vx_time = 0.0;
     prev_abs_vx = std::abs(vx);
 }
 
-void GameCore::update(double dt) {
+void GameCore::reset_paddles() {
+    Archetype &paddles = s.entities.paddles();
+    paddles.clear();
+    // Slots follow PaddleSide: left, right, top, bottom
+    const double vertical_w = 2.0; // x positions 1..3 (mirrored on the right)
+    EntityInit p;
+    p.shape = { ShapeKind::Capsule, vertical_w, (double)s.paddle_h };
+    p.ai = { PaddleSide::Left, false, 25.0, true };
+    p.position = { 2.0, s.gh/2.0 };
+    paddles.add(p);
+    p.ai.side = PaddleSide::Right;
+    p.position = { s.gw - 2.0, s.gh/2.0 };
+    paddles.add(p);
+    p.shape = { ShapeKind::Box, (double)s.paddle_w, 1.0 };
+    p.ai = { PaddleSide::Top, false, 30.0, false };
+    p.position = { s.gw/2.0, 0.0 };
+    paddles.add(p);
+    p.ai.side = PaddleSide::Bottom;
+    p.position = { s.gw/2.0, s.gh - 1.0 };
+    paddles.add(p);
+    sync_paddle_mirrors();
+}
+
+void GameCore::sync_paddle_mirrors() {
+    const Archetype &paddles = s.entities.paddles();
+    s.left_y = paddles.position[(size_t)PaddleSide::Left].y - s.paddle_h/2.0;
+    s.right_y = paddles.position[(size_t)PaddleSide::Right].y - s.paddle_h/2.0;
+    s.top_x = paddles.position[(size_t)PaddleSide::Top].x;
+    s.bottom_x = paddles.position[(size_t)PaddleSide::Bottom].x;
+}
+
+ArenaBounds GameCore::bounds() const {
+    ArenaBounds b;
+    b.w = s.gw;
+    b.h = s.gh;
+    b.ball_walls = s.mode != GameMode::ThreeEnemies;
+    return b;
+}
+
+void GameCore::update(double dt, const PaddleCommand *inputs, size_t count, int64_t frame_start_ns) {
     // simple substepping to improve collision stability
     const double maxStep = 1.0/240.0; // 240 Hz substep
     double remaining = dt;
-    // store paddle positions to compute paddle velocity
-    double left_y_before = s.left_y;
-    double right_y_before = s.right_y;
+    const ArenaBounds arena = bounds();
+    size_t next_input = 0;
+    double elapsed = 0.0;
+    s.input_ns = pending_input_ns;
+    pending_input_ns = 0;
+    // Paddle moves made between updates (move_left_by, mouse) count as input in the first substep
+    double moved_left = s.left_y - prev_left_y, moved_right = s.right_y - prev_right_y;
     while (remaining > 1e-6) {
         double step = remaining > maxStep ? maxStep : remaining;
         remaining -= step;
-        // Update obstacles (Obstacles mode)
-        if (s.mode == GameMode::Obstacles || s.mode == GameMode::ObstaclesMulti) {
-            // Apply black hole gravity to obstacles if enabled
-            if (config_obstacles_gravity) {
-                for (auto &ob : s.obstacles) {
-                    for (const auto &bh : s.blackholes) {
-                        double fx, fy;
-                        bh.calculateForce(ob.x, ob.y, fx, fy);
-                        // Apply weak force (10% of ball force) as acceleration
-                        ob.vx += fx * step * 0.1;
-                        ob.vy += fy * step * 0.1;
-                    }
-                }
-            }
-            
-            // Update obstacle positions
-            for (auto &ob : s.obstacles) {
-                ob.x += ob.vx * step;
-                ob.y += ob.vy * step;
-                if (ob.x - ob.w/2 < 5 || ob.x + ob.w/2 > s.gw-5) ob.vx = -ob.vx;
-                if (ob.y - ob.h/2 < 1 || ob.y + ob.h/2 > s.gh-1) ob.vy = -ob.vy;
+
+        const double y_left = s.left_y, y_right = s.right_y;
+        if (command_source) apply_paddle_commands();
+        // Frame inputs stamped before the end of this substep (the last one takes the rest)
+        const int64_t substep_end_ns = frame_start_ns + (int64_t)((elapsed + step) * 1e9);
+        bool applied = false;
+        while (next_input < count && (remaining <= 1e-6 || inputs[next_input].sent_ns < substep_end_ns)) {
+            apply_paddle_command(inputs[next_input++]);
+            applied = true;
+        }
+        if (applied) sync_paddle_mirrors();
+        elapsed += step;
+        sim_time += step;
+
+        // Velocity = input displacement over a fixed trailing window, so spin
+        // does not depend on the frame rate the input arrived at
+        moved_left += s.left_y - y_left;
+        moved_right += s.right_y - y_right;
+        PaddleTrail &t = trail;
+        t.step[t.head] = step; t.left[t.head] = moved_left; t.right[t.head] = moved_right;
+        t.head = (t.head + 1) % PaddleTrail::kSize;
+        t.count = std::min(t.count + 1, PaddleTrail::kSize);
+        moved_left = moved_right = 0.0;
+        double window = 0.0, dl = 0.0, dr = 0.0;
+        for (int k = 1; k <= t.count && window < kPaddleVelocityWindow - 1e-9; ++k) {
+            const int i = (t.head - k + PaddleTrail::kSize) % PaddleTrail::kSize;
+            window += t.step[i]; dl += t.left[i]; dr += t.right[i];
+        }
+        const double left_paddle_v = dl / std::max(window, kPaddleVelocityWindow);
+        const double right_paddle_v = dr / std::max(window, kPaddleVelocityWindow);
+
+        // Gravity sources move first so every body feels this substep's field
+        s.entities.each(Component::Position | Component::Velocity | Component::GravitySource, [&](Archetype &a) {
+            integrate_system(a, step);
+            bounds_system(a, arena);
+        });
+
+        // Bodies (balls, obstacles, custom archetypes) only touch their own columns
+        run_body_stage(step);
+
+        // Cross-archetype rules: paddles, obstacles and scoring, then ball pairs
+        resolve_ball_contacts(left_paddle_v, right_paddle_v);
+        resolve_ball_pairs();
+    }
+
+    // AI for paddles if enabled (horizontal paddles only play in ThreeEnemies)
+    Archetype &paddles = s.entities.paddles();
+    paddles.ai[(size_t)PaddleSide::Left].enabled = left_ai_enabled;
+    paddles.ai[(size_t)PaddleSide::Right].enabled = right_ai_enabled;
+    paddles.ai[(size_t)PaddleSide::Top].enabled = s.mode == GameMode::ThreeEnemies;
+    paddles.ai[(size_t)PaddleSide::Bottom].enabled = s.mode == GameMode::ThreeEnemies;
+    ai_system(paddles, s.entities.balls(), Position{ s.ball_x, s.ball_y }, arena, ai_speed, dt);
+    sync_paddle_mirrors();
+
+    // Speed mode: accelerate if horizontal velocity is low for too long
+    Archetype &balls = s.entities.balls();
+    if (speed_mode && !balls.empty()) {
+        double current_abs_vx = std::abs(balls.velocity[0].vx);
+        const double vx_threshold = 15.0; // threshold for "low" horizontal velocity
+        const double accel_time_threshold = 0.5; // seconds of low vx before acceleration kicks in
+        const double accel_boost = 1.15; // 15% speed boost per trigger
+
+        if (current_abs_vx < vx_threshold) {
+            low_vx_time += dt;
+            if (low_vx_time >= accel_time_threshold) {
+                // Boost horizontal velocity while preserving direction
+                balls.velocity[0].vx *= accel_boost;
+                low_vx_time = 0.0; // reset timer after boost
             }
-            
-            // Obstacle-obstacle collision detection and response
-            for (size_t i = 0; i < s.obstacles.size(); ++i) {
-                for (size_t j = i + 1; j < s.obstacles.size(); ++j) {
-                    Obstacle &ob1 = s.obstacles[i];
-                    Obstacle &ob2 = s.obstacles[j];
-                    
-                    // AABB overlap test
-                    double left1 = ob1.x - ob1.w/2.0;
-                    double right1 = ob1.x + ob1.w/2.0;
-                    double top1 = ob1.y - ob1.h/2.0;
-                    double bottom1 = ob1.y + ob1.h/2.0;
-                    
-                    double left2 = ob2.x - ob2.w/2.0;
-                    double right2 = ob2.x + ob2.w/2.0;
-                    double top2 = ob2.y - ob2.h/2.0;
-                    double bottom2 = ob2.y + ob2.h/2.0;
-                    
-                    bool overlap_x = (left1 < right2) && (right1 > left2);
-                    bool overlap_y = (top1 < bottom2) && (bottom1 > top2);
-                    
-                    if (overlap_x && overlap_y) {
-                        // Calculate penetration depths on each axis
-                        double pen_left = right1 - left2;
-                        double pen_right = right2 - left1;
-                        double pen_top = bottom1 - top2;
-                        double pen_bottom = bottom2 - top1;
-                        
-                        double pen_x = std::min(pen_left, pen_right);
-                        double pen_y = std::min(pen_top, pen_bottom);
-                        
-                        // Resolve along axis of minimum penetration
-                        if (pen_x < pen_y) {
-                            // Separate horizontally
-                            double sep = pen_x / 2.0 + 0.01;
-                            if (pen_left < pen_right) {
-                                ob1.x -= sep;
-                                ob2.x += sep;
-                            } else {
-                                ob1.x += sep;
-                                ob2.x -= sep;
-                            }
-                            // Elastic collision: exchange velocities
-                            double temp_vx = ob1.vx;
-                            ob1.vx = ob2.vx;
-                            ob2.vx = temp_vx;
-                        } else {
-                            // Separate vertically
-                            double sep = pen_y / 2.0 + 0.01;
-                            if (pen_top < pen_bottom) {
-                                ob1.y -= sep;
-                                ob2.y += sep;
-                            } else {
-                                ob1.y += sep;
-                                ob2.y -= sep;
-                            }
-                            // Elastic collision: exchange velocities
-                            double temp_vy = ob1.vy;
-                            ob1.vy = ob2.vy;
-                            ob2.vy = temp_vy;
-                        }
+        } else {
+            low_vx_time = 0.0; // reset if velocity is healthy
+        }
+        prev_abs_vx = current_abs_vx;
+    }
+
+    // Mirror primary ball for legacy fields
+    if (!balls.empty()) {
+        s.ball_x = balls.position[0].x; s.ball_y = balls.position[0].y;
+        vx = balls.velocity[0].vx; vy = balls.velocity[0].vy;
+    }
+
+    // store for next frame's velocity estimation
+    prev_left_y = s.left_y;
+    prev_right_y = s.right_y;
+}
+
+void GameCore::run_body_stage(double step) {
+    stage_bodies.clear();
+    s.entities.each(Component::Position | Component::Velocity, [&](Archetype &a) {
+        if (!a.has(Component::GravitySource) && !a.empty()) stage_bodies.push_back(&a);
+    });
+    if (stage_bodies.size() < 2 || s.entities.entity_count() < parallel_threshold) {
+        for (Archetype *a : stage_bodies) step_bodies(*a, step);
+        return;
+    }
+    stage_jobs.clear();
+    for (Archetype *a : stage_bodies) stage_jobs.push_back([this, a, step] { step_bodies(*a, step); });
+    SystemScheduler::shared().run(stage_jobs);
+}
+
+void GameCore::step_bodies(Archetype &a, double step) {
+    gravity_system(a, s.entities, step);
+    integrate_system(a, step);
+    if (&a == &s.entities.balls()) absorb_balls(a);
+    bounds_system(a, bounds());
+    if (&a == &s.entities.obstacles()) resolve_obstacle_pairs();
+}
+
+void GameCore::absorb_balls(Archetype &balls) {
+    // Check for black hole contact/destruction if enabled
+    if (!config_blackholes_destroy_balls) return;
+    for (size_t bi = 0; bi < balls.size(); ++bi) {
+        Position &b = balls.position[bi];
+        Velocity &v = balls.velocity[bi];
+        SpawnPoint &sp = balls.spawn[bi];
+        bool absorbed = false;
+        s.entities.each(Component::Position | Component::Shape | Component::GravitySource, [&](const Archetype &src) {
+            for (size_t k = 0; k < src.size() && !absorbed; ++k) {
+                const Position &bh = src.position[k];
+                double dx = b.x - bh.x;
+                double dy = b.y - bh.y;
+                double dist = std::sqrt(dx*dx + dy*dy);
+
+                // Check if ball touches event horizon (radius of black hole)
+                if (dist < src.shape[k].radius()) {
+                    // Calculate distance from last reset to check if immediately sucked in again
+                    double reset_dx = bh.x - sp.x;
+                    double reset_dy = bh.y - sp.y;
+                    double reset_dist = std::sqrt(reset_dx*reset_dx + reset_dy*reset_dy);
+
+                    // If last reset was at/near center and we're being sucked in again
+                    // reset to side of center instead
+                    if (reset_dist < 3.0) {
+                        // Reset to side (offset from center)
+                        b.x = s.gw/2.0 + 10.0 * arena_cfg.scale_x();
+                        b.y = s.gh/2.0;
+                    } else {
+                        // First reset or far enough from last - reset to center
+                        b.x = s.gw/2.0;
+                        b.y = s.gh/2.0;
                     }
+                    sp.x = b.x;
+                    sp.y = b.y;
+
+                    // Reset velocity to reasonable initial state
+                    double speed = 25.0;
+                    double angle = (bi * 0.7 + 0.3) * 3.14159; // Different angle per ball
+                    v.vx = speed * std::cos(angle);
+                    v.vy = speed * std::sin(angle);
+
+                    // No points awarded for black hole destruction
+                    absorbed = true; // Only process first black hole hit
                 }
             }
+        });
+    }
+}
+
+void GameCore::resolve_obstacle_pairs() {
+    Archetype &obs = s.entities.obstacles();
+    const size_t n = obs.size();
+    Position *pos = obs.position.data();
+    Velocity *vel = obs.velocity.data();
+    const Shape *shp = obs.shape.data();
+
+    // Rebuild obstacle broadphase from post-integration positions
+    obstacle_grid.clear();
+    for (size_t i = 0; i < n; ++i) {
+        obstacle_grid.insert((uint32_t)i, pos[i].x - shp[i].w/2.0, pos[i].y - shp[i].h/2.0,
+                             pos[i].x + shp[i].w/2.0, pos[i].y + shp[i].h/2.0);
+    }
+
+    // Candidates from grid, ascending order
+    for (size_t i = 0; i < n; ++i) {
+        {
+            const Position &q = pos[i];
+            const Shape &qs = shp[i];
+            obstacle_grid.query(q.x - qs.w/2.0 - 0.5, q.y - qs.h/2.0 - 0.5, q.x + qs.w/2.0 + 0.5, q.y + qs.h/2.0 + 0.5, obstacle_hits);
         }
-        
-        // Update black holes
-        for (auto &bh : s.blackholes) {
-            bh.update(step, s.gw, s.gh);
-        }
+        for (uint32_t j : obstacle_hits) {
+            if (j <= i) continue;
+            Position &ob1 = pos[i], &ob2 = pos[j];
+            Velocity &ov1 = vel[i], &ov2 = vel[j];
+            const Shape &os1 = shp[i], &os2 = shp[j];
 
-        // Multi-ball / single ball iteration
-        for (size_t bi=0; bi<s.balls.size(); ++bi) {
-            BallState &b = s.balls[bi];
-            
-            // Apply black hole gravitational forces
-            for (const auto &bh : s.blackholes) {
-                double fx, fy;
-                bh.calculateForce(b.x, b.y, fx, fy);
-                // Apply force as acceleration (F = ma, assuming unit mass)
-                b.vx += fx * step;
-                b.vy += fy * step;
-            }
-            
-            b.x += b.vx * step;
-            b.y += b.vy * step;
-            
-            // Check for black hole contact/destruction if enabled
-            if (config_blackholes_destroy_balls && !s.blackholes.empty()) {
-                for (const auto &bh : s.blackholes) {
-                    double dx = b.x - bh.x;
-                    double dy = b.y - bh.y;
-                    double dist = std::sqrt(dx*dx + dy*dy);
-                    
-                    // Check if ball touches event horizon (radius of black hole)
-                    if (dist < bh.radius) {
-                        // Calculate distance from last reset to check if immediately sucked in again
-                        double reset_dx = bh.x - b.last_reset_x;
-                        double reset_dy = bh.y - b.last_reset_y;
-                        double reset_dist = std::sqrt(reset_dx*reset_dx + reset_dy*reset_dy);
-                        
-                        // If last reset was at/near center and we're being sucked in again
-                        // reset to side of center instead
-                        if (reset_dist < 3.0) {
-                            // Reset to side (offset from center)
-                            b.x = s.gw/2.0 + 10.0;
-                            b.y = s.gh/2.0;
-                            b.last_reset_x = b.x;
-                            b.last_reset_y = b.y;
-                        } else {
-                            // First reset or far enough from last - reset to center
-                            b.x = s.gw/2.0;
-                            b.y = s.gh/2.0;
-                            b.last_reset_x = b.x;
-                            b.last_reset_y = b.y;
-                        }
-                        
-                        // Reset velocity to reasonable initial state
-                        double speed = 25.0;
-                        double angle = (bi * 0.7 + 0.3) * 3.14159; // Different angle per ball
-                        b.vx = speed * std::cos(angle);
-                        b.vy = speed * std::sin(angle);
-                        
-                        // No points awarded for black hole destruction
-                        break; // Only process first black hole hit
+            // AABB overlap test
+            double left1 = ob1.x - os1.w/2.0;
+            double right1 = ob1.x + os1.w/2.0;
+            double top1 = ob1.y - os1.h/2.0;
+            double bottom1 = ob1.y + os1.h/2.0;
+
+            double left2 = ob2.x - os2.w/2.0;
+            double right2 = ob2.x + os2.w/2.0;
+            double top2 = ob2.y - os2.h/2.0;
+            double bottom2 = ob2.y + os2.h/2.0;
+
+            bool overlap_x = (left1 < right2) && (right1 > left2);
+            bool overlap_y = (top1 < bottom2) && (bottom1 > top2);
+
+            if (overlap_x && overlap_y) {
+                // Calculate penetration depths on each axis
+                double pen_left = right1 - left2;
+                double pen_right = right2 - left1;
+                double pen_top = bottom1 - top2;
+                double pen_bottom = bottom2 - top1;
+
+                double pen_x = std::min(pen_left, pen_right);
+                double pen_y = std::min(pen_top, pen_bottom);
+
+                // Resolve along axis of minimum penetration
+                if (pen_x < pen_y) {
+                    // Separate horizontally
+                    double sep = pen_x / 2.0 + 0.01;
+                    if (pen_left < pen_right) {
+                        ob1.x -= sep;
+                        ob2.x += sep;
+                    } else {
+                        ob1.x += sep;
+                        ob2.x -= sep;
                     }
+                    // Elastic collision: exchange velocities
+                    double temp_vx = ov1.vx;
+                    ov1.vx = ov2.vx;
+                    ov2.vx = temp_vx;
+                } else {
+                    // Separate vertically
+                    double sep = pen_y / 2.0 + 0.01;
+                    if (pen_top < pen_bottom) {
+                        ob1.y -= sep;
+                        ob2.y += sep;
+                    } else {
+                        ob1.y += sep;
+                        ob2.y -= sep;
+                    }
+                    // Elastic collision: exchange velocities
+                    double temp_vy = ov1.vy;
+                    ov1.vy = ov2.vy;
+                    ov2.vy = temp_vy;
                 }
             }
-            
-            if (s.mode != GameMode::ThreeEnemies) {
-                if (b.y < 0) { b.y = 0; b.vy = -b.vy; }
-                if (b.y > s.gh-1) { b.y = s.gh-1; b.vy = -b.vy; }
-            }
         }
+    }
+}
 
-        // paddle geometry: paddles are approx width 2 (x positions 1..3) with semicircle caps
+void GameCore::resolve_ball_contacts(double left_paddle_v, double right_paddle_v) {
+    Archetype &balls = s.entities.balls();
+    const Archetype &obs = s.entities.obstacles();
+
+    // paddle geometry: paddles are approx width 2 (x positions 1..3) with semicircle caps
     auto dist2 = [&](double ax, double ay, double bx, double by){ double dx=ax-bx, dy=ay-by; return dx*dx+dy*dy; };
     const double ball_r = 0.6; // ball radius in game coords
-        // estimate paddle velocities (per second) from last frame positions stored in prev_*
-        double left_paddle_v = 0.0, right_paddle_v = 0.0;
-        if (dt > 1e-8) {
-            left_paddle_v = (s.left_y - prev_left_y) / dt;
-            right_paddle_v = (s.right_y - prev_right_y) / dt;
-        }
+    double hit_offset = 0.0;   // contact offset of the last paddle hit, for event_sink
+    // paddle velocities (per second) come from update()'s trailing input window
     auto handle_paddle_local = [&](double &bx, double &by, double &bvx, double &bvy,
                                    double px_left, double px_right, double py_top, double py_bottom, bool isLeft)->bool {
         if (bx >= px_left && bx <= px_right && by >= py_top && by <= py_bottom) {
@@ -283,6 +417,7 @@ void GameCore::update(double dt) {
                     double maxsp = 80.0; double spc = std::sqrt(bvx*bvx + bvy*bvy); if (spc > maxsp) { double sc = maxsp / spc; bvx*=sc; bvy*=sc; }
                 }
             }
+            hit_offset = contact_offset;
             return true;
         }
         // caps are drawn as ellipses on the left and right sides of the rectangle
@@ -340,6 +475,7 @@ void GameCore::update(double dt) {
                     bvx *= 1.02; bvy *= 1.02;
                     double maxsp = 80.0; double spc = std::sqrt(bvx*bvx + bvy*bvy); if (spc > maxsp) { double sc = maxsp / spc; bvx*=sc; bvy*=sc; }
                 }
+                hit_offset = contact_offset;
                 return true;
             }
         }
@@ -384,63 +520,71 @@ void GameCore::update(double dt) {
                     bvx *= 1.02; bvy *= 1.02;
                     double maxsp = 80.0; double spc = std::sqrt(bvx*bvx + bvy*bvy); if (spc > maxsp) { double sc = maxsp / spc; bvx*=sc; bvy*=sc; }
                 }
+                hit_offset = contact_offset;
                 return true;
             }
         }
         return false;
     };
 
-    auto process_ball = [&](BallState &b)->void {
+    auto process_ball = [&](size_t bi, Position &bp, Velocity &bv)->void {
         // left paddle collision
         double l_px_left = 1.0, l_px_right = 3.0;
-        if (b.x < l_px_right + 1.5) {
-            if (handle_paddle_local(b.x, b.y, b.vx, b.vy, l_px_left, l_px_right, s.left_y, s.left_y + s.paddle_h, true)) {
-                if (b.vx < 0) b.vx = fabs(b.vx);
+        if (bp.x < l_px_right + 1.5) {
+            if (handle_paddle_local(bp.x, bp.y, bv.vx, bv.vy, l_px_left, l_px_right, s.left_y, s.left_y + s.paddle_h, true)) {
+                if (bv.vx < 0) bv.vx = fabs(bv.vx);
                 if (!speed_mode) {
-                    double sp = sqrt(b.vx*b.vx + b.vy*b.vy);
+                    double sp = sqrt(bv.vx*bv.vx + bv.vy*bv.vy);
                     double maxsp = 80.0;
-                    if (sp > maxsp) { b.vx *= maxsp/sp; b.vy *= maxsp/sp; }
+                    if (sp > maxsp) { bv.vx *= maxsp/sp; bv.vy *= maxsp/sp; }
                 }
-            } else if (b.x < -1.0) {
+                if (event_sink) emit_event(GameEventKind::PaddleHit, PaddleSide::Left, bi, bp, bv, hit_offset);
+            } else if (bp.x < -1.0) {
+                if (event_sink) emit_event(GameEventKind::Point, PaddleSide::Right, bi, bp, bv, 0.0);
                 s.score_right++;
-                b.x = s.gw/2.0; b.y = s.gh/2.0; b.vx = 20.0; b.vy = 10.0;
+                bp.x = s.gw/2.0; bp.y = s.gh/2.0; bv.vx = 20.0; bv.vy = 10.0;
             }
         }
         // right paddle collision
         double r_px_left = s.gw - 3.0, r_px_right = s.gw - 1.0;
-        if (b.x > r_px_left - 1.5) {
-            if (handle_paddle_local(b.x, b.y, b.vx, b.vy, r_px_left, r_px_right, s.right_y, s.right_y + s.paddle_h, false)) {
-                if (b.vx > 0) b.vx = -fabs(b.vx);
+        if (bp.x > r_px_left - 1.5) {
+            if (handle_paddle_local(bp.x, bp.y, bv.vx, bv.vy, r_px_left, r_px_right, s.right_y, s.right_y + s.paddle_h, false)) {
+                if (bv.vx > 0) bv.vx = -fabs(bv.vx);
                 if (!speed_mode) {
-                    double sp = sqrt(b.vx*b.vx + b.vy*b.vy);
+                    double sp = sqrt(bv.vx*bv.vx + bv.vy*bv.vy);
                     double maxsp = 80.0;
-                    if (sp > maxsp) { b.vx *= maxsp/sp; b.vy *= maxsp/sp; }
+                    if (sp > maxsp) { bv.vx *= maxsp/sp; bv.vy *= maxsp/sp; }
                 }
-            } else if (b.x > s.gw + 1.0) {
+                if (event_sink) emit_event(GameEventKind::PaddleHit, PaddleSide::Right, bi, bp, bv, hit_offset);
+            } else if (bp.x > s.gw + 1.0) {
+                if (event_sink) emit_event(GameEventKind::Point, PaddleSide::Left, bi, bp, bv, 0.0);
                 s.score_left++;
-                b.x = s.gw/2.0; b.y = s.gh/2.0; b.vx = -20.0; b.vy = -10.0;
+                bp.x = s.gw/2.0; bp.y = s.gh/2.0; bv.vx = -20.0; bv.vy = -10.0;
             }
         }
 
-        // Obstacles collisions (AABB vs ball)
-        if (s.mode == GameMode::Obstacles || s.mode == GameMode::ObstaclesMulti) {
-            for (auto &ob : s.obstacles) {
-                double left = ob.x - ob.w/2.0;
-                double right = ob.x + ob.w/2.0;
-                double top = ob.y - ob.h/2.0;
-                double bottom = ob.y + ob.h/2.0;
-                if (b.x >= left-0.6 && b.x <= right+0.6 && b.y >= top-0.6 && b.y <= bottom+0.6) {
+        // Obstacles collisions (AABB vs ball), candidates from the obstacle grid
+        if ((s.mode == GameMode::Obstacles || s.mode == GameMode::ObstaclesMulti) && !obs.empty()) {
+            obstacle_grid.query(bp.x - 1.6, bp.y - 1.6, bp.x + 1.6, bp.y + 1.6, grid_hits);
+            for (uint32_t oi : grid_hits) {
+                const Position &ob = obs.position[oi];
+                const Shape &os = obs.shape[oi];
+                double left = ob.x - os.w/2.0;
+                double right = ob.x + os.w/2.0;
+                double top = ob.y - os.h/2.0;
+                double bottom = ob.y + os.h/2.0;
+                if (bp.x >= left-0.6 && bp.x <= right+0.6 && bp.y >= top-0.6 && bp.y <= bottom+0.6) {
                     // compute penetration depths
-                    double penLeft = (right+0.6) - b.x;
-                    double penRight = b.x - (left-0.6);
-                    double penTop = (bottom+0.6) - b.y;
-                    double penBottom = b.y - (top-0.6);
+                    double penLeft = (right+0.6) - bp.x;
+                    double penRight = bp.x - (left-0.6);
+                    double penTop = (bottom+0.6) - bp.y;
+                    double penBottom = bp.y - (top-0.6);
                     // choose minimal axis
                     double minPen = std::min({penLeft, penRight, penTop, penBottom});
-                    if (minPen == penLeft) { b.x = right+0.61; b.vx = fabs(b.vx); }
-                    else if (minPen == penRight) { b.x = left-0.61; b.vx = -fabs(b.vx); }
-                    else if (minPen == penTop) { b.y = bottom+0.61; b.vy = fabs(b.vy); }
-                    else { b.y = top-0.61; b.vy = -fabs(b.vy); }
+                    if (minPen == penLeft) { bp.x = right+0.61; bv.vx = fabs(bv.vx); }
+                    else if (minPen == penRight) { bp.x = left-0.61; bv.vx = -fabs(bv.vx); }
+                    else if (minPen == penTop) { bp.y = bottom+0.61; bv.vy = fabs(bv.vy); }
+                    else { bp.y = top-0.61; bv.vy = -fabs(bv.vy); }
                 }
             }
         }
@@ -451,199 +595,176 @@ void GameCore::update(double dt) {
             double top_line = 0.0; // top boundary
             double bottom_line = s.gh - 1.0; // bottom boundary
             // If ball crosses top
-            if (b.y < top_line) {
-                if (fabs(b.x - s.top_x) <= halfW) {
+            if (bp.y < top_line) {
+                if (fabs(bp.x - s.top_x) <= halfW) {
                     // treat as paddle hit -> reflect down
-                    b.y = top_line; b.vy = fabs(b.vy);
+                    bp.y = top_line; bv.vy = fabs(bv.vy);
+                    if (event_sink) emit_event(GameEventKind::PaddleHit, PaddleSide::Top, bi, bp, bv, (bp.x - s.top_x) / halfW);
                 } else {
                     // Score for bottom/AI side (treat like passing player paddle)
+                    if (event_sink) emit_event(GameEventKind::Point, PaddleSide::Right, bi, bp, bv, 0.0);
                     s.score_right++;
-                    b.x = s.gw/2.0; b.y = s.gh/2.0; b.vx = 20.0; b.vy = 10.0; // re-center
+                    bp.x = s.gw/2.0; bp.y = s.gh/2.0; bv.vx = 20.0; bv.vy = 10.0; // re-center
                 }
             }
             // If ball crosses bottom
-            if (b.y > bottom_line) {
-                if (fabs(b.x - s.bottom_x) <= halfW) {
-                    b.y = bottom_line; b.vy = -fabs(b.vy);
+            if (bp.y > bottom_line) {
+                if (fabs(bp.x - s.bottom_x) <= halfW) {
+                    bp.y = bottom_line; bv.vy = -fabs(bv.vy);
+                    if (event_sink) emit_event(GameEventKind::PaddleHit, PaddleSide::Bottom, bi, bp, bv, (bp.x - s.bottom_x) / halfW);
                 } else {
                     // Score for left/player side
+                    if (event_sink) emit_event(GameEventKind::Point, PaddleSide::Left, bi, bp, bv, 0.0);
                     s.score_left++;
-                    b.x = s.gw/2.0; b.y = s.gh/2.0; b.vx = -20.0; b.vy = -10.0;
+                    bp.x = s.gw/2.0; bp.y = s.gh/2.0; bv.vx = -20.0; bv.vy = -10.0;
                 }
             }
         }
     };
 
-        for (auto &b : s.balls) process_ball(b);
-
-        // Ball-to-ball collision detection (for multi-ball modes)
-        if (s.balls.size() > 1) {
-            for (size_t i = 0; i < s.balls.size(); ++i) {
-                for (size_t j = i + 1; j < s.balls.size(); ++j) {
-                    BallState &b1 = s.balls[i];
-                    BallState &b2 = s.balls[j];
-                    
-                    // Calculate distance between ball centers
-                    double dx = b2.x - b1.x;
-                    double dy = b2.y - b1.y;
-                    double dist_sq = dx*dx + dy*dy;
-                    double collision_dist = 2.0 * ball_r; // sum of radii
-                    double collision_dist_sq = collision_dist * collision_dist;
-                    
-                    if (dist_sq < collision_dist_sq && dist_sq > 1e-6) {
-                        // Balls are colliding
-                        double dist = std::sqrt(dist_sq);
-                        
-                        // Normalized collision normal (from b1 to b2)
-                        double nx = dx / dist;
-                        double ny = dy / dist;
-                        
-                        // Separate balls to prevent overlap
-                        double overlap = collision_dist - dist;
-                        double separation = overlap / 2.0 + 0.01; // small extra push
-                        b1.x -= nx * separation;
-                        b1.y -= ny * separation;
-                        b2.x += nx * separation;
-                        b2.y += ny * separation;
-                        
-                        // Calculate relative velocity
-                        double dvx = b2.vx - b1.vx;
-                        double dvy = b2.vy - b1.vy;
-                        
-                        // Relative velocity in collision normal direction
-                        double dvn = dvx * nx + dvy * ny;
-                        
-                        // Only resolve if balls are approaching (not separating)
-                        if (dvn < 0) {
-                            // Elastic collision with restitution
-                            double impulse = -(1.0 + restitution) * dvn / 2.0;
-                            
-                            // Apply impulse to both balls (equal mass assumption)
-                            b1.vx -= impulse * nx;
-                            b1.vy -= impulse * ny;
-                            b2.vx += impulse * nx;
-                            b2.vy += impulse * ny;
-                            
-                            // Apply speed cap if not in speed mode
-                            if (!speed_mode) {
-                                double maxsp = 90.0;
-                                double sp1 = std::sqrt(b1.vx*b1.vx + b1.vy*b1.vy);
-                                if (sp1 > maxsp) {
-                                    b1.vx *= maxsp / sp1;
-                                    b1.vy *= maxsp / sp1;
-                                }
-                                double sp2 = std::sqrt(b2.vx*b2.vx + b2.vy*b2.vy);
-                                if (sp2 > maxsp) {
-                                    b2.vx *= maxsp / sp2;
-                                    b2.vy *= maxsp / sp2;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
+    for (size_t bi = 0; bi < balls.size(); ++bi) process_ball(bi, balls.position[bi], balls.velocity[bi]);
+}
 
-        // AI for right paddle (performed per frame, fine-grained control above)
-        // (AI update outside of substep loop - handled after loop)
-    }
+void GameCore::emit_event(GameEventKind kind, PaddleSide side, size_t ball, const Position &p, const Velocity &v,
+                          double offset) {
+    GameEvent e;
+    e.kind = kind;
+    e.side = side;
+    e.ball = (uint32_t)ball;
+    e.time = sim_time;
+    e.x = p.x; e.y = p.y;
+    e.vx = v.vx; e.vy = v.vy;
+    e.offset = offset;
+    event_sink->on_event(e);
+}
 
-    // compute paddle velocities (units per second)
-    double left_paddle_v = (s.left_y - left_y_before) / dt;
-    double right_paddle_v = (s.right_y - right_y_before) / dt;
-
-    // AI for paddles if enabled
-    if (right_ai_enabled) {
-        double target_ball_y = s.ball_y;
-        double min_dx = 1e9;
-        for (auto &b : s.balls) {
-            double dx = (s.gw - b.x);
-            if (b.vx > 0 && dx < min_dx) { min_dx = dx; target_ball_y = b.y; }
-        }
-        double target = target_ball_y - s.paddle_h/2.0;
-        double dy = target - s.right_y;
-        double max_speed = 25.0 * ai_speed * dt;
-        if (fabs(dy) > max_speed) dy = (dy > 0 ? 1 : -1) * max_speed;
-        s.right_y += dy;
-    }
-    if (left_ai_enabled) {
-        // Track closest ball moving toward left paddle (vx < 0)
-        double target_ball_y = s.ball_y;
-        double min_dx = 1e9;
-        for (auto &b : s.balls) {
-            double dx = b.x; // distance from left edge
-            if (b.vx < 0 && dx < min_dx) { min_dx = dx; target_ball_y = b.y; }
+void GameCore::resolve_ball_pairs() {
+    // Ball-to-ball collision detection (for multi-ball modes)
+    Archetype &balls = s.entities.balls();
+    const size_t n = balls.size();
+    Position *pos = balls.position.data();
+    Velocity *vel = balls.velocity.data();
+    const double ball_r = 0.6; // ball radius in game coords
+    if (n > 1) {
+        ball_grid.clear();
+        for (size_t i = 0; i < n; ++i) {
+            const Position &b = pos[i];
+            ball_grid.insert((uint32_t)i, b.x - ball_r, b.y - ball_r, b.x + ball_r, b.y + ball_r);
         }
-        double target = target_ball_y - s.paddle_h/2.0;
-        double dy = target - s.left_y;
-        double max_speed = 25.0 * ai_speed * dt;
-        if (fabs(dy) > max_speed) dy = (dy > 0 ? 1 : -1) * max_speed;
-        s.left_y += dy;
-    }
+        for (size_t i = 0; i < n; ++i) {
+            {
+                const Position &q = pos[i];
+                ball_grid.query(q.x - 2.0*ball_r, q.y - 2.0*ball_r, q.x + 2.0*ball_r, q.y + 2.0*ball_r, grid_hits);
+            }
+            for (uint32_t j : grid_hits) {
+                if (j <= i) continue;
+                Position &b1 = pos[i], &b2 = pos[j];
+                Velocity &bv1 = vel[i], &bv2 = vel[j];
 
-    // ThreeEnemies horizontal paddle AI: track nearest ball
-    if (s.mode == GameMode::ThreeEnemies) {
-        double nearest_top = s.balls.front().x;
-        double nearest_bottom = s.balls.front().x;
-        double min_top_dist = 1e9, min_bottom_dist = 1e9;
-        for (auto &b : s.balls) {
-            if (b.vy < 0) { double d = fabs(b.y - 1.0); if (d < min_top_dist) { min_top_dist = d; nearest_top = b.x; } }
-            if (b.vy > 0) { double d = fabs(b.y - (s.gh - 2.0)); if (d < min_bottom_dist) { min_bottom_dist = d; nearest_bottom = b.x; } }
-        }
-        double speed = 30.0 * dt;
-        s.top_x += std::clamp(nearest_top - s.top_x, -speed, speed);
-        s.bottom_x += std::clamp(nearest_bottom - s.bottom_x, -speed, speed);
-        // clamp within bounds
-        if (s.top_x < s.paddle_w/2.0) s.top_x = s.paddle_w/2.0;
-        if (s.top_x > s.gw - s.paddle_w/2.0) s.top_x = s.gw - s.paddle_w/2.0;
-        if (s.bottom_x < s.paddle_w/2.0) s.bottom_x = s.paddle_w/2.0;
-        if (s.bottom_x > s.gw - s.paddle_w/2.0) s.bottom_x = s.gw - s.paddle_w/2.0;
-    }
+                // Calculate distance between ball centers
+                double dx = b2.x - b1.x;
+                double dy = b2.y - b1.y;
+                double dist_sq = dx*dx + dy*dy;
+                double collision_dist = 2.0 * ball_r; // sum of radii
+                double collision_dist_sq = collision_dist * collision_dist;
 
-    if (s.left_y < 0) s.left_y = 0;
-    if (s.left_y + s.paddle_h > s.gh) s.left_y = s.gh - s.paddle_h;
-    if (s.right_y < 0) s.right_y = 0;
-    if (s.right_y + s.paddle_h > s.gh) s.right_y = s.gh - s.paddle_h;
+                if (dist_sq < collision_dist_sq && dist_sq > 1e-6) {
+                    // Balls are colliding
+                    double dist = std::sqrt(dist_sq);
 
-    // Speed mode: accelerate if horizontal velocity is low for too long
-    if (speed_mode && !s.balls.empty()) {
-        double current_abs_vx = std::abs(s.balls[0].vx);
-        const double vx_threshold = 15.0; // threshold for "low" horizontal velocity
-        const double accel_time_threshold = 0.5; // seconds of low vx before acceleration kicks in
-        const double accel_boost = 1.15; // 15% speed boost per trigger
-        
-        if (current_abs_vx < vx_threshold) {
-            low_vx_time += dt;
-            if (low_vx_time >= accel_time_threshold) {
-                // Boost horizontal velocity while preserving direction
-                double dir = (s.balls[0].vx >= 0) ? 1.0 : -1.0;
-                s.balls[0].vx *= accel_boost;
-                low_vx_time = 0.0; // reset timer after boost
+                    // Normalized collision normal (from b1 to b2)
+                    double nx = dx / dist;
+                    double ny = dy / dist;
+
+                    // Separate balls to prevent overlap
+                    double overlap = collision_dist - dist;
+                    double separation = overlap / 2.0 + 0.01; // small extra push
+                    b1.x -= nx * separation;
+                    b1.y -= ny * separation;
+                    b2.x += nx * separation;
+                    b2.y += ny * separation;
+
+                    // Calculate relative velocity
+                    double dvx = bv2.vx - bv1.vx;
+                    double dvy = bv2.vy - bv1.vy;
+
+                    // Relative velocity in collision normal direction
+                    double dvn = dvx * nx + dvy * ny;
+
+                    // Only resolve if balls are approaching (not separating)
+                    if (dvn < 0) {
+                        // Elastic collision with restitution
+                        double impulse = -(1.0 + restitution) * dvn / 2.0;
+
+                        // Apply impulse to both balls (equal mass assumption)
+                        bv1.vx -= impulse * nx;
+                        bv1.vy -= impulse * ny;
+                        bv2.vx += impulse * nx;
+                        bv2.vy += impulse * ny;
+
+                        // Apply speed cap if not in speed mode
+                        if (!speed_mode) {
+                            double maxsp = 90.0;
+                            double sp1 = std::sqrt(bv1.vx*bv1.vx + bv1.vy*bv1.vy);
+                            if (sp1 > maxsp) {
+                                bv1.vx *= maxsp / sp1;
+                                bv1.vy *= maxsp / sp1;
+                            }
+                            double sp2 = std::sqrt(bv2.vx*bv2.vx + bv2.vy*bv2.vy);
+                            if (sp2 > maxsp) {
+                                bv2.vx *= maxsp / sp2;
+                                bv2.vy *= maxsp / sp2;
+                            }
+                        }
+                    }
+                }
             }
-        } else {
-            low_vx_time = 0.0; // reset if velocity is healthy
         }
-        prev_abs_vx = current_abs_vx;
     }
-    
-    // Mirror primary ball for legacy fields
-    if (!s.balls.empty()) { s.ball_x = s.balls[0].x; s.ball_y = s.balls[0].y; vx = s.balls[0].vx; vy = s.balls[0].vy; }
+}
 
-    // store for next frame's velocity estimation
-    prev_left_y = s.left_y;
-    prev_right_y = s.right_y;
+void GameCore::move_left_by(double dy) {
+    s.entities.paddles().position[(size_t)PaddleSide::Left].y += dy;
+    sync_paddle_mirrors();
+}
+
+void GameCore::set_left_y(double y) {
+    s.entities.paddles().position[(size_t)PaddleSide::Left].y = y + s.paddle_h/2.0;
+    sync_paddle_mirrors();
 }
 
-void GameCore::move_left_by(double dy) { 
-    s.left_y += dy; 
+void GameCore::apply_paddle_command(const PaddleCommand &cmd) {
+    Archetype &paddles = s.entities.paddles();
+    const size_t i = (size_t)cmd.side;
+    if (i >= paddles.size()) return;
+    Position &p = paddles.position[i];
+    const Shape &sh = paddles.shape[i];
+    const bool vertical = cmd.side == PaddleSide::Left || cmd.side == PaddleSide::Right;
+    double &axis = vertical ? p.y : p.x;
+    axis = cmd.kind == PaddleCommandKind::SetCentre ? cmd.value : axis + cmd.value;
+    if (vertical) axis = std::clamp(axis, sh.h/2.0, s.gh - sh.h/2.0);
+    else axis = std::clamp(axis, sh.w/2.0, s.gw - sh.w/2.0);
+    if (cmd.sent_ns > 0 && (!s.input_ns || cmd.sent_ns < s.input_ns)) s.input_ns = cmd.sent_ns;
+    // id 0 marks local input (keyboard); only tracked commands are echoed back
+    if (cmd.id) {
+        s.last_command_id = cmd.id;
+        s.last_command_ns = cmd.sent_ns;
+    }
 }
 
-void GameCore::set_left_y(double y) { 
-    s.left_y = y; 
+void GameCore::apply_paddle_commands() {
+    PaddleCommand cmd;
+    bool applied = false;
+    while (command_source->next(cmd)) {
+        apply_paddle_command(cmd);
+        applied = true;
+    }
+    if (applied) sync_paddle_mirrors();
 }
 
-void GameCore::move_right_by(double dy) { 
-    s.right_y += dy; 
+void GameCore::move_right_by(double dy) {
+    s.entities.paddles().position[(size_t)PaddleSide::Right].y += dy;
+    sync_paddle_mirrors();
 }
 
 void GameCore::set_mode(GameMode m) {
@@ -653,28 +774,66 @@ void GameCore::set_mode(GameMode m) {
 }
 
 void GameCore::spawn_ball(double speed_scale) {
-    double angle = 0.3 + (s.balls.size()*0.7); // simple variety
+    Archetype &balls = s.entities.balls();
     double speed = 22.0 * speed_scale;
-    double dir = (s.balls.size()%2==0)?1.0:-1.0;
-    BallState b; b.x = s.gw/2.0; b.y = s.gh/2.0; b.vx = dir*speed; b.vy = speed*0.5;
-    s.balls.push_back(b);
+    double dir = (balls.size()%2==0)?1.0:-1.0;
+    EntityInit b;
+    b.position = { s.gw/2.0, s.gh/2.0 };
+    b.velocity = { dir*speed, speed*0.5 };
+    b.shape = { ShapeKind::Circle, 1.2, 1.2 };
+    balls.add(b);
+}
+
+void GameCore::spawn_obstacles(bool moving) {
+    // The classic field holds three blocks around its center. Larger arenas are
+    // split into reference-sized tiles and the same pattern is repeated per tile,
+    // so obstacle density (and per-chunk collision load) stays constant.
+    const int tx = arena_cfg.tiles_x(), ty = arena_cfg.tiles_y();
+    const int tiles = tx * ty;
+    const double tile_w = s.gw / (double)tx, tile_h = s.gh / (double)ty;
+    const int count = arena_cfg.obstacle_count;
+    Archetype &obs = s.entities.obstacles();
+    obs.reserve(count);
+    for (int k = 0; k < count; ++k) {
+        int i = k % 3;
+        int tile = (k / 3) % tiles;
+        int layer = k / (3 * tiles);
+        double cx = (tile % tx + 0.5) * tile_w;
+        double cy = (tile / tx + 0.5) * tile_h;
+        double fx = cx + (i-1)*10.0;
+        double fy = cy + (i-1)*2.0;
+        if (layer > 0) {
+            // Explicit counts beyond one pattern per tile: offset extra layers inside the tile
+            double f = std::fmod(layer * 0.6180339887, 1.0) - 0.5;
+            fx += f * tile_w * 0.5;
+            fy += f * tile_h * 0.5;
+        }
+        EntityInit ob;
+        ob.shape = { ShapeKind::Box, 4.0, 3.0 };
+        ob.position.x = std::clamp(fx, 5.0 + ob.shape.w, s.gw - 5.0 - ob.shape.w);
+        ob.position.y = std::clamp(fy, 1.0 + ob.shape.h, s.gh - 1.0 - ob.shape.h);
+        if (moving) {
+            ob.velocity.vx = (i-1)*5.0;
+            ob.velocity.vy = (i%2==0?5.0:-5.0);
+        }
+        obs.add(ob);
+    }
 }
 
 void GameCore::spawn_blackhole(double x, double y, bool moving) {
-    BlackHole bh;
-    bh.x = x;
-    bh.y = y;
-    bh.moving = moving;
+    Archetype &holes = s.entities.blackholes();
+    EntityInit bh;
+    bh.position = { x, y };
     if (moving) {
         // Random velocity for moving black holes
-        double angle = (s.blackholes.size() * 1.2) + 0.5;
-        bh.vx = 10.0 * std::cos(angle);
-        bh.vy = 10.0 * std::sin(angle);
+        double angle = (holes.size() * 1.2) + 0.5;
+        bh.velocity.vx = 10.0 * std::cos(angle);
+        bh.velocity.vy = 10.0 * std::sin(angle);
     }
-    bh.strength = 500.0;
-    bh.radius = 2.0;
-    bh.influence = 100.0;
-    s.blackholes.push_back(bh);
+    bh.shape = { ShapeKind::Circle, 2.0 * kBlackHoleRadius, 2.0 * kBlackHoleRadius };
+    bh.gravity.strength = 500.0;
+    bh.gravity.influence = 100.0;
+    holes.add(bh);
 }
 
 void GameCore::apply_mode_config(bool multiball, bool obstacles, bool obstacles_moving,
@@ -684,7 +843,9 @@ void GameCore::apply_mode_config(bool multiball, bool obstacles, bool obstacles_
     // Store config flags for use in update loop
     config_obstacles_gravity = obstacles_gravity;
     config_blackholes_destroy_balls = blackholes_destroy_balls;
-    
+    // Obstacles feel a weak pull (10% of ball force) when enabled
+    s.entities.obstacles().set_gravity_scale(obstacles_gravity ? 0.1 : 0.0);
+
     // Set mode enum based on combination of flags (for legacy compatibility)
     if (obstacles && multiball) {
         s.mode = GameMode::ObstaclesMulti;
@@ -697,42 +858,33 @@ void GameCore::apply_mode_config(bool multiball, bool obstacles, bool obstacles_
     } else {
         s.mode = GameMode::Classic;
     }
-    
+
     // Clear existing dynamic objects
-    s.balls.clear();
-    s.obstacles.clear();
-    s.blackholes.clear();
-    
+    Archetype &balls = s.entities.balls();
+    balls.clear();
+    s.entities.obstacles().clear();
+    s.entities.blackholes().clear();
+
     // Always have at least one ball
-    s.balls.push_back({s.gw/2.0, s.gh/2.0, 20.0, 10.0});
+    EntityInit ball;
+    ball.position = { s.gw/2.0, s.gh/2.0 };
+    ball.velocity = { 20.0, 10.0 };
+    ball.shape = { ShapeKind::Circle, 1.2, 1.2 };
+    balls.add(ball);
     vx = 20.0; vy = 10.0; // Keep legacy velocities in sync
-    
+
     // Add extra balls for multiball
     if (multiball) {
         for (int i = 1; i < multiball_count; ++i) {
             spawn_ball(0.9 + 0.1 * i);
         }
     }
-    
+
     // Add obstacles
     if (obstacles) {
-        int count = 3;
-        for (int i=0;i<count;++i) {
-            double fx = s.gw/2.0 + (i-1)*10.0;
-            double fy = s.gh/2.0 + (i-1)*2.0;
-            Obstacle ob; 
-            ob.x = fx; ob.y = fy; ob.w = 4; ob.h = 3;
-            if (obstacles_moving) {
-                ob.vx = (i-1)*5.0; 
-                ob.vy = (i%2==0?5.0:-5.0);
-            } else {
-                ob.vx = 0.0;
-                ob.vy = 0.0;
-            }
-            s.obstacles.push_back(ob);
-        }
+        spawn_obstacles(obstacles_moving);
     }
-    
+
     // Add black holes
     if (blackholes) {
         if (blackhole_count == 1) {
@@ -741,16 +893,14 @@ void GameCore::apply_mode_config(bool multiball, bool obstacles, bool obstacles_
             // Distribute multiple black holes
             for (int i = 0; i < blackhole_count; ++i) {
                 double angle = (i * 2.0 * 3.14159) / blackhole_count;
-                double radius = 15.0;
+                double radius = 15.0 * arena_cfg.scale();
                 double bx = s.gw/2.0 + radius * std::cos(angle);
                 double by = s.gh/2.0 + radius * std::sin(angle);
                 spawn_blackhole(bx, by, blackholes_moving);
             }
         }
     }
-    
+
     // Three enemies mode affects collision logic, not objects
     // The actual horizontal paddle logic is handled in update()
 }
-
-
@@ -8,9 +8,16 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
+#include "arena.h"
 #include "black_hole.h"
+#include "entity_store.h"
+#include "game_events.h"
+#include "paddle_command.h"
+#include "spatial_grid.h"
+#include "systems.h"
 
 /**
  * @brief Available game modes
@@ -28,62 +35,41 @@ enum class GameMode {
     ObstaclesMulti  ///< Obstacles + MultiBall combined mode
 };
 
-/**
- * @brief Obstacle block used in obstacle game mode
- */
-struct Obstacle {
-    double x = 0.0;    ///< Center X
-    double y = 0.0;    ///< Center Y
-    double w = 4.0;    ///< Width
-    double h = 2.0;    ///< Height
-    double vx = 0.0;   ///< Horizontal velocity (for moving obstacles mode)
-    double vy = 0.0;   ///< Vertical velocity
-};
-
-/**
- * @brief Ball state (supports multi-ball mode)
- */
-struct BallState {
-    double x = 0.0;
-    double y = 0.0;
-    double vx = 0.0;
-    double vy = 0.0;
-    double last_reset_x = 0.0;  ///< Last X position where ball was reset (for black hole logic)
-    double last_reset_y = 0.0;  ///< Last Y position where ball was reset (for black hole logic)
-};
-
 /**
  * @brief Game state structure containing all dynamic game data
  * 
  * This structure holds the complete state of a Pong game including
  * paddle positions, ball position, scores, and game dimensions.
+ * 
+ * Balls, obstacles, black holes and paddles live in the entity store as
+ * dense component arrays. The scalar paddle and ball fields mirror the
+ * store (paddle top/centre edges and balls[0]) for input code and
+ * renderers that only need the classic two-paddle view.
  */
 struct GameState {
     int gw = 80;           ///< Game width in game coordinate units
     int gh = 24;           ///< Game height in game coordinate units
-    double left_y = 0.0;   ///< Left paddle Y position (center)
-    double right_y = 0.0;  ///< Right paddle Y position (center)
-    double ball_x = 0.0;   ///< Ball X position
-    double ball_y = 0.0;   ///< Ball Y position
+    double left_y = 0.0;   ///< Left paddle top edge Y (mirrors paddle entity)
+    double right_y = 0.0;  ///< Right paddle top edge Y (mirrors paddle entity)
+    double ball_x = 0.0;   ///< Primary ball X position (mirrors balls[0])
+    double ball_y = 0.0;   ///< Primary ball Y position (mirrors balls[0])
     int paddle_h = 5;      ///< Paddle height in game units
     int score_left = 0;    ///< Left player score
     int score_right = 0;   ///< Right player score
     
     // Extended paddles for advanced modes
-    double top_x = 0.0;    ///< Top horizontal paddle X (center) (ThreeEnemies mode)
-    double bottom_x = 0.0; ///< Bottom horizontal paddle X (center) (ThreeEnemies mode)
+    double top_x = 0.0;    ///< Top horizontal paddle X (center) (ThreeEnemies mode, mirrors paddle entity)
+    double bottom_x = 0.0; ///< Bottom horizontal paddle X (center) (ThreeEnemies mode, mirrors paddle entity)
     int paddle_w = 8;      ///< Horizontal paddle width
 
-    // Obstacles (Obstacles mode)
-    std::vector<Obstacle> obstacles; ///< Active obstacles
-
-    // Multi-ball
-    std::vector<BallState> balls;    ///< Active balls (ball_x/ball_y mirror balls[0])
-    
-    // Black holes
-    std::vector<BlackHole> blackholes; ///< Active black holes
+    // Balls, obstacles, black holes and paddles
+    EntityStore entities;  ///< Component arrays shared by simulation systems and renderers
 
     GameMode mode = GameMode::Classic; ///< Current game mode
+
+    uint64_t last_command_id = 0;      ///< Newest applied external paddle command (0 = none)
+    int64_t last_command_ns = 0;       ///< Sender timestamp of that command
+    int64_t input_ns = 0;              ///< Oldest input the last update reflects (steady ns, 0 = none); frames carry it to the display
 };
 
 /**
@@ -105,8 +91,28 @@ public:
      * @brief Construct a new GameCore object
      * 
      * Initializes the game state and resets all values to defaults.
+     * 
+     * @param arena Arena dimensions and sizing (defaults to the classic 80x24 field)
+     */
+    explicit GameCore(const ArenaConfig &arena = ArenaConfig{});
+    
+    /**
+     * @brief Change arena dimensions and reset the game
+     * 
+     * Auto-sized fields of the configuration (paddle sizes, obstacle
+     * count) are resolved against the new dimensions. Dynamic objects
+     * configured through apply_mode_config() must be re-applied afterwards.
+     * 
+     * @param arena New arena configuration
+     */
+    void set_arena(const ArenaConfig &arena);
+    
+    /**
+     * @brief Get the resolved arena configuration
+     * 
+     * @return const ArenaConfig& Arena configuration with all auto fields filled in
      */
-    GameCore();
+    const ArenaConfig& arena() const { return arena_cfg; }
     
     /**
      * @brief Reset the game to initial state
@@ -129,7 +135,24 @@ public:
      * 
      * @param dt Time delta in seconds since last update
      */
-    void update(double dt);
+    void update(double dt) { update(dt, nullptr, 0, 0); }
+
+    /**
+     * @brief Update for one frame, applying input at the substep it happened in
+     *
+     * The frame simulates [frame_start_ns, frame_start_ns + dt). Each
+     * command is applied at the start of the 1/240 s substep containing
+     * its sent_ns (earlier stamps go to the first substep, later ones to
+     * the last), so a key pressed late in a frame does not steer a bounce
+     * that happened earlier in it. Paddle velocity for spin is the input
+     * displacement over the last 1/60 s, tracked per substep.
+     *
+     * @param dt Time delta in seconds since last update
+     * @param inputs Commands sorted by sent_ns (may be nullptr when @p count is 0)
+     * @param count Number of commands
+     * @param frame_start_ns Steady-clock time the frame starts at, same clock as sent_ns
+     */
+    void update(double dt, const PaddleCommand *inputs, size_t count, int64_t frame_start_ns);
 
     /**
      * @brief Move left paddle relatively
@@ -208,19 +231,19 @@ public:
     void spawn_ball(double speed_scale = 1.0);
 
     /**
-     * @brief Access balls vector (read-only)
+     * @brief Access ball archetype (read-only)
      */
-    const std::vector<BallState>& balls() const { return s.balls; }
+    const Archetype& balls() const { return s.entities.balls(); }
 
     /**
-     * @brief Access obstacles vector (read-only)
+     * @brief Access obstacle archetype (read-only)
      */
-    const std::vector<Obstacle>& get_obstacles() const { return s.obstacles; }
+    const Archetype& get_obstacles() const { return s.entities.obstacles(); }
     
     /**
-     * @brief Access black holes vector (read-only)
+     * @brief Access black hole archetype (read-only)
      */
-    const std::vector<BlackHole>& get_blackholes() const { return s.blackholes; }
+    const Archetype& get_blackholes() const { return s.entities.blackholes(); }
     
     /**
      * @brief Spawn a black hole at specified position
@@ -231,8 +254,94 @@ public:
      */
     void spawn_blackhole(double x, double y, bool moving);
 
+    /**
+     * @brief Entity count from which independent systems run in parallel
+     * 
+     * Below the threshold every system runs on the calling thread; the
+     * worker pool costs more than it saves on small arenas.
+     * 
+     * @param n Minimum total entity count (0 = always parallel)
+     */
+    void set_parallel_threshold(size_t n) { parallel_threshold = n; }
+
+    /**
+     * @brief Drive paddles from an external command queue
+     * 
+     * The source is drained at the start of every substep. It is not
+     * owned and must outlive its registration (pass nullptr to detach).
+     * Disable the AI of paddles the source controls, otherwise both steer.
+     */
+    void set_command_source(PaddleCommandSource *src) { command_source = src; }
+
+    /**
+     * @brief Report paddle hits and points to @p sink
+     * 
+     * Not owned; must outlive its registration (pass nullptr to detach).
+     */
+    void set_event_sink(GameEventSink *sink) { event_sink = sink; }
+
+    /**
+     * @brief Note user input applied outside update() (move_left_by, set_left_y)
+     *
+     * The next update() reports the oldest such timestamp, together with
+     * the commands it applies, in GameState::input_ns.
+     *
+     * @param t_ns Steady-clock time the input was read
+     */
+    void mark_input(int64_t t_ns) { if (t_ns > 0 && (!pending_input_ns || t_ns < pending_input_ns)) pending_input_ns = t_ns; }
+
 private:
+    /**
+     * @brief Populate obstacles using the tiled reference layout
+     * 
+     * @param moving Whether obstacles get initial velocities
+     */
+    void spawn_obstacles(bool moving);
+
+    /// @brief Recreate the four paddle entities at their centred start positions
+    void reset_paddles();
+
+    /// @brief Copy paddle entity positions into the legacy scalar fields
+    void sync_paddle_mirrors();
+
+    /// @brief Arena limits for the generic systems
+    ArenaBounds bounds() const;
+
+    /// @brief Apply every pending command from command_source
+    void apply_paddle_commands();
+
+    /// @brief Move / place one paddle as @p cmd says (clamped to the arena); no mirror sync
+    void apply_paddle_command(const PaddleCommand &cmd);
+
+    /**
+     * @brief Per-archetype body pipeline for one substep
+     * 
+     * Gravity, integration, kind-specific post-integration rules and
+     * bounds. Touches only @p a (and reads gravity sources), so different
+     * archetypes run concurrently.
+     */
+    void step_bodies(Archetype &a, double step);
+
+    /// @brief Reset balls that crossed a black hole event horizon
+    void absorb_balls(Archetype &balls);
+
+    /// @brief Separate overlapping obstacles and exchange their velocities
+    void resolve_obstacle_pairs();
+
+    /// @brief Ball contacts with paddles, obstacles and ThreeEnemies edges (scores points)
+    void resolve_ball_contacts(double left_paddle_v, double right_paddle_v);
+
+    /// @brief Report one event to event_sink (which must be set)
+    void emit_event(GameEventKind kind, PaddleSide side, size_t ball, const Position &p, const Velocity &v, double offset);
+
+    /// @brief Elastic ball-ball collisions (multi-ball modes)
+    void resolve_ball_pairs();
+
+    /// @brief Run step_bodies() for every moving non-source archetype, in parallel when the world is large enough
+    void run_body_stage(double step);
+
     GameState s;                    ///< Current game state
+    ArenaConfig arena_cfg;          ///< Resolved arena configuration
     double vx, vy;                  ///< Legacy primary ball velocity (mirrors balls[0])
     double ai_speed = 1.0;          ///< AI difficulty multiplier
     bool left_ai_enabled = false;   ///< When true, left paddle is AI-controlled
@@ -254,8 +363,18 @@ private:
     
     /// @name Paddle Physics State
     /// @{
-    double prev_left_y = 0.0;       ///< Previous left paddle Y (for velocity calculation)
-    double prev_right_y = 0.0;      ///< Previous right paddle Y (for velocity calculation)
+    double prev_left_y = 0.0;       ///< Left paddle Y at the end of the last update (moves between frames count as input)
+    double prev_right_y = 0.0;      ///< Right paddle Y at the end of the last update
+    /// @brief Paddle velocity is input displacement over this much trailing time (one 60 Hz frame)
+    static constexpr double kPaddleVelocityWindow = 1.0 / 60.0;
+    /// @brief Input-driven paddle displacement per recent substep, newest last (for velocity)
+    struct PaddleTrail {
+        static constexpr int kSize = 64;
+        double step[kSize] = {};
+        double left[kSize] = {};
+        double right[kSize] = {};
+        int head = 0, count = 0;
+    } trail;
     /// @}
     
     /// @name Physics Tuning Parameters
@@ -264,6 +383,26 @@ private:
     double tangent_strength = 6.0;  ///< How much contact offset affects ball spin
     double paddle_influence = 1.5;  ///< How much paddle velocity transfers to ball
     /// @}
+    
+    /// @name Collision Broadphase
+    /// @{
+    SpatialGrid obstacle_grid;          ///< Obstacle boxes, rebuilt every substep
+    SpatialGrid ball_grid;              ///< Ball boxes for ball-ball pairs, rebuilt every substep
+    std::vector<uint32_t> grid_hits;    ///< Scratch buffer for ball grid queries
+    std::vector<uint32_t> obstacle_hits; ///< Scratch buffer for obstacle pair queries (obstacle job)
+    /// @}
+
+    /// @name System Scheduling
+    /// @{
+    size_t parallel_threshold = 4096;   ///< Entity count from which stages run on the worker pool
+    std::vector<Archetype*> stage_bodies;          ///< Archetypes processed by the body stage
+    std::vector<std::function<void()>> stage_jobs; ///< Job list when the body stage runs in parallel
+    /// @}
+
+    PaddleCommandSource *command_source = nullptr; ///< External paddle input (not owned)
+    GameEventSink *event_sink = nullptr;           ///< Hit / point listener (not owned)
+    double sim_time = 0.0;                         ///< Simulated seconds since reset(), for events
+    int64_t pending_input_ns = 0;                  ///< mark_input() stamps for the next update
 
 public:
     // AI enable/disable controls (used by UI/player mode)
@@ -275,4 +414,7 @@ public:
     bool is_physical() const { return physical_mode; }
     void set_speed_mode(bool on){ speed_mode = on; if(!on) low_vx_time = 0.0; }
     bool is_speed_mode() const { return speed_mode; }
+    // Broadphase diagnostics (used by benchmarks / stats overlays)
+    size_t broadphase_active_chunks() const { return obstacle_grid.active_chunks(); }
+    size_t broadphase_allocated_chunks() const { return obstacle_grid.allocated_chunks(); }
 };
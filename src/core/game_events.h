@@ -0,0 +1,45 @@
+/**
+ * @file game_events.h
+ * @brief Simulation events reported by GameCore to an optional sink
+ *
+ * Analysis tools (match telemetry, balancing runs) want to know what
+ * happened inside a frame, not only the state after it: which paddle hit
+ * which ball where, and who scored. GameCore reports these to a
+ * GameEventSink from the substep they happen in. Without a sink the cost
+ * is one pointer test per contact.
+ */
+
+#pragma once
+
+#include "entity_store.h"
+#include <cstdint>
+
+/// @brief What a GameEvent reports
+enum class GameEventKind : uint8_t {
+    PaddleHit = 1,  ///< A paddle returned a ball (velocity is the outgoing one)
+    Point = 2       ///< A ball left the field; side is the paddle that scored
+};
+
+/**
+ * @brief One simulation event
+ */
+struct GameEvent {
+    GameEventKind kind = GameEventKind::PaddleHit;
+    PaddleSide side = PaddleSide::Left;  ///< Hitting paddle, or scoring side for Point
+    uint32_t ball = 0;                   ///< Index in the ball archetype
+    double time = 0.0;                   ///< Simulated seconds since the last reset()
+    double x = 0.0, y = 0.0;             ///< Ball position at the contact (Point: where it left)
+    double vx = 0.0, vy = 0.0;           ///< Ball velocity after the contact (Point: before the serve)
+    double offset = 0.0;                 ///< PaddleHit: contact offset from the paddle centre, -1..1
+};
+
+/**
+ * @brief Receiver of simulation events
+ *
+ * Called on the thread that runs GameCore::update(), in simulation order.
+ */
+class GameEventSink {
+public:
+    virtual ~GameEventSink() = default;
+    virtual void on_event(const GameEvent &e) = 0;
+};
@@ -0,0 +1,50 @@
+/**
+ * @file paddle_command.h
+ * @brief Externally submitted paddle commands consumed by GameCore
+ *
+ * Besides the built-in AI, the keyboard and the mouse, paddles can be
+ * driven by a PaddleCommandSource (e.g. a shared-memory ring filled by a
+ * bot process). GameCore drains the source at the start of every substep,
+ * so a command takes effect at most one substep (1/240 s) of simulated
+ * time after the frame that follows its submission. Frontends can also
+ * pass a frame's commands straight to GameCore::update, which applies
+ * each at the substep matching its sent_ns.
+ */
+
+#pragma once
+
+#include "entity_store.h"
+#include <cstdint>
+
+/// @brief How PaddleCommand::value is interpreted
+enum class PaddleCommandKind : uint8_t {
+    SetCentre = 0,  ///< Move the paddle centre to value (Y for left/right, X for top/bottom)
+    MoveBy = 1      ///< Move the paddle by value units along its axis
+};
+
+/**
+ * @brief One timestamped paddle command
+ */
+struct PaddleCommand {
+    uint64_t id = 0;                                   ///< Sender-assigned, increasing (0 = local input, not echoed)
+    int64_t sent_ns = 0;                               ///< Sender timestamp (steady clock)
+    PaddleSide side = PaddleSide::Right;
+    PaddleCommandKind kind = PaddleCommandKind::SetCentre;
+    double value = 0.0;
+};
+
+/**
+ * @brief Queue of pending commands polled by GameCore
+ */
+class PaddleCommandSource {
+public:
+    virtual ~PaddleCommandSource() = default;
+
+    /**
+     * @brief Pop the oldest pending command
+     *
+     * @param cmd Receives the command
+     * @return false when no command is pending
+     */
+    virtual bool next(PaddleCommand &cmd) = 0;
+};
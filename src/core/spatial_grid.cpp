@@ -0,0 +1,94 @@
+/**
+ * @file spatial_grid.cpp
+ * @brief Implementation of the sparse chunked spatial grid
+ */
+
+#include "spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(double chunk_size) { set_chunk_size(chunk_size); }
+
+void SpatialGrid::set_chunk_size(double chunk_size) {
+    size = std::max(1.0, chunk_size);
+    inv_size = 1.0 / size;
+    slots.clear();
+    chunks.clear();
+    active.clear();
+    stamp = 1;
+}
+
+void SpatialGrid::clear() {
+    ++stamp;
+    if (stamp == 0) {
+        // Generation counter wrapped: invalidate every chunk explicitly
+        for (auto &c : chunks) c.stamp = 0;
+        stamp = 1;
+    }
+    active.clear();
+}
+
+int32_t SpatialGrid::cell(double v) const {
+    double c = std::floor(v * inv_size);
+    if (c < -2147483000.0) c = -2147483000.0;
+    if (c > 2147483000.0) c = 2147483000.0;
+    return (int32_t)c;
+}
+
+void SpatialGrid::insert(uint32_t id, double minx, double miny, double maxx, double maxy) {
+    Entry e{ id, (float)minx, (float)miny, (float)maxx, (float)maxy };
+    int32_t x0 = cell(minx), x1 = cell(maxx);
+    int32_t y0 = cell(miny), y1 = cell(maxy);
+    for (int32_t cy = y0; cy <= y1; ++cy) {
+        for (int32_t cx = x0; cx <= x1; ++cx) {
+            auto it = slots.find(key(cx, cy));
+            uint32_t slot;
+            if (it == slots.end()) {
+                slot = (uint32_t)chunks.size();
+                chunks.emplace_back();
+                slots.emplace(key(cx, cy), slot);
+            } else {
+                slot = it->second;
+            }
+            Chunk &c = chunks[slot];
+            if (c.stamp != stamp) {
+                c.stamp = stamp;
+                c.entries.clear();
+                active.push_back(slot);
+            }
+            c.entries.push_back(e);
+        }
+    }
+}
+
+void SpatialGrid::query(double minx, double miny, double maxx, double maxy, std::vector<uint32_t> &out) const {
+    out.clear();
+    if (active.empty()) return;
+    float qx0 = (float)minx, qy0 = (float)miny, qx1 = (float)maxx, qy1 = (float)maxy;
+    auto collect = [&](const Chunk &c) {
+        for (const Entry &e : c.entries) {
+            if (e.minx <= qx1 && e.maxx >= qx0 && e.miny <= qy1 && e.maxy >= qy0) out.push_back(e.id);
+        }
+    };
+    int32_t x0 = cell(minx), x1 = cell(maxx);
+    int32_t y0 = cell(miny), y1 = cell(maxy);
+    double span = ((double)x1 - x0 + 1.0) * ((double)y1 - y0 + 1.0);
+    if (span > (double)active.size()) {
+        // Query box covers more chunks than are live: scan live chunks instead of area
+        for (uint32_t slot : active) collect(chunks[slot]);
+    } else {
+        for (int32_t cy = y0; cy <= y1; ++cy) {
+            for (int32_t cx = x0; cx <= x1; ++cx) {
+                auto it = slots.find(key(cx, cy));
+                if (it == slots.end()) continue;
+                const Chunk &c = chunks[it->second];
+                if (c.stamp != stamp) continue;
+                collect(c);
+            }
+        }
+    }
+    if (out.size() > 1) {
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * @file spatial_grid.h
+ * @brief Sparse chunked spatial partitioning for collision broadphase
+ *
+ * This file defines the SpatialGrid class used by GameCore to find
+ * candidate collision pairs without testing every entity against every
+ * other one, and without allocating storage for empty parts of the arena.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Sparse grid of fixed-size chunks holding entity bounding boxes
+ *
+ * The arena is divided into square chunks, but only chunks that actually
+ * contain an entity are materialized. Chunks are looked up through a hash
+ * map and recycled between frames using a generation stamp, so:
+ * - clear() is O(1) regardless of arena size
+ * - insert() is O(chunks overlapped by the box)
+ * - query() is O(chunks overlapped + entries found), falling back to the
+ *   list of live chunks when the query box would span more chunks than exist
+ *
+ * Per-tick cost therefore tracks the number of active entities rather than
+ * the area of the arena. Entity ids are caller-defined (typically indices
+ * into a vector) and query results are returned sorted and de-duplicated so
+ * callers can resolve collisions in a deterministic order.
+ */
+class SpatialGrid {
+public:
+    /**
+     * @brief Construct a grid with the given chunk edge length
+     *
+     * @param chunk_size Chunk edge length in game units (clamped to >= 1)
+     */
+    explicit SpatialGrid(double chunk_size = 16.0);
+
+    /**
+     * @brief Change the chunk edge length
+     *
+     * Drops all materialized chunks; the grid must be refilled afterwards.
+     *
+     * @param chunk_size Chunk edge length in game units (clamped to >= 1)
+     */
+    void set_chunk_size(double chunk_size);
+
+    /// @brief Chunk edge length in game units
+    double chunk_size() const { return size; }
+
+    /**
+     * @brief Remove all entries (O(1), chunk storage is kept for reuse)
+     */
+    void clear();
+
+    /**
+     * @brief Insert an entity bounding box
+     *
+     * @param id Caller-defined entity id
+     * @param minx Box minimum X
+     * @param miny Box minimum Y
+     * @param maxx Box maximum X
+     * @param maxy Box maximum Y
+     */
+    void insert(uint32_t id, double minx, double miny, double maxx, double maxy);
+
+    /**
+     * @brief Collect ids of all entries whose boxes overlap the query box
+     *
+     * @param minx Query minimum X
+     * @param miny Query minimum Y
+     * @param maxx Query maximum X
+     * @param maxy Query maximum Y
+     * @param out Receives matching ids, sorted ascending without duplicates (cleared first)
+     */
+    void query(double minx, double miny, double maxx, double maxy, std::vector<uint32_t> &out) const;
+
+    /// @brief Number of chunks holding at least one entry since the last clear()
+    size_t active_chunks() const { return active.size(); }
+
+    /// @brief Number of chunks ever materialized (storage footprint)
+    size_t allocated_chunks() const { return chunks.size(); }
+
+private:
+    struct Entry {
+        uint32_t id;
+        float minx, miny, maxx, maxy;
+    };
+    struct Chunk {
+        uint32_t stamp = 0;          ///< Generation in which entries were last valid
+        std::vector<Entry> entries;  ///< Boxes overlapping this chunk
+    };
+
+    static uint64_t key(int32_t cx, int32_t cy) {
+        return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+    }
+    int32_t cell(double v) const;
+
+    double size = 16.0;                             ///< Chunk edge length
+    double inv_size = 1.0 / 16.0;                   ///< Reciprocal of chunk edge length
+    uint32_t stamp = 1;                             ///< Current generation
+    std::unordered_map<uint64_t, uint32_t> slots;   ///< Chunk coordinate -> index into chunks
+    std::vector<Chunk> chunks;                      ///< Chunk storage (recycled across clears)
+    std::vector<uint32_t> active;                   ///< Chunks written in the current generation
+};
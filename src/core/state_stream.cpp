@@ -0,0 +1,140 @@
+/**
+ * @file state_stream.cpp
+ * @brief GameState stream serialization
+ */
+
+#include "state_stream.h"
+#include <cstring>
+#include <iterator>
+
+namespace {
+
+constexpr char kMagic[8] = { 'P', 'O', 'N', 'G', 'G', 'S', '0', '1' };
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeader = 16;
+
+template <class T>
+void put(std::vector<uint8_t> &b, T v) {
+    const size_t n = b.size();
+    b.resize(n + sizeof(T));
+    std::memcpy(b.data() + n, &v, sizeof(T));
+}
+
+/// Bounds-checked cursor over one record
+struct Cursor {
+    const uint8_t *p, *end;
+    template <class T>
+    bool get(T &v) {
+        if ((size_t)(end - p) < sizeof(T)) return false;
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+};
+
+} // namespace
+
+bool StateStreamWriter::open(const std::filesystem::path &path, int fps, std::string &err) {
+    close();
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) { err = path.string() + ": cannot create"; return false; }
+    std::vector<uint8_t> h(kMagic, kMagic + sizeof(kMagic));
+    put<uint32_t>(h, kVersion);
+    put<uint32_t>(h, (uint32_t)fps);
+    out.write(reinterpret_cast<const char *>(h.data()), (std::streamsize)h.size());
+    count = 0;
+    return (bool)out;
+}
+
+bool StateStreamWriter::write(const GameState &gs) {
+    if (!out.is_open()) return false;
+    record.clear();
+    put<uint32_t>(record, 0);  // length, patched below
+    for (int v : { gs.gw, gs.gh, gs.paddle_h, gs.paddle_w, gs.score_left, gs.score_right, (int)gs.mode })
+        put<int32_t>(record, v);
+    for (double v : { gs.left_y, gs.right_y, gs.ball_x, gs.ball_y, gs.top_x, gs.bottom_x })
+        put<double>(record, v);
+    put<uint32_t>(record, kBuiltinArchetypeCount);
+    for (ArchetypeId id = 0; id < kBuiltinArchetypeCount; ++id) {
+        const Archetype &a = gs.entities.archetype(id);
+        const bool vel = a.has(Component::Velocity), shape = a.has(Component::Shape);
+        put<uint32_t>(record, (uint32_t)a.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            put<double>(record, a.position[i].x);
+            put<double>(record, a.position[i].y);
+            put<double>(record, vel ? a.velocity[i].vx : 0.0);
+            put<double>(record, vel ? a.velocity[i].vy : 0.0);
+            const Shape s = shape ? a.shape[i] : Shape{};
+            put<uint32_t>(record, (uint32_t)s.kind);
+            put<double>(record, s.w);
+            put<double>(record, s.h);
+        }
+    }
+    const uint32_t bytes = (uint32_t)(record.size() - sizeof(uint32_t));
+    std::memcpy(record.data(), &bytes, sizeof(bytes));
+    out.write(reinterpret_cast<const char *>(record.data()), (std::streamsize)record.size());
+    ++count;
+    return (bool)out;
+}
+
+void StateStreamWriter::close() {
+    if (out.is_open()) out.close();
+}
+
+bool StateStreamReader::open(const std::filesystem::path &path, std::string &err) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) { err = path.string() + ": cannot open"; return false; }
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    offsets.clear();
+    lengths.clear();
+    uint32_t version = 0, fps = 0;
+    if (data.size() < kHeader || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+        err = path.string() + ": not a GameState stream";
+        return false;
+    }
+    std::memcpy(&version, data.data() + 8, 4);
+    std::memcpy(&fps, data.data() + 12, 4);
+    if (version != kVersion) { err = path.string() + ": unsupported version " + std::to_string(version); return false; }
+    rate = fps ? (int)fps : 60;
+    // A recording cut off mid-record keeps every complete frame before it
+    size_t p = kHeader;
+    while (data.size() - p >= sizeof(uint32_t)) {
+        uint32_t bytes;
+        std::memcpy(&bytes, data.data() + p, sizeof(bytes));
+        if (data.size() - p - sizeof(bytes) < bytes) break;
+        offsets.push_back(p + sizeof(bytes));
+        lengths.push_back(bytes);
+        p += sizeof(bytes) + bytes;
+    }
+    return true;
+}
+
+bool StateStreamReader::load(size_t i, GameState &gs) const {
+    if (i >= offsets.size()) return false;
+    Cursor c{ data.data() + offsets[i], data.data() + offsets[i] + lengths[i] };
+    int32_t ints[7];
+    for (int32_t &v : ints) if (!c.get(v)) return false;
+    gs.gw = ints[0]; gs.gh = ints[1]; gs.paddle_h = ints[2]; gs.paddle_w = ints[3];
+    gs.score_left = ints[4]; gs.score_right = ints[5]; gs.mode = (GameMode)ints[6];
+    for (double *v : { &gs.left_y, &gs.right_y, &gs.ball_x, &gs.ball_y, &gs.top_x, &gs.bottom_x })
+        if (!c.get(*v)) return false;
+    uint32_t archetypes = 0;
+    if (!c.get(archetypes)) return false;
+    for (uint32_t id = 0; id < archetypes; ++id) {
+        uint32_t n = 0;
+        if (!c.get(n)) return false;
+        Archetype *a = id < kBuiltinArchetypeCount ? &gs.entities.archetype(id) : nullptr;
+        if (a) a->clear();
+        for (uint32_t k = 0; k < n; ++k) {
+            EntityInit e;
+            uint32_t kind = 0;
+            if (!c.get(e.position.x) || !c.get(e.position.y) || !c.get(e.velocity.vx) || !c.get(e.velocity.vy) ||
+                !c.get(kind) || !c.get(e.shape.w) || !c.get(e.shape.h))
+                return false;
+            e.shape.kind = (ShapeKind)kind;
+            e.spawn = SpawnPoint{ e.position.x, e.position.y };
+            if (a) a->add(e);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file state_stream.h
+ * @brief Recorded GameState stream for offline re-rendering
+ *
+ * A recording that keeps the per-frame GameState instead of (or next to)
+ * the rendered pixels can be drawn again later at any resolution and
+ * quality (pong_rerender). The file is a 16-byte header followed by one
+ * length-prefixed record per frame:
+ *
+ *     "PONGGS01" | u32 version | u32 fps
+ *     u32 bytes | scalar fields | per built-in archetype: u32 count, entities
+ *
+ * Each entity keeps position, velocity and shape, which is what the
+ * renderers read; AI and gravity parameters are not stored, so a loaded
+ * state can be drawn but not simulated further. Values are stored in
+ * host byte order (little endian on every supported target).
+ */
+#pragma once
+
+#include "game_core.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Appends one record per frame; every write goes out through an ofstream buffer
+ */
+class StateStreamWriter {
+public:
+    bool open(const std::filesystem::path &path, int fps, std::string &err);
+    /// @brief Append @p gs as the next frame
+    bool write(const GameState &gs);
+    void close();
+    bool is_open() const { return out.is_open(); }
+    uint64_t frames() const { return count; }
+
+private:
+    std::ofstream out;
+    std::vector<uint8_t> record;  ///< Reused serialization buffer
+    uint64_t count = 0;
+};
+
+/**
+ * @brief Whole stream in memory with random access, so frames can be drawn in any order
+ */
+class StateStreamReader {
+public:
+    bool open(const std::filesystem::path &path, std::string &err);
+    size_t size() const { return offsets.size(); }
+    int fps() const { return rate; }
+    /// @brief Restore frame @p i into @p gs (entities replaced, other fields overwritten); false if the record is damaged
+    bool load(size_t i, GameState &gs) const;
+
+private:
+    std::vector<uint8_t> data;
+    std::vector<size_t> offsets;  ///< Start of each record's payload
+    std::vector<uint32_t> lengths;
+    int rate = 60;
+};
@@ -0,0 +1,87 @@
+/**
+ * @file system_scheduler.cpp
+ * @brief Implementation of the shared system worker pool
+ */
+
+#include "system_scheduler.h"
+
+SystemScheduler &SystemScheduler::shared() {
+    static SystemScheduler instance;
+    return instance;
+}
+
+SystemScheduler::~SystemScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &t : workers) if (t.joinable()) t.join();
+}
+
+void SystemScheduler::start() {
+    unsigned hw = std::thread::hardware_concurrency();
+    unsigned n = hw > 1 ? hw - 1 : 0;
+    workers.reserve(n);
+    for (unsigned i = 0; i < n; ++i) workers.emplace_back([this] { worker_loop(); });
+}
+
+void SystemScheduler::finish(Batch &b) {
+    // Decrement under the lock: the submitter may destroy the batch as soon
+    // as it observes zero, so nothing may touch it after the unlock
+    std::lock_guard<std::mutex> lock(b.mtx);
+    if (--b.remaining == 0) b.done.notify_all();
+}
+
+bool SystemScheduler::try_run_one() {
+    Task t;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (queue.empty()) return false;
+        t = queue.front();
+        queue.pop_front();
+    }
+    (*t.job)();
+    finish(*t.batch);
+    return true;
+}
+
+void SystemScheduler::worker_loop() {
+    for (;;) {
+        Task t;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping && queue.empty()) return;
+            t = queue.front();
+            queue.pop_front();
+        }
+        (*t.job)();
+        finish(*t.batch);
+    }
+}
+
+void SystemScheduler::run(const std::vector<Job> &jobs) {
+    if (jobs.empty()) return;
+    std::call_once(started, [this] { start(); });
+    if (jobs.size() == 1 || workers.empty()) {
+        for (const Job &j : jobs) j();
+        return;
+    }
+
+    Batch batch;
+    batch.remaining = jobs.size();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (size_t i = 1; i < jobs.size(); ++i) queue.push_back({ &jobs[i], &batch });
+    }
+    wake.notify_all();
+
+    jobs[0]();
+    finish(batch);
+
+    // Help with queued work (ours or another submitter's) until our batch is done
+    while (try_run_one()) {}
+    std::unique_lock<std::mutex> lock(batch.mtx);
+    batch.done.wait(lock, [&] { return batch.remaining == 0; });
+}
@@ -0,0 +1,71 @@
+/**
+ * @file system_scheduler.h
+ * @brief Runs independent simulation systems concurrently
+ *
+ * A process-wide pool of worker threads, started on first use. The
+ * calling thread always takes part in executing its own batch, so a
+ * batch never waits for an idle worker and several GameCore instances
+ * (e.g. one per server match) can submit from different threads.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Shared worker pool for parallel system stages
+ */
+class SystemScheduler {
+public:
+    using Job = std::function<void()>;
+
+    /// @brief Process-wide scheduler instance
+    static SystemScheduler &shared();
+
+    ~SystemScheduler();
+    SystemScheduler(const SystemScheduler &) = delete;
+    SystemScheduler &operator=(const SystemScheduler &) = delete;
+
+    /**
+     * @brief Run jobs concurrently and wait for all of them
+     *
+     * Jobs of one batch must not touch the same data. Runs inline when
+     * the batch has a single job or the machine has a single core.
+     *
+     * @param jobs Jobs to execute
+     */
+    void run(const std::vector<Job> &jobs);
+
+    /// @brief Number of worker threads (0 until the first parallel batch)
+    unsigned worker_count() const { return (unsigned)workers.size(); }
+
+private:
+    SystemScheduler() = default;
+
+    struct Batch {
+        size_t remaining = 0;  ///< Guarded by mtx
+        std::mutex mtx;
+        std::condition_variable done;
+    };
+    struct Task {
+        const Job *job;
+        Batch *batch;
+    };
+
+    void start();
+    void worker_loop();
+    bool try_run_one();
+    static void finish(Batch &b);
+
+    std::mutex mtx;
+    std::condition_variable wake;
+    std::deque<Task> queue;
+    std::vector<std::thread> workers;
+    std::once_flag started;
+    bool stopping = false;
+};
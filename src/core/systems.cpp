@@ -0,0 +1,126 @@
+/**
+ * @file systems.cpp
+ * @brief Implementation of the generic simulation systems
+ */
+
+#include "systems.h"
+#include "black_hole.h"
+#include <algorithm>
+#include <cmath>
+
+void gravity_system(Archetype &bodies, const EntityStore &store, double step) {
+    const double scale = bodies.gravity_scale();
+    if (scale == 0.0 || !bodies.has(Component::Position | Component::Velocity)) return;
+    const size_t n = bodies.size();
+    Position *pos = bodies.position.data();
+    Velocity *vel = bodies.velocity.data();
+    for (size_t i = 0; i < n; ++i) {
+        store.each(Component::Position | Component::GravitySource, [&](const Archetype &src) {
+            for (size_t k = 0; k < src.size(); ++k) {
+                double fx, fy;
+                gravity_force(src.position[k], src.gravity[k], pos[i].x, pos[i].y, fx, fy);
+                // Apply force as acceleration (F = ma, assuming unit mass)
+                vel[i].vx += fx * step * scale;
+                vel[i].vy += fy * step * scale;
+            }
+        });
+    }
+}
+
+void integrate_system(Archetype &a, double step) {
+    const size_t n = a.size();
+    Position *pos = a.position.data();
+    const Velocity *vel = a.velocity.data();
+    for (size_t i = 0; i < n; ++i) {
+        pos[i].x += vel[i].vx * step;
+        pos[i].y += vel[i].vy * step;
+    }
+}
+
+void bounds_system(Archetype &a, const ArenaBounds &arena) {
+    const size_t n = a.size();
+    Position *pos = a.position.data();
+    Velocity *vel = a.velocity.data();
+    switch (a.bounds()) {
+    case BoundsPolicy::None:
+        break;
+    case BoundsPolicy::ReflectInset: {
+        // Flip direction once the extent leaves the inset rectangle (no clamping)
+        const Shape *shp = a.shape.data();
+        const double ix = a.inset_x(), iy = a.inset_y();
+        for (size_t i = 0; i < n; ++i) {
+            if (pos[i].x - shp[i].w/2 < ix || pos[i].x + shp[i].w/2 > arena.w - ix) vel[i].vx = -vel[i].vx;
+            if (pos[i].y - shp[i].h/2 < iy || pos[i].y + shp[i].h/2 > arena.h - iy) vel[i].vy = -vel[i].vy;
+        }
+        break;
+    }
+    case BoundsPolicy::ClampReflect: {
+        // Bodies at rest (static black holes) are left where they were placed
+        const Shape *shp = a.shape.data();
+        for (size_t i = 0; i < n; ++i) {
+            if (vel[i].vx == 0.0 && vel[i].vy == 0.0) continue;
+            double mx = shp[i].radius() + a.inset_x();
+            double my = shp[i].radius() + a.inset_y();
+            if (pos[i].x < mx) {
+                pos[i].x = mx;
+                vel[i].vx = std::abs(vel[i].vx);
+            } else if (pos[i].x > arena.w - mx) {
+                pos[i].x = arena.w - mx;
+                vel[i].vx = -std::abs(vel[i].vx);
+            }
+            if (pos[i].y < my) {
+                pos[i].y = my;
+                vel[i].vy = std::abs(vel[i].vy);
+            } else if (pos[i].y > arena.h - my) {
+                pos[i].y = arena.h - my;
+                vel[i].vy = -std::abs(vel[i].vy);
+            }
+        }
+        break;
+    }
+    case BoundsPolicy::BallWalls:
+        if (!arena.ball_walls) break;
+        for (size_t i = 0; i < n; ++i) {
+            if (pos[i].y < 0) { pos[i].y = 0; vel[i].vy = -vel[i].vy; }
+            if (pos[i].y > arena.h-1) { pos[i].y = arena.h-1; vel[i].vy = -vel[i].vy; }
+        }
+        break;
+    }
+}
+
+void ai_system(Archetype &controlled, const Archetype &balls, const Position &fallback,
+               const ArenaBounds &arena, double difficulty, double dt) {
+    const size_t n = controlled.size();
+    const size_t nb = balls.size();
+    for (size_t i = 0; i < n; ++i) {
+        const AIController &ai = controlled.ai[i];
+        Position &p = controlled.position[i];
+        const Shape &sh = controlled.shape[i];
+        const bool vertical = ai.side == PaddleSide::Left || ai.side == PaddleSide::Right;
+
+        if (ai.enabled) {
+            // Track closest ball moving toward the defended side
+            double target = vertical ? fallback.y : fallback.x;
+            double best = 1e9;
+            for (size_t k = 0; k < nb; ++k) {
+                const Position &b = balls.position[k];
+                const Velocity &v = balls.velocity[k];
+                double d;
+                switch (ai.side) {
+                case PaddleSide::Left:   if (!(v.vx < 0)) continue; d = b.x; break;
+                case PaddleSide::Right:  if (!(v.vx > 0)) continue; d = arena.w - b.x; break;
+                case PaddleSide::Top:    if (!(v.vy < 0)) continue; d = std::fabs(b.y - 1.0); break;
+                default:                 if (!(v.vy > 0)) continue; d = std::fabs(b.y - (arena.h - 2.0)); break;
+                }
+                if (d < best) { best = d; target = vertical ? b.y : b.x; }
+            }
+            double max_speed = ai.speed * (ai.difficulty_scaled ? difficulty : 1.0) * dt;
+            double &axis = vertical ? p.y : p.x;
+            axis += std::clamp(target - axis, -max_speed, max_speed);
+        }
+
+        // Keep on the rail
+        if (vertical) p.y = std::clamp(p.y, sh.h/2.0, arena.h - sh.h/2.0);
+        else p.x = std::clamp(p.x, sh.w/2.0, arena.w - sh.w/2.0);
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ * @file systems.h
+ * @brief Generic simulation systems over EntityStore archetypes
+ *
+ * Each system touches only the component columns it names and works on
+ * any archetype that stores them, so entity types registered after the
+ * fact are simulated without changes to GameCore::update(). Rules that
+ * are specific to one kind of entity (scoring, paddle contacts, obstacle
+ * stacking) stay in GameCore.
+ */
+
+#pragma once
+
+#include "entity_store.h"
+
+/**
+ * @brief Arena limits passed to the bounds and AI systems
+ */
+struct ArenaBounds {
+    int w = 80;              ///< Arena width
+    int h = 24;              ///< Arena height
+    bool ball_walls = true;  ///< Balls reflect off top/bottom walls (false in ThreeEnemies)
+};
+
+/**
+ * @brief Accelerate bodies towards every gravity source in the store
+ *
+ * Reads Position + GravitySource of source archetypes and writes the
+ * Velocity of @p bodies, scaled by the archetype's gravity_scale().
+ * No-op when the scale is zero.
+ *
+ * @param bodies Archetype receiving the pull (Position + Velocity)
+ * @param store Store providing the gravity sources
+ * @param step Substep length in seconds
+ */
+void gravity_system(Archetype &bodies, const EntityStore &store, double step);
+
+/**
+ * @brief Explicit Euler integration of Position by Velocity
+ *
+ * @param a Archetype with Position + Velocity
+ * @param step Substep length in seconds
+ */
+void integrate_system(Archetype &a, double step);
+
+/**
+ * @brief Keep an archetype inside the arena according to its BoundsPolicy
+ *
+ * @param a Archetype with Position + Velocity (+ Shape for extent-based policies)
+ * @param arena Arena limits
+ */
+void bounds_system(Archetype &a, const ArenaBounds &arena);
+
+/**
+ * @brief Steer AI-controlled entities towards approaching balls
+ *
+ * Every entity with an enabled AIController tracks the closest ball
+ * heading towards its side, limited to its tracking speed; all
+ * controlled entities are then kept on their rail inside the arena.
+ *
+ * @param controlled Archetype with Position + Shape + AIController
+ * @param balls Ball archetype (Position + Velocity)
+ * @param fallback Target used when no ball approaches (primary ball position)
+ * @param arena Arena limits
+ * @param difficulty Speed multiplier for difficulty-scaled controllers
+ * @param dt Frame time in seconds
+ */
+void ai_system(Archetype &controlled, const Archetype &balls, const Position &fallback,
+               const ArenaBounds &arena, double difficulty, double dt);
@@ -0,0 +1,37 @@
+/**
+ * @file time_histogram.cpp
+ * @brief Implementation of TimeHistogram
+ */
+
+#include "time_histogram.h"
+#include <algorithm>
+
+TimeHistogram::TimeHistogram(int bin_width_us, int nbins)
+: bin_us(std::max(bin_width_us, 1)), bins((size_t)std::max(nbins, 1), 0) {}
+
+void TimeHistogram::add_ms(double ms) {
+    ms = std::max(ms, 0.0);
+    const double b = ms * 1000.0 / bin_us;
+    const size_t i = b >= (double)(bins.size() - 1) ? bins.size() - 1 : (size_t)b;
+    ++bins[i];
+    ++n;
+    sum_ms += ms;
+    max = std::max(max, ms);
+}
+
+void TimeHistogram::clear() {
+    std::fill(bins.begin(), bins.end(), 0u);
+    n = 0;
+    sum_ms = max = 0.0;
+}
+
+double TimeHistogram::percentile_ms(double p) const {
+    if (!n) return 0.0;
+    const uint64_t rank = (uint64_t)(std::clamp(p, 0.0, 1.0) * (double)(n - 1));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bins.size(); ++i) {
+        seen += bins[i];
+        if (seen > rank) return std::min((i + 0.5) * bin_us / 1000.0, max);
+    }
+    return max;
+}
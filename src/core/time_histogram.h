@@ -0,0 +1,37 @@
+/**
+ * @file time_histogram.h
+ * @brief Fixed-bin histogram of durations (frame times, latencies)
+ *
+ * Constant memory and O(1) insertion, so it can sit in a frame loop for
+ * the whole session; percentiles are resolved to the bin width.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class TimeHistogram {
+public:
+    /**
+     * @param bin_us Bin width in microseconds
+     * @param bins Number of bins; durations past the last one land in it (max_ms stays exact)
+     */
+    explicit TimeHistogram(int bin_us = 50, int bins = 4000);
+
+    void add_ms(double ms);
+    void add_ns(int64_t ns) { add_ms((double)ns / 1e6); }
+    void clear();
+
+    uint64_t count() const { return n; }
+    double mean_ms() const { return n ? sum_ms / (double)n : 0.0; }
+    double max_ms() const { return max; }
+    /// @brief Duration below which a fraction @p p of the samples fall (bin centre)
+    double percentile_ms(double p) const;
+
+private:
+    int bin_us;
+    std::vector<uint32_t> bins;
+    uint64_t n = 0;
+    double sum_ms = 0.0, max = 0.0;
+};
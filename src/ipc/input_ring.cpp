@@ -0,0 +1,129 @@
+/**
+ * @file input_ring.cpp
+ * @brief POSIX shared-memory implementation of the bot input ring
+ */
+
+#include "ipc/input_ring.h"
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert((kInputRingCapacity & (kInputRingCapacity - 1)) == 0, "ring capacity must be a power of two");
+
+InputRingReader::~InputRingReader() { close(); }
+
+bool InputRingReader::create(const std::string &name, std::string &err) {
+    close();
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) { err = "shm_open " + name + ": " + std::strerror(errno); return false; }
+    if (ftruncate(fd, sizeof(InputRingSegment)) != 0) {
+        err = std::string("ftruncate: ") + std::strerror(errno);
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void *p = mmap(nullptr, sizeof(InputRingSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        err = std::string("mmap: ") + std::strerror(errno);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    seg = static_cast<InputRingSegment *>(p);
+    new (&seg->magic) std::atomic<uint32_t>(0);
+    new (&seg->head) std::atomic<uint64_t>(0);
+    new (&seg->tail) std::atomic<uint64_t>(0);
+    seg->capacity = kInputRingCapacity;
+    seg->version = kInputRingVersion;
+    seg->reader_pid = (uint32_t)getpid();
+    seg->magic.store(kInputRingMagic, std::memory_order_release);
+    shm_name = name;
+    tail = head_cache = 0;
+    return true;
+}
+
+void InputRingReader::close() {
+    if (!seg) return;
+    munmap(seg, sizeof(InputRingSegment));
+    shm_unlink(shm_name.c_str());
+    seg = nullptr;
+}
+
+bool InputRingReader::next(PaddleCommand &cmd) {
+    if (!seg) return false;
+    if (tail == head_cache) {
+        head_cache = seg->head.load(std::memory_order_acquire);
+        if (tail == head_cache) return false;
+    }
+    const SharedPaddleCommand &slot = seg->slots[tail & (kInputRingCapacity - 1)];
+    cmd.id = slot.id;
+    cmd.sent_ns = slot.sent_ns;
+    cmd.side = (PaddleSide)(slot.side & 3);
+    cmd.kind = slot.kind == (uint32_t)PaddleCommandKind::MoveBy ? PaddleCommandKind::MoveBy : PaddleCommandKind::SetCentre;
+    cmd.value = slot.value;
+    seg->tail.store(++tail, std::memory_order_release);
+    return true;
+}
+
+InputRingWriter::~InputRingWriter() { close(); }
+
+bool InputRingWriter::open(const std::string &name, std::string &err) {
+    close();
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) { err = "shm_open " + name + ": " + std::strerror(errno); return false; }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(InputRingSegment)) {
+        err = "segment " + name + " is too small (game not ready or different layout)";
+        ::close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, sizeof(InputRingSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) { err = std::string("mmap: ") + std::strerror(errno); return false; }
+    InputRingSegment *s = static_cast<InputRingSegment *>(p);
+    if (s->magic.load(std::memory_order_acquire) != kInputRingMagic || s->version != kInputRingVersion || s->capacity != kInputRingCapacity) {
+        err = "segment " + name + " has an incompatible layout";
+        munmap(p, sizeof(InputRingSegment));
+        return false;
+    }
+    seg = s;
+    // Resume after whatever a previous producer left behind (acquire: last_id() reads its final slot)
+    head = seg->head.load(std::memory_order_acquire);
+    tail_cache = seg->tail.load(std::memory_order_acquire);
+    return true;
+}
+
+void InputRingWriter::close() {
+    if (!seg) return;
+    munmap(seg, sizeof(InputRingSegment));
+    seg = nullptr;
+}
+
+bool InputRingWriter::push(const PaddleCommand &cmd) {
+    if (!seg) return false;
+    if (head - tail_cache == kInputRingCapacity) {
+        tail_cache = seg->tail.load(std::memory_order_acquire);
+        if (head - tail_cache == kInputRingCapacity) return false;
+    }
+    SharedPaddleCommand &slot = seg->slots[head & (kInputRingCapacity - 1)];
+    slot.id = cmd.id;
+    slot.sent_ns = cmd.sent_ns;
+    slot.side = (uint32_t)cmd.side;
+    slot.kind = (uint32_t)cmd.kind;
+    slot.value = cmd.value;
+    seg->head.store(++head, std::memory_order_release);
+    return true;
+}
+
+uint64_t InputRingWriter::last_id() const {
+    if (!seg || head == 0) return 0;
+    return seg->slots[(head - 1) & (kInputRingCapacity - 1)].id;
+}
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * @file input_ring.h
+ * @brief Shared-memory SPSC ring carrying bot paddle commands into GameCore
+ *
+ * The game process creates the segment and is the only consumer
+ * (InputRingReader, a PaddleCommandSource drained once per substep).
+ * One bot process opens it and is the only producer (InputRingWriter).
+ * head and tail are free-running 64-bit counters on separate cache
+ * lines; each side caches the other's counter and only reloads it when
+ * the ring looks full (producer) or empty (consumer), so the steady state
+ * touches no shared cache line besides the slot itself. POSIX only.
+ */
+
+#pragma once
+
+#include "core/paddle_command.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// @brief Segment name used when none is given
+constexpr const char *kInputRingDefaultName = "/pong_input";
+
+constexpr uint32_t kInputRingMagic = 0x50494E50;   ///< 'PINP'
+constexpr uint32_t kInputRingVersion = 1;
+constexpr uint32_t kInputRingCapacity = 1024;       ///< Slots (power of two)
+
+/// @brief Slot layout of a PaddleCommand
+struct SharedPaddleCommand {
+    uint64_t id;
+    int64_t sent_ns;
+    uint32_t side;    ///< PaddleSide
+    uint32_t kind;    ///< PaddleCommandKind
+    double value;
+};
+
+/// @brief Complete ring segment
+struct InputRingSegment {
+    std::atomic<uint32_t> magic;              ///< Stored last (release) by the game, loaded first (acquire) by the bot
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t reader_pid;
+    alignas(64) std::atomic<uint64_t> head;   ///< Next slot to write (producer)
+    alignas(64) std::atomic<uint64_t> tail;   ///< Next slot to read (consumer)
+    alignas(64) SharedPaddleCommand slots[kInputRingCapacity];
+};
+
+/**
+ * @brief Consumer side, owned by the game process
+ */
+class InputRingReader : public PaddleCommandSource {
+public:
+    InputRingReader() = default;
+    ~InputRingReader() override;
+    InputRingReader(const InputRingReader &) = delete;
+    InputRingReader &operator=(const InputRingReader &) = delete;
+
+    /// @brief Create (or replace) the segment; false with @p err on failure
+    bool create(const std::string &name, std::string &err);
+    void close();
+    bool is_open() const { return seg != nullptr; }
+
+    bool next(PaddleCommand &cmd) override;
+
+private:
+    InputRingSegment *seg = nullptr;
+    std::string shm_name;
+    uint64_t tail = 0;
+    uint64_t head_cache = 0;
+};
+
+/**
+ * @brief Producer side, used by the bot process
+ */
+class InputRingWriter {
+public:
+    InputRingWriter() = default;
+    ~InputRingWriter();
+    InputRingWriter(const InputRingWriter &) = delete;
+    InputRingWriter &operator=(const InputRingWriter &) = delete;
+
+    /// @brief Map the segment created by the game; false with @p err on failure
+    bool open(const std::string &name, std::string &err);
+    void close();
+    bool is_open() const { return seg != nullptr; }
+
+    /// @brief Enqueue a command; false when the ring is full (game not consuming)
+    bool push(const PaddleCommand &cmd);
+    /// @brief Id of the newest command pushed by any producer, this one or an earlier bot (0 = none)
+    uint64_t last_id() const;
+
+private:
+    InputRingSegment *seg = nullptr;
+    uint64_t head = 0;
+    uint64_t tail_cache = 0;
+};
@@ -0,0 +1,165 @@
+/**
+ * @file state_export.cpp
+ * @brief POSIX shared-memory implementation of the GameState export
+ */
+
+#include "ipc/state_export.h"
+#ifndef _WIN32
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+StateExporter::~StateExporter() { close(); }
+
+bool StateExporter::open(const std::string &name, std::string &err) {
+    close();
+    // A stale segment from a crashed writer may have an older layout
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) { err = "shm_open " + name + ": " + std::strerror(errno); return false; }
+    if (ftruncate(fd, sizeof(StateShmSegment)) != 0) {
+        err = std::string("ftruncate: ") + std::strerror(errno);
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void *p = mmap(nullptr, sizeof(StateShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        err = std::string("mmap: ") + std::strerror(errno);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    // ftruncate zero-fills; construct the atomics in place before publishing the header
+    seg = static_cast<StateShmSegment *>(p);
+    new (&seg->magic) std::atomic<uint32_t>(0);
+    new (&seg->seq) std::atomic<uint64_t>(0);
+    seg->size = sizeof(StateShmSegment);
+    seg->version = kStateShmVersion;
+    seg->writer_pid = (uint32_t)getpid();
+    // Pairs with the acquire load in StateReader::open: a reader that sees magic sees the header
+    seg->magic.store(kStateShmMagic, std::memory_order_release);
+    shm_name = name;
+    frame = 0;
+    return true;
+}
+
+void StateExporter::close() {
+    if (!seg) return;
+    munmap(seg, sizeof(StateShmSegment));
+    shm_unlink(shm_name.c_str());
+    seg = nullptr;
+}
+
+void StateExporter::publish(const GameState &gs) {
+    if (!seg) return;
+    const uint64_t s = seg->seq.load(std::memory_order_relaxed);
+    seg->seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    SharedGameState &out = seg->state;
+    out.frame = ++frame;
+    out.publish_ns = shm_now_ns();
+    out.width = gs.gw;
+    out.height = gs.gh;
+    out.score_left = gs.score_left;
+    out.score_right = gs.score_right;
+    out.mode = (int32_t)gs.mode;
+    out.paddle_w = gs.paddle_w;
+    out.paddle_h = gs.paddle_h;
+    out.left_y = gs.left_y;
+    out.right_y = gs.right_y;
+    out.top_x = gs.top_x;
+    out.bottom_x = gs.bottom_x;
+    out.last_command_id = gs.last_command_id;
+    out.last_command_ns = gs.last_command_ns;
+
+    const Archetype &balls = gs.entities.balls();
+    const Archetype &obs = gs.entities.obstacles();
+    const Archetype &holes = gs.entities.blackholes();
+    out.ball_count = (uint32_t)std::min<size_t>(balls.size(), kShmMaxBalls);
+    out.obstacle_count = (uint32_t)std::min<size_t>(obs.size(), kShmMaxObstacles);
+    out.blackhole_count = (uint32_t)std::min<size_t>(holes.size(), kShmMaxBlackHoles);
+    out.truncated = balls.size() > kShmMaxBalls || obs.size() > kShmMaxObstacles || holes.size() > kShmMaxBlackHoles;
+    for (uint32_t i = 0; i < out.ball_count; ++i) {
+        out.ball_pos[i] = { balls.position[i].x, balls.position[i].y };
+        out.ball_vel[i] = { balls.velocity[i].vx, balls.velocity[i].vy };
+    }
+    for (uint32_t i = 0; i < out.obstacle_count; ++i) {
+        out.obstacle_pos[i] = { obs.position[i].x, obs.position[i].y };
+        out.obstacle_size[i] = { obs.shape[i].w, obs.shape[i].h };
+    }
+    for (uint32_t i = 0; i < out.blackhole_count; ++i) {
+        out.blackhole_pos[i] = { holes.position[i].x, holes.position[i].y };
+    }
+
+    seg->seq.store(s + 2, std::memory_order_release);
+}
+
+// Copy the scalar prefix and only the populated part of each array. Counts
+// may be torn while the writer is active; they are clamped here and the
+// sequence check discards such copies anyway.
+static void copy_state(SharedGameState &out, const SharedGameState &in) {
+    std::memcpy(&out, &in, offsetof(SharedGameState, ball_pos));
+    const uint32_t balls = std::min(out.ball_count, kShmMaxBalls);
+    const uint32_t obs = std::min(out.obstacle_count, kShmMaxObstacles);
+    const uint32_t holes = std::min(out.blackhole_count, kShmMaxBlackHoles);
+    std::memcpy(out.ball_pos, in.ball_pos, balls * sizeof(SharedVec2));
+    std::memcpy(out.ball_vel, in.ball_vel, balls * sizeof(SharedVec2));
+    std::memcpy(out.obstacle_pos, in.obstacle_pos, obs * sizeof(SharedVec2));
+    std::memcpy(out.obstacle_size, in.obstacle_size, obs * sizeof(SharedVec2));
+    std::memcpy(out.blackhole_pos, in.blackhole_pos, holes * sizeof(SharedVec2));
+}
+
+StateReader::~StateReader() { close(); }
+
+bool StateReader::open(const std::string &name, std::string &err) {
+    close();
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) { err = "shm_open " + name + ": " + std::strerror(errno); return false; }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(StateShmSegment)) {
+        err = "segment " + name + " is too small (writer not ready or different layout)";
+        ::close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, sizeof(StateShmSegment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) { err = std::string("mmap: ") + std::strerror(errno); return false; }
+    const StateShmSegment *s = static_cast<const StateShmSegment *>(p);
+    if (s->magic.load(std::memory_order_acquire) != kStateShmMagic || s->version != kStateShmVersion ||
+        s->size != sizeof(StateShmSegment)) {
+        err = "segment " + name + " has an incompatible layout";
+        munmap(p, sizeof(StateShmSegment));
+        return false;
+    }
+    seg = s;
+    return true;
+}
+
+void StateReader::close() {
+    if (!seg) return;
+    munmap(const_cast<StateShmSegment *>(seg), sizeof(StateShmSegment));
+    seg = nullptr;
+}
+
+uint64_t StateReader::read(SharedGameState &out, unsigned max_attempts) {
+    for (unsigned i = 0; i < max_attempts; ++i) {
+        const uint64_t s1 = seg->seq.load(std::memory_order_acquire);
+        if (s1 == 0) return 0;   // nothing published yet
+        if (s1 & 1) { ++retry_count; continue; }
+        copy_state(out, seg->state);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seg->seq.load(std::memory_order_relaxed) == s1) return s1;
+        ++retry_count;
+    }
+    return 0;
+}
+
+#endif
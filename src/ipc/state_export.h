@@ -0,0 +1,92 @@
+/**
+ * @file state_export.h
+ * @brief Writer and reader for the shared-memory GameState export
+ *
+ * StateExporter is owned by a frontend loop and called once per tick.
+ * StateReader is the small library external tools link against; it maps
+ * the segment read-only and never blocks the writer. POSIX only.
+ */
+
+#pragma once
+
+#include "core/game_core.h"
+#include "ipc/state_shm.h"
+#include <string>
+
+/**
+ * @brief Creates the segment and publishes GameState into it
+ */
+class StateExporter {
+public:
+    StateExporter() = default;
+    ~StateExporter();
+    StateExporter(const StateExporter &) = delete;
+    StateExporter &operator=(const StateExporter &) = delete;
+
+    /**
+     * @brief Create (or replace) the shared-memory segment
+     *
+     * @param name Segment name, e.g. kStateShmDefaultName
+     * @param err Receives a description on failure
+     * @return true on success
+     */
+    bool open(const std::string &name, std::string &err);
+
+    /// @brief Unmap and unlink the segment
+    void close();
+
+    bool is_open() const { return seg != nullptr; }
+
+    /// @brief Publish one tick (writer side of the seqlock; no syscalls)
+    void publish(const GameState &gs);
+
+private:
+    StateShmSegment *seg = nullptr;
+    std::string shm_name;
+    uint64_t frame = 0;
+};
+
+/**
+ * @brief Read-only view of an exported segment
+ */
+class StateReader {
+public:
+    StateReader() = default;
+    ~StateReader();
+    StateReader(const StateReader &) = delete;
+    StateReader &operator=(const StateReader &) = delete;
+
+    /**
+     * @brief Map an existing segment
+     *
+     * @param name Segment name used by the writer
+     * @param err Receives a description on failure (missing, wrong version)
+     * @return true on success
+     */
+    bool open(const std::string &name, std::string &err);
+
+    void close();
+
+    bool is_open() const { return seg != nullptr; }
+
+    /// @brief Current sequence (even = stable); cheap change detection
+    uint64_t sequence() const { return seg->seq.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Copy a consistent snapshot
+     *
+     * Only the populated entries of the entity arrays are copied.
+     *
+     * @param out Destination
+     * @param max_attempts Copies tried before giving up while the writer is busy
+     * @return Sequence of the copied snapshot, 0 when no consistent copy was obtained
+     */
+    uint64_t read(SharedGameState &out, unsigned max_attempts = 64);
+
+    /// @brief Copies discarded because the writer raced them
+    uint64_t retries() const { return retry_count; }
+
+private:
+    const StateShmSegment *seg = nullptr;
+    uint64_t retry_count = 0;
+};
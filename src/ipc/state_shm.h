@@ -0,0 +1,92 @@
+/**
+ * @file state_shm.h
+ * @brief Shared-memory layout for exporting GameState to other processes
+ *
+ * A single writer (the game loop) publishes one SharedGameState per tick
+ * into a POSIX shared-memory segment guarded by a seqlock: the sequence
+ * is odd while a write is in progress and even when the snapshot is
+ * stable. Readers copy the snapshot and retry when the sequence moved,
+ * so any number of them can follow the game without locks, without
+ * slowing the writer and without syscalls after the segment is mapped.
+ *
+ * The payload is plain data with fixed capacity arrays; entities beyond
+ * the capacity are dropped and flagged in SharedGameState::truncated.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// @brief Segment name used when none is given (see shm_open)
+constexpr const char *kStateShmDefaultName = "/pong_state";
+
+constexpr uint32_t kStateShmMagic = 0x504F4E47;   ///< 'PONG'
+constexpr uint32_t kStateShmVersion = 2;          ///< Bumped on any layout change
+
+constexpr uint32_t kShmMaxBalls = 64;
+constexpr uint32_t kShmMaxObstacles = 256;
+constexpr uint32_t kShmMaxBlackHoles = 16;
+
+/// @brief Position (and extent or velocity, depending on the array)
+struct SharedVec2 {
+    double x;
+    double y;
+};
+
+/**
+ * @brief One published tick
+ *
+ * Paddle fields follow GameState: left_y/right_y are top edges, top_x and
+ * bottom_x are centres.
+ */
+struct SharedGameState {
+    uint64_t frame;               ///< Publish counter (1 = first tick)
+    int64_t publish_ns;           ///< shm_now_ns() when the write started
+    int32_t width, height;        ///< Arena size (GameState::gw / gh)
+    int32_t score_left, score_right;
+    int32_t mode;                 ///< GameMode value
+    int32_t paddle_w, paddle_h;
+    int32_t truncated;            ///< Non-zero when an entity array hit its capacity
+    double left_y, right_y;
+    double top_x, bottom_x;
+    uint64_t last_command_id;     ///< Newest bot command applied (see input_ring.h)
+    int64_t last_command_ns;      ///< Sender timestamp of that command
+    uint32_t ball_count;
+    uint32_t obstacle_count;
+    uint32_t blackhole_count;
+    uint32_t reserved;
+    SharedVec2 ball_pos[kShmMaxBalls];
+    SharedVec2 ball_vel[kShmMaxBalls];
+    SharedVec2 obstacle_pos[kShmMaxObstacles];
+    SharedVec2 obstacle_size[kShmMaxObstacles];
+    SharedVec2 blackhole_pos[kShmMaxBlackHoles];
+};
+
+/**
+ * @brief Complete shared-memory segment
+ *
+ * The header is written once at creation; magic is stored last with
+ * release order, so a reader that loads it with acquire and sees the
+ * right value also sees the rest of the header. seq sits on its own cache
+ * line so reader polling never contends with the payload being written.
+ */
+struct StateShmSegment {
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t size;                        ///< sizeof(StateShmSegment)
+    uint32_t writer_pid;
+    alignas(64) std::atomic<uint64_t> seq;
+    alignas(64) SharedGameState state;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs a lock-free 64-bit atomic");
+static_assert(std::atomic<uint32_t>::is_always_lock_free && sizeof(std::atomic<uint32_t>) == 4,
+              "the segment header is shared between processes");
+
+/// @brief Monotonic clock shared by writer and readers (CLOCK_MONOTONIC on Linux)
+inline int64_t shm_now_ns() {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,111 @@
+/**
+ * @file lb_protocol.cpp
+ * @brief Encoding and decoding of leaderboard messages
+ */
+
+#include "leaderboard/lb_protocol.h"
+#include "server/protocol.h"
+#include <algorithm>
+
+namespace {
+
+void put_name(WireWriter &w, std::vector<uint8_t> &out, const std::string &name) {
+    const size_t n = std::min(name.size(), kLbMaxName);
+    w.u8((uint8_t)n);
+    out.insert(out.end(), name.begin(), name.begin() + (std::ptrdiff_t)n);
+}
+
+bool get_name(WireReader &r, std::string &name) {
+    const size_t n = r.u8();
+    if (!r.ok() || n > kLbMaxName || n > r.remaining()) return false;
+    name.assign((const char *)r.cursor(), n);
+    r.skip(n);
+    return true;
+}
+
+} // namespace
+
+void encode_request(const LbRequest &r, std::vector<uint8_t> &out) {
+    WireWriter w(out);
+    w.u8((uint8_t)r.type);
+    w.u32(r.req);
+    switch (r.type) {
+    case LbType::Submit: w.u32((uint32_t)r.score); put_name(w, out, r.name); break;
+    case LbType::Top: w.u32(r.first); w.u8(r.count); break;
+    case LbType::Rank: put_name(w, out, r.name); break;
+    case LbType::Around: w.u8(r.count); put_name(w, out, r.name); break;
+    }
+}
+
+bool decode_request(const uint8_t *data, size_t len, LbRequest &r) {
+    WireReader rd(data, len);
+    const uint8_t type = rd.u8();
+    r.req = rd.u32();
+    r.name.clear();
+    switch ((LbType)type) {
+    case LbType::Submit: r.score = (int32_t)rd.u32(); if (!get_name(rd, r.name)) return false; break;
+    case LbType::Top: r.first = rd.u32(); r.count = rd.u8(); break;
+    case LbType::Rank: if (!get_name(rd, r.name)) return false; break;
+    case LbType::Around: r.count = rd.u8(); if (!get_name(rd, r.name)) return false; break;
+    default: return false;
+    }
+    r.type = (LbType)type;
+    return rd.ok() && rd.remaining() == 0;
+}
+
+void encode_reply(const LbReply &r, std::vector<uint8_t> &out) {
+    WireWriter w(out);
+    w.u8((uint8_t)((uint8_t)r.type | kLbReplyBit));
+    w.u32(r.req);
+    w.u8((uint8_t)r.status);
+    if (r.status != LbStatus::Ok) return;
+    switch (r.type) {
+    case LbType::Submit: w.u64(r.id); w.u32(r.rank); w.u32(r.total); break;
+    case LbType::Rank: w.u32(r.rank); w.u32((uint32_t)r.score); w.u32(r.total); break;
+    case LbType::Top:
+    case LbType::Around: {
+        const size_t n = std::min(r.rows.size(), kLbMaxRows);
+        w.u32(r.total);
+        w.u32(r.rank);
+        w.u8((uint8_t)n);
+        for (size_t i = 0; i < n; ++i) {
+            w.u64(r.rows[i].id);
+            w.u32((uint32_t)r.rows[i].score);
+            put_name(w, out, r.rows[i].name);
+        }
+        break;
+    }
+    }
+}
+
+bool decode_reply(const uint8_t *data, size_t len, LbReply &r) {
+    WireReader rd(data, len);
+    const uint8_t type = rd.u8();
+    if (!(type & kLbReplyBit)) return false;
+    r.type = (LbType)(type & ~kLbReplyBit);
+    r.req = rd.u32();
+    r.status = (LbStatus)rd.u8();
+    r.rows.clear();
+    if (!rd.ok()) return false;
+    if (r.status != LbStatus::Ok) return rd.remaining() == 0;
+    switch (r.type) {
+    case LbType::Submit: r.id = rd.u64(); r.rank = rd.u32(); r.total = rd.u32(); break;
+    case LbType::Rank: r.rank = rd.u32(); r.score = (int32_t)rd.u32(); r.total = rd.u32(); break;
+    case LbType::Top:
+    case LbType::Around: {
+        r.total = rd.u32();
+        r.rank = rd.u32();
+        const size_t n = rd.u8();
+        if (n > kLbMaxRows) return false;
+        r.rows.resize(n);
+        for (LbRow &row : r.rows) {
+            row.id = rd.u64();
+            row.score = (int32_t)rd.u32();
+            if (!get_name(rd, row.name)) return false;
+        }
+        break;
+    }
+    default: return false;
+    }
+    return rd.ok() && rd.remaining() == 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file lb_protocol.h
+ * @brief Wire format of pong_leaderboard
+ *
+ * Messages travel over a Unix stream socket or TCP, framed with the
+ * 16-bit length prefix of server/protocol.h. Integers are little-endian;
+ * names are UTF-8, at most kLbMaxName bytes. Every request carries a
+ * client-chosen id that the reply echoes, so a client may pipeline.
+ *
+ * Requests:
+ *   Submit: u8 type | u32 req | i32 score | u8 len | name
+ *   Top:    u8 type | u32 req | u32 first (0-based) | u8 count
+ *   Rank:   u8 type | u32 req | u8 len | name
+ *   Around: u8 type | u32 req | u8 radius | u8 len | name
+ *
+ * Replies (type = request type | 0x80):
+ *   u8 type | u32 req | u8 status | body
+ *   Submit: u64 id | u32 rank | u32 total
+ *   Rank:   u32 rank | i32 best score | u32 total
+ *   Top, Around: u32 total | u32 rank of the first row | u8 rows |
+ *                rows x (u64 id | i32 score | u8 len | name)
+ *
+ * Ranks are 1-based. A player's rank is that of their best score;
+ * Around returns up to radius rows on either side of it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// @brief Default TCP port of pong_leaderboard (loopback)
+constexpr uint16_t kLbDefaultPort = 47810;
+
+constexpr size_t kLbMaxName = 32;      ///< Longer names are cut
+constexpr size_t kLbMaxRows = 100;     ///< Rows per Top / Around reply (and 2 * radius + 1)
+constexpr size_t kLbMaxMessageBytes = 8192;
+
+enum class LbType : uint8_t {
+    Submit = 1,
+    Top = 2,
+    Rank = 3,
+    Around = 4
+};
+
+constexpr uint8_t kLbReplyBit = 0x80;
+
+enum class LbStatus : uint8_t {
+    Ok = 0,
+    NotFound = 1,   ///< Rank / Around for a player without scores
+    BadRequest = 2,
+    StorageError = 3
+};
+
+struct LbRequest {
+    LbType type = LbType::Top;
+    uint32_t req = 0;
+    int32_t score = 0;      ///< Submit
+    uint32_t first = 0;     ///< Top: 0-based rank of the first row
+    uint8_t count = 0;      ///< Top: rows; Around: radius
+    std::string name;       ///< Submit, Rank, Around
+};
+
+struct LbRow {
+    uint64_t id = 0;
+    int32_t score = 0;
+    std::string name;
+};
+
+struct LbReply {
+    LbType type = LbType::Top;
+    uint32_t req = 0;
+    LbStatus status = LbStatus::Ok;
+    uint64_t id = 0;        ///< Submit: stored entry
+    uint32_t rank = 0;      ///< Submit: entry rank; Rank: player rank; Top/Around: rank of rows[0]
+    uint32_t total = 0;     ///< Entries on the board
+    int32_t score = 0;      ///< Rank: player's best
+    std::vector<LbRow> rows;
+};
+
+/// @brief Append an encoded request (not framed)
+void encode_request(const LbRequest &r, std::vector<uint8_t> &out);
+/// @brief Parse a request; false when malformed
+bool decode_request(const uint8_t *data, size_t len, LbRequest &r);
+/// @brief Append an encoded reply (not framed)
+void encode_reply(const LbReply &r, std::vector<uint8_t> &out);
+/// @brief Parse a reply; false when malformed
+bool decode_reply(const uint8_t *data, size_t len, LbReply &r);
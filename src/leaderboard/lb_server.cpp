@@ -0,0 +1,196 @@
+/**
+ * @file lb_server.cpp
+ * @brief Implementation of the leaderboard request loop
+ */
+
+#include "leaderboard/lb_server.h"
+#include "server/protocol.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+/// Unsent reply bytes after which a connection is not read until it drains
+constexpr size_t kMaxBacklog = 1 << 20;
+
+bool set_nonblocking(int fd) {
+    int fl = fcntl(fd, F_GETFL, 0);
+    return fl >= 0 && fcntl(fd, F_SETFL, fl | O_NONBLOCK) == 0;
+}
+
+} // namespace
+
+LeaderboardServer::~LeaderboardServer() {
+    for (Conn &c : conns) close(c.fd);
+    if (tcp_fd >= 0) close(tcp_fd);
+    if (unix_fd >= 0) {
+        close(unix_fd);
+        unlink(cfg.unix_path.c_str());
+    }
+}
+
+bool LeaderboardServer::start(std::string &err) {
+    if (cfg.port) {
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_port = htons(cfg.port);
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        tcp_fd = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(tcp_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (tcp_fd < 0 || bind(tcp_fd, (sockaddr *)&a, sizeof(a)) != 0 || listen(tcp_fd, SOMAXCONN) != 0 ||
+            !set_nonblocking(tcp_fd)) {
+            err = std::string("tcp listen: ") + std::strerror(errno);
+            return false;
+        }
+    }
+    if (!cfg.unix_path.empty()) {
+        sockaddr_un a{};
+        a.sun_family = AF_UNIX;
+        if (cfg.unix_path.size() >= sizeof(a.sun_path)) { err = "unix socket path too long"; return false; }
+        std::memcpy(a.sun_path, cfg.unix_path.c_str(), cfg.unix_path.size() + 1);
+        unlink(cfg.unix_path.c_str());  // left behind by a previous run
+        unix_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (unix_fd < 0 || bind(unix_fd, (sockaddr *)&a, sizeof(a)) != 0 || listen(unix_fd, SOMAXCONN) != 0 ||
+            !set_nonblocking(unix_fd)) {
+            err = std::string("unix listen: ") + std::strerror(errno);
+            return false;
+        }
+    }
+    if (tcp_fd < 0 && unix_fd < 0) { err = "no listener configured"; return false; }
+    return true;
+}
+
+void LeaderboardServer::accept_all(int listen_fd) {
+    for (;;) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) break;
+        set_nonblocking(fd);
+        if (listen_fd == tcp_fd) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        Conn c;
+        c.fd = fd;
+        conns.push_back(std::move(c));
+    }
+}
+
+void LeaderboardServer::read_conn(Conn &c) {
+    uint8_t buf[16384];
+    uint64_t counts[5] = {}, bad = 0;
+    for (;;) {
+        ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+        if (n == 0) { c.dead = true; break; }
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) c.dead = true;
+            break;
+        }
+        c.in.insert(c.in.end(), buf, buf + n);
+        const bool framed = drain_frames(c.in, [&](const uint8_t *data, size_t len) {
+            if (!decode_request(data, len, req)) {
+                ++bad;
+                reply = LbReply{};
+                reply.type = (LbType)(data[0] & ~kLbReplyBit);
+                // Keep the request id when it is there, so a pipelining client knows which request failed
+                if (len >= 5) reply.req = WireReader(data + 1, 4).u32();
+                reply.status = LbStatus::BadRequest;
+            } else {
+                ++counts[(int)req.type];
+                c.submitted = c.submitted || req.type == LbType::Submit;
+                lb.handle(req, reply);
+            }
+            msg.clear();
+            encode_reply(reply, msg);
+            append_frame(msg.data(), msg.size(), c.out);
+        }, kLbMaxMessageBytes);
+        if (!framed) { c.dead = true; break; }
+        if (c.out.size() > kMaxBacklog) break;
+    }
+    std::lock_guard<std::mutex> lock(stats_mtx);
+    for (int i = 0; i < 5; ++i) acc.requests[i] += counts[i];
+    acc.bad_requests += bad;
+}
+
+void LeaderboardServer::write_conn(Conn &c) {
+    size_t off = 0;
+    while (off < c.out.size()) {
+        ssize_t n = send(c.fd, c.out.data() + off, c.out.size() - off, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) c.dead = true;
+            break;
+        }
+        off += (size_t)n;
+    }
+    c.out.erase(c.out.begin(), c.out.begin() + (std::ptrdiff_t)off);
+}
+
+bool LeaderboardServer::run(const std::atomic<bool> &stop) {
+    std::vector<pollfd> fds;
+    while (!stop.load()) {
+        fds.clear();
+        fds.push_back({ tcp_fd, POLLIN, 0 });
+        fds.push_back({ unix_fd, POLLIN, 0 });
+        for (const Conn &c : conns) {
+            short ev = c.out.size() > kMaxBacklog ? 0 : POLLIN;
+            if (!c.out.empty()) ev |= POLLOUT;
+            fds.push_back({ c.fd, ev, 0 });
+        }
+        if (poll(fds.data(), (nfds_t)fds.size(), 100) <= 0) continue;
+
+        // Answer everything that arrived; replies wait in the output buffers
+        bool submitted = false, handled = false;
+        for (size_t i = 0; i < conns.size(); ++i) {
+            if (fds[2 + i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                read_conn(conns[i]);
+                submitted = submitted || conns[i].submitted;
+                handled = true;
+            }
+        }
+        // Group commit: one fsync covers every submission of the batch, before any of them is acknowledged
+        if (submitted && !lb.commit()) {
+            // The batch's scores are already ranked, so any reply (and every later one) could report a
+            // score the log may not hold: drop everyone unanswered and stop; a restart replays the log
+            std::fprintf(stderr, "pong_leaderboard: log fsync failed, closing all connections and stopping\n");
+            for (Conn &c : conns) close(c.fd);
+            conns.clear();
+            std::lock_guard<std::mutex> lock(stats_mtx);
+            acc.connections = 0;
+            return false;
+        }
+        for (Conn &c : conns) {
+            c.submitted = false;
+            if (!c.dead && !c.out.empty()) write_conn(c);
+        }
+        for (Conn &c : conns) {
+            if (c.dead) close(c.fd);
+        }
+        conns.erase(std::remove_if(conns.begin(), conns.end(), [](const Conn &c) { return c.dead; }), conns.end());
+        if (tcp_fd >= 0 && (fds[0].revents & POLLIN)) accept_all(tcp_fd);
+        if (unix_fd >= 0 && (fds[1].revents & POLLIN)) accept_all(unix_fd);
+
+        std::lock_guard<std::mutex> lock(stats_mtx);
+        acc.commits += submitted ? 1 : 0;
+        acc.batches += handled ? 1 : 0;
+        acc.connections = conns.size();
+    }
+    return true;
+}
+
+LbServerStats LeaderboardServer::take_stats() {
+    std::lock_guard<std::mutex> lock(stats_mtx);
+    LbServerStats s = acc;
+    acc = LbServerStats{};
+    acc.connections = s.connections;
+    return s;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file lb_server.h
+ * @brief pong_leaderboard request loop over Unix and TCP stream sockets
+ *
+ * One thread polls the listeners and every connection, decodes all
+ * complete requests that arrived and answers them in order against the
+ * Leaderboard. If the batch contained submissions the log is fsync'd
+ * once (group commit) before any reply of the batch is written, so the
+ * cost of durability is shared by every submission that arrived during
+ * the previous fsync instead of paid per request. If that fsync fails
+ * the batch's scores are already ranked, so the loop closes every
+ * connection without replying and stops rather than serve them.
+ */
+
+#pragma once
+
+#include "leaderboard/leaderboard.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct LbServerConfig {
+    uint16_t port = kLbDefaultPort;   ///< TCP port on 127.0.0.1 (0 = no TCP)
+    std::string unix_path;            ///< Unix socket path (empty = none)
+};
+
+/**
+ * @brief Counters accumulated since start (or the last take_stats())
+ */
+struct LbServerStats {
+    uint64_t requests[5] = {};    ///< Indexed by LbType
+    uint64_t bad_requests = 0;
+    uint64_t commits = 0;         ///< Log fsyncs (one per batch with submissions)
+    uint64_t batches = 0;         ///< Poll rounds that handled requests
+    uint64_t connections = 0;     ///< Open connections at the end of the interval
+};
+
+class LeaderboardServer {
+public:
+    LeaderboardServer(Leaderboard &board, const LbServerConfig &cfg) : lb(board), cfg(cfg) {}
+    ~LeaderboardServer();
+    LeaderboardServer(const LeaderboardServer &) = delete;
+    LeaderboardServer &operator=(const LeaderboardServer &) = delete;
+
+    /**
+     * @brief Bind the configured listeners
+     *
+     * @param err Receives a description on failure
+     * @return true on success
+     */
+    bool start(std::string &err);
+
+    /**
+     * @brief Serve requests until @p stop is set
+     *
+     * @return false if serving stopped because the log could not be made durable
+     */
+    bool run(const std::atomic<bool> &stop);
+
+    /// @brief Return and reset the counters (thread-safe)
+    LbServerStats take_stats();
+
+private:
+    struct Conn {
+        int fd = -1;
+        std::vector<uint8_t> in;
+        std::vector<uint8_t> out;     ///< Replies not yet written
+        bool submitted = false;       ///< Holds an acknowledgement that waits for the batch commit
+        bool dead = false;
+    };
+
+    void accept_all(int listen_fd);
+    void read_conn(Conn &c);
+    void write_conn(Conn &c);
+
+    Leaderboard &lb;
+    LbServerConfig cfg;
+    int tcp_fd = -1, unix_fd = -1;
+    std::vector<Conn> conns;
+    LbRequest req;                    ///< Scratch
+    LbReply reply;
+    std::vector<uint8_t> msg;
+    std::mutex stats_mtx;
+    LbServerStats acc;
+};
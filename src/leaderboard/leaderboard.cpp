@@ -0,0 +1,69 @@
+/**
+ * @file leaderboard.cpp
+ * @brief Leaderboard queries over the score board
+ */
+
+#include "leaderboard/leaderboard.h"
+#include <algorithm>
+
+bool Leaderboard::open(const std::filesystem::path &path, std::string &err) {
+    best.clear();
+    if (!board.open(path, err)) return false;
+    board.storage().set_durable(false);
+    // Walk the ranking best first: the first entry seen for a name is that player's best
+    const size_t kPage = 4096;
+    for (size_t first = 0; first < board.size(); first += kPage) {
+        for (const ScoreEntry &e : board.page(first, kPage)) best.emplace(e.name, e.id);
+    }
+    return true;
+}
+
+bool Leaderboard::commit() {
+    return board.storage().flush(true);
+}
+
+void Leaderboard::rows(size_t first, size_t n, LbReply &reply) const {
+    reply.rank = (uint32_t)(first + 1);
+    for (ScoreEntry &e : board.page(first, std::min(n, kLbMaxRows))) reply.rows.push_back({ e.id, e.score, std::move(e.name) });
+}
+
+void Leaderboard::handle(const LbRequest &req, LbReply &reply) {
+    reply = LbReply{};
+    reply.type = req.type;
+    reply.req = req.req;
+    switch (req.type) {
+    case LbType::Submit: {
+        const std::string name = req.name.substr(0, kLbMaxName);
+        const uint64_t id = board.submit(name, req.score);
+        if (id == 0) { reply.status = LbStatus::StorageError; break; }
+        auto it = best.find(name);
+        if (it == best.end()) best.emplace(name, id);
+        else if (board.rank_of(id) < board.rank_of(it->second)) it->second = id;
+        reply.id = id;
+        reply.rank = (uint32_t)board.rank_of(id);
+        break;
+    }
+    case LbType::Top:
+        rows(req.first, req.count, reply);
+        break;
+    case LbType::Rank:
+    case LbType::Around: {
+        auto it = best.find(req.name);
+        if (it == best.end()) { reply.status = LbStatus::NotFound; break; }
+        const size_t rank = board.rank_of(it->second);
+        if (req.type == LbType::Rank) {
+            reply.rank = (uint32_t)rank;
+            reply.score = board.page(rank - 1, 1).front().score;
+        } else {
+            const size_t radius = std::min<size_t>(req.count, (kLbMaxRows - 1) / 2);
+            const size_t first = rank - 1 > radius ? rank - 1 - radius : 0;
+            rows(first, rank - 1 - first + radius + 1, reply);
+        }
+        break;
+    }
+    default:
+        reply.status = LbStatus::BadRequest;
+        break;
+    }
+    reply.total = (uint32_t)board.size();
+}
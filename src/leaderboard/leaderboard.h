@@ -0,0 +1,44 @@
+/**
+ * @file leaderboard.h
+ * @brief Shared leaderboard state: score board plus each player's best entry
+ *
+ * Scores are kept like the cabinets keep them (every submission is an
+ * entry of a ScoreBoard, so the log format is the one pong_win writes);
+ * the leaderboard adds a map from player name to that player's best
+ * entry for rank-of-player and around-me queries. All ranking goes
+ * through the board's order-statistic B+tree, so every query is
+ * O(log n + rows).
+ *
+ * Submissions are appended to the log without an fsync; the server
+ * calls commit() once per batch of requests before it replies, so a
+ * reply is never sent for a score that a crash could still lose.
+ */
+
+#pragma once
+
+#include "leaderboard/lb_protocol.h"
+#include "scores/score_board.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+class Leaderboard {
+public:
+    /// @brief Open or create the log at @p path and index every player's best score
+    bool open(const std::filesystem::path &path, std::string &err);
+
+    /// @brief Answer one request (Submit appends to the log; see commit())
+    void handle(const LbRequest &req, LbReply &reply);
+    /// @brief Make every submission so far durable; false if the log write failed
+    bool commit();
+
+    size_t size() const { return board.size(); }
+    size_t players() const { return best.size(); }
+
+private:
+    void rows(size_t first, size_t n, LbReply &reply) const;
+
+    ScoreBoard board;
+    std::unordered_map<std::string, uint64_t> best;   ///< Player -> id of their best entry
+};
@@ -0,0 +1,189 @@
+/**
+ * @file leaderboard_main.cpp
+ * @brief Entry point of pong_leaderboard
+ *
+ * Usage:
+ *   pong_leaderboard [--log PATH] [--port N] [--unix PATH] [--seconds N]
+ *                    [--clients N] [--client-threads N] [--players N]
+ *                    [--submit-pct N] [--seed-entries N]
+ *
+ * Serves the leaderboard kept in --log (default leaderboard.log) on
+ * 127.0.0.1:--port (0 disables TCP) and, with --unix, on a Unix socket.
+ * --seed-entries tops the board up to that many entries of random
+ * players before serving. Unless --clients 0, drives the server with
+ * closed-loop load clients (over the Unix socket when one is given) and
+ * prints one line per second plus a summary with queries per second and
+ * latency percentiles per request type. --seconds 0 runs until
+ * interrupted, which is how the shared daemon is started:
+ *   pong_leaderboard --clients 0 --seconds 0 --unix /run/pong/leaderboard.sock
+ */
+
+#include "leaderboard/lb_server.h"
+#include "leaderboard/load_clients.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+
+static std::atomic<bool> g_stop{false};
+
+static void on_signal(int) { g_stop.store(true); }
+
+static long int_arg(int argc, char **argv, const char *name, long fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            char *end = nullptr;
+            long v = std::strtol(argv[i+1], &end, 10);
+            if (end && *end == '\0' && v >= 0) return v;
+        }
+    }
+    return fallback;
+}
+
+static const char *str_arg(int argc, char **argv, const char *name, const char *fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) return argv[i+1];
+    }
+    return fallback;
+}
+
+static double percentile(std::vector<double> &v, double p) {
+    if (v.empty()) return 0.0;
+    size_t k = (size_t)(p * (double)(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + (std::ptrdiff_t)k, v.end());
+    return v[k];
+}
+
+static const char *const kTypeNames[5] = { "", "submit", "top10", "rank", "around" };
+
+int main(int argc, char **argv) {
+    const std::string log_path = str_arg(argc, argv, "--log", "leaderboard.log");
+    LbServerConfig cfg;
+    cfg.port = (uint16_t)int_arg(argc, argv, "--port", kLbDefaultPort);
+    cfg.unix_path = str_arg(argc, argv, "--unix", "");
+    const long seconds = int_arg(argc, argv, "--seconds", 10);
+    const size_t seed_entries = (size_t)int_arg(argc, argv, "--seed-entries", 0);
+
+    LoadConfig load;
+    load.port = cfg.port;
+    load.unix_path = cfg.unix_path;
+    load.connections = (size_t)int_arg(argc, argv, "--clients", 32);
+    load.threads = (unsigned)int_arg(argc, argv, "--client-threads", 2);
+    load.players = (size_t)int_arg(argc, argv, "--players", 100000);
+    load.submit_pct = (unsigned)int_arg(argc, argv, "--submit-pct", 10);
+
+    Leaderboard board;
+    std::string err;
+    auto t0 = std::chrono::steady_clock::now();
+    if (!board.open(log_path, err)) {
+        std::fprintf(stderr, "pong_leaderboard: %s\n", err.c_str());
+        return 1;
+    }
+    const double open_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("pong_leaderboard: %s: %zu entries, %zu players (opened in %.2f s)\n",
+                log_path.c_str(), board.size(), board.players(), open_s);
+    if (board.size() < seed_entries) {
+        std::mt19937_64 rng(42);
+        LbRequest req;
+        LbReply reply;
+        req.type = LbType::Submit;
+        t0 = std::chrono::steady_clock::now();
+        for (size_t i = board.size(); i < seed_entries; ++i) {
+            req.name = "player-" + std::to_string(rng() % std::max<size_t>(load.players, 1));
+            req.score = (int32_t)(rng() % 100000);
+            board.handle(req, reply);
+            if (reply.status != LbStatus::Ok) break;
+        }
+        if (!board.commit() || board.size() < seed_entries) {
+            std::fprintf(stderr, "pong_leaderboard: seeding failed\n");
+            return 1;
+        }
+        std::printf("pong_leaderboard: seeded to %zu entries, %zu players in %.2f s\n", board.size(), board.players(),
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+
+    LeaderboardServer server(board, cfg);
+    if (!server.start(err)) {
+        std::fprintf(stderr, "pong_leaderboard: %s\n", err.c_str());
+        return 1;
+    }
+    LoadClients clients(load);
+    if (load.connections && !clients.start(err)) {
+        std::fprintf(stderr, "pong_leaderboard: clients: %s\n", err.c_str());
+        return 1;
+    }
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    std::printf("pong_leaderboard: serving on %s%s%s, %zu clients over %s\n",
+                cfg.port ? ("127.0.0.1:" + std::to_string(cfg.port)).c_str() : "",
+                cfg.port && !cfg.unix_path.empty() ? " and " : "", cfg.unix_path.c_str(),
+                load.connections, cfg.unix_path.empty() ? "tcp" : "unix");
+    std::printf("%4s %9s %8s %8s %8s %8s %7s %7s %7s\n",
+                "sec", "qps", "submit", "p50 us", "p99 us", "max us", "fsyncs", "conns", "errors");
+
+    // Reporter: the server loop owns the calling thread
+    LoadStats total;
+    uint64_t total_commits = 0, total_batches = 0, total_bad = 0;
+    std::thread reporter([&] {
+        for (long sec = 1; !g_stop.load(); ++sec) {
+            for (int i = 0; i < 10 && !g_stop.load(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            LbServerStats s = server.take_stats();
+            LoadStats c = clients.take_stats();
+            uint64_t served = 0;
+            for (uint64_t n : s.requests) served += n;
+            std::vector<double> us;
+            for (const auto &v : c.us) us.insert(us.end(), v.begin(), v.end());
+            const double max_us = us.empty() ? 0.0 : *std::max_element(us.begin(), us.end());
+            std::printf("%4ld %9llu %8llu %8.1f %8.1f %8.1f %7llu %7llu %7llu\n", sec, (unsigned long long)served,
+                        (unsigned long long)s.requests[(int)LbType::Submit], percentile(us, 0.5), percentile(us, 0.99),
+                        max_us, (unsigned long long)s.commits, (unsigned long long)s.connections,
+                        (unsigned long long)(c.errors + s.bad_requests));
+            std::fflush(stdout);
+            for (int t = 0; t < 5; ++t) {
+                total.replies[t] += c.replies[t];
+                total.us[t].insert(total.us[t].end(), c.us[t].begin(), c.us[t].end());
+            }
+            total.not_found += c.not_found;
+            total.errors += c.errors;
+            total_commits += s.commits;
+            total_batches += s.batches;
+            total_bad += s.bad_requests;
+            if (seconds > 0 && sec >= seconds) g_stop.store(true);
+        }
+    });
+    const auto run_start = std::chrono::steady_clock::now();
+    const bool durable = server.run(g_stop);
+    const double run_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
+    g_stop.store(true);
+    reporter.join();
+    clients.stop();
+    if (!durable) return 1;
+    if (!board.commit()) std::fprintf(stderr, "pong_leaderboard: final log flush failed\n");
+
+    std::printf("\nsummary\n");
+    std::printf("  board            %zu entries, %zu players\n", board.size(), board.players());
+    std::printf("  server           %llu batches, %llu group commits, %llu bad requests\n",
+                (unsigned long long)total_batches, (unsigned long long)total_commits, (unsigned long long)total_bad);
+    if (!load.connections) return 0;
+    uint64_t replies = 0;
+    std::vector<double> all;
+    for (int t = 1; t < 5; ++t) {
+        replies += total.replies[t];
+        all.insert(all.end(), total.us[t].begin(), total.us[t].end());
+    }
+    std::printf("  clients          %zu over %s, %llu replies (%.0f qps), %llu not found, %llu errors\n",
+                load.connections, cfg.unix_path.empty() ? "tcp" : "unix", (unsigned long long)replies,
+                run_s > 0.0 ? (double)replies / run_s : 0.0, (unsigned long long)total.not_found,
+                (unsigned long long)total.errors);
+    std::printf("  latency us       all     p50 %7.1f  p99 %7.1f\n", percentile(all, 0.5), percentile(all, 0.99));
+    for (int t = 1; t < 5; ++t) {
+        std::printf("                   %-7s p50 %7.1f  p99 %7.1f  (%llu)\n", kTypeNames[t],
+                    percentile(total.us[t], 0.5), percentile(total.us[t], 0.99), (unsigned long long)total.replies[t]);
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * @file load_clients.cpp
+ * @brief Implementation of the leaderboard load generator
+ */
+
+#include "leaderboard/load_clients.h"
+#include "server/protocol.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <random>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// A thread hands its samples to take_stats() at this count or interval
+constexpr size_t kFlushSamples = 4096;
+constexpr auto kFlushInterval = std::chrono::milliseconds(50);
+
+} // namespace
+
+struct LoadClients::Conn {
+    int fd = -1;
+    uint32_t req = 0;                 ///< Id of the request in flight
+    LbType type = LbType::Top;
+    Clock::time_point sent;
+    std::vector<uint8_t> in;
+};
+
+struct LoadClients::Group {
+    std::vector<Conn> conns;
+    std::mt19937_64 rng;
+};
+
+LoadClients::LoadClients(const LoadConfig &c) : cfg(c) {
+    if (cfg.threads == 0) cfg.threads = 1;
+    if (cfg.players == 0) cfg.players = 1;
+    if (cfg.submit_pct > 100) cfg.submit_pct = 100;
+}
+
+LoadClients::~LoadClients() {
+    stop();
+    for (Group *g : groups) {
+        for (Conn &c : g->conns) if (c.fd >= 0) close(c.fd);
+        delete g;
+    }
+}
+
+int LoadClients::connect_one(std::string &err) const {
+    int fd;
+    if (!cfg.unix_path.empty()) {
+        sockaddr_un a{};
+        a.sun_family = AF_UNIX;
+        if (cfg.unix_path.size() >= sizeof(a.sun_path)) { err = "unix socket path too long"; return -1; }
+        std::memcpy(a.sun_path, cfg.unix_path.c_str(), cfg.unix_path.size() + 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (const sockaddr *)&a, sizeof(a)) == 0) return fd;
+        err = std::string("unix connect: ") + std::strerror(errno);
+    } else {
+        sockaddr_in a{};
+        a.sin_family = AF_INET;
+        a.sin_port = htons(cfg.port);
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (const sockaddr *)&a, sizeof(a)) == 0) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            return fd;
+        }
+        err = std::string("tcp connect: ") + std::strerror(errno);
+    }
+    if (fd >= 0) close(fd);
+    return -1;
+}
+
+bool LoadClients::start(std::string &err) {
+    const size_t per = (cfg.connections + cfg.threads - 1) / cfg.threads;
+    for (size_t first = 0; first < cfg.connections; first += per) {
+        Group *g = new Group();
+        groups.push_back(g);
+        g->rng.seed(cfg.seed + first);
+        g->conns.resize(std::min(per, cfg.connections - first));
+        for (Conn &c : g->conns) {
+            c.fd = connect_one(err);
+            if (c.fd < 0) return false;
+            fcntl(c.fd, F_SETFL, fcntl(c.fd, F_GETFL, 0) | O_NONBLOCK);
+        }
+    }
+    for (Group *g : groups) threads.emplace_back([this, g] { thread_loop(*g); });
+    return true;
+}
+
+void LoadClients::stop() {
+    stopping.store(true);
+    for (auto &t : threads) t.join();
+    threads.clear();
+}
+
+LoadStats LoadClients::take_stats() {
+    std::lock_guard<std::mutex> lock(stats_mtx);
+    LoadStats s = std::move(acc);
+    acc = LoadStats{};
+    return s;
+}
+
+void LoadClients::thread_loop(Group &g) {
+    LoadStats local;
+    size_t samples = 0;
+    Clock::time_point flushed = Clock::now();
+    std::vector<uint8_t> body, frame;
+    LbRequest req;
+    LbReply reply;
+
+    auto flush = [&] {
+        std::lock_guard<std::mutex> lock(stats_mtx);
+        for (int t = 0; t < 5; ++t) {
+            acc.replies[t] += local.replies[t];
+            acc.us[t].insert(acc.us[t].end(), local.us[t].begin(), local.us[t].end());
+            local.us[t].clear();
+            local.replies[t] = 0;
+        }
+        acc.not_found += local.not_found;
+        acc.errors += local.errors;
+        local.not_found = local.errors = 0;
+        samples = 0;
+        flushed = Clock::now();
+    };
+
+    auto send_next = [&](Conn &c) {
+        const unsigned roll = (unsigned)(g.rng() % 100);
+        const unsigned rest = 100 - cfg.submit_pct;
+        req = LbRequest{};
+        req.req = ++c.req;
+        req.name = "player-" + std::to_string(g.rng() % cfg.players);
+        if (roll < cfg.submit_pct) {
+            req.type = LbType::Submit;
+            req.score = (int32_t)(g.rng() % 100000);
+        } else if (roll < cfg.submit_pct + rest * 40 / 90) {
+            req.type = LbType::Top;
+            req.first = 0;
+            req.count = 10;
+        } else if (roll < cfg.submit_pct + rest * 65 / 90) {
+            req.type = LbType::Rank;
+        } else {
+            req.type = LbType::Around;
+            req.count = 5;
+        }
+        body.clear();
+        frame.clear();
+        encode_request(req, body);
+        append_frame(body.data(), body.size(), frame);
+        c.type = req.type;
+        c.sent = Clock::now();
+        // A request is far smaller than the socket buffer and the connection has nothing else queued
+        if (send(c.fd, frame.data(), frame.size(), MSG_NOSIGNAL) != (ssize_t)frame.size()) ++local.errors;
+    };
+
+    for (Conn &c : g.conns) send_next(c);
+    std::vector<pollfd> fds;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        fds.clear();
+        for (const Conn &c : g.conns) fds.push_back({ c.fd, POLLIN, 0 });
+        if (Clock::now() - flushed >= kFlushInterval) flush();
+        if (poll(fds.data(), (nfds_t)fds.size(), 50) <= 0) continue;
+        for (size_t i = 0; i < g.conns.size(); ++i) {
+            if (!(fds[i].revents & POLLIN)) continue;
+            Conn &c = g.conns[i];
+            uint8_t buf[16384];
+            ssize_t n;
+            bool answered = false;
+            while ((n = recv(c.fd, buf, sizeof(buf), 0)) > 0) c.in.insert(c.in.end(), buf, buf + n);
+            if (n == 0) {   // server went away: poll() ignores negative descriptors
+                ++local.errors;
+                close(c.fd);
+                c.fd = -1;
+                continue;
+            }
+            const bool framed = drain_frames(c.in, [&](const uint8_t *data, size_t len) {
+                answered = true;
+                if (!decode_reply(data, len, reply) || reply.req != c.req || reply.type != c.type) { ++local.errors; return; }
+                const double us = std::chrono::duration<double, std::micro>(Clock::now() - c.sent).count();
+                ++local.replies[(int)reply.type];
+                local.us[(int)reply.type].push_back(us);
+                ++samples;
+                if (reply.status == LbStatus::NotFound) ++local.not_found;
+                else if (reply.status != LbStatus::Ok) ++local.errors;
+            }, kLbMaxMessageBytes);
+            if (!framed) { ++local.errors; c.in.clear(); }
+            if (answered) send_next(c);
+        }
+        if (samples >= kFlushSamples) flush();
+    }
+    flush();
+}
@@ -0,0 +1,84 @@
+/**
+ * @file load_clients.h
+ * @brief Closed-loop load generator for pong_leaderboard
+ *
+ * Every connection keeps exactly one request in flight: it sends, waits
+ * for the reply with the same request id, records the round trip and
+ * sends the next one. Requests follow a fixed mix (submit, top 10,
+ * rank-of-player, around-me) over players "player-0" .. "player-N-1",
+ * so the measured latency includes the server's group commit for
+ * submissions. Connections are spread over a few client threads that
+ * each poll their own connections.
+ */
+
+#pragma once
+
+#include "leaderboard/lb_protocol.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Load generator configuration
+ */
+struct LoadConfig {
+    uint16_t port = kLbDefaultPort;   ///< TCP port (ignored when unix_path is set)
+    std::string unix_path;            ///< Connect over this Unix socket instead of TCP
+    size_t connections = 32;
+    unsigned threads = 2;
+    size_t players = 100000;          ///< Distinct player names
+    unsigned submit_pct = 10;         ///< Remaining requests: 4/9 top 10, 5/18 rank, 5/18 around-me
+    uint64_t seed = 1;
+};
+
+/**
+ * @brief Client-side results since start (or the last take_stats())
+ */
+struct LoadStats {
+    uint64_t replies[5] = {};          ///< Indexed by LbType
+    uint64_t not_found = 0;            ///< Rank / Around for players without a score yet
+    uint64_t errors = 0;               ///< Malformed or mismatched replies, error statuses
+    std::vector<double> us[5];         ///< Round trip per reply, microseconds, by LbType
+};
+
+/**
+ * @brief Pool of closed-loop leaderboard clients
+ */
+class LoadClients {
+public:
+    explicit LoadClients(const LoadConfig &cfg);
+    ~LoadClients();
+    LoadClients(const LoadClients &) = delete;
+    LoadClients &operator=(const LoadClients &) = delete;
+
+    /**
+     * @brief Connect and start the client threads
+     *
+     * @param err Receives a description on failure
+     * @return true on success
+     */
+    bool start(std::string &err);
+
+    /// @brief Stop and join the client threads
+    void stop();
+
+    /// @brief Return and reset the results (thread-safe)
+    LoadStats take_stats();
+
+private:
+    struct Conn;
+    struct Group;
+
+    int connect_one(std::string &err) const;
+    void thread_loop(Group &g);
+
+    LoadConfig cfg;
+    std::vector<Group *> groups;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping{false};
+    std::mutex stats_mtx;
+    LoadStats acc;
+};
@@ -0,0 +1,74 @@
+/**
+ * @file metrics/game_metrics.cpp
+ * @brief Registration and per-frame feeding of the game metrics
+ */
+
+#include "metrics/game_metrics.h"
+#include "render/soft_renderer.h"
+
+namespace {
+
+/// Frame intervals and work times: around the 60 Hz budget, out to visible hitches
+const std::vector<double> kFrameBounds = { 0.001, 0.002, 0.004, 0.008, 0.012, 0.0167, 0.020, 0.025,
+                                           0.0334, 0.050, 0.100, 0.250 };
+/// Path tracer passes: from terminal-sized frames to a full window at high spp
+const std::vector<double> kTraceBounds = { 0.0005, 0.001, 0.002, 0.004, 0.008, 0.016, 0.033, 0.066,
+                                           0.133, 0.250, 0.500, 1.0 };
+
+const char *const kSideLabels[4] = { "side=\"left\"", "side=\"right\"", "side=\"top\"", "side=\"bottom\"" };
+
+} // namespace
+
+GameMetrics::GameMetrics(MetricsRegistry &reg)
+: frames(reg.counter("pong_frames_total", "Frames (or headless ticks) run by the game loop")),
+  missed(reg.counter("pong_frames_missed_total", "Frames that started more than one period late")),
+  interval(reg.histogram("pong_frame_interval_seconds", "Time between frame starts", kFrameBounds)),
+  work(reg.histogram("pong_frame_work_seconds", "Time a frame spent updating and rendering", kFrameBounds)),
+  score_left(reg.gauge("pong_score", "Current score", "side=\"left\"")),
+  score_right(reg.gauge("pong_score", "Current score", "side=\"right\"")),
+  balls(reg.gauge("pong_balls", "Balls in play")),
+  mode(reg.gauge("pong_mode", "Game mode (0 classic, 1 three enemies, 2 obstacles, 3 multi-ball, 4 obstacles + multi-ball)")),
+  pt_frames(reg.counter("pong_pt_frames_total", "Frames rendered by the path tracer")),
+  pt_trace(reg.histogram("pong_pt_trace_seconds", "Path tracing kernel time per frame (SRStats msTrace)", kTraceBounds)),
+  pt_total(reg.histogram("pong_pt_render_seconds", "Total path tracer time per frame (SRStats msTotal)", kTraceBounds)),
+  pt_spp(reg.gauge("pong_pt_samples_per_pixel", "Samples per pixel of the last frame")),
+  pt_threads(reg.gauge("pong_pt_threads", "Threads used by the last frame, including the caller")),
+  pt_bounce_depth(reg.gauge("pong_pt_avg_bounce_depth", "Average bounces per path in the last frame")),
+  pt_pixels(reg.gauge("pong_pt_internal_pixels", "Internal render target size of the last frame")),
+  pt_rays(reg.counter("pong_pt_rays_total", "Primary rays traced")) {
+    for (int s = 0; s < 4; ++s) hits[s] = &reg.counter("pong_paddle_hits_total", "Balls returned by a paddle", kSideLabels[s]);
+    for (int s = 0; s < 4; ++s) points[s] = &reg.counter("pong_points_total", "Points scored", kSideLabels[s]);
+}
+
+void GameMetrics::frame(double interval_s, double work_s, uint64_t missed_total) {
+    frames.add();
+    interval.observe(interval_s);
+    work.observe(work_s);
+    if (missed_total > missed_seen) {
+        missed.add(missed_total - missed_seen);
+        missed_seen = missed_total;
+    }
+}
+
+void GameMetrics::state(const GameState &gs) {
+    score_left.set(gs.score_left);
+    score_right.set(gs.score_right);
+    balls.set((double)gs.entities.balls().size());
+    mode.set((double)(int)gs.mode);
+}
+
+void GameMetrics::render(const SRStats &s) {
+    pt_frames.add();
+    pt_trace.observe(s.msTrace * 1e-3);
+    pt_total.observe(s.msTotal * 1e-3);
+    pt_spp.set(s.spp);
+    pt_threads.set(s.threadsUsed);
+    pt_bounce_depth.set(s.avgBounceDepth);
+    pt_pixels.set((double)s.internalW * s.internalH);
+    if (s.totalRays > 0) pt_rays.add((uint64_t)s.totalRays);
+}
+
+void GameMetrics::on_event(const GameEvent &e) {
+    const size_t side = (size_t)e.side & 3;
+    (e.kind == GameEventKind::Point ? points : hits)[side]->add();
+}
@@ -0,0 +1,58 @@
+/**
+ * @file metrics/game_metrics.h
+ * @brief The metrics the game frontends export
+ *
+ * One set of series for every frontend (pong, pong --headless, pong_win):
+ * frame pacing, path tracer statistics (SRStats) and game counters. The
+ * frontend's loop feeds it once per frame; paddle hits and points arrive
+ * through the GameCore event sink. Everything here is a relaxed atomic
+ * update, so feeding it costs the loop well under a microsecond.
+ */
+
+#pragma once
+
+#include "core/game_core.h"
+#include "metrics/metrics.h"
+
+struct SRStats;
+
+class GameMetrics : public GameEventSink {
+public:
+    explicit GameMetrics(MetricsRegistry &reg);
+
+    /**
+     * @brief One frame (or headless tick) of the loop
+     *
+     * @param interval_s Time since the previous frame started
+     * @param work_s Time the frame spent simulating and rendering (not waiting)
+     * @param missed_total Frames the pacer has reported missed so far
+     */
+    void frame(double interval_s, double work_s, uint64_t missed_total);
+    /// @brief Scores, balls in play, mode (after the update)
+    void state(const GameState &gs);
+    /// @brief Statistics of the path-traced frame just rendered
+    void render(const SRStats &s);
+
+    void on_event(const GameEvent &e) override;
+
+private:
+    MetricCounter &frames;
+    MetricCounter &missed;
+    MetricHistogram &interval;
+    MetricHistogram &work;
+    MetricCounter *hits[4];          ///< Indexed by PaddleSide
+    MetricCounter *points[4];
+    MetricGauge &score_left;
+    MetricGauge &score_right;
+    MetricGauge &balls;
+    MetricGauge &mode;
+    MetricCounter &pt_frames;
+    MetricHistogram &pt_trace;
+    MetricHistogram &pt_total;
+    MetricGauge &pt_spp;
+    MetricGauge &pt_threads;
+    MetricGauge &pt_bounce_depth;
+    MetricGauge &pt_pixels;
+    MetricCounter &pt_rays;
+    uint64_t missed_seen = 0;
+};
@@ -0,0 +1,157 @@
+/**
+ * @file metrics/metrics.cpp
+ * @brief Per-thread metric slots and the text exposition
+ */
+
+#include "metrics/metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+std::atomic<size_t> g_next_shard{0};
+
+void append_value(std::string &out, double v) {
+    if (std::isnan(v)) { out += "NaN"; return; }
+    if (std::isinf(v)) { out += v > 0 ? "+Inf" : "-Inf"; return; }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.10g", v);
+    out += buf;
+}
+
+void append_u64(std::string &out, uint64_t v) {
+    char buf[24];
+    std::snprintf(buf, sizeof(buf), "%llu", (unsigned long long)v);
+    out += buf;
+}
+
+/// `name{labels}` or `name{labels,extra}`; braces are left out when both are empty
+void append_series(std::string &out, const std::string &name, const char *suffix, const std::string &labels,
+                   const std::string &extra = {}) {
+    out += name;
+    out += suffix;
+    if (labels.empty() && extra.empty()) { out += ' '; return; }
+    out += '{';
+    out += labels;
+    if (!labels.empty() && !extra.empty()) out += ',';
+    out += extra;
+    out += "} ";
+}
+
+uint64_t double_bits(double v) { uint64_t b; std::memcpy(&b, &v, sizeof(b)); return b; }
+double bits_double(uint64_t b) { double v; std::memcpy(&v, &b, sizeof(v)); return v; }
+
+} // namespace
+
+int metrics_detail::claim_shard() {
+    const size_t next = g_next_shard.fetch_add(1, std::memory_order_relaxed);
+    return (int)std::min(next, kMetricShards);
+}
+
+uint64_t MetricCounter::value() const {
+    uint64_t sum = 0;
+    for (const Slot &s : slots) sum += s.v.load(std::memory_order_relaxed);
+    return sum;
+}
+
+MetricHistogram::MetricHistogram(std::vector<double> bounds)
+: upper(std::move(bounds)), stride((upper.size() + 2 + 7) / 8), lines(new Line[(kMetricShards + 1) * stride]()) {}
+
+void MetricHistogram::observe(double x) {
+    const size_t shard = metric_shard();
+    size_t b = 0;
+    while (b < upper.size() && x > upper[b]) ++b;
+    metrics_detail::add(word(shard, 1 + b), 1, shard);
+    std::atomic<uint64_t> &sum = word(shard, 0);
+    uint64_t old = sum.load(std::memory_order_relaxed);
+    if (shard < kMetricShards) {
+        sum.store(double_bits(bits_double(old) + x), std::memory_order_relaxed);
+    } else {
+        while (!sum.compare_exchange_weak(old, double_bits(bits_double(old) + x), std::memory_order_relaxed)) {}
+    }
+}
+
+void MetricHistogram::read(std::vector<uint64_t> &counts, uint64_t &count, double &sum) const {
+    counts.assign(upper.size() + 1, 0);
+    count = 0;
+    sum = 0.0;
+    for (size_t s = 0; s <= kMetricShards; ++s) {
+        sum += bits_double(word(s, 0).load(std::memory_order_relaxed));
+        for (size_t b = 0; b < counts.size(); ++b) counts[b] += word(s, 1 + b).load(std::memory_order_relaxed);
+    }
+    for (uint64_t c : counts) count += c;
+}
+
+MetricCounter &MetricsRegistry::counter(const std::string &name, const std::string &help, const std::string &labels) {
+    std::lock_guard<std::mutex> lk(mtx);
+    counters.emplace_back();
+    series.push_back({ name, help, labels, Type::Counter, counters.size() - 1 });
+    return counters.back();
+}
+
+MetricGauge &MetricsRegistry::gauge(const std::string &name, const std::string &help, const std::string &labels) {
+    std::lock_guard<std::mutex> lk(mtx);
+    gauges.emplace_back();
+    series.push_back({ name, help, labels, Type::Gauge, gauges.size() - 1 });
+    return gauges.back();
+}
+
+MetricHistogram &MetricsRegistry::histogram(const std::string &name, const std::string &help, std::vector<double> bounds,
+                                            const std::string &labels) {
+    std::lock_guard<std::mutex> lk(mtx);
+    histograms.emplace_back(std::move(bounds));
+    series.push_back({ name, help, labels, Type::Histogram, histograms.size() - 1 });
+    return histograms.back();
+}
+
+void MetricsRegistry::render(std::string &out) const {
+    static const char *const kTypeNames[] = { "counter", "gauge", "histogram" };
+    std::lock_guard<std::mutex> lk(mtx);
+    out.clear();
+    std::vector<bool> done(series.size(), false);
+    for (size_t first = 0; first < series.size(); ++first) {
+        if (done[first]) continue;
+        const Series &f = series[first];
+        out += "# HELP " + f.name + ' ' + f.help + '\n';
+        out += "# TYPE " + f.name + ' ' + kTypeNames[(int)f.type] + '\n';
+        // Every series of the family, in registration order
+        for (size_t i = first; i < series.size(); ++i) {
+            const Series &s = series[i];
+            if (done[i] || s.name != f.name) continue;
+            done[i] = true;
+            if (s.type == Type::Counter) {
+                append_series(out, s.name, "", s.labels);
+                append_u64(out, counters[s.index].value());
+                out += '\n';
+            } else if (s.type == Type::Gauge) {
+                append_series(out, s.name, "", s.labels);
+                append_value(out, gauges[s.index].value());
+                out += '\n';
+            } else {
+                const MetricHistogram &h = histograms[s.index];
+                uint64_t count = 0;
+                double sum = 0.0;
+                h.read(scratch, count, sum);
+                uint64_t cumulative = 0;
+                for (size_t b = 0; b < scratch.size(); ++b) {
+                    cumulative += scratch[b];
+                    std::string le = "le=\"";
+                    if (b < h.bounds().size()) append_value(le, h.bounds()[b]);
+                    else le += "+Inf";
+                    le += '"';
+                    append_series(out, s.name, "_bucket", s.labels, le);
+                    append_u64(out, cumulative);
+                    out += '\n';
+                }
+                append_series(out, s.name, "_sum", s.labels);
+                append_value(out, sum);
+                out += '\n';
+                append_series(out, s.name, "_count", s.labels);
+                append_u64(out, count);
+                out += '\n';
+            }
+        }
+    }
+}
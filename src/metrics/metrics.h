@@ -0,0 +1,140 @@
+/**
+ * @file metrics/metrics.h
+ * @brief Lock-free counters, gauges and histograms for the metrics endpoint
+ *
+ * Metrics are registered once, before the threads that update them start,
+ * and then updated from any thread without taking a lock. Counters and
+ * histograms keep one cache-line-aligned slot per thread: the first
+ * kMetricShards threads that update any metric each own a slot and update
+ * it with a plain load and store (no locked instruction), later threads
+ * share one extra slot through atomic read-modify-writes. The game loop and
+ * worker threads therefore never write to the same line, and a scrape
+ * never holds anything an update waits for. A scrape sums the slots with
+ * relaxed loads; it may see a histogram's buckets a few updates apart,
+ * which the exposition format tolerates since every series only grows.
+ *
+ * MetricsRegistry::render() writes the Prometheus text format (0.0.4);
+ * MetricsServer (metrics/metrics_server.h) serves it over HTTP.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Slots owned by one thread each; threads past this many share slot kMetricShards
+constexpr size_t kMetricShards = 16;
+
+namespace metrics_detail {
+inline thread_local int t_shard = -1;
+int claim_shard();
+
+/// Add @p n to a slot word: a plain store when the calling thread owns the slot
+inline void add(std::atomic<uint64_t> &w, uint64_t n, size_t shard) {
+    if (shard < kMetricShards) w.store(w.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    else w.fetch_add(n, std::memory_order_relaxed);
+}
+} // namespace metrics_detail
+
+/// @brief Slot of the calling thread (assigned on its first update)
+inline size_t metric_shard() {
+    int s = metrics_detail::t_shard;
+    if (s < 0) s = metrics_detail::t_shard = metrics_detail::claim_shard();
+    return (size_t)s;
+}
+
+/**
+ * @brief Monotonic count (events, bytes, frames)
+ */
+class MetricCounter {
+public:
+    void add(uint64_t n = 1) {
+        const size_t s = metric_shard();
+        metrics_detail::add(slots[s].v, n, s);
+    }
+    /// @brief Sum over all threads
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Slot { std::atomic<uint64_t> v{0}; };
+    Slot slots[kMetricShards + 1];
+};
+
+/**
+ * @brief Last value written (sizes, settings, per-frame statistics)
+ */
+class MetricGauge {
+public:
+    void set(double x) { v.store(x, std::memory_order_relaxed); }
+    double value() const { return v.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> v{0.0};
+};
+
+/**
+ * @brief Distribution over fixed upper bounds (durations in seconds, sizes)
+ *
+ * observe() finds the bucket with a short linear scan of the bounds and
+ * bumps it in the calling thread's slot; the sum is kept next to the
+ * buckets in the same slot.
+ */
+class MetricHistogram {
+public:
+    /// @param bounds Ascending bucket upper bounds; an implicit +Inf bucket follows
+    explicit MetricHistogram(std::vector<double> bounds);
+
+    void observe(double x);
+
+    const std::vector<double> &bounds() const { return upper; }
+    /// @brief Per-bucket counts (not cumulative; last = +Inf), total count and sum over all threads
+    void read(std::vector<uint64_t> &counts, uint64_t &count, double &sum) const;
+
+private:
+    struct alignas(64) Line { std::atomic<uint64_t> w[8]; };
+    std::atomic<uint64_t> &word(size_t shard, size_t k) const { return lines[shard * stride + k / 8].w[k % 8]; }
+
+    std::vector<double> upper;
+    size_t stride;                   ///< Lines per slot: the sum's bits, then one word per bucket
+    std::unique_ptr<Line[]> lines;
+};
+
+/**
+ * @brief Named metrics and their text exposition
+ *
+ * Registration and render() share a mutex; updates go straight to the
+ * returned objects, which stay valid for the registry's lifetime. A
+ * series is a name plus an optional label list without braces, e.g.
+ * `side="left"`; series of one name form one family in the output.
+ */
+class MetricsRegistry {
+public:
+    MetricCounter &counter(const std::string &name, const std::string &help, const std::string &labels = {});
+    MetricGauge &gauge(const std::string &name, const std::string &help, const std::string &labels = {});
+    MetricHistogram &histogram(const std::string &name, const std::string &help, std::vector<double> bounds,
+                               const std::string &labels = {});
+
+    /// @brief Replace @p out with the current values in the Prometheus text format
+    void render(std::string &out) const;
+
+private:
+    enum class Type : uint8_t { Counter, Gauge, Histogram };
+    struct Series {
+        std::string name, help, labels;
+        Type type;
+        size_t index;                ///< Into the deque of its type
+    };
+
+    mutable std::mutex mtx;
+    std::deque<MetricCounter> counters;
+    std::deque<MetricGauge> gauges;
+    std::deque<MetricHistogram> histograms;
+    std::vector<Series> series;
+    mutable std::vector<uint64_t> scratch;
+};
@@ -0,0 +1,204 @@
+/**
+ * @file metrics/metrics_server.cpp
+ * @brief Implementation of the localhost metrics endpoint
+ */
+
+#include "metrics/metrics_server.h"
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+using socket_t = SOCKET;
+const socket_t kNoSocket = INVALID_SOCKET;
+void close_socket(socket_t s) { closesocket(s); }
+int poll_socket(socket_t s, int ms) {
+    WSAPOLLFD p{};
+    p.fd = s;
+    p.events = POLLRDNORM;
+    return WSAPoll(&p, 1, ms);
+}
+std::string socket_error(const char *what) { return std::string(what) + ": winsock error " + std::to_string(WSAGetLastError()); }
+void set_timeouts(socket_t s, int ms) {
+    DWORD t = (DWORD)ms;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char *)&t, sizeof(t));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char *)&t, sizeof(t));
+}
+const int kSendFlags = 0;
+#else
+using socket_t = int;
+const socket_t kNoSocket = -1;
+void close_socket(socket_t s) { close(s); }
+int poll_socket(socket_t s, int ms) {
+    pollfd p{};
+    p.fd = s;
+    p.events = POLLIN;
+    return poll(&p, 1, ms);
+}
+std::string socket_error(const char *what) { return std::string(what) + ": " + std::strerror(errno); }
+void set_timeouts(socket_t s, int ms) {
+    timeval t{};
+    t.tv_sec = ms / 1000;
+    t.tv_usec = (ms % 1000) * 1000;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &t, sizeof(t));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &t, sizeof(t));
+}
+#ifdef MSG_NOSIGNAL
+const int kSendFlags = MSG_NOSIGNAL;   // a scraper hanging up must not SIGPIPE the game
+#else
+const int kSendFlags = 0;
+#endif
+#endif
+
+/// How often the accept loop checks for stop(), and the per-call I/O timeout
+constexpr int kPollMs = 200;
+constexpr int kIoTimeoutMs = 1000;
+/// Whole-connection deadline: a client trickling bytes cannot hold the thread past it
+constexpr int kConnectionMs = 2000;
+/// Request heads past this are refused
+constexpr size_t kMaxRequest = 8192;
+
+using Deadline = std::chrono::steady_clock::time_point;
+
+/// Milliseconds left until @p deadline (0 once it has passed)
+int ms_left(Deadline deadline) {
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    return left.count() > 0 ? (int)left.count() : 0;
+}
+
+/// Each send() can block up to kIoTimeoutMs, so the deadline is overrun by at most that much
+bool send_all(socket_t s, const std::string &data, Deadline deadline) {
+    size_t off = 0;
+    while (off < data.size()) {
+        if (ms_left(deadline) == 0) return false;
+        const int n = send(s, data.data() + off, (int)(data.size() - off), kSendFlags);
+        if (n <= 0) return false;
+        off += (size_t)n;
+    }
+    return true;
+}
+
+void append_head(std::string &out, const char *status, const char *type, size_t length) {
+    out = "HTTP/1.1 ";
+    out += status;
+    out += "\r\nContent-Type: ";
+    out += type;
+    out += "\r\nContent-Length: " + std::to_string(length) + "\r\nConnection: close\r\n\r\n";
+}
+
+} // namespace
+
+MetricsServer::~MetricsServer() { stop(); }
+
+bool MetricsServer::start(uint16_t port, std::string &err) {
+    if (running()) { err = "already running"; return false; }
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) { err = "WSAStartup failed"; return false; }
+#endif
+    const socket_t s = socket(AF_INET, SOCK_STREAM, 0);
+    if (s == kNoSocket) { err = socket_error("socket"); return false; }
+    int one = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char *)&one, sizeof(one));
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(a);
+    if (bind(s, (sockaddr *)&a, sizeof(a)) != 0 || listen(s, 16) != 0 || getsockname(s, (sockaddr *)&a, &len) != 0) {
+        err = socket_error("metrics listen");
+        close_socket(s);
+        return false;
+    }
+    listen_fd = (intptr_t)s;
+    bound_port = ntohs(a.sin_port);
+    stopping.store(false);
+    thread = std::thread([this] { run(); });
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!thread.joinable()) return;
+    stopping.store(true);
+    thread.join();
+    close_socket((socket_t)listen_fd);
+    listen_fd = -1;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void MetricsServer::run() {
+    const socket_t ls = (socket_t)listen_fd;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (poll_socket(ls, kPollMs) <= 0) continue;
+        const socket_t c = accept(ls, nullptr, nullptr);
+        if (c == kNoSocket) continue;
+        set_timeouts(c, kIoTimeoutMs);
+        serve((intptr_t)c);
+        close_socket(c);
+    }
+}
+
+void MetricsServer::serve(intptr_t fd) {
+    const socket_t c = (socket_t)fd;
+    const Deadline deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kConnectionMs);
+    // Read the request head; the body (if any) is ignored
+    char buf[1024];
+    std::string req;
+    while (req.find("\r\n\r\n") == std::string::npos && req.find("\n\n") == std::string::npos) {
+        // SO_RCVTIMEO restarts with every byte, so wait against the connection's deadline instead
+        const int left = ms_left(deadline);
+        if (left == 0 || poll_socket(c, left) <= 0) return;
+        const int n = recv(c, buf, (int)sizeof(buf), 0);
+        if (n <= 0) return;
+        req.append(buf, (size_t)n);
+        if (req.size() > kMaxRequest) {
+            append_head(response, "431 Request Header Fields Too Large", "text/plain", 0);
+            send_all(c, response, deadline);
+            return;
+        }
+    }
+    const size_t sp1 = req.find(' ');
+    const size_t sp2 = sp1 == std::string::npos ? std::string::npos : req.find(' ', sp1 + 1);
+    const std::string method = req.substr(0, sp1);
+    std::string path = sp2 == std::string::npos ? std::string() : req.substr(sp1 + 1, sp2 - sp1 - 1);
+    path = path.substr(0, path.find('?'));
+
+    if (method != "GET" && method != "HEAD") {
+        body = "only GET and HEAD are supported\n";
+        append_head(response, "405 Method Not Allowed", "text/plain", body.size());
+        response += body;
+    } else if (path == "/metrics") {
+        reg.render(body);
+        append_head(response, "200 OK", "text/plain; version=0.0.4; charset=utf-8", body.size());
+        if (method == "GET") response += body;
+        scrape_count.fetch_add(1, std::memory_order_relaxed);
+    } else if (path == "/") {
+        body = "<html><body><a href=\"/metrics\">/metrics</a></body></html>\n";
+        append_head(response, "200 OK", "text/html", body.size());
+        if (method == "GET") response += body;
+    } else {
+        body = "not found; metrics are at /metrics\n";
+        append_head(response, "404 Not Found", "text/plain", body.size());
+        if (method == "GET") response += body;
+    }
+    send_all(c, response, deadline);
+}
@@ -0,0 +1,60 @@
+/**
+ * @file metrics/metrics_server.h
+ * @brief HTTP endpoint serving a MetricsRegistry on localhost
+ *
+ * A single background thread accepts connections on 127.0.0.1, answers
+ * `GET /metrics` with MetricsRegistry::render() and closes the
+ * connection. The game loop never waits on it: updates are lock-free
+ * (metrics/metrics.h), and a slow or stalled client only delays the next
+ * scrape, since each connection has to finish within one overall
+ * deadline of about two seconds.
+ * POSIX sockets, or Winsock on Windows.
+ */
+
+#pragma once
+
+#include "metrics/metrics.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/// Default port of the endpoint (pong --metrics, settings.json "metrics_port")
+constexpr uint16_t kMetricsDefaultPort = 9464;
+
+class MetricsServer {
+public:
+    explicit MetricsServer(const MetricsRegistry &reg) : reg(reg) {}
+    ~MetricsServer();
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+    /**
+     * @brief Listen on 127.0.0.1:@p port and start serving
+     *
+     * @param port TCP port (0 = any free port; see port())
+     * @param err Receives a description on failure
+     * @return true on success
+     */
+    bool start(uint16_t port, std::string &err);
+    /// @brief Stop serving and close the listener (also done by the destructor)
+    void stop();
+
+    bool running() const { return thread.joinable(); }
+    /// @brief Bound port (after start())
+    uint16_t port() const { return bound_port; }
+    /// @brief Requests answered with metrics
+    uint64_t scrapes() const { return scrape_count.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void serve(intptr_t fd);
+
+    const MetricsRegistry &reg;
+    intptr_t listen_fd = -1;          ///< int on POSIX, SOCKET on Windows
+    uint16_t bound_port = 0;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> scrape_count{0};
+    std::thread thread;
+    std::string body, response;       ///< Reused between scrapes
+};
@@ -0,0 +1,62 @@
+/**
+ * @file platform/key_event.h
+ * @brief Timestamped key events and the terminal escape-sequence parser
+ *
+ * Terminals send most keys as multi-byte sequences (CSI "ESC [ ... final",
+ * SS3 "ESC O x", Alt as an ESC prefix). KeyParser is fed raw bytes as they
+ * arrive, in chunks of any size, and keeps partial sequences between
+ * calls, so a sequence split across two reads still yields one event.
+ * A lone ESC is only reported once the caller decides no more bytes are
+ * coming (flush()).
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief Decoded key
+enum class Key : uint8_t {
+    Char,        ///< Printable character or Ctrl+letter; see KeyEvent::ch
+    Enter, Tab, Backspace, Escape,
+    Up, Down, Left, Right,
+    Home, End, Insert, Delete, PageUp, PageDown,
+    F1, F2, F3, F4, F5, F6, F7, F8, F9, F10, F11, F12,
+    Unknown      ///< Well-formed sequence with no mapping (ignored by the game)
+};
+
+/// @brief Modifier bits in KeyEvent::mods (xterm encoding minus one)
+enum KeyMod : uint8_t { kModShift = 1, kModAlt = 2, kModCtrl = 4 };
+
+/// @brief One key press
+struct KeyEvent {
+    Key key = Key::Unknown;
+    uint8_t mods = 0;      ///< KeyMod bits
+    uint32_t ch = 0;       ///< Unicode code point for Key::Char (lower-case letter for Ctrl+letter)
+    int64_t t_ns = 0;      ///< steady_clock time the bytes were read
+};
+
+/**
+ * @brief Incremental byte-to-KeyEvent decoder (UTF-8, CSI, SS3, Alt prefix)
+ */
+class KeyParser {
+public:
+    /// @brief Decode @p n bytes read at @p t_ns, appending complete events to @p out
+    void feed(const char *data, size_t n, int64_t t_ns, std::vector<KeyEvent> &out);
+    /// @brief True while a partial sequence is buffered
+    bool pending() const { return state != State::Ground || utf8_left > 0; }
+    /// @brief End any partial sequence: a lone ESC becomes Key::Escape, anything else is dropped
+    void flush(int64_t t_ns, std::vector<KeyEvent> &out);
+
+private:
+    enum class State : uint8_t { Ground, Esc, Csi, Ss3 };
+    void ground(unsigned char c, uint8_t mods, int64_t t, std::vector<KeyEvent> &out);
+    void csi_final(unsigned char f, int64_t t, std::vector<KeyEvent> &out);
+
+    State state = State::Ground;
+    int params[4] = {0, 0, 0, 0};
+    int nparams = 0;
+    uint32_t utf8_cp = 0;
+    int utf8_left = 0;
+    uint8_t utf8_mods = 0;
+};
@@ -0,0 +1,145 @@
+/**
+ * @file platform/key_parser.cpp
+ * @brief KeyParser implementation
+ */
+
+#include "platform/key_event.h"
+
+static void push(std::vector<KeyEvent> &out, Key k, uint8_t mods, uint32_t ch, int64_t t) {
+    KeyEvent ev;
+    ev.key = k;
+    ev.mods = mods;
+    ev.ch = ch;
+    ev.t_ns = t;
+    out.push_back(ev);
+}
+
+void KeyParser::ground(unsigned char c, uint8_t mods, int64_t t, std::vector<KeyEvent> &out) {
+    if (utf8_left > 0) {
+        if ((c & 0xC0) == 0x80) {
+            utf8_cp = (utf8_cp << 6) | (c & 0x3F);
+            if (--utf8_left == 0) push(out, Key::Char, utf8_mods, utf8_cp, t);
+            return;
+        }
+        utf8_left = 0;   // truncated sequence: drop it and decode c afresh
+    }
+    if (c == '\r' || c == '\n') push(out, Key::Enter, mods, 0, t);
+    else if (c == '\t') push(out, Key::Tab, mods, 0, t);
+    else if (c == 0x7F || c == 0x08) push(out, Key::Backspace, mods, 0, t);
+    else if (c >= 1 && c <= 26) push(out, Key::Char, (uint8_t)(mods | kModCtrl), (uint32_t)('a' + c - 1), t);
+    else if (c < 0x80) { if (c >= 0x20) push(out, Key::Char, mods, c, t); }
+    else if ((c & 0xE0) == 0xC0) { utf8_cp = c & 0x1F; utf8_left = 1; utf8_mods = mods; }
+    else if ((c & 0xF0) == 0xE0) { utf8_cp = c & 0x0F; utf8_left = 2; utf8_mods = mods; }
+    else if ((c & 0xF8) == 0xF0) { utf8_cp = c & 0x07; utf8_left = 3; utf8_mods = mods; }
+}
+
+void KeyParser::csi_final(unsigned char f, int64_t t, std::vector<KeyEvent> &out) {
+    // "CSI 1;5A": the second parameter is 1 + modifier bits
+    const uint8_t mods = nparams >= 2 && params[1] >= 2 ? (uint8_t)(params[1] - 1) : 0;
+    Key k = Key::Unknown;
+    switch (f) {
+        case 'A': k = Key::Up; break;
+        case 'B': k = Key::Down; break;
+        case 'C': k = Key::Right; break;
+        case 'D': k = Key::Left; break;
+        case 'H': k = Key::Home; break;
+        case 'F': k = Key::End; break;
+        case 'P': k = Key::F1; break;
+        case 'Q': k = Key::F2; break;
+        case 'R': k = Key::F3; break;
+        case 'S': k = Key::F4; break;
+        case 'Z': push(out, Key::Tab, kModShift, 0, t); return;
+        case '~':
+            switch (params[0]) {
+                case 1: case 7: k = Key::Home; break;
+                case 2: k = Key::Insert; break;
+                case 3: k = Key::Delete; break;
+                case 4: case 8: k = Key::End; break;
+                case 5: k = Key::PageUp; break;
+                case 6: k = Key::PageDown; break;
+                case 11: k = Key::F1; break;
+                case 12: k = Key::F2; break;
+                case 13: k = Key::F3; break;
+                case 14: k = Key::F4; break;
+                case 15: k = Key::F5; break;
+                case 17: k = Key::F6; break;
+                case 18: k = Key::F7; break;
+                case 19: k = Key::F8; break;
+                case 20: k = Key::F9; break;
+                case 21: k = Key::F10; break;
+                case 23: k = Key::F11; break;
+                case 24: k = Key::F12; break;
+                default: break;
+            }
+            break;
+        default: break;
+    }
+    push(out, k, mods, 0, t);
+}
+
+void KeyParser::feed(const char *data, size_t n, int64_t t, std::vector<KeyEvent> &out) {
+    for (size_t i = 0; i < n; ++i) {
+        const unsigned char c = (unsigned char)data[i];
+        switch (state) {
+            case State::Ground:
+                if (c == 0x1B) { utf8_left = 0; state = State::Esc; }
+                else ground(c, 0, t, out);
+                break;
+            case State::Esc:
+                if (c == '[') {
+                    state = State::Csi;
+                    nparams = 0;
+                    params[0] = params[1] = params[2] = params[3] = 0;
+                } else if (c == 'O') {
+                    state = State::Ss3;
+                } else if (c == 0x1B) {
+                    push(out, Key::Escape, 0, 0, t);   // ESC ESC: first one stood alone
+                } else {
+                    state = State::Ground;
+                    ground(c, kModAlt, t, out);
+                }
+                break;
+            case State::Csi:
+                if (c >= '0' && c <= '9') {
+                    if (nparams == 0) nparams = 1;
+                    int &p = params[nparams - 1];
+                    if (p < 10000) p = p * 10 + (c - '0');
+                } else if (c == ';') {
+                    if (nparams == 0) nparams = 1;
+                    if (nparams < 4) ++nparams;
+                } else if (c >= 0x20 && c <= 0x3F) {
+                    // private markers / intermediates: accepted, not interpreted
+                } else {
+                    state = State::Ground;
+                    if (c >= 0x40 && c <= 0x7E) csi_final(c, t, out);
+                }
+                break;
+            case State::Ss3: {
+                state = State::Ground;
+                Key k = Key::Unknown;
+                switch (c) {
+                    case 'A': k = Key::Up; break;
+                    case 'B': k = Key::Down; break;
+                    case 'C': k = Key::Right; break;
+                    case 'D': k = Key::Left; break;
+                    case 'H': k = Key::Home; break;
+                    case 'F': k = Key::End; break;
+                    case 'M': k = Key::Enter; break;
+                    case 'P': k = Key::F1; break;
+                    case 'Q': k = Key::F2; break;
+                    case 'R': k = Key::F3; break;
+                    case 'S': k = Key::F4; break;
+                    default: break;
+                }
+                push(out, k, 0, 0, t);
+                break;
+            }
+        }
+    }
+}
+
+void KeyParser::flush(int64_t t, std::vector<KeyEvent> &out) {
+    if (state == State::Esc) push(out, Key::Escape, 0, 0, t);
+    state = State::Ground;
+    utf8_left = 0;
+}
@@ -3,6 +3,8 @@
  * @brief Platform abstraction layer for console I/O operations (moved to src/platform)
  */
 #pragma once
+#include "platform/key_event.h"
+#include <cstddef>
 #include <memory>
 
 struct Platform {
@@ -12,6 +14,15 @@ struct Platform {
     virtual void clear_screen() = 0;
     virtual void set_cursor_visible(bool visible) = 0;
     virtual void enable_ansi() = 0;
+    /// @brief Write a whole frame to the terminal unbuffered; returns the number of system calls used
+    virtual int write(const char *data, size_t len) = 0;
+    /**
+     * @brief Next decoded, timestamped key press; false when none is waiting
+     *
+     * POSIX reads the terminal on its own thread from the first call on, so
+     * do not mix this with kbhit()/getch().
+     */
+    virtual bool next_event(KeyEvent &ev) = 0;
 };
 
 std::unique_ptr<Platform> createPlatform();
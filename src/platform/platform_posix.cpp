@@ -1,14 +1,83 @@
 /** platform/platform_posix.cpp - moved */
 #include "platform/platform.h"
 #ifndef _WIN32
+#include "platform/spsc_queue.h"
 #include <termios.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <sys/ioctl.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
 #include <iostream>
+#include <thread>
+#include <vector>
+
+static int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 class PosixPlatform : public Platform {
 public:
-    PosixPlatform(){ enable_ansi(); orig={}; tcgetattr(STDIN_FILENO,&orig); term=orig; term.c_lflag &= ~(ICANON|ECHO); tcsetattr(STDIN_FILENO,TCSANOW,&term);}~PosixPlatform()override{tcsetattr(STDIN_FILENO,TCSANOW,&orig);set_cursor_visible(true);}bool kbhit() override {int bytes=0; ioctl(STDIN_FILENO,FIONREAD,&bytes); return bytes>0;}int getch() override {char c=0; if(read(STDIN_FILENO,&c,1)<=0) return -1; return (int)c;}void clear_screen() override {std::cout<<"\x1b[2J\x1b[H";}void set_cursor_visible(bool v) override { if(v) std::cout<<"\x1b[?25h"; else std::cout<<"\x1b[?25l";}void enable_ansi() override {}
-private: struct termios orig; struct termios term;};
+    PosixPlatform(){ enable_ansi(); orig={}; tcgetattr(STDIN_FILENO,&orig); term=orig; term.c_lflag &= ~(ICANON|ECHO); tcsetattr(STDIN_FILENO,TCSANOW,&term);}~PosixPlatform()override{stop_input();tcsetattr(STDIN_FILENO,TCSANOW,&orig);set_cursor_visible(true);}bool kbhit() override {int bytes=0; ioctl(STDIN_FILENO,FIONREAD,&bytes); return bytes>0;}int getch() override {char c=0; if(read(STDIN_FILENO,&c,1)<=0) return -1; return (int)c;}void clear_screen() override {std::cout<<"\x1b[2J\x1b[H";}void set_cursor_visible(bool v) override { if(v) std::cout<<"\x1b[?25h"; else std::cout<<"\x1b[?25l"; std::cout.flush();}void enable_ansi() override {}
+    int write(const char *data, size_t len) override {
+        int calls=0;
+        while(len>0){ ssize_t n=::write(STDOUT_FILENO,data,len); ++calls; if(n<0){ if(errno==EINTR) continue; break; } data+=n; len-=(size_t)n; }
+        return calls;
+    }
+    bool next_event(KeyEvent &ev) override {
+        if (!input_started) start_input();
+        return events.pop(ev);
+    }
+private:
+    /// How long a lone ESC waits for the rest of a sequence before it counts as the Esc key
+    static constexpr int kEscTimeoutMs = 25;
+
+    void start_input() {
+        input_started = true;
+        if (pipe(wake) != 0) { wake[0] = wake[1] = -1; return; }
+        input_thread = std::thread([this] { input_loop(); });
+    }
+    void stop_input() {
+        if (!input_thread.joinable()) return;
+        const char b = 0;
+        (void)!::write(wake[1], &b, 1);
+        input_thread.join();
+        ::close(wake[0]); ::close(wake[1]);
+    }
+    // Blocks in poll() until stdin has bytes, decodes them and queues the
+    // events with the time read() returned. Runs until stop_input().
+    void input_loop() {
+        KeyParser parser;
+        std::vector<KeyEvent> decoded;
+        decoded.reserve(64);
+        char buf[256];
+        for (;;) {
+            pollfd fds[2] = { {STDIN_FILENO, POLLIN, 0}, {wake[0], POLLIN, 0} };
+            const int r = poll(fds, 2, parser.pending() ? kEscTimeoutMs : -1);
+            if (r < 0) { if (errno == EINTR) continue; break; }
+            if (fds[1].revents) break;
+            decoded.clear();
+            if (r == 0) {
+                parser.flush(steady_ns(), decoded);
+            } else if (fds[0].revents & POLLIN) {
+                const ssize_t n = ::read(STDIN_FILENO, buf, sizeof(buf));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break;   // EOF / error: no more input
+                parser.feed(buf, (size_t)n, steady_ns(), decoded);
+            } else {
+                break;               // POLLHUP / POLLERR without data
+            }
+            for (const KeyEvent &e : decoded) events.push(e);   // full: drop (the game is not reading)
+        }
+    }
+
+    struct termios orig; struct termios term;
+    SpscQueue<KeyEvent, 256> events;
+    std::thread input_thread;
+    int wake[2] = {-1, -1};
+    bool input_started = false;
+};
 std::unique_ptr<Platform> createPlatform(){ return std::make_unique<PosixPlatform>(); }
 #endif
@@ -3,7 +3,38 @@
 #ifdef _WIN32
 #include <windows.h>
 #include <conio.h>
+#include <chrono>
 #include <iostream>
-class WinPlatform : public Platform { public: WinPlatform(){enable_ansi();} ~WinPlatform() override { set_cursor_visible(true);} bool kbhit() override {return _kbhit();} int getch() override {return _getch();} void clear_screen() override { std::cout << "\x1b[2J\x1b[H"; } void set_cursor_visible(bool vis) override { HANDLE h=GetStdHandle(STD_OUTPUT_HANDLE); if(h==INVALID_HANDLE_VALUE) return; CONSOLE_CURSOR_INFO info; if(!GetConsoleCursorInfo(h,&info)) return; info.bVisible = vis?TRUE:FALSE; SetConsoleCursorInfo(h,&info);} void enable_ansi() override { HANDLE h=GetStdHandle(STD_OUTPUT_HANDLE); if(h==INVALID_HANDLE_VALUE) return; DWORD mode=0; if(!GetConsoleMode(h,&mode)) return; mode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING; SetConsoleMode(h,mode);} };
+class WinPlatform : public Platform { public: WinPlatform(){enable_ansi();} ~WinPlatform() override { set_cursor_visible(true);} bool kbhit() override {return _kbhit();} int getch() override {return _getch();} void clear_screen() override { std::cout << "\x1b[2J\x1b[H"; } void set_cursor_visible(bool vis) override { HANDLE h=GetStdHandle(STD_OUTPUT_HANDLE); if(h==INVALID_HANDLE_VALUE) return; CONSOLE_CURSOR_INFO info; if(!GetConsoleCursorInfo(h,&info)) return; info.bVisible = vis?TRUE:FALSE; SetConsoleCursorInfo(h,&info);} void enable_ansi() override { HANDLE h=GetStdHandle(STD_OUTPUT_HANDLE); if(h==INVALID_HANDLE_VALUE) return; DWORD mode=0; if(!GetConsoleMode(h,&mode)) return; mode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING; SetConsoleMode(h,mode); SetConsoleOutputCP(CP_UTF8);}
+    int write(const char *data, size_t len) override { std::cout.flush(); HANDLE h=GetStdHandle(STD_OUTPUT_HANDLE); int calls=0; while(len>0){ DWORD n=0; ++calls; if(!WriteFile(h,data,(DWORD)len,&n,nullptr) || n==0) break; data+=n; len-=n; } return calls; }
+    // The console delivers whole keys (extended keys as a 0 / 0xE0 prefix plus
+    // scan code), so no parser or thread is needed; stamped when read.
+    bool next_event(KeyEvent &ev) override {
+        if (!_kbhit()) return false;
+        ev = KeyEvent{};
+        ev.t_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        const int c = _getch();
+        if (c == 0 || c == 0xE0) {
+            switch (_getch()) {
+                case 72: ev.key = Key::Up; break;
+                case 80: ev.key = Key::Down; break;
+                case 75: ev.key = Key::Left; break;
+                case 77: ev.key = Key::Right; break;
+                case 71: ev.key = Key::Home; break;
+                case 79: ev.key = Key::End; break;
+                case 73: ev.key = Key::PageUp; break;
+                case 81: ev.key = Key::PageDown; break;
+                case 82: ev.key = Key::Insert; break;
+                case 83: ev.key = Key::Delete; break;
+                default: ev.key = Key::Unknown; break;
+            }
+        } else if (c == '\r') { ev.key = Key::Enter; }
+        else if (c == '\t') { ev.key = Key::Tab; }
+        else if (c == 8) { ev.key = Key::Backspace; }
+        else if (c == 27) { ev.key = Key::Escape; }
+        else if (c >= 1 && c <= 26) { ev.key = Key::Char; ev.ch = (uint32_t)('a' + c - 1); ev.mods = kModCtrl; }
+        else { ev.key = Key::Char; ev.ch = (uint32_t)(unsigned char)c; }
+        return true;
+    } };
 std::unique_ptr<Platform> createPlatform(){ return std::make_unique<WinPlatform>(); }
 #endif
@@ -0,0 +1,51 @@
+/**
+ * @file platform/spsc_queue.h
+ * @brief Bounded lock-free single-producer / single-consumer queue
+ *
+ * Same scheme as the shared-memory input ring (ipc/input_ring.h), in
+ * process: free-running head/tail counters on their own cache lines, and
+ * each side caches the other's counter so it only reloads it when the
+ * queue looks full or empty.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+    /// @brief Producer: append @p v; false (and nothing written) when full
+    bool push(const T &v) {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail_cache >= N) {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if (h - tail_cache >= N) return false;
+        }
+        slots[h & (N - 1)] = v;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Consumer: take the oldest element; false when empty
+    bool pop(T &v) {
+        const uint64_t t = tail.load(std::memory_order_relaxed);
+        if (t == head_cache) {
+            head_cache = head.load(std::memory_order_acquire);
+            if (t == head_cache) return false;
+        }
+        v = slots[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<uint64_t> head{0};   ///< Next slot to write (producer)
+    uint64_t tail_cache = 0;                     ///< Producer's view of tail
+    alignas(64) std::atomic<uint64_t> tail{0};   ///< Next slot to read (consumer)
+    uint64_t head_cache = 0;                     ///< Consumer's view of head
+    alignas(64) T slots[N];
+};
@@ -0,0 +1,352 @@
+/**
+ * @file raster/classic_raster.cpp
+ * @brief Display list, tile pool and SIMD span rasterization of the classic look
+ */
+
+#include "raster/classic_raster.h"
+#include "core/game_core.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONG_RASTER_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define PONG_RASTER_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+constexpr uint32_t rgb(int r, int g, int b) { return (uint32_t)r << 16 | (uint32_t)g << 8 | (uint32_t)b; }
+
+/// Scalar (bg * (256 - a) + fg * a) >> 8 with red/blue and green in separate lanes of one word
+inline uint32_t blend(uint32_t bg, uint32_t fg, int a) {
+    const uint32_t ia = 256u - (uint32_t)a;
+    const uint32_t rb = ((bg & 0xff00ffu) * ia + (fg & 0xff00ffu) * (uint32_t)a) >> 8;
+    const uint32_t g = ((bg & 0x00ff00u) * ia + (fg & 0x00ff00u) * (uint32_t)a) >> 8;
+    return (rb & 0xff00ffu) | (g & 0x00ff00u);
+}
+
+/// Coverage 0..1 to the 0..256 blend weight
+inline int weight(float c) { return (int)(c * 256.0f + 0.5f); }
+
+inline void plot(uint32_t *p, uint32_t color, float c) {
+    const int a = weight(c);
+    if (a >= 256) *p = color;
+    else if (a > 0) *p = blend(*p, color, a);
+}
+
+/// Clip rectangle of one tile, in pixels [x0, x1) x [y0, y1)
+struct Clip { int x0, y0, x1, y1; };
+
+void draw_rect(const RasterPrim &r, const RasterTarget &fb, const Clip &c) {
+    const int ya = std::max(c.y0, (int)std::floor(r.y0)), yb = std::min(c.y1, (int)std::ceil(r.y1));
+    const int xa = std::max(c.x0, (int)std::floor(r.x0)), xb = std::min(c.x1, (int)std::ceil(r.x1));
+    if (ya >= yb || xa >= xb) return;
+    // Columns whose pixel lies wholly inside [x0, x1]; the rest get their covered fraction
+    const int fa = std::max(xa, (int)std::ceil(r.x0)), fb_ = std::min(xb, (int)std::floor(r.x1));
+    for (int y = ya; y < yb; ++y) {
+        const float cy = std::min(r.y1, (float)(y + 1)) - std::max(r.y0, (float)y);
+        if (cy <= 0.0f) continue;
+        uint32_t *row = fb.pixels + (ptrdiff_t)y * fb.stride;
+        for (int x = xa; x < xb; ++x) {
+            if (x == fa && fa < fb_) {
+                if (cy >= 1.0f) raster_fill_span(row + fa, fb_ - fa, r.color);
+                else raster_blend_span(row + fa, fb_ - fa, r.color, weight(cy));
+                x = fb_ - 1;
+                continue;
+            }
+            const float cx = std::min(r.x1, (float)(x + 1)) - std::max(r.x0, (float)x);
+            if (cx > 0.0f) plot(row + x, r.color, cx * cy);
+        }
+    }
+}
+
+/// Box [x0, x1] x [y0, y1] grown by radius R; coverage is 0.5 - signed distance, clamped
+void draw_round(const RasterPrim &r, const RasterTarget &fb, const Clip &c) {
+    const float R = r.radius, outer = R + 0.5f, inner = R - 0.5f;
+    const int ya = std::max(c.y0, (int)std::floor(r.y0 - outer)), yb = std::min(c.y1, (int)std::ceil(r.y1 + outer));
+    for (int y = ya; y < yb; ++y) {
+        const float py = (float)y + 0.5f;
+        const float dy = std::max({ r.y0 - py, 0.0f, py - r.y1 });
+        if (dy >= outer) continue;
+        const float ho = std::sqrt(outer * outer - dy * dy);
+        const int xa = std::max(c.x0, (int)std::ceil(r.x0 - ho - 0.5f));
+        const int xb = std::min(c.x1, (int)std::floor(r.x1 + ho - 0.5f) + 1);
+        if (xa >= xb) continue;
+        uint32_t *row = fb.pixels + (ptrdiff_t)y * fb.stride;
+        // Solid span: pixel centres within R - 0.5 of the box, or the flat part of a partly covered row
+        int sa = xb, sb = xb, a = 256;
+        if (dy <= inner) {
+            const float hi = std::sqrt(inner * inner - dy * dy);
+            sa = std::max(xa, (int)std::ceil(r.x0 - hi - 0.5f));
+            sb = std::min(xb, (int)std::floor(r.x1 + hi - 0.5f) + 1);
+        } else {
+            sa = std::max(xa, (int)std::ceil(r.x0 - 0.5f));
+            sb = std::min(xb, (int)std::floor(r.x1 - 0.5f) + 1);
+            a = weight(std::min(1.0f, 0.5f - (dy - R)));
+        }
+        auto edge = [&](int x) {
+            const float px = (float)x + 0.5f;
+            const float dx = std::max({ r.x0 - px, 0.0f, px - r.x1 });
+            const float d = std::sqrt(dx * dx + dy * dy) - R;
+            plot(row + x, r.color, std::min(1.0f, std::max(0.0f, 0.5f - d)));
+        };
+        if (sa >= sb) {
+            for (int x = xa; x < xb; ++x) edge(x);
+            continue;
+        }
+        for (int x = xa; x < sa; ++x) edge(x);
+        if (a >= 256) raster_fill_span(row + sa, sb - sa, r.color);
+        else if (a > 0) raster_blend_span(row + sa, sb - sa, r.color, a);
+        for (int x = sb; x < xb; ++x) edge(x);
+    }
+}
+
+} // namespace
+
+void raster_fill_span(uint32_t *p, int n, uint32_t color) {
+    int i = 0;
+#if PONG_RASTER_SSE2
+    const __m128i v = _mm_set1_epi32((int)color);
+    for (; i + 16 <= n; i += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i), v);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i + 4), v);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i + 8), v);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i + 12), v);
+    }
+    for (; i + 4 <= n; i += 4) _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i), v);
+#elif PONG_RASTER_NEON
+    const uint32x4_t v = vdupq_n_u32(color);
+    for (; i + 16 <= n; i += 16) {
+        vst1q_u32(p + i, v);
+        vst1q_u32(p + i + 4, v);
+        vst1q_u32(p + i + 8, v);
+        vst1q_u32(p + i + 12, v);
+    }
+    for (; i + 4 <= n; i += 4) vst1q_u32(p + i, v);
+#endif
+    for (; i < n; ++i) p[i] = color;
+}
+
+void raster_blend_span(uint32_t *p, int n, uint32_t color, int alpha) {
+    if (alpha <= 0) return;
+    if (alpha >= 256) { raster_fill_span(p, n, color); return; }
+    int i = 0;
+#if PONG_RASTER_SSE2
+    // 16-bit lanes: bg * (256 - a) + fg * a peaks at 255 * 256, so nothing overflows before the >> 8
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i fg = _mm_mullo_epi16(_mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero), _mm_set1_epi16((short)alpha));
+    const __m128i ia = _mm_set1_epi16((short)(256 - alpha));
+    for (; i + 4 <= n; i += 4) {
+        const __m128i bg = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        const __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(bg, zero), ia), fg), 8);
+        const __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(bg, zero), ia), fg), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i), _mm_packus_epi16(lo, hi));
+    }
+#elif PONG_RASTER_NEON
+    const uint8x8_t fg8 = vreinterpret_u8_u32(vdup_n_u32(color));
+    const uint16x8_t fg = vmulq_n_u16(vmovl_u8(fg8), (uint16_t)alpha);
+    const uint16_t ia = (uint16_t)(256 - alpha);
+    for (; i + 4 <= n; i += 4) {
+        const uint8x16_t bg = vreinterpretq_u8_u32(vld1q_u32(p + i));
+        const uint8x8_t lo = vshrn_n_u16(vmlaq_n_u16(fg, vmovl_u8(vget_low_u8(bg)), ia), 8);
+        const uint8x8_t hi = vshrn_n_u16(vmlaq_n_u16(fg, vmovl_u8(vget_high_u8(bg)), ia), 8);
+        vst1q_u32(p + i, vreinterpretq_u32_u8(vcombine_u8(lo, hi)));
+    }
+#endif
+    for (; i < n; ++i) p[i] = blend(p[i], color, alpha);
+}
+
+void raster_blend_mask(uint32_t *p, const uint8_t *mask, int n, uint32_t color) {
+    int i = 0;
+#if PONG_RASTER_SSE2
+    // Four pixels per step; text masks are mostly empty or solid, which skip the multiply
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i fg = _mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero);
+    const __m128i full = _mm_set1_epi16(256);
+    const __m128i solid = _mm_set1_epi32((int)color);
+    for (; i + 4 <= n; i += 4) {
+        uint32_t m4;
+        std::memcpy(&m4, mask + i, 4);
+        if (m4 == 0) continue;
+        if (m4 == 0xffffffffu) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i), solid); continue; }
+        __m128i m = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)m4), zero);  // 16-bit m0..m3
+        m = _mm_add_epi16(m, _mm_srli_epi16(m, 7));                         // 0..255 -> 0..256
+        m = _mm_unpacklo_epi16(m, m);                                       // m0 m0 m1 m1 m2 m2 m3 m3
+        const __m128i a01 = _mm_unpacklo_epi32(m, m), a23 = _mm_unpackhi_epi32(m, m);
+        const __m128i bg = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i));
+        const __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(bg, zero), _mm_sub_epi16(full, a01)),
+                                                        _mm_mullo_epi16(fg, a01)), 8);
+        const __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(bg, zero), _mm_sub_epi16(full, a23)),
+                                                        _mm_mullo_epi16(fg, a23)), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < n; ++i) {
+        const int a = mask[i] + (mask[i] >> 7);
+        if (a >= 256) p[i] = color;
+        else if (a > 0) p[i] = blend(p[i], color, a);
+    }
+}
+
+const char *raster_simd_path() {
+#if PONG_RASTER_SSE2
+    return "sse2";
+#elif PONG_RASTER_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+ClassicRaster::ClassicRaster(int threads) {
+    for (int i = 1; i < threads; ++i) workers.emplace_back([this] { worker(); });
+}
+
+ClassicRaster::~ClassicRaster() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (std::thread &t : workers) t.join();
+}
+
+void ClassicRaster::build(const GameState &gs, int w, int h, double ui) {
+    list.clear();
+    auto scaled = [&](int min, double v) { return (float)std::max(min, (int)(v * ui + 0.5)); };
+    auto round = [&](float x0, float y0, float x1, float y1, float radius, uint32_t color) {
+        list.push_back({ RasterPrim::Round, x0, y0, x1, y1, radius, color });
+    };
+    auto rect = [&](float x0, float y0, float x1, float y1, uint32_t color) {
+        list.push_back({ RasterPrim::Rect, x0, y0, x1, y1, 0.0f, color });
+    };
+    const float sx = (float)w / (float)gs.gw, sy = (float)h / (float)gs.gh;
+    auto mapX = [&](double gx) { return (float)gx * sx; };
+    auto mapY = [&](double gy) { return (float)gy * sy; };
+
+    // Centre line: round-capped dashes, a wide dim glow under a thin bright stroke
+    const float dashH = scaled(12, 20), dashSeg = scaled(6, 10);
+    const float cx = (float)(w / 2);
+    for (const auto &pen : { std::make_pair(scaled(3, 6), rgb(100, 100, 120)), std::make_pair(scaled(1, 2), rgb(200, 200, 200)) })
+        for (float y = 0; y < (float)h; y += dashH) round(cx, y, cx, y + dashSeg, pen.first * 0.5f, pen.second);
+
+    // Paddles: the column between x = 1 and 3 (mirrored on the right), ends grown into rounded caps
+    const uint32_t paddle = rgb(240, 240, 240);
+    const float pw = mapX(3) - mapX(1);
+    const float rad = std::max(1.0f, std::floor(pw * 0.5f * (float)ui + 0.5f));
+    for (const auto &p : { std::make_pair(mapX(1), gs.left_y), std::make_pair(mapX(gs.gw - 3), gs.right_y) }) {
+        const float top = mapY(p.second), bottom = mapY(p.second + gs.paddle_h);
+        const float r = std::min(rad, (bottom - top) * 0.5f);
+        round(p.first, top + r, p.first + pw, bottom - r, r, paddle);
+    }
+
+    // Balls (first is primary, brighter); the scalar ball stands in when there are no ball entities
+    const float br = scaled(4, 8);
+    auto ball = [&](float x, float y, bool primary) {
+        round(x, y, x, y, br, primary ? rgb(250, 220, 220) : rgb(200, 200, 230));
+        round(x, y, x, y, std::floor(br / 2), primary ? rgb(200, 80, 80) : rgb(120, 120, 200));
+    };
+    const Archetype &balls = gs.entities.balls();
+    for (size_t i = 0; i < balls.size(); ++i) ball(mapX(balls.position[i].x), mapY(balls.position[i].y), i == 0);
+    if (balls.empty()) ball(mapX(gs.ball_x), mapY(gs.ball_y), true);
+
+    if (gs.mode == GameMode::Obstacles || gs.mode == GameMode::ObstaclesMulti) {
+        const Archetype &obs = gs.entities.obstacles();
+        for (size_t i = 0; i < obs.size(); ++i) {
+            const Position &p = obs.position[i];
+            const Shape &s = obs.shape[i];
+            rect(mapX(p.x - s.w / 2.0), mapY(p.y - s.h / 2.0), mapX(p.x + s.w / 2.0), mapY(p.y + s.h / 2.0), rgb(90, 140, 200));
+        }
+    }
+
+    // Black holes: purple event horizon with a black core
+    const float hole = scaled(8, 16);
+    gs.entities.each(Component::Position | Component::GravitySource, [&](const Archetype &src) {
+        for (size_t i = 0; i < src.size(); ++i) {
+            const float x = mapX(src.position[i].x), y = mapY(src.position[i].y);
+            round(x, y, x, y, hole, rgb(80, 40, 120));
+            round(x, y, x, y, std::floor(hole / 2), 0);
+        }
+    });
+
+    // Entity types without dedicated art: plain shapes from the component arrays
+    for (size_t ai = kBuiltinArchetypeCount; ai < gs.entities.archetype_count(); ++ai) {
+        const Archetype &a = gs.entities.archetype((ArchetypeId)ai);
+        if (!a.has(Component::Position | Component::Shape) || a.has(Component::GravitySource)) continue;
+        for (size_t i = 0; i < a.size(); ++i) {
+            const Position &p = a.position[i];
+            const Shape &s = a.shape[i];
+            if (s.kind == ShapeKind::Box) {
+                rect(mapX(p.x - s.w / 2.0), mapY(p.y - s.h / 2.0), mapX(p.x + s.w / 2.0), mapY(p.y + s.h / 2.0), rgb(170, 170, 170));
+            } else {
+                const float x = mapX(p.x), y = mapY(p.y);
+                round(x, y, x, y, (float)(s.w / 2.0) * sx, rgb(170, 170, 170));
+            }
+        }
+    }
+
+    // Horizontal enemy paddles (top/bottom): capsules
+    if (gs.mode == GameMode::ThreeEnemies) {
+        const float halfW = std::floor((float)(gs.paddle_w / (double)gs.gw) * (float)w * 0.5f);
+        const float cap = std::floor(scaled(4, 8) / 2);
+        for (const auto &p : { std::make_pair(mapX(gs.top_x), mapY(1.0)), std::make_pair(mapX(gs.bottom_x), mapY(gs.gh - 2.0)) })
+            round(p.first - halfW, p.second, p.first + halfW, p.second, cap, rgb(200, 240, 200));
+    }
+}
+
+void ClassicRaster::draw_tile(int tile) {
+    const int tx = tile % tiles_x, ty = tile / tiles_x;
+    const Clip c{ tx * kTileW, ty * kTileH, std::min(fb.width, (tx + 1) * kTileW), std::min(fb.height, (ty + 1) * kTileH) };
+    for (int y = c.y0; y < c.y1; ++y) raster_fill_span(fb.pixels + (ptrdiff_t)y * fb.stride + c.x0, c.x1 - c.x0, 0);
+    for (const RasterPrim &p : list) {
+        // Bounds grown by the anti-aliasing half pixel
+        const float g = (p.kind == RasterPrim::Round ? p.radius : 0.0f) + 0.5f;
+        if (p.x1 + g <= (float)c.x0 || p.x0 - g >= (float)c.x1 || p.y1 + g <= (float)c.y0 || p.y0 - g >= (float)c.y1) continue;
+        if (p.kind == RasterPrim::Rect) draw_rect(p, fb, c);
+        else draw_round(p, fb, c);
+    }
+}
+
+void ClassicRaster::draw_tiles() {
+    const int n = tiles_x * tiles_y;
+    for (int t = next_tile.fetch_add(1, std::memory_order_relaxed); t < n; t = next_tile.fetch_add(1, std::memory_order_relaxed))
+        draw_tile(t);
+}
+
+void ClassicRaster::worker() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        draw_tiles();
+        std::lock_guard<std::mutex> lock(mtx);
+        if (--busy == 0) done_cv.notify_one();
+    }
+}
+
+void ClassicRaster::render(const GameState &gs, const RasterTarget &target, double ui) {
+    if (!target.pixels || target.width <= 0 || target.height <= 0 || gs.gw <= 0 || gs.gh <= 0) return;
+    fb = target;
+    tiles_x = (fb.width + kTileW - 1) / kTileW;
+    tiles_y = (fb.height + kTileH - 1) / kTileH;
+    build(gs, fb.width, fb.height, ui);
+    next_tile.store(0, std::memory_order_relaxed);
+    if (workers.empty()) { draw_tiles(); return; }
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        busy = (int)workers.size();
+        ++generation;
+    }
+    cv.notify_all();
+    draw_tiles();
+    std::unique_lock<std::mutex> lock(mtx);
+    done_cv.wait(lock, [&] { return busy == 0; });
+}
@@ -0,0 +1,104 @@
+/**
+ * @file raster/classic_raster.h
+ * @brief Portable CPU rasterizer for the classic (flat, GDI-style) look
+ *
+ * Draws the arena straight into a 32-bit BGRA framebuffer (0x00RRGGBB
+ * words, what GDI DIBs, SoftRenderer and the capture slots use), with no
+ * platform graphics API, so the classic renderer runs headless on any OS.
+ *
+ * Each frame the GameState is turned into a short display list of two
+ * primitive kinds, painted in order:
+ *  - Rect: axis-aligned box with exact area coverage on its edges
+ *  - Round: an axis-aligned box grown by a radius, which covers circles
+ *    (empty box), capsules (box of zero width or height) and rounded
+ *    paddles; edges are anti-aliased from the signed distance
+ * Rows of a primitive split into a fully covered interior span, filled
+ * with SIMD stores, and a few edge pixels that are blended one by one.
+ * The framebuffer is cut into tiles that worker threads take from a
+ * shared counter; every tile clears itself and paints the primitives
+ * that overlap it, so threads never touch the same pixels.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct GameState;
+
+/**
+ * @brief Destination image
+ *
+ * @c stride is in pixels and may be negative: pass the last row of a
+ * bottom-up DIB (e.g. a FrameCapture slot) with stride -width to draw it
+ * upright without a copy.
+ */
+struct RasterTarget {
+    uint32_t *pixels = nullptr;  ///< Top visible row
+    int width = 0, height = 0;
+    ptrdiff_t stride = 0;        ///< Pixels from one row to the next one down
+};
+
+/// @brief One display-list entry (pixel coordinates, y down)
+struct RasterPrim {
+    enum Kind : uint8_t { Rect, Round } kind = Rect;
+    float x0 = 0, y0 = 0, x1 = 0, y1 = 0; ///< Box (Round: the core the radius grows)
+    float radius = 0;                     ///< Round only
+    uint32_t color = 0;                   ///< 0x00RRGGBB
+};
+
+class ClassicRaster {
+public:
+    /// @param threads Tile workers including the caller (1 = render on the calling thread only)
+    explicit ClassicRaster(int threads = 1);
+    ~ClassicRaster();
+    ClassicRaster(const ClassicRaster &) = delete;
+    ClassicRaster &operator=(const ClassicRaster &) = delete;
+
+    /**
+     * @brief Draw @p gs over the whole target
+     * @param ui Size scale of fixed-size elements (ball, centre line) relative to 96 DPI
+     */
+    void render(const GameState &gs, const RasterTarget &target, double ui = 1.0);
+
+    /// @brief Display list of the last render (for tests / tools)
+    const std::vector<RasterPrim> &prims() const { return list; }
+    int threads() const { return (int)workers.size() + 1; }
+
+    static constexpr int kTileW = 128, kTileH = 64;
+
+private:
+    void build(const GameState &gs, int w, int h, double ui);
+    void draw_tiles();
+    void draw_tile(int tile);
+    void worker();
+
+    std::vector<RasterPrim> list;
+    RasterTarget fb;
+    int tiles_x = 0, tiles_y = 0;
+
+    // Tile pool: render() publishes a generation, workers and the caller claim tiles until none are left
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable cv, done_cv;
+    uint64_t generation = 0;
+    int busy = 0;
+    bool stopping = false;
+    std::atomic<int> next_tile{0};
+};
+
+/// @name Span primitives (exposed for the benchmark)
+/// @{
+/// @brief Set @p n pixels to @p color (SSE2 / NEON stores, scalar tail)
+void raster_fill_span(uint32_t *p, int n, uint32_t color);
+/// @brief Blend @p color over @p n pixels with coverage @p alpha (0..256)
+void raster_blend_span(uint32_t *p, int n, uint32_t color, int alpha);
+/// @brief Blend @p color over @p n pixels with per-pixel coverage @p mask (0..255)
+void raster_blend_mask(uint32_t *p, const uint8_t *mask, int n, uint32_t color);
+/// @brief Instruction set the span primitives were built for ("sse2", "neon" or "scalar")
+const char *raster_simd_path();
+/// @}
@@ -0,0 +1,131 @@
+/**
+ * @file raster/text_raster.cpp
+ * @brief Built-in bitmap font, atlas rasterization and cached text runs
+ */
+
+#include "raster/text_raster.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+/// 5x7 glyphs for ' '..'~', one byte per column, bit 0 = top row; g j p q y descend into bit 7
+constexpr uint8_t kFont5x7[GlyphAtlas::kCount][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14}, // ' ' ! " #
+    {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x55,0x22,0x50}, {0x00,0x05,0x03,0x00,0x00}, // $ % & '
+    {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x08,0x2A,0x1C,0x2A,0x08}, {0x08,0x08,0x3E,0x08,0x08}, // ( ) * +
+    {0x00,0x50,0x30,0x00,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x60,0x60,0x00,0x00}, {0x20,0x10,0x08,0x04,0x02}, // , - . /
+    {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x42,0x61,0x51,0x49,0x46}, {0x21,0x41,0x45,0x4B,0x31}, // 0 1 2 3
+    {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x30}, {0x01,0x71,0x09,0x05,0x03}, // 4 5 6 7
+    {0x36,0x49,0x49,0x49,0x36}, {0x06,0x49,0x49,0x29,0x1E}, {0x00,0x36,0x36,0x00,0x00}, {0x00,0x56,0x36,0x00,0x00}, // 8 9 : ;
+    {0x08,0x14,0x22,0x41,0x00}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x51,0x09,0x06}, // < = > ?
+    {0x32,0x49,0x79,0x41,0x3E}, {0x7E,0x11,0x11,0x11,0x7E}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22}, // @ A B C
+    {0x7F,0x41,0x41,0x22,0x1C}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x49,0x49,0x7A}, // D E F G
+    {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41}, // H I J K
+    {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x0C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E}, // L M N O
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x46,0x49,0x49,0x49,0x31}, // P Q R S
+    {0x01,0x01,0x7F,0x01,0x01}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F}, // T U V W
+    {0x63,0x14,0x08,0x14,0x63}, {0x07,0x08,0x70,0x08,0x07}, {0x61,0x51,0x49,0x45,0x43}, {0x00,0x7F,0x41,0x41,0x00}, // X Y Z [
+    {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x7F,0x00}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40}, // \ ] ^ _
+    {0x00,0x01,0x02,0x04,0x00}, {0x20,0x54,0x54,0x54,0x78}, {0x7F,0x48,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x20}, // ` a b c
+    {0x38,0x44,0x44,0x48,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x08,0x7E,0x09,0x01,0x02}, {0x98,0xA4,0xA4,0x7C,0x00}, // d e f g
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x40,0x80,0x80,0x7D,0x00}, {0x7F,0x10,0x28,0x44,0x00}, // h i j k
+    {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x18,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38}, // l m n o
+    {0xFC,0x24,0x24,0x18,0x00}, {0x18,0x24,0x24,0xFC,0x00}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x20}, // p q r s
+    {0x04,0x3F,0x44,0x40,0x20}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C}, // t u v w
+    {0x44,0x28,0x10,0x28,0x44}, {0x9C,0xA0,0xA0,0x7C,0x00}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00}, // x y z {
+    {0x00,0x00,0x7F,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x08,0x04,0x08,0x10,0x08},                              // | } ~
+};
+
+constexpr int kCellW = 6, kCellH = 8;  ///< Font cell including one column / row of spacing
+constexpr int kSub = 4;                ///< Supersamples per axis when scaling the font
+
+} // namespace
+
+void GlyphAtlas::build(int cell_h) {
+    ch = std::max(6, cell_h);
+    cw = (ch * kCellW + kCellH / 2) / kCellH;
+    pixels.assign((size_t)stride() * (size_t)ch, 0);
+    const float fx = (float)kCellW / (float)cw, fy = (float)kCellH / (float)ch;
+    for (int g = 0; g < kCount; ++g) {
+        const uint8_t *cols = kFont5x7[g];
+        for (int y = 0; y < ch; ++y) {
+            uint8_t *row = pixels.data() + (size_t)y * (size_t)stride() + (size_t)g * (size_t)cw;
+            for (int x = 0; x < cw; ++x) {
+                // Box filter: fraction of kSub x kSub samples that land on a set font pixel
+                int lit = 0;
+                for (int sy = 0; sy < kSub; ++sy) {
+                    const int fr = (int)(((float)y + ((float)sy + 0.5f) / kSub) * fy);
+                    for (int sx = 0; sx < kSub; ++sx) {
+                        const int fc = (int)(((float)x + ((float)sx + 0.5f) / kSub) * fx);
+                        if (fc < 5 && (cols[fc] >> fr & 1)) ++lit;
+                    }
+                }
+                row[x] = (uint8_t)((lit * 255 + kSub * kSub / 2) / (kSub * kSub));
+            }
+        }
+    }
+}
+
+const uint8_t *GlyphAtlas::glyph(unsigned char c) const {
+    const int g = c >= kFirst && c < kFirst + kCount ? c - kFirst : '?' - kFirst;
+    return pixels.data() + (size_t)g * (size_t)cw;
+}
+
+void TextRenderer::set_height(int px) {
+    px = std::max(6, px);
+    if (px == atlas.cell_h()) return;
+    atlas.build(px);
+    runs.clear();
+}
+
+const TextRenderer::Run &TextRenderer::run(std::string_view text) {
+    key.assign(text.data(), text.size());
+    auto it = runs.find(key);
+    if (it != runs.end()) {
+        ++hit;
+        it->second.used = frame;
+        return it->second;
+    }
+    ++miss;
+    Run &r = runs[key];
+    const int cw = atlas.cell_w(), ch = atlas.cell_h(), w = measure(text);
+    r.mask.resize((size_t)w * (size_t)ch);
+    r.used = frame;
+    for (int y = 0; y < ch; ++y) {
+        uint8_t *dst = r.mask.data() + (size_t)y * (size_t)w;
+        for (size_t i = 0; i < text.size(); ++i)
+            std::memcpy(dst + i * (size_t)cw, atlas.glyph((unsigned char)text[i]) + (size_t)y * (size_t)atlas.stride(), (size_t)cw);
+    }
+    return r;
+}
+
+int TextRenderer::draw(const RasterTarget &target, int x, int y, std::string_view text, uint32_t color) {
+    if (atlas.cell_h() == 0) set_height(16);
+    const int w = measure(text), h = atlas.cell_h();
+    const int x0 = std::max(0, x), x1 = std::min(target.width, x + w);
+    const int y0 = std::max(0, y), y1 = std::min(target.height, y + h);
+    if (text.empty() || !target.pixels || x0 >= x1 || y0 >= y1) return w;
+    const Run &r = run(text);
+    for (int py = y0; py < y1; ++py)
+        raster_blend_mask(target.pixels + (ptrdiff_t)py * target.stride + x0,
+                          r.mask.data() + (size_t)(py - y) * (size_t)w + (size_t)(x0 - x), x1 - x0, color);
+    return w;
+}
+
+void TextRenderer::fill(const RasterTarget &target, int x, int y, int w, int h, uint32_t color, int alpha) {
+    const int x0 = std::max(0, x), x1 = std::min(target.width, x + w);
+    const int y0 = std::max(0, y), y1 = std::min(target.height, y + h);
+    if (!target.pixels || x0 >= x1) return;
+    for (int py = y0; py < y1; ++py) raster_blend_span(target.pixels + (ptrdiff_t)py * target.stride + x0, x1 - x0, color, alpha);
+}
+
+void TextRenderer::end_frame() {
+    if (runs.size() > kMaxRuns) {
+        for (auto it = runs.begin(); it != runs.end();) {
+            if (it->second.used != frame) it = runs.erase(it);
+            else ++it;
+        }
+    }
+    ++frame;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file raster/text_raster.h
+ * @brief Glyph-atlas text rendering into 32-bit framebuffers
+ *
+ * A built-in 5x7 ASCII bitmap font is rasterized once per pixel height
+ * into a GlyphAtlas of 8-bit coverage (box-filtered, so non-integer
+ * scales stay smooth). TextRenderer composes each string into a
+ * coverage run from the atlas and keeps the run keyed by its text, so a
+ * line that did not change since the last frame costs one masked blend
+ * per row. No platform text API is involved: the HUD draws the same way
+ * in pong_win and in headless captures.
+ */
+#pragma once
+
+#include "raster/classic_raster.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Coverage bitmaps of the printable ASCII range at one pixel height
+ *
+ * Glyphs sit side by side in one row-major image (cell_w() * 95 wide),
+ * 6x8 font cells scaled to cell_h() pixels high.
+ */
+class GlyphAtlas {
+public:
+    static constexpr int kFirst = 32, kCount = 95;  ///< ' ' .. '~'
+
+    /// @brief Rasterize every glyph at @p cell_h pixels per line (clamped to >= 6)
+    void build(int cell_h);
+    int cell_w() const { return cw; }
+    int cell_h() const { return ch; }
+    int stride() const { return cw * kCount; }
+    /// @brief Top-left coverage byte of @p c ('?' outside the printable range)
+    const uint8_t *glyph(unsigned char c) const;
+
+private:
+    std::vector<uint8_t> pixels;
+    int cw = 0, ch = 0;
+};
+
+/**
+ * @brief Draws single-line strings with a cache of composed runs
+ *
+ * Runs drawn during a frame survive end_frame(); once more than
+ * kMaxRuns are cached the ones not drawn in that frame are dropped.
+ */
+class TextRenderer {
+public:
+    static constexpr size_t kMaxRuns = 128;
+
+    /// @brief Line height in pixels (>= 6); rebuilds the atlas and drops cached runs when it changes
+    void set_height(int px);
+    int height() const { return atlas.cell_h(); }
+    int measure(std::string_view text) const { return (int)text.size() * atlas.cell_w(); }
+
+    /**
+     * @brief Blend @p text with its top-left corner at (@p x, @p y), clipped to the target
+     * @return Width drawn in pixels (before clipping)
+     */
+    int draw(const RasterTarget &target, int x, int y, std::string_view text, uint32_t color);
+    /// @brief Alpha-blend a solid panel (@p alpha 0..256), clipped to the target
+    static void fill(const RasterTarget &target, int x, int y, int w, int h, uint32_t color, int alpha = 256);
+    /// @brief Close the frame: count it and trim the run cache
+    void end_frame();
+
+    size_t cached_runs() const { return runs.size(); }
+    uint64_t hits() const { return hit; }
+    uint64_t misses() const { return miss; }
+
+private:
+    struct Run {
+        std::vector<uint8_t> mask;  ///< measure(text) x height() coverage
+        uint64_t used = 0;          ///< Frame it was last drawn in
+    };
+    const Run &run(std::string_view text);
+
+    GlyphAtlas atlas;
+    std::unordered_map<std::string, Run> runs;
+    std::string key;  ///< Lookup buffer, reused
+    uint64_t frame = 0, hit = 0, miss = 0;
+};
@@ -1,4 +1,3 @@
-#ifdef _WIN32
 // Ensure Windows headers do not define min/max macros that break std::max/std::min
 #ifndef NOMINMAX
 #define NOMINMAX
@@ -6,6 +5,9 @@
 
 #include "soft_renderer.h"
 #include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <cmath> // sqrt, tan, fabs, pow
 #include <chrono>
@@ -527,6 +529,7 @@ void SoftRenderer::resize(int w, int h) {
     if (w==outW && h==outH) return;
     outW = std::max(1,w); outH = std::max(1,h);
     updateInternalResolution();
+#ifdef _WIN32
     // setup BITMAPINFO (top‑down: negative height)
     std::memset(&bmpInfo,0,sizeof(bmpInfo));
     bmpInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
@@ -535,6 +538,7 @@ void SoftRenderer::resize(int w, int h) {
     bmpInfo.bmiHeader.biPlanes = 1;
     bmpInfo.bmiHeader.biBitCount = 32;
     bmpInfo.bmiHeader.biCompression = BI_RGB;
+#endif
     pixel32.assign(outW*outH,0);
     // accum/history were already (re)allocated in updateInternalResolution()
     haveHistory = false;
@@ -1568,7 +1572,7 @@ void SoftRenderer::render(const GameState &gs) {
     if (!config.enablePathTracing) return; // nothing (caller can draw classic)
     if (rtW==0||rtH==0) return;
 
-    using clock = std::chrono::high_resolution_clock;
+    using clock = std::chrono::steady_clock;
     auto tStart = clock::now();
     auto t0 = tStart;
 
@@ -1581,10 +1585,11 @@ void SoftRenderer::render(const GameState &gs) {
         return {wx, wy, 0.0f};
     };
     // Balls (multi-ball support). First ball is emissive, others dimmer.
-    std::vector<Vec3> ballCenters; std::vector<float> ballRs; ballCenters.reserve(gs.balls.size()); ballRs.reserve(gs.balls.size());
-    if (!gs.balls.empty()) {
-        for (size_t i=0;i<gs.balls.size();++i){
-            ballCenters.push_back(toWorld((float)gs.balls[i].x, (float)gs.balls[i].y));
+    const Archetype &balls = gs.entities.balls();
+    std::vector<Vec3> ballCenters; std::vector<float> ballRs; ballCenters.reserve(balls.size()); ballRs.reserve(balls.size());
+    if (!balls.empty()) {
+        for (size_t i=0;i<balls.size();++i){
+            ballCenters.push_back(toWorld((float)balls.position[i].x, (float)balls.position[i].y));
             ballRs.push_back(0.09f);
         }
     } else {
@@ -1594,42 +1599,48 @@ void SoftRenderer::render(const GameState &gs) {
     Vec3 ballC = ballCenters[0];
     float ballR = ballRs[0];
     // Paddles: width ~ 2 game units => (2/gw)*4 world units
+    const Archetype &paddles = gs.entities.paddles();
+    const Position &leftP = paddles.position[(size_t)PaddleSide::Left];
+    const Position &rightP = paddles.position[(size_t)PaddleSide::Right];
     float paddleHalfX = (2.0f/gw)*4.0f*0.5f; // half
     float paddleHalfY = ((float)gs.paddle_h/gh)*3.0f*0.5f;
-    Vec3 leftCenter = toWorld(2.0f, (float)gs.left_y + (float)gs.paddle_h*0.5f);
-    Vec3 rightCenter = toWorld(gw-2.0f, (float)gs.right_y + (float)gs.paddle_h*0.5f);
+    Vec3 leftCenter = toWorld((float)leftP.x, (float)leftP.y);
+    Vec3 rightCenter = toWorld((float)rightP.x, (float)rightP.y);
     // Horizontal enemy paddles (ThreeEnemies mode) represented as thin boxes spanning horizontally
     bool useHoriz = (gs.mode == GameMode::ThreeEnemies);
     float horizHalfX = ((float)gs.paddle_w/gw)*4.0f*0.5f;
     float horizHalfY = (0.5f/gh)*3.0f; // very thin
-    Vec3 topCenter = toWorld((float)gs.top_x, 1.0f);
-    Vec3 bottomCenter = toWorld((float)gs.bottom_x, gh - 2.0f);
+    Vec3 topCenter = toWorld((float)paddles.position[(size_t)PaddleSide::Top].x, 1.0f);
+    Vec3 bottomCenter = toWorld((float)paddles.position[(size_t)PaddleSide::Bottom].x, gh - 2.0f);
     float horizThickness = 0.04f;
     // Obstacles as boxes
     bool useObs = (gs.mode == GameMode::Obstacles || gs.mode == GameMode::ObstaclesMulti);
     struct Box { Vec3 bmin,bmax; };
     std::vector<Box> obsBoxes;
     if (useObs) {
-        for (auto &ob : gs.obstacles) {
-            Vec3 c = toWorld((float)ob.x, (float)ob.y);
-            float hw = (float)(ob.w/gw)*4.0f*0.5f;
-            float hh = (float)(ob.h/gh)*3.0f*0.5f;
+        const Archetype &obs = gs.entities.obstacles();
+        obsBoxes.reserve(obs.size());
+        for (size_t i=0;i<obs.size();++i) {
+            const Position &op = obs.position[i]; const Shape &os = obs.shape[i];
+            Vec3 c = toWorld((float)op.x, (float)op.y);
+            float hw = (float)(os.w/gw)*4.0f*0.5f;
+            float hh = (float)(os.h/gh)*3.0f*0.5f;
             Vec3 mn{c.x-hw, c.y-hh, -0.05f}; Vec3 mx{c.x+hw, c.y+hh, 0.05f};
             obsBoxes.push_back({mn,mx});
         }
     }
     
-    // Black holes as dark spheres
+    // Black holes (every gravity source) as dark spheres
     std::vector<Vec3> blackholeCenters;
     std::vector<float> blackholeRs;
-    if (!gs.blackholes.empty()) {
-        for (auto &bh : gs.blackholes) {
-            Vec3 c = toWorld((float)bh.x, (float)bh.y);
+    gs.entities.each(Component::Position | Component::GravitySource, [&](const Archetype &src) {
+        for (size_t i=0;i<src.size();++i) {
+            Vec3 c = toWorld((float)src.position[i].x, (float)src.position[i].y);
             float r = 0.15f;  // Black hole radius in world space
             blackholeCenters.push_back(c);
             blackholeRs.push_back(r);
         }
-    }
+    });
     
     float paddleThickness = 0.05f;
     
@@ -2687,7 +2698,9 @@ void SoftRenderer::render(const GameState &gs) {
             _snprintf_s(msg, _TRUNCATE, "[SoftRenderer] Threads=%u (max=%u, override=%s, last=%.2fms ema=%.2fms cd=%d)\n", (unsigned)stats_.threadsUsed, wantMax, envOverride?"yes":"no", g_srLastFrameMs.load(), g_srEmaFrameMs.load(), g_srCooldown.load());
             OutputDebugStringA(msg); printf("%s", msg);
 #else
-            printf("[SoftRenderer] Threads=%u (max=%u, override=%s, last=%.2fms ema=%.2fms cd=%d)\n", (unsigned)stats_.threadsUsed, wantMax, envOverride?"yes":"no": "no", g_srLastFrameMs.load(), g_srEmaFrameMs.load(), g_srCooldown.load());
+            // stdout may be the terminal the console frontend draws into: opt-in, on stderr
+            if (std::getenv("PONG_PT_LOG"))
+                std::fprintf(stderr, "[SoftRenderer] Threads=%u (max=%u, override=%s, last=%.2fms ema=%.2fms cd=%d)\n", (unsigned)stats_.threadsUsed, wantMax, envOverride?"yes":"no", g_srLastFrameMs.load(), g_srEmaFrameMs.load(), g_srCooldown.load());
 #endif
             g_srLastLogged.store((unsigned)stats_.threadsUsed, std::memory_order_relaxed);
         }
@@ -4520,5 +4533,3 @@ void SoftRenderer::spatialDenoise() {
     accumG.swap(denoiseG);
     accumB.swap(denoiseB);
 }
-
-#endif // _WIN32
@@ -3,11 +3,12 @@
  * @brief Minimal CPU path tracing style renderer (no external graphics APIs)
  *
  * This renderer creates a small per-frame ray/path traced image of the Pong
- * scene (ball as an emissive sphere, paddles as thin glass panels) and blits
- * it to the window via GDI StretchDIBits.
+ * scene (ball as an emissive sphere, paddles as thin glass panels). The
+ * Windows GUI blits it via GDI StretchDIBits; the console frontend packs it
+ * into half-block terminal cells (see console/pt_view.h).
  *
  * Design goals:
- *  - Self‑contained (only <windows.h> + standard library)
+ *  - Self‑contained (standard library only; <windows.h> for the GDI header on Windows)
  *  - Fully parameter driven (no fixed quality presets). Caller supplies:
  *      raysPerFrame: total rays this frame (or per-pixel when forceFullPixelRays)
  *      maxBounces: path depth (1..8)
@@ -24,14 +25,15 @@
  */
 
 #pragma once
-#ifdef _WIN32
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include <vector>
 #include <cstdint>
 #include <cmath>
 #include <chrono>
-#include "../core/game_core.h"
+#include "core/game_core.h"
 
 struct SRConfig {
     // Runtime toggles
@@ -125,14 +127,21 @@ public:
 
     const SRStats &stats() const { return stats_; }
 
+#ifdef _WIN32
     const BITMAPINFO &getBitmapInfo() const { return bmpInfo; }
+#endif
+    /// Output size set by resize(); pixels() is width()*height(), top-down, 0x00RRGGBB
+    int width() const { return outW; }
+    int height() const { return outH; }
     const uint32_t *pixels() const { return reinterpret_cast<const uint32_t*>(pixel32.data()); }
 
 private:
     int outW = 0, outH = 0;      // window size
     int rtW = 0, rtH = 0;        // internal render resolution
     SRConfig config{};
+#ifdef _WIN32
     BITMAPINFO bmpInfo{};        // top‑down 32bpp DIB header
+#endif
     
     // Phase 2: Structure of Arrays layout for better SIMD performance
     // Instead of [RGBRGBRGB...], we have separate R[], G[], B[] arrays
@@ -156,5 +165,3 @@ private:
     void temporalAccumulate(const std::vector<float>& curR, const std::vector<float>& curG, const std::vector<float>& curB);
     void spatialDenoise();
 };
-
-#endif // _WIN32
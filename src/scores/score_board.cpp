@@ -0,0 +1,151 @@
+/**
+ * @file scores/score_board.cpp
+ * @brief Score board replay, submission, queries and automatic compaction
+ */
+
+#include "scores/score_board.h"
+#include <algorithm>
+
+namespace {
+
+constexpr uint64_t kCompactMinRecords = 1024;  ///< Small logs are never worth rewriting
+
+/// Longest prefix of @p s within @p max bytes that does not split a UTF-8 sequence
+std::string_view utf8_prefix(std::string_view s, size_t max) {
+    if (s.size() <= max) return s;
+    while (max > 0 && ((uint8_t)s[max] & 0xC0) == 0x80) --max;
+    return s.substr(0, max);
+}
+
+} // namespace
+
+bool ScoreBoard::open(const std::filesystem::path &path, std::string &err) {
+    where = path;
+    index.clear();
+    heap.clear();
+    slots.clear();
+    next_id = 1;
+    if (!log.open(path, [this](const ScoreRecord &r) { apply(r); }, err)) return false;
+    heap_rebuild();
+    maybe_compact();
+    return true;
+}
+
+void ScoreBoard::apply(const ScoreRecord &r) {
+    if (r.seq == 0) return;
+    if (r.type == ScoreRecord::NextSeq) {
+        next_id = std::max(next_id, r.seq);
+    } else if (r.type == ScoreRecord::Add) {
+        if (slots.size() < r.seq) slots.resize(r.seq);
+        Slot &s = slots[r.seq - 1];
+        if (s.live) return;  // replayed twice; the first one stands
+        s.name.assign(r.name.data(), r.name.size());
+        s.score = r.score;
+        s.live = true;
+        index.insert(ScoreKey{ r.score, r.seq });
+        next_id = std::max(next_id, r.seq + 1);
+    } else if (r.seq <= slots.size() && slots[r.seq - 1].live) {
+        Slot &s = slots[r.seq - 1];
+        index.erase(ScoreKey{ s.score, r.seq });
+        s.live = false;
+        std::string().swap(s.name);
+    }
+}
+
+void ScoreBoard::heap_offer(const ScoreKey &key) {
+    if (heap.size() < k) {
+        heap.push_back(key);
+        std::push_heap(heap.begin(), heap.end(), ScoreKey::before);
+    } else if (ScoreKey::before(key, heap.front())) {
+        std::pop_heap(heap.begin(), heap.end(), ScoreKey::before);
+        heap.back() = key;
+        std::push_heap(heap.begin(), heap.end(), ScoreKey::before);
+    }
+}
+
+void ScoreBoard::heap_rebuild() {
+    heap.clear();
+    index.range(0, k, heap);
+    std::make_heap(heap.begin(), heap.end(), ScoreKey::before);
+}
+
+uint64_t ScoreBoard::submit(std::string_view name, int32_t score) {
+    ScoreRecord r;
+    r.type = ScoreRecord::Add;
+    r.seq = next_id;
+    r.score = score;
+    r.name = utf8_prefix(name, ScoreLog::kMaxName);
+    if (!log.append(r)) return 0;
+    ++next_id;
+    apply(r);
+    heap_offer(ScoreKey{ score, r.seq });
+    return r.seq;
+}
+
+bool ScoreBoard::remove(uint64_t id) {
+    if (id == 0 || id > slots.size() || !slots[id - 1].live) return false;
+    ScoreRecord r;
+    r.type = ScoreRecord::Remove;
+    r.seq = id;
+    if (!log.append(r)) return false;
+    const ScoreKey key{ slots[id - 1].score, id };
+    apply(r);
+    // The heap only changes if the entry was one of the best k
+    if (!heap.empty() && !ScoreKey::before(heap.front(), key)) heap_rebuild();
+    maybe_compact();
+    return true;
+}
+
+ScoreEntry ScoreBoard::entry(const ScoreKey &key) const {
+    ScoreEntry e;
+    e.id = key.seq;
+    e.score = key.score;
+    e.name = slots[key.seq - 1].name;
+    return e;
+}
+
+std::vector<ScoreEntry> ScoreBoard::top(size_t n) const {
+    if (n > heap.size() && heap.size() < index.size()) return page(0, n);
+    std::vector<ScoreKey> best(heap);
+    std::sort(best.begin(), best.end(), ScoreKey::before);
+    if (best.size() > n) best.resize(n);
+    std::vector<ScoreEntry> out;
+    out.reserve(best.size());
+    for (const ScoreKey &key : best) out.push_back(entry(key));
+    return out;
+}
+
+std::vector<ScoreEntry> ScoreBoard::page(size_t first, size_t n) const {
+    std::vector<ScoreKey> keys;
+    index.range(first, n, keys);
+    std::vector<ScoreEntry> out;
+    out.reserve(keys.size());
+    for (const ScoreKey &key : keys) out.push_back(entry(key));
+    return out;
+}
+
+size_t ScoreBoard::rank_of(uint64_t id) const {
+    if (id == 0 || id > slots.size() || !slots[id - 1].live) return 0;
+    return index.rank(ScoreKey{ slots[id - 1].score, id }) + 1;
+}
+
+bool ScoreBoard::compact(std::string &err) {
+    std::vector<ScoreRecord> live;
+    live.reserve(index.size());
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (!slots[i].live) continue;
+        ScoreRecord r;
+        r.seq = i + 1;
+        r.score = slots[i].score;
+        r.name = slots[i].name;
+        live.push_back(r);
+    }
+    return log.compact(live, next_id, err);
+}
+
+void ScoreBoard::maybe_compact() {
+    const uint64_t records = log.records(), live = index.size();
+    if (records < kCompactMinRecords || records - live <= live) return;
+    std::string err;
+    compact(err);  // on failure the old log stays valid and is retried on the next removal
+}
@@ -0,0 +1,84 @@
+/**
+ * @file scores/score_board.h
+ * @brief Persistent high-score board: score log + rank index + top-K heap
+ *
+ * Every submission is one durable append to the ScoreLog and an
+ * O(log n) insert into the ScoreIndex, so neither depends on how many
+ * scores are already stored. The best K entries are also kept in a
+ * bounded min-heap (worst of the K on top): a submission that does not
+ * beat the heap top costs one comparison there, and top(n <= K) is
+ * served from those K keys without walking the tree. Deeper pages of the
+ * ranking, rank-of-score and position-of-entry queries go to the index.
+ *
+ * Once dead records (removed entries and their Remove records) outweigh
+ * the live ones the log is compacted automatically.
+ */
+#pragma once
+
+#include "scores/score_index.h"
+#include "scores/score_log.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// @brief A stored score as returned by queries
+struct ScoreEntry {
+    uint64_t id = 0;        ///< Log sequence number; stable across compaction and never reused
+    int32_t score = 0;
+    std::string name;       ///< UTF-8
+};
+
+class ScoreBoard {
+public:
+    /// @param top_k Size of the best-entries heap (the longest top() list served without the index)
+    explicit ScoreBoard(size_t top_k = 10) : k(top_k ? top_k : 1) {}
+
+    /// @brief Open or create the log at @p path and rebuild the index from it
+    bool open(const std::filesystem::path &path, std::string &err);
+    void close() { log.close(); }
+    bool is_open() const { return log.is_open(); }
+    const std::filesystem::path &path() const { return where; }
+    ScoreLog &storage() { return log; }
+
+    /// @brief Store a score; returns its id (0 if the log write failed)
+    ///
+    /// Names longer than ScoreLog::kMaxName bytes are cut at a UTF-8 character boundary.
+    uint64_t submit(std::string_view name, int32_t score);
+    /// @brief Delete entry @p id; false if it does not exist or the log write failed
+    bool remove(uint64_t id);
+
+    size_t size() const { return index.size(); }
+    /// @brief Best @p n entries, best first
+    std::vector<ScoreEntry> top(size_t n) const;
+    /// @brief @p n entries starting at 0-based position @p first
+    std::vector<ScoreEntry> page(size_t first, size_t n) const;
+    /// @brief 1-based place a new @p score would take (ties go after existing equal scores)
+    size_t rank_of_score(int32_t score) const { return index.rank(ScoreKey{ score, UINT64_MAX }) + 1; }
+    /// @brief 1-based place of entry @p id, 0 if it does not exist
+    size_t rank_of(uint64_t id) const;
+    /// @brief Compact now, whatever the garbage ratio
+    bool compact(std::string &err);
+
+private:
+    struct Slot {
+        std::string name;
+        int32_t score = 0;
+        bool live = false;
+    };
+
+    void apply(const ScoreRecord &r);
+    void heap_offer(const ScoreKey &key);
+    void heap_rebuild();
+    ScoreEntry entry(const ScoreKey &key) const;
+    void maybe_compact();
+
+    size_t k;
+    std::filesystem::path where;
+    ScoreLog log;
+    ScoreIndex index;
+    std::vector<ScoreKey> heap;   ///< Best k keys; heap order puts the worst of them at front()
+    std::vector<Slot> slots;      ///< By id - 1
+    uint64_t next_id = 1;
+};
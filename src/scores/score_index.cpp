@@ -0,0 +1,235 @@
+/**
+ * @file scores/score_index.cpp
+ * @brief Counted B+tree insert, erase, rank and select
+ */
+
+#include "scores/score_index.h"
+#include <algorithm>
+
+namespace {
+
+/// First position in [keys, keys + n) that does not rank before @p k
+int lower_bound(const ScoreKey *keys, int n, const ScoreKey &k) {
+    return (int)(std::lower_bound(keys, keys + n, k, ScoreKey::before) - keys);
+}
+
+} // namespace
+
+void ScoreIndex::clear() {
+    leaves.clear();
+    inners.clear();
+    free_leaves.clear();
+    free_inners.clear();
+    root = new_leaf();
+    levels = 0;
+    total = 0;
+}
+
+uint32_t ScoreIndex::new_leaf() {
+    if (!free_leaves.empty()) {
+        const uint32_t id = free_leaves.back();
+        free_leaves.pop_back();
+        leaves[id].n = 0;
+        return id;
+    }
+    leaves.emplace_back();
+    return (uint32_t)(leaves.size() - 1);
+}
+
+uint32_t ScoreIndex::new_inner() {
+    if (!free_inners.empty()) {
+        const uint32_t id = free_inners.back();
+        free_inners.pop_back();
+        inners[id].n = 0;
+        return id;
+    }
+    inners.emplace_back();
+    return (uint32_t)(inners.size() - 1);
+}
+
+uint64_t ScoreIndex::node_count(uint32_t node, int level) const {
+    if (level == 0) return (uint64_t)leaves[node].n;
+    const Inner &in = inners[node];
+    uint64_t c = 0;
+    for (int i = 0; i < in.n; ++i) c += in.count[i];
+    return c;
+}
+
+int ScoreIndex::child_for(const Inner &in, const ScoreKey &k) const {
+    // Last child whose lower bound does not rank after k
+    const int i = (int)(std::upper_bound(in.first + 1, in.first + in.n, k, ScoreKey::before) - in.first);
+    return i - 1;
+}
+
+void ScoreIndex::insert(const ScoreKey &k) {
+    uint32_t split = 0;
+    ScoreKey split_first;
+    if (insert_at(root, levels, k, split, split_first)) {
+        const uint32_t old_root = root, top = new_inner();
+        Inner &in = inners[top];
+        in.n = 2;
+        in.child[0] = old_root;
+        in.count[0] = node_count(old_root, levels);
+        in.child[1] = split;
+        in.count[1] = node_count(split, levels);
+        in.first[1] = split_first;
+        root = top;
+        ++levels;
+    }
+    ++total;
+}
+
+bool ScoreIndex::insert_at(uint32_t node, int level, const ScoreKey &k, uint32_t &split, ScoreKey &split_first) {
+    if (level == 0) {
+        {
+            Leaf &lf = leaves[node];
+            const int pos = lower_bound(lf.keys, lf.n, k);
+            if (lf.n < kLeafKeys) {
+                std::copy_backward(lf.keys + pos, lf.keys + lf.n, lf.keys + lf.n + 1);
+                lf.keys[pos] = k;
+                ++lf.n;
+                return false;
+            }
+        }
+        // Full: move the upper half to a new leaf, then insert into the half that owns k
+        split = new_leaf();
+        Leaf &lf = leaves[node], &rt = leaves[split];
+        const int half = kLeafKeys / 2;
+        std::copy(lf.keys + half, lf.keys + lf.n, rt.keys);
+        rt.n = lf.n - half;
+        lf.n = half;
+        Leaf &dst = ScoreKey::before(k, rt.keys[0]) ? lf : rt;
+        const int pos = lower_bound(dst.keys, dst.n, k);
+        std::copy_backward(dst.keys + pos, dst.keys + dst.n, dst.keys + dst.n + 1);
+        dst.keys[pos] = k;
+        ++dst.n;
+        split_first = rt.keys[0];
+        return true;
+    }
+
+    const int i = child_for(inners[node], k);
+    uint32_t child_split = 0;
+    ScoreKey child_first;
+    const bool grew = insert_at(inners[node].child[i], level - 1, k, child_split, child_first);
+    Inner *in = &inners[node];
+    if (!grew) {
+        ++in->count[i];
+        return false;
+    }
+    in->count[i] = node_count(in->child[i], level - 1);
+    const uint64_t split_count = node_count(child_split, level - 1);
+    if (in->n == kInnerChildren) {
+        // Full: move the upper half to a new node first, then insert the new child into its half
+        split = new_inner();
+        in = &inners[node];
+        Inner &rt = inners[split];
+        const int half = kInnerChildren / 2;
+        rt.n = in->n - half;
+        std::copy(in->child + half, in->child + in->n, rt.child);
+        std::copy(in->count + half, in->count + in->n, rt.count);
+        std::copy(in->first + half, in->first + in->n, rt.first);
+        in->n = half;
+        split_first = rt.first[0];
+        Inner &dst = i + 1 <= half ? *in : rt;
+        const int at = i + 1 <= half ? i + 1 : i + 1 - half;
+        std::copy_backward(dst.child + at, dst.child + dst.n, dst.child + dst.n + 1);
+        std::copy_backward(dst.count + at, dst.count + dst.n, dst.count + dst.n + 1);
+        std::copy_backward(dst.first + at, dst.first + dst.n, dst.first + dst.n + 1);
+        dst.child[at] = child_split;
+        dst.count[at] = split_count;
+        dst.first[at] = child_first;
+        ++dst.n;
+        return true;
+    }
+    const int at = i + 1;
+    std::copy_backward(in->child + at, in->child + in->n, in->child + in->n + 1);
+    std::copy_backward(in->count + at, in->count + in->n, in->count + in->n + 1);
+    std::copy_backward(in->first + at, in->first + in->n, in->first + in->n + 1);
+    in->child[at] = child_split;
+    in->count[at] = split_count;
+    in->first[at] = child_first;
+    ++in->n;
+    return false;
+}
+
+bool ScoreIndex::erase(const ScoreKey &k) {
+    if (erase_at(root, levels, k) == 0) return false;
+    --total;
+    // Collapse single-child roots so lookups do not walk a chain of one-way nodes
+    while (levels > 0 && inners[root].n == 1) {
+        free_inners.push_back(root);
+        root = inners[root].child[0];
+        --levels;
+    }
+    if (levels > 0 && inners[root].n == 0) clear();
+    return true;
+}
+
+int ScoreIndex::erase_at(uint32_t node, int level, const ScoreKey &k) {
+    if (level == 0) {
+        Leaf &lf = leaves[node];
+        const int pos = lower_bound(lf.keys, lf.n, k);
+        if (pos == lf.n || !(lf.keys[pos] == k)) return 0;
+        std::copy(lf.keys + pos + 1, lf.keys + lf.n, lf.keys + pos);
+        --lf.n;
+        return lf.n == 0 ? 2 : 1;
+    }
+    Inner &in = inners[node];
+    const int i = child_for(in, k);
+    const int r = erase_at(in.child[i], level - 1, k);
+    if (r == 0) return 0;
+    --in.count[i];
+    if (r == 2) {
+        // Drop the empty child; the next child's lower bound still holds for what remains
+        if (level == 1) free_leaves.push_back(in.child[i]);
+        else free_inners.push_back(in.child[i]);
+        std::copy(in.child + i + 1, in.child + in.n, in.child + i);
+        std::copy(in.count + i + 1, in.count + in.n, in.count + i);
+        std::copy(in.first + i + 1, in.first + in.n, in.first + i);
+        --in.n;
+    }
+    return in.n == 0 ? 2 : 1;
+}
+
+size_t ScoreIndex::rank(const ScoreKey &k) const {
+    size_t before = 0;
+    uint32_t node = root;
+    for (int level = levels; level > 0; --level) {
+        const Inner &in = inners[node];
+        const int i = child_for(in, k);
+        for (int c = 0; c < i; ++c) before += (size_t)in.count[c];
+        node = in.child[i];
+    }
+    const Leaf &lf = leaves[node];
+    return before + (size_t)lower_bound(lf.keys, lf.n, k);
+}
+
+ScoreKey ScoreIndex::at(size_t i) const {
+    uint32_t node = root;
+    for (int level = levels; level > 0; --level) {
+        const Inner &in = inners[node];
+        int c = 0;
+        while (c + 1 < in.n && i >= in.count[c]) i -= (size_t)in.count[c++];
+        node = in.child[c];
+    }
+    return leaves[node].keys[i];
+}
+
+void ScoreIndex::range(size_t first, size_t n, std::vector<ScoreKey> &out) const {
+    if (first >= total || n == 0) return;
+    range_at(root, levels, first, n, out);
+}
+
+void ScoreIndex::range_at(uint32_t node, int level, size_t first, size_t &n, std::vector<ScoreKey> &out) const {
+    if (level == 0) {
+        const Leaf &lf = leaves[node];
+        for (int i = (int)first; i < lf.n && n > 0; ++i, --n) out.push_back(lf.keys[i]);
+        return;
+    }
+    const Inner &in = inners[node];
+    for (int c = 0; c < in.n && n > 0; ++c) {
+        if (first >= in.count[c]) { first -= (size_t)in.count[c]; continue; }
+        range_at(in.child[c], level - 1, first, n, out);
+        first = 0;
+    }
+}
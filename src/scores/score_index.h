@@ -0,0 +1,87 @@
+/**
+ * @file scores/score_index.h
+ * @brief Order-statistic B+tree over score keys
+ *
+ * Keys are ordered best first: higher score, then earlier submission.
+ * Every inner node keeps the key count of each child, so besides insert
+ * and erase the tree answers "how many keys rank before this one" and
+ * "which key is n-th" in O(log n), and hands out any slice of the
+ * ranking in O(log n + length). Nodes live in two pooled vectors and
+ * refer to each other by index.
+ *
+ * erase() drops nodes that become empty but does not merge underfull
+ * ones, so the height follows the peak size; the score log rebuilds the
+ * index from scratch when it compacts.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// @brief One ranked score: @ref seq breaks ties (earlier ranks first) and identifies the entry
+struct ScoreKey {
+    int32_t score = 0;
+    uint64_t seq = 0;
+
+    /// @brief True if @p a ranks before @p b
+    static bool before(const ScoreKey &a, const ScoreKey &b) {
+        return a.score != b.score ? a.score > b.score : a.seq < b.seq;
+    }
+    bool operator==(const ScoreKey &o) const { return score == o.score && seq == o.seq; }
+};
+
+class ScoreIndex {
+public:
+    static constexpr int kLeafKeys = 64;     ///< Keys per leaf
+    static constexpr int kInnerChildren = 64; ///< Children per inner node
+
+    ScoreIndex() { clear(); }
+
+    void clear();
+    size_t size() const { return total; }
+    /// @brief Tree height in levels above the leaves (0 = the root is a leaf)
+    int height() const { return levels; }
+
+    /// @brief Insert @p k (keys are unique by seq; inserting a present key is not checked)
+    void insert(const ScoreKey &k);
+    /// @brief Remove @p k; false if it is not present
+    bool erase(const ScoreKey &k);
+
+    /// @brief Number of keys ranking before @p k (its 0-based rank if present)
+    size_t rank(const ScoreKey &k) const;
+    /// @brief Number of keys with a score strictly above @p score
+    size_t count_above(int32_t score) const { return rank(ScoreKey{ score, 0 }); }
+    /// @brief Key at 0-based rank @p i (< size())
+    ScoreKey at(size_t i) const;
+    /// @brief Append up to @p n keys starting at rank @p first to @p out, best first
+    void range(size_t first, size_t n, std::vector<ScoreKey> &out) const;
+
+private:
+    struct Leaf {
+        int n = 0;
+        ScoreKey keys[kLeafKeys];
+    };
+    struct Inner {
+        int n = 0;
+        uint32_t child[kInnerChildren];
+        uint64_t count[kInnerChildren];   ///< Keys under each child
+        ScoreKey first[kInnerChildren];   ///< Lower bound of each child (first[0] unused)
+    };
+
+    uint32_t new_leaf();
+    uint32_t new_inner();
+    uint64_t node_count(uint32_t node, int level) const;
+    int child_for(const Inner &in, const ScoreKey &k) const;
+    bool insert_at(uint32_t node, int level, const ScoreKey &k, uint32_t &split, ScoreKey &split_first);
+    /// Returns 0 if not found, 1 if erased, 2 if erased and @p node is now empty
+    int erase_at(uint32_t node, int level, const ScoreKey &k);
+    void range_at(uint32_t node, int level, size_t first, size_t &n, std::vector<ScoreKey> &out) const;
+
+    std::vector<Leaf> leaves;
+    std::vector<Inner> inners;
+    std::vector<uint32_t> free_leaves, free_inners;
+    uint32_t root = 0;
+    int levels = 0;
+    size_t total = 0;
+};
@@ -0,0 +1,239 @@
+/**
+ * @file scores/score_log.cpp
+ * @brief Score log encoding, replay with torn-tail recovery, durable append and compaction
+ */
+
+#include "scores/score_log.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = { 'P', 'O', 'N', 'G', 'S', 'C', 'L', '1' };
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderBytes = 16;
+constexpr size_t kFixedPayload = 1 + 8 + 4 + 2;   ///< Payload bytes before the name
+
+/// CRC-32 (IEEE, reflected), table built at compile time
+constexpr std::array<uint32_t, 256> make_crc_table() {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        t[i] = c;
+    }
+    return t;
+}
+constexpr std::array<uint32_t, 256> kCrcTable = make_crc_table();
+
+uint32_t crc32(const uint8_t *p, size_t n) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; ++i) c = kCrcTable[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+template <typename T> void put(std::vector<uint8_t> &b, T v) {
+    const size_t at = b.size();
+    b.resize(at + sizeof(T));
+    std::memcpy(b.data() + at, &v, sizeof(T));
+}
+template <typename T> T get(const uint8_t *p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+bool sync_file(std::FILE *f) {
+    if (std::fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+/// Make a rename durable: on POSIX the directory entry has to be flushed too
+void sync_dir(const std::filesystem::path &dir) {
+#ifndef _WIN32
+    const int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) { fsync(fd); ::close(fd); }
+#else
+    (void)dir;
+#endif
+}
+
+std::FILE *open_append(const std::filesystem::path &p) {
+#ifdef _WIN32
+    return _wfopen(p.c_str(), L"ab");
+#else
+    return std::fopen(p.c_str(), "ab");
+#endif
+}
+
+bool write_header(std::FILE *f) {
+    uint8_t h[kHeaderBytes] = {};
+    std::memcpy(h, kMagic, sizeof(kMagic));
+    std::memcpy(h + 8, &kVersion, 4);
+    return std::fwrite(h, 1, sizeof(h), f) == sizeof(h);
+}
+
+} // namespace
+
+ScoreLog::~ScoreLog() { close(); }
+
+void ScoreLog::close() {
+    if (file) {
+        sync_file(file);
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+bool ScoreLog::open(const std::filesystem::path &path, const std::function<void(const ScoreRecord &)> &replay, std::string &err) {
+    close();
+    where = path;
+    size = count = dropped = 0;
+
+    std::vector<uint8_t> data;
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (in) data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    size_t good = 0;
+    if (data.size() >= kHeaderBytes) {
+        if (std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0 || get<uint32_t>(data.data() + 8) != kVersion) {
+            err = path.string() + ": not a score log";
+            return false;
+        }
+        good = kHeaderBytes;
+        while (data.size() - good >= 8) {
+            const uint8_t *rec = data.data() + good;
+            const uint32_t len = get<uint32_t>(rec);
+            if (len < kFixedPayload || len > kFixedPayload + kMaxName || data.size() - good - 8 < len) break;
+            const uint8_t *p = rec + 8;
+            if (crc32(p, len) != get<uint32_t>(rec + 4)) break;
+            ScoreRecord r;
+            r.type = (ScoreRecord::Type)p[0];
+            r.seq = get<uint64_t>(p + 1);
+            r.score = get<int32_t>(p + 9);
+            const uint16_t name_len = get<uint16_t>(p + 13);
+            if (kFixedPayload + name_len != len || r.type < ScoreRecord::Add || r.type > ScoreRecord::NextSeq) break;
+            r.name = std::string_view((const char *)p + kFixedPayload, name_len);
+            replay(r);
+            good += 8 + len;
+            ++count;
+        }
+    }
+
+    std::error_code ec;
+    if (good == 0) {
+        // New (or header-less) log: start it fresh
+        std::FILE *f = nullptr;
+#ifdef _WIN32
+        f = _wfopen(path.c_str(), L"wb");
+#else
+        f = std::fopen(path.c_str(), "wb");
+#endif
+        if (!f || !write_header(f) || !sync_file(f)) {
+            if (f) std::fclose(f);
+            err = path.string() + ": cannot create";
+            return false;
+        }
+        std::fclose(f);
+        dropped = data.size();
+        good = kHeaderBytes;
+    } else if (good < data.size()) {
+        dropped = data.size() - good;
+        std::filesystem::resize_file(path, good, ec);
+        if (ec) { err = path.string() + ": cannot truncate torn tail: " + ec.message(); return false; }
+    }
+
+    file = open_append(path);
+    if (!file) { err = path.string() + ": cannot open for append"; return false; }
+    size = good;
+    return true;
+}
+
+bool ScoreLog::write_record(std::FILE *f, const ScoreRecord &r) {
+    const size_t name_len = std::min(r.name.size(), kMaxName);
+    buf.clear();
+    put<uint32_t>(buf, (uint32_t)(kFixedPayload + name_len));
+    put<uint32_t>(buf, 0);
+    put<uint8_t>(buf, (uint8_t)r.type);
+    put<uint64_t>(buf, r.seq);
+    put<int32_t>(buf, r.score);
+    put<uint16_t>(buf, (uint16_t)name_len);
+    buf.insert(buf.end(), r.name.data(), r.name.data() + name_len);
+    const uint32_t crc = crc32(buf.data() + 8, buf.size() - 8);
+    std::memcpy(buf.data() + 4, &crc, 4);
+    return std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+}
+
+bool ScoreLog::append(const ScoreRecord &r) {
+    if (!file || !write_record(file, r)) return false;
+    size += buf.size();
+    ++count;
+    return durable ? sync_file(file) : true;
+}
+
+bool ScoreLog::flush(bool to_disk) {
+    if (!file) return false;
+    return to_disk ? sync_file(file) : std::fflush(file) == 0;
+}
+
+bool ScoreLog::compact(const std::vector<ScoreRecord> &live, uint64_t next_seq, std::string &err) {
+    if (!file) { err = "score log not open"; return false; }
+    std::filesystem::path tmp = where;
+    tmp += ".tmp";
+    std::FILE *f = nullptr;
+#ifdef _WIN32
+    f = _wfopen(tmp.c_str(), L"wb");
+#else
+    f = std::fopen(tmp.c_str(), "wb");
+#endif
+    if (!f) { err = tmp.string() + ": cannot create"; return false; }
+    ScoreRecord next;
+    next.type = ScoreRecord::NextSeq;
+    next.seq = next_seq;
+    bool ok = write_header(f) && write_record(f, next);
+    uint64_t bytes = kHeaderBytes + buf.size();
+    for (size_t i = 0; ok && i < live.size(); ++i) {
+        ok = write_record(f, live[i]);
+        bytes += buf.size();
+    }
+    ok = sync_file(f) && ok;
+    std::fclose(f);
+    std::error_code ec;
+    if (!ok) {
+        std::filesystem::remove(tmp, ec);
+        err = tmp.string() + ": write failed";
+        return false;
+    }
+
+    // Appends so far are in the old file; flush them before it is replaced so nothing is lost if the rename fails
+    sync_file(file);
+    std::fclose(file);
+    file = nullptr;
+    std::filesystem::rename(tmp, where, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        err = where.string() + ": rename failed";
+        file = open_append(where);
+        return false;
+    }
+    sync_dir(where.parent_path());
+    file = open_append(where);
+    if (!file) { err = where.string() + ": cannot reopen for append"; return false; }
+    size = bytes;
+    count = live.size() + 1;
+    return true;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file scores/score_log.h
+ * @brief Append-only, checksummed score log with compaction by atomic rename
+ *
+ * Layout (little endian):
+ *
+ *     "PONGSCL1" | u32 version | u32 reserved
+ *     records: u32 payload bytes | u32 CRC-32 of payload | payload
+ *     payload: u8 type | u64 seq | i32 score | u16 name bytes | name (UTF-8)
+ *
+ * A submission appends one Add record and a deletion one Remove record
+ * naming the seq it removes, so a write never touches existing bytes.
+ * A compacted log starts with a NextSeq record holding the first unused
+ * seq, since the Adds of removed entries it drops may have held the
+ * highest ones. On
+ * open the records are replayed in order; a short or corrupt record at
+ * the end (a write cut off by a crash or power loss) ends the replay and
+ * is truncated away. compact() writes only the live entries to a
+ * temporary file, flushes it to disk and renames it over the log, so at
+ * any instant the path holds either the old or the new log in full.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ScoreRecord {
+    enum Type : uint8_t { Add = 1, Remove = 2, NextSeq = 3 };
+    Type type = Add;
+    uint64_t seq = 0;        ///< Entry id: assigned on Add, referenced by Remove; first unused id for NextSeq
+    int32_t score = 0;
+    std::string_view name;   ///< UTF-8, at most kMaxName bytes; empty for Remove
+};
+
+class ScoreLog {
+public:
+    static constexpr size_t kMaxName = 255;
+
+    ScoreLog() = default;
+    ~ScoreLog();
+    ScoreLog(const ScoreLog &) = delete;
+    ScoreLog &operator=(const ScoreLog &) = delete;
+
+    /**
+     * @brief Open (or create) the log and replay every intact record through @p replay
+     *
+     * The string_view in each record is only valid during the call.
+     */
+    bool open(const std::filesystem::path &path, const std::function<void(const ScoreRecord &)> &replay, std::string &err);
+    void close();
+    bool is_open() const { return file != nullptr; }
+
+    /// @brief fsync after every append (default on); off leaves durability to flush(true)
+    void set_durable(bool on) { durable = on; }
+    /// @brief Append one record (names are cut to kMaxName bytes)
+    bool append(const ScoreRecord &r);
+    /// @brief Push buffered appends to the OS, and to the disk if @p to_disk
+    bool flush(bool to_disk);
+
+    /**
+     * @brief Replace the log with @p live (Add records, any order) via a temporary file and rename
+     *
+     * @param next_seq First id not handed out yet; stored so ids of removed entries are never reused
+     */
+    bool compact(const std::vector<ScoreRecord> &live, uint64_t next_seq, std::string &err);
+
+    uint64_t bytes() const { return size; }
+    uint64_t records() const { return count; }
+    /// @brief Bytes of a torn tail dropped by the last open()
+    uint64_t truncated() const { return dropped; }
+
+private:
+    bool write_record(std::FILE *f, const ScoreRecord &r);
+
+    std::filesystem::path where;
+    std::FILE *file = nullptr;
+    std::vector<uint8_t> buf;   ///< Reused record encoding buffer
+    bool durable = true;
+    uint64_t size = 0, count = 0, dropped = 0;
+};
@@ -0,0 +1,492 @@
+/**
+ * @file match_server.cpp
+ * @brief Implementation of the multi-match server
+ */
+
+#include "server/match_server.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static bool set_nonblocking(int fd) {
+    int fl = fcntl(fd, F_GETFL, 0);
+    return fl >= 0 && fcntl(fd, F_SETFL, fl | O_NONBLOCK) == 0;
+}
+
+static sockaddr_in loopback(uint16_t port) {
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return a;
+}
+
+MatchServer::Match::Match(const ServerConfig &cfg, uint32_t match_id) : id(match_id) {
+    core.set_mode(cfg.mode);
+}
+
+MatchServer::MatchServer(const ServerConfig &c) : cfg(c), sched(c.threads) {
+    if (cfg.hz <= 0) cfg.hz = 60;
+    if (cfg.matches_per_task == 0) cfg.matches_per_task = 1;
+    matches.reserve(cfg.matches);
+    for (size_t i = 0; i < cfg.matches; ++i) matches.push_back(std::make_unique<Match>(cfg, (uint32_t)i));
+}
+
+MatchServer::~MatchServer() {
+    for (auto &c : conns) close(c.fd);
+    if (udp_fd >= 0) close(udp_fd);
+    if (listen_fd >= 0) close(listen_fd);
+}
+
+bool MatchServer::start(std::string &err) {
+    sockaddr_in addr = loopback(cfg.port);
+    udp_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp_fd < 0 || bind(udp_fd, (sockaddr *)&addr, sizeof(addr)) != 0 || !set_nonblocking(udp_fd)) {
+        err = std::string("udp bind: ") + std::strerror(errno);
+        return false;
+    }
+    // Thousands of clients per tick: give the kernel room to queue bursts
+    int buf = 8 << 20;
+    setsockopt(udp_fd, SOL_SOCKET, SO_RCVBUF, &buf, sizeof(buf));
+    setsockopt(udp_fd, SOL_SOCKET, SO_SNDBUF, &buf, sizeof(buf));
+
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (listen_fd < 0 || bind(listen_fd, (sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0 || !set_nonblocking(listen_fd)) {
+        err = std::string("tcp listen: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+void MatchServer::route_input(const uint8_t *data, size_t len, const sockaddr_in *from, int tcp_fd) {
+    InputMsg in;
+    if (!decode_input(data, len, in) || in.match_id >= matches.size()) {
+        std::lock_guard<std::mutex> lock(stats_mtx);
+        ++acc.stale_inputs;
+        return;
+    }
+    ClientSlot &c = matches[in.match_id]->clients[in.side];
+    if (c.active && in.seq <= c.last_seq) {
+        std::lock_guard<std::mutex> lock(stats_mtx);
+        ++acc.stale_inputs;
+        return;
+    }
+    if (tcp_fd >= 0) {
+        if (!c.tcp || c.fd != tcp_fd) c.out.clear();
+        c.tcp = true;
+        c.fd = tcp_fd;
+    } else {
+        c.tcp = false;
+        c.fd = -1;
+        c.addr = *from;
+    }
+    c.active = true;
+    c.last_seq = in.seq;
+    if (in.ack_tick > c.ack_tick) c.ack_tick = in.ack_tick;
+    c.paddle_y = in.paddle_y;
+    c.has_input = true;
+    std::lock_guard<std::mutex> lock(stats_mtx);
+    ++acc.inputs;
+}
+
+void MatchServer::route_tcp(const uint8_t *data, size_t len, TcpConn &c) {
+    uint32_t match;
+    bool spectate = false;
+    if (message_type(data, len) == (uint8_t)MsgType::Spectate) {
+        if (!decode_spectate(data, len, match) || match >= matches.size()) return;
+        spectate = true;
+    } else {
+        InputMsg in;
+        if (!decode_input(data, len, in) || in.match_id >= matches.size()) {
+            route_input(data, len, nullptr, c.fd);   // counted as stale there
+            return;
+        }
+        match = in.match_id;
+    }
+    // Each match's task writes to its players and spectators from its own
+    // lane; binding the connection keeps its socket to a single writer
+    if (c.match == kNoMatch) {
+        c.match = match;
+        c.spectator = spectate;
+        if (spectate) {
+            add_spectator(c.fd, match);
+            return;
+        }
+    } else if (c.match != match || c.spectator || spectate) {
+        std::lock_guard<std::mutex> lock(stats_mtx);
+        ++acc.rejected_tcp;
+        return;
+    }
+    route_input(data, len, nullptr, c.fd);
+}
+
+void MatchServer::add_spectator(int fd, uint32_t match) {
+    Spectator s;
+    s.fd = fd;
+    s.match = match;
+    spectators.push_back(std::move(s));
+    ++matches[match]->spectators;
+    matches[match]->spectator_joined = true;
+}
+
+void MatchServer::prune_spectators() {
+    auto dead = std::remove_if(spectators.begin(), spectators.end(), [](const Spectator &s) { return s.dead; });
+    for (auto it = dead; it != spectators.end(); ++it) --matches[it->match]->spectators;
+    spectators.erase(dead, spectators.end());
+}
+
+void MatchServer::drain_udp() {
+    uint8_t buf[kMaxMessageBytes];
+    for (;;) {
+        sockaddr_in from{};
+        socklen_t fl = sizeof(from);
+        ssize_t n = recvfrom(udp_fd, buf, sizeof(buf), 0, (sockaddr *)&from, &fl);
+        if (n <= 0) break;
+        route_input(buf, (size_t)n, &from, -1);
+    }
+}
+
+void MatchServer::accept_tcp() {
+    for (;;) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) break;
+        set_nonblocking(fd);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        conns.push_back({ fd, {} });
+    }
+}
+
+bool MatchServer::read_tcp(TcpConn &c) {
+    uint8_t buf[4096];
+    for (;;) {
+        ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+        if (n == 0) return false;
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        c.in.insert(c.in.end(), buf, buf + n);
+        if (!drain_frames(c.in, [&](const uint8_t *msg, size_t len) { route_tcp(msg, len, c); }))
+            return false;
+    }
+}
+
+void MatchServer::drop_tcp(int fd) {
+    for (auto &m : matches) {
+        for (ClientSlot &c : m->clients) {
+            if (c.tcp && c.fd == fd) c = ClientSlot{};
+        }
+    }
+    // Prune before closing so a reused descriptor never reaches a stale spectator
+    for (Spectator &s : spectators) {
+        if (s.fd == fd) s.dead = true;
+    }
+    prune_spectators();
+    close(fd);
+}
+
+void MatchServer::drop_dead_players() {
+    for (auto &m : matches) {
+        for (ClientSlot &c : m->clients) {
+            if (!c.dead) continue;
+            const int fd = c.fd;
+            for (TcpConn &t : conns) {
+                if (t.fd == fd) t.fd = -1;
+            }
+            drop_tcp(fd);
+        }
+    }
+    conns.erase(std::remove_if(conns.begin(), conns.end(), [](const TcpConn &c) { return c.fd < 0; }), conns.end());
+}
+
+void MatchServer::poll_network(int timeout_ms) {
+    std::vector<pollfd> fds;
+    fds.reserve(2 + conns.size());
+    fds.push_back({ udp_fd, POLLIN, 0 });
+    fds.push_back({ listen_fd, POLLIN, 0 });
+    for (const auto &c : conns) fds.push_back({ c.fd, POLLIN, 0 });
+    if (poll(fds.data(), (nfds_t)fds.size(), timeout_ms) <= 0) return;
+
+    if (fds[0].revents & POLLIN) drain_udp();
+    for (size_t i = 0; i < conns.size(); ++i) {
+        if (!fds[2 + i].revents) continue;
+        if (!read_tcp(conns[i])) {
+            drop_tcp(conns[i].fd);
+            conns[i].fd = -1;
+        }
+    }
+    conns.erase(std::remove_if(conns.begin(), conns.end(), [](const TcpConn &c) { return c.fd < 0; }), conns.end());
+    if (fds[1].revents & POLLIN) accept_tcp();
+}
+
+bool MatchServer::flush_player(ClientSlot &c) {
+    ssize_t n = send(c.fd, c.out.data(), c.out.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n > 0) c.out.erase(c.out.begin(), c.out.begin() + n);
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) c.dead = true;
+    return !c.dead;
+}
+
+void MatchServer::send_snapshot(Match &m, uint8_t side, TaskCounters &tc) {
+    ClientSlot &c = m.clients[side];
+    SnapshotHeader hdr;
+    hdr.match_id = m.id;
+    hdr.side = side;
+    hdr.tick = m.tick;
+    hdr.base_tick = c.ack_tick;
+    m.msg.clear();
+    bool delta = encode_snapshot(hdr, m.fields, m.history.find(c.ack_tick), m.msg);
+    if (m.msg.size() > kMaxMessageBytes) { ++tc.drops; return; }
+
+    if (c.tcp) {
+        // Drain the backlog first so a reader that stalled once catches up
+        if (!c.out.empty() && !flush_player(c)) { ++tc.drops; return; }
+        // Never queue behind a stalled reader: the next snapshot is a fresh delta anyway
+        if (c.out.size() > 64 * 1024) { ++tc.drops; return; }
+        append_frame(m.msg.data(), m.msg.size(), c.out);
+        if (!flush_player(c)) { ++tc.drops; return; }
+    } else {
+        ssize_t n = sendto(udp_fd, m.msg.data(), m.msg.size(), MSG_DONTWAIT, (const sockaddr *)&c.addr, sizeof(c.addr));
+        if (n < 0) { ++tc.drops; return; }
+    }
+    if (delta) { ++tc.deltas; tc.delta_bytes += m.msg.size(); }
+    else { ++tc.keyframes; tc.keyframe_bytes += m.msg.size(); }
+}
+
+void MatchServer::tick_match(Match &m, bool late, TaskCounters &tc) {
+    GameCore &core = m.core;
+    const GameState &gs = core.state();
+    ClientSlot &left = m.clients[0], &right = m.clients[1];
+    if (left.has_input) core.set_left_y(left.paddle_y - gs.paddle_h/2.0);
+    // A connected right player replaces the AI opponent
+    core.enable_right_ai(!right.active);
+    if (right.active && right.has_input) core.move_right_by((right.paddle_y - gs.paddle_h/2.0) - gs.right_y);
+
+    core.update(1.0 / cfg.hz);
+    ++m.tick;
+    snapshot_fields(gs, m.fields);
+    m.history.push(m.tick, m.fields);
+    // Encoded even when late: the fan-out pass decides whether it is delivered
+    if (m.spectators) encode_spectator_frame(m, tc);
+    else m.spec_frame.reset();
+    if (late) return;
+    for (uint8_t side = 0; side < 2; ++side) {
+        if (m.clients[side].active) send_snapshot(m, side, tc);
+    }
+}
+
+void MatchServer::encode_spectator_frame(Match &m, TaskCounters &tc) {
+    const bool key = m.spectator_joined || m.tick % kSpectatorKeyframeTicks == 0;
+    m.spectator_joined = false;
+    SnapshotHeader hdr;
+    hdr.match_id = m.id;
+    hdr.side = kSpectatorSide;
+    hdr.tick = m.tick;
+    hdr.base_tick = key ? 0 : m.tick - 1;
+
+    auto frame = std::make_shared<std::vector<uint8_t>>(2);
+    const bool delta = encode_snapshot(hdr, m.fields, key ? nullptr : m.history.find(m.tick - 1), *frame);
+    const size_t len = frame->size() - 2;
+    if (len > kMaxMessageBytes) { m.spec_frame.reset(); ++tc.drops; return; }
+    (*frame)[0] = (uint8_t)len;
+    (*frame)[1] = (uint8_t)(len >> 8);
+    m.spec_base = delta ? m.tick - 1 : 0;
+    m.spec_frame = std::move(frame);
+    ++tc.spec_frames;
+    if (!delta) ++tc.spec_keyframes;
+    tc.spec_frame_bytes += len + 2;
+}
+
+void MatchServer::resync_spectator(Spectator &s) {
+    // Keep a partially written frame so the stream stays framed
+    const size_t keep = s.offset > 0 ? 1 : 0;
+    while (s.queue.size() > keep) s.queue.pop_back();
+    s.queued_bytes = keep ? s.queue.front()->size() - s.offset : 0;
+    s.waiting_keyframe = true;
+}
+
+void MatchServer::flush_spectator(Spectator &s, TaskCounters &tc) {
+    constexpr size_t kMaxIov = 64;
+    iovec iov[kMaxIov];
+    size_t count = 0, off = s.offset;
+    for (const SharedFrame &f : s.queue) {
+        if (count == kMaxIov) break;
+        iov[count].iov_base = const_cast<uint8_t *>(f->data() + off);
+        iov[count].iov_len = f->size() - off;
+        off = 0;
+        ++count;
+    }
+    msghdr mh{};
+    mh.msg_iov = iov;
+    mh.msg_iovlen = count;
+    ssize_t n = sendmsg(s.fd, &mh, MSG_DONTWAIT | MSG_NOSIGNAL);
+    ++tc.fan_syscalls;
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) s.dead = true;
+        return;
+    }
+    tc.fan_bytes += (uint64_t)n;
+    s.queued_bytes -= (size_t)n;
+    size_t left = (size_t)n;
+    while (left > 0) {
+        const size_t avail = s.queue.front()->size() - s.offset;
+        if (left < avail) { s.offset += left; break; }
+        left -= avail;
+        s.queue.pop_front();
+        s.offset = 0;
+    }
+}
+
+void MatchServer::feed_spectator(Spectator &s, const Match &m, TaskCounters &tc) {
+    const bool key = m.spec_base == 0;
+    if (!s.waiting_keyframe && (s.queued_bytes > kSpectatorBacklog || (!key && m.spec_base != s.last_tick))) {
+        resync_spectator(s);
+        ++tc.resyncs;
+    }
+    if (s.waiting_keyframe) {
+        if (!key) {
+            if (!s.queue.empty()) flush_spectator(s, tc);
+            return;
+        }
+        s.waiting_keyframe = false;
+    }
+    s.last_tick = m.tick;
+    const SharedFrame &f = m.spec_frame;
+    if (!s.queue.empty()) {
+        s.queue.push_back(f);
+        s.queued_bytes += f->size();
+        flush_spectator(s, tc);
+        return;
+    }
+    // Common case: the socket takes the whole frame and no reference is kept
+    ssize_t n = send(s.fd, f->data(), f->size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    ++tc.fan_syscalls;
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) { s.dead = true; return; }
+        n = 0;
+    }
+    tc.fan_bytes += (uint64_t)n;
+    if ((size_t)n == f->size()) return;
+    s.queue.push_back(f);
+    s.offset = (size_t)n;
+    s.queued_bytes = f->size() - (size_t)n;
+}
+
+void MatchServer::fanout_task(size_t task, bool late) {
+    TaskCounters tc;
+    size_t begin = task * cfg.spectators_per_task;
+    size_t end = std::min(spectators.size(), begin + cfg.spectators_per_task);
+    for (size_t i = begin; i < end; ++i) {
+        Spectator &s = spectators[i];
+        const Match &m = *matches[s.match];
+        if (s.dead || !m.spec_frame) continue;
+        if (late) {
+            // Out of time: drop this tick and let the spectator rejoin at a keyframe
+            if (!s.waiting_keyframe) { resync_spectator(s); ++tc.resyncs; }
+            continue;
+        }
+        feed_spectator(s, m, tc);
+    }
+    add_counters(tc);
+}
+
+void MatchServer::add_counters(const TaskCounters &tc) {
+    if (tc.deltas) { deltas.fetch_add(tc.deltas); delta_bytes.fetch_add(tc.delta_bytes); }
+    if (tc.keyframes) { keyframes.fetch_add(tc.keyframes); keyframe_bytes.fetch_add(tc.keyframe_bytes); }
+    if (tc.drops) send_drops.fetch_add(tc.drops);
+    if (tc.spec_frames) {
+        spec_frames.fetch_add(tc.spec_frames);
+        spec_keyframes.fetch_add(tc.spec_keyframes);
+        spec_frame_bytes.fetch_add(tc.spec_frame_bytes);
+    }
+    if (tc.fan_syscalls) { fan_bytes.fetch_add(tc.fan_bytes); fan_syscalls.fetch_add(tc.fan_syscalls); }
+    if (tc.resyncs) resyncs.fetch_add(tc.resyncs);
+}
+
+void MatchServer::tick_task(size_t task, bool late) {
+    TaskCounters tc;
+    size_t begin = task * cfg.matches_per_task;
+    size_t end = std::min(matches.size(), begin + cfg.matches_per_task);
+    for (size_t i = begin; i < end; ++i) tick_match(*matches[i], late, tc);
+    add_counters(tc);
+}
+
+void MatchServer::run(const std::atomic<bool> &stop) {
+    using Clock = TickScheduler::Clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / cfg.hz));
+    const size_t tasks = (matches.size() + cfg.matches_per_task - 1) / cfg.matches_per_task;
+    const TickScheduler::TaskFn fn = [this](size_t task, bool late) { tick_task(task, late); };
+    const TickScheduler::TaskFn fan_fn = [this](size_t task, bool late) { fanout_task(task, late); };
+
+    auto next = Clock::now();
+    while (!stop.load(std::memory_order_relaxed)) {
+        drain_udp();
+        const auto deadline = next + period;
+        TickScheduler::TickStats ts = sched.run(tasks, fn, deadline);
+        drop_dead_players();
+        TickScheduler::TickStats fs;
+        if (!spectators.empty()) {
+            const size_t fan_tasks = (spectators.size() + cfg.spectators_per_task - 1) / cfg.spectators_per_task;
+            fs = sched.run(fan_tasks, fan_fn, deadline);
+            prune_spectators();
+        }
+        next += period;
+        {
+            std::lock_guard<std::mutex> lock(stats_mtx);
+            ++acc.ticks;
+            acc.match_ticks += matches.size();
+            acc.cpu_ns += ts.cpu_ns;
+            acc.fanout_cpu_ns += fs.cpu_ns;
+            acc.steals += ts.steals + fs.steals;
+            acc.late_tasks += ts.late + fs.late;
+            acc.spectators = spectators.size();
+            acc.spectator_ticks += spectators.size();
+            acc.tick_ms.push_back(ts.wall_ms + fs.wall_ms);
+        }
+        auto now = Clock::now();
+        if (now > next) {
+            // Behind schedule: tick again immediately but never try to catch up a backlog
+            {
+                std::lock_guard<std::mutex> lock(stats_mtx);
+                ++acc.overruns;
+            }
+            next = now;
+            poll_network(0);
+            continue;
+        }
+        // Serve input until the next tick is due
+        while (!stop.load(std::memory_order_relaxed)) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now()).count();
+            if (left <= 0) break;
+            poll_network((int)left);
+        }
+    }
+}
+
+ServerStats MatchServer::take_stats() {
+    ServerStats out;
+    {
+        std::lock_guard<std::mutex> lock(stats_mtx);
+        out = std::move(acc);
+        acc = ServerStats{};
+    }
+    out.deltas = deltas.exchange(0);
+    out.delta_bytes = delta_bytes.exchange(0);
+    out.keyframes = keyframes.exchange(0);
+    out.keyframe_bytes = keyframe_bytes.exchange(0);
+    out.send_drops = send_drops.exchange(0);
+    out.spectator_frames = spec_frames.exchange(0);
+    out.spectator_keyframes = spec_keyframes.exchange(0);
+    out.spectator_frame_bytes = spec_frame_bytes.exchange(0);
+    out.fanout_bytes = fan_bytes.exchange(0);
+    out.fanout_syscalls = fan_syscalls.exchange(0);
+    out.spectator_resyncs = resyncs.exchange(0);
+    return out;
+}
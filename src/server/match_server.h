@@ -0,0 +1,220 @@
+/**
+ * @file match_server.h
+ * @brief Headless server ticking many GameCore matches at a fixed rate
+ *
+ * The network thread (the caller of run()) drains UDP datagrams and TCP
+ * connections between ticks and applies the newest input per paddle.
+ * Each tick, matches are split into tasks of a few matches and executed
+ * by the TickScheduler; a task advances its matches, stores a quantized
+ * snapshot and sends every subscribed client a delta against the last
+ * snapshot that client acknowledged. Tasks that start after the tick
+ * deadline still simulate but skip the broadcast, so an overloaded
+ * server degrades to fewer snapshots instead of a slower game clock.
+ *
+ * Spectators do not get per-client deltas. A match with spectators
+ * encodes one chained delta (or keyframe) per tick into a shared,
+ * reference-counted frame; a second scheduler pass fans it out to all
+ * spectator connections with send()/writev() straight from that buffer.
+ * A spectator whose backlog grows past kSpectatorBacklog drops its
+ * queued frames and resumes at the next keyframe.
+ *
+ * Tasks of different matches run on different scheduler lanes, so a TCP
+ * connection is bound to one match and one role (player or spectator)
+ * by its first message; later messages for another match or role are
+ * dropped. Each socket therefore has a single writer and frames from two
+ * lanes never interleave in its stream.
+ */
+
+#pragma once
+
+#include "core/game_core.h"
+#include "server/protocol.h"
+#include "server/snapshot.h"
+#include "server/tick_scheduler.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <netinet/in.h>
+
+/**
+ * @brief Server configuration
+ */
+struct ServerConfig {
+    uint16_t port = kServerDefaultPort;  ///< UDP and TCP port (loopback only)
+    unsigned threads = 0;                ///< Tick workers incl. network thread (0 = all cores)
+    int hz = 60;                         ///< Fixed tick rate
+    size_t matches = 1000;               ///< Concurrent matches
+    size_t matches_per_task = 16;        ///< Scheduling granularity
+    GameMode mode = GameMode::Classic;   ///< Game mode of every match
+    size_t spectators_per_task = 256;    ///< Fan-out scheduling granularity
+};
+
+/// @brief Ticks between spectator keyframes (resync points for slow consumers)
+constexpr uint32_t kSpectatorKeyframeTicks = 60;
+
+/// @brief Unsent bytes after which a spectator skips to the next keyframe
+constexpr size_t kSpectatorBacklog = 32 * 1024;
+
+/**
+ * @brief Counters accumulated since start (or the last take_stats())
+ */
+struct ServerStats {
+    uint64_t ticks = 0;
+    uint64_t match_ticks = 0;      ///< Sum over ticks of matches advanced
+    uint64_t cpu_ns = 0;           ///< Worker CPU time spent in tick tasks
+    uint64_t steals = 0;
+    uint64_t late_tasks = 0;       ///< Tasks started after their deadline (broadcast skipped)
+    uint64_t overruns = 0;         ///< Ticks that finished after the next tick was due
+    uint64_t inputs = 0;           ///< Accepted input messages
+    uint64_t stale_inputs = 0;     ///< Inputs dropped as out of order or malformed
+    uint64_t rejected_tcp = 0;     ///< TCP messages for a match or role other than the connection's
+    uint64_t deltas = 0;           ///< Delta snapshots sent
+    uint64_t delta_bytes = 0;
+    uint64_t keyframes = 0;        ///< Keyframe snapshots sent
+    uint64_t keyframe_bytes = 0;
+    uint64_t send_drops = 0;       ///< Snapshots not sent (socket buffer full / TCP backlog)
+    std::vector<double> tick_ms;   ///< Wall time per tick (simulation + fan-out)
+
+    uint64_t spectators = 0;          ///< Subscribed spectators at the end of the interval
+    uint64_t spectator_ticks = 0;     ///< Sum over ticks of subscribed spectators
+    uint64_t spectator_frames = 0;    ///< Shared frames encoded (one per match and tick)
+    uint64_t spectator_keyframes = 0;
+    uint64_t spectator_frame_bytes = 0;
+    uint64_t fanout_bytes = 0;        ///< Bytes handed to spectator sockets
+    uint64_t fanout_syscalls = 0;     ///< send()/writev() calls
+    uint64_t fanout_cpu_ns = 0;       ///< Worker CPU time spent in the fan-out pass
+    uint64_t spectator_resyncs = 0;   ///< Spectators that fell behind and skipped to a keyframe
+};
+
+/**
+ * @brief Multi-match server bound to localhost
+ */
+class MatchServer {
+public:
+    explicit MatchServer(const ServerConfig &cfg);
+    ~MatchServer();
+    MatchServer(const MatchServer &) = delete;
+    MatchServer &operator=(const MatchServer &) = delete;
+
+    /**
+     * @brief Bind the UDP socket and TCP listener on 127.0.0.1
+     *
+     * @param err Receives a description on failure
+     * @return true on success
+     */
+    bool start(std::string &err);
+
+    /**
+     * @brief Tick at the configured rate until @p stop is set
+     *
+     * @param stop Set from another thread to return
+     */
+    void run(const std::atomic<bool> &stop);
+
+    /// @brief Return and reset accumulated statistics (thread-safe)
+    ServerStats take_stats();
+
+    /// @brief Number of worker lanes used by the tick scheduler
+    unsigned lanes() const { return sched.lanes(); }
+
+private:
+    struct ClientSlot {
+        bool active = false;
+        bool tcp = false;
+        sockaddr_in addr{};            ///< UDP peer
+        int fd = -1;                   ///< TCP connection
+        uint32_t last_seq = 0;
+        uint32_t ack_tick = 0;
+        float paddle_y = 0.0f;
+        bool has_input = false;
+        bool dead = false;             ///< TCP write failed; dropped between ticks
+        std::vector<uint8_t> out;      ///< Unsent TCP bytes (written by the tick worker only)
+    };
+
+    /// @brief Length-framed spectator message shared by every subscriber of a match
+    using SharedFrame = std::shared_ptr<const std::vector<uint8_t>>;
+
+    struct Match {
+        Match(const ServerConfig &cfg, uint32_t match_id);
+        uint32_t id;
+        GameCore core;
+        uint32_t tick = 0;
+        ClientSlot clients[2];
+        SnapshotHistory history;
+        std::vector<int32_t> fields;   ///< Scratch: current snapshot
+        std::vector<uint8_t> msg;      ///< Scratch: encoded message
+
+        size_t spectators = 0;         ///< Subscribed spectators (network thread)
+        bool spectator_joined = false; ///< Force a keyframe for new spectators
+        SharedFrame spec_frame;        ///< This tick's spectator frame (null when none)
+        uint32_t spec_base = 0;        ///< base_tick of spec_frame (0 = keyframe)
+    };
+
+    struct Spectator {
+        int fd = -1;
+        uint32_t match = 0;
+        uint32_t last_tick = 0;        ///< Tick of the newest frame queued or sent
+        bool waiting_keyframe = true;
+        bool dead = false;             ///< Write failed; removed between ticks
+        std::deque<SharedFrame> queue; ///< Frames not yet fully written
+        size_t offset = 0;             ///< Bytes of queue.front() already written
+        size_t queued_bytes = 0;
+    };
+
+    /// Match a TcpConn is not bound to yet
+    static constexpr uint32_t kNoMatch = UINT32_MAX;
+
+    struct TcpConn {
+        int fd = -1;
+        std::vector<uint8_t> in;
+        uint32_t match = kNoMatch;     ///< Bound by the first Input or Spectate (one writer per socket)
+        bool spectator = false;
+    };
+
+    void poll_network(int timeout_ms);
+    void drain_udp();
+    void accept_tcp();
+    bool read_tcp(TcpConn &c);
+    void drop_tcp(int fd);
+    void drop_dead_players();
+    void route_input(const uint8_t *data, size_t len, const sockaddr_in *from, int tcp_fd);
+    void route_tcp(const uint8_t *data, size_t len, TcpConn &c);
+    void add_spectator(int fd, uint32_t match);
+    void prune_spectators();
+
+    /// @brief Snapshot counters accumulated locally by one task
+    struct TaskCounters {
+        uint64_t deltas = 0, delta_bytes = 0, keyframes = 0, keyframe_bytes = 0, drops = 0;
+        uint64_t spec_frames = 0, spec_keyframes = 0, spec_frame_bytes = 0;
+        uint64_t fan_bytes = 0, fan_syscalls = 0, resyncs = 0;
+    };
+
+    void tick_task(size_t task, bool late);
+    void tick_match(Match &m, bool late, TaskCounters &tc);
+    void send_snapshot(Match &m, uint8_t side, TaskCounters &tc);
+    static bool flush_player(ClientSlot &c);
+    void encode_spectator_frame(Match &m, TaskCounters &tc);
+    void fanout_task(size_t task, bool late);
+    void feed_spectator(Spectator &s, const Match &m, TaskCounters &tc);
+    void flush_spectator(Spectator &s, TaskCounters &tc);
+    void resync_spectator(Spectator &s);
+    void add_counters(const TaskCounters &tc);
+
+    ServerConfig cfg;
+    TickScheduler sched;
+    std::vector<std::unique_ptr<Match>> matches;
+    std::vector<TcpConn> conns;
+    std::vector<Spectator> spectators;
+    int udp_fd = -1;
+    int listen_fd = -1;
+
+    std::atomic<uint64_t> deltas{0}, delta_bytes{0}, keyframes{0}, keyframe_bytes{0}, send_drops{0};
+    std::atomic<uint64_t> spec_frames{0}, spec_keyframes{0}, spec_frame_bytes{0};
+    std::atomic<uint64_t> fan_bytes{0}, fan_syscalls{0}, resyncs{0};
+    std::mutex stats_mtx;
+    ServerStats acc;   ///< Tick-level counters (guarded by stats_mtx)
+};
@@ -0,0 +1,46 @@
+/**
+ * @file protocol.cpp
+ * @brief Input message and TCP framing codecs
+ */
+
+#include "server/protocol.h"
+
+void encode_input(const InputMsg &msg, std::vector<uint8_t> &out) {
+    WireWriter w(out);
+    w.u8((uint8_t)MsgType::Input);
+    w.u32(msg.match_id);
+    w.u8(msg.side);
+    w.u32(msg.seq);
+    w.u32(msg.ack_tick);
+    w.f32(msg.paddle_y);
+}
+
+bool decode_input(const uint8_t *data, size_t len, InputMsg &msg) {
+    if (len != kInputMsgBytes || data[0] != (uint8_t)MsgType::Input) return false;
+    WireReader r(data + 1, len - 1);
+    msg.match_id = r.u32();
+    msg.side = r.u8();
+    msg.seq = r.u32();
+    msg.ack_tick = r.u32();
+    msg.paddle_y = r.f32();
+    return r.ok() && msg.side < 2;
+}
+
+void encode_spectate(uint32_t match_id, std::vector<uint8_t> &out) {
+    WireWriter w(out);
+    w.u8((uint8_t)MsgType::Spectate);
+    w.u32(match_id);
+}
+
+bool decode_spectate(const uint8_t *data, size_t len, uint32_t &match_id) {
+    if (len != kSpectateMsgBytes || data[0] != (uint8_t)MsgType::Spectate) return false;
+    WireReader r(data + 1, len - 1);
+    match_id = r.u32();
+    return r.ok();
+}
+
+void append_frame(const uint8_t *msg, size_t len, std::vector<uint8_t> &out) {
+    out.push_back((uint8_t)len);
+    out.push_back((uint8_t)(len >> 8));
+    out.insert(out.end(), msg, msg + len);
+}
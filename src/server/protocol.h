@@ -0,0 +1,179 @@
+/**
+ * @file protocol.h
+ * @brief Wire format shared by pong_server and its clients
+ *
+ * All integers are little-endian. Over UDP every datagram carries one
+ * message; over TCP messages are framed with a 16-bit length prefix.
+ *
+ * Input (client -> server), 18 bytes:
+ *   u8 type=Input | u32 match_id | u8 side | u32 seq | u32 ack_tick | f32 paddle_y
+ *
+ * Snapshot (server -> client):
+ *   u8 type=Snapshot | u32 match_id | u8 side | u32 tick | u32 base_tick |
+ *   u16 field_count | change mask (ceil(field_count/8) bytes) |
+ *   zigzag varint delta per changed field
+ *
+ * Spectate (client -> server, TCP only), 5 bytes:
+ *   u8 type=Spectate | u32 match_id
+ *
+ * base_tick == 0 marks a keyframe (deltas against zero). See snapshot.h
+ * for the field layout. Spectator streams carry side = kSpectatorSide and
+ * are chained: every delta is relative to the previous message on the
+ * same connection, so a consumer that falls behind is resynchronized at
+ * the next keyframe instead of being sent per-client deltas.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/// @brief Default UDP/TCP port of pong_server
+constexpr uint16_t kServerDefaultPort = 47800;
+
+/// @brief Largest message accepted on either transport
+constexpr size_t kMaxMessageBytes = 1400;
+
+/// @brief Message type tag (first byte of every message)
+enum class MsgType : uint8_t {
+    Input = 1,     ///< Paddle input + snapshot acknowledgement
+    Snapshot = 2,  ///< Full or delta-compressed match state
+    Spectate = 3   ///< Subscribe a TCP connection to a match's spectator stream
+};
+
+/// @brief SnapshotHeader::side of spectator stream messages
+constexpr uint8_t kSpectatorSide = 2;
+
+/// @brief Encoded size of a Spectate message
+constexpr size_t kSpectateMsgBytes = 5;
+
+/**
+ * @brief Client input for one paddle
+ *
+ * The first input from an address (UDP) or connection (TCP) subscribes
+ * it to snapshots of the match for that side.
+ */
+struct InputMsg {
+    uint32_t match_id = 0;
+    uint8_t side = 0;        ///< 0 = left paddle, 1 = right paddle
+    uint32_t seq = 0;        ///< Client sequence number (stale inputs dropped)
+    uint32_t ack_tick = 0;   ///< Newest snapshot tick the client decoded (0 = none)
+    float paddle_y = 0.0f;   ///< Requested paddle centre Y in game units
+};
+
+/// @brief Encoded size of an InputMsg
+constexpr size_t kInputMsgBytes = 18;
+
+/**
+ * @brief Snapshot message header
+ */
+struct SnapshotHeader {
+    uint32_t match_id = 0;
+    uint8_t side = 0;
+    uint32_t tick = 0;        ///< Server tick the state belongs to
+    uint32_t base_tick = 0;   ///< Tick the deltas are relative to (0 = keyframe)
+    uint16_t field_count = 0; ///< Number of quantized fields
+};
+
+/// @brief Encoded size of a SnapshotHeader including the type byte
+constexpr size_t kSnapshotHeaderBytes = 16;
+
+/**
+ * @brief Append-only little-endian writer
+ */
+class WireWriter {
+public:
+    explicit WireWriter(std::vector<uint8_t> &out) : buf(out) {}
+    void u8(uint8_t v) { buf.push_back(v); }
+    void u16(uint16_t v) { u8((uint8_t)v); u8((uint8_t)(v >> 8)); }
+    void u32(uint32_t v) { u16((uint16_t)v); u16((uint16_t)(v >> 16)); }
+    void u64(uint64_t v) { u32((uint32_t)v); u32((uint32_t)(v >> 32)); }
+    void f32(float v) { uint32_t u; std::memcpy(&u, &v, 4); u32(u); }
+    void varint(uint32_t v) {
+        while (v >= 0x80) { u8((uint8_t)(v | 0x80)); v >>= 7; }
+        u8((uint8_t)v);
+    }
+private:
+    std::vector<uint8_t> &buf;
+};
+
+/**
+ * @brief Bounds-checked little-endian reader
+ *
+ * Reads past the end return zero and clear ok(); callers check once at
+ * the end instead of after every field.
+ */
+class WireReader {
+public:
+    WireReader(const uint8_t *data, size_t len) : p(data), end(data + len) {}
+    uint8_t u8() { if (p >= end) { good = false; return 0; } return *p++; }
+    uint16_t u16() { uint16_t lo = u8(); return (uint16_t)(lo | (uint16_t)u8() << 8); }
+    uint32_t u32() { uint32_t lo = u16(); return lo | (uint32_t)u16() << 16; }
+    uint64_t u64() { uint64_t lo = u32(); return lo | (uint64_t)u32() << 32; }
+    float f32() { uint32_t u = u32(); float v; std::memcpy(&v, &u, 4); return v; }
+    uint32_t varint() {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t b = u8();
+            v |= (uint32_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        good = false;
+        return 0;
+    }
+    const uint8_t *cursor() const { return p; }
+    size_t remaining() const { return (size_t)(end - p); }
+    void skip(size_t n) { if (n > remaining()) { good = false; p = end; } else p += n; }
+    bool ok() const { return good; }
+private:
+    const uint8_t *p;
+    const uint8_t *end;
+    bool good = true;
+};
+
+/// @brief Map a signed delta to an unsigned varint-friendly value
+inline uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+
+/// @brief Inverse of zigzag()
+inline int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+/// @brief Append an encoded InputMsg
+void encode_input(const InputMsg &msg, std::vector<uint8_t> &out);
+
+/// @brief Parse an InputMsg (type byte included); false when malformed
+bool decode_input(const uint8_t *data, size_t len, InputMsg &msg);
+
+/// @brief Append an encoded Spectate message
+void encode_spectate(uint32_t match_id, std::vector<uint8_t> &out);
+
+/// @brief Parse a Spectate message; false when malformed
+bool decode_spectate(const uint8_t *data, size_t len, uint32_t &match_id);
+
+/// @brief Message type of a raw message, 0 when empty
+inline uint8_t message_type(const uint8_t *data, size_t len) { return len ? data[0] : 0; }
+
+/**
+ * @brief Split complete length-prefixed frames off a TCP receive buffer
+ *
+ * Calls fn(data, len) for every complete frame and erases the consumed
+ * bytes. Returns false when a frame header announces a message larger
+ * than @p max_len (the connection should be dropped).
+ */
+template <class F>
+bool drain_frames(std::vector<uint8_t> &in, F &&fn, size_t max_len = kMaxMessageBytes) {
+    size_t off = 0;
+    while (in.size() - off >= 2) {
+        size_t len = (size_t)in[off] | (size_t)in[off + 1] << 8;
+        if (len == 0 || len > max_len) return false;
+        if (in.size() - off - 2 < len) break;
+        fn(in.data() + off + 2, len);
+        off += 2 + len;
+    }
+    in.erase(in.begin(), in.begin() + (std::ptrdiff_t)off);
+    return true;
+}
+
+/// @brief Prefix a message with its 16-bit TCP frame length
+void append_frame(const uint8_t *msg, size_t len, std::vector<uint8_t> &out);
@@ -0,0 +1,232 @@
+/**
+ * @file server_main.cpp
+ * @brief Entry point of pong_server
+ *
+ * Usage:
+ *   pong_server [--matches N] [--threads N] [--hz N] [--seconds N]
+ *               [--players N] [--tcp-clients N] [--client-threads N]
+ *               [--port N] [--mode classic|three|obstacles|multiball|obstacles-multi]
+ *               [--spectators N] [--spectate-matches N] [--spectator-threads N]
+ *
+ * Hosts --matches matches on 127.0.0.1 and, unless --players 0, drives
+ * them with simulated clients (default: both paddles of every match).
+ * Prints one line per second and a summary with the tick time
+ * distribution, snapshot sizes and the derived matches per core at 60 Hz.
+ * With --spectators, that many TCP spectators follow the first
+ * --spectate-matches matches (default 1: one very popular match) and the
+ * summary adds the fan-out cost and spectators per core at 60 Hz.
+ * --seconds 0 runs until interrupted.
+ */
+
+#include "server/match_server.h"
+#include "server/sim_clients.h"
+#include "server/sim_spectators.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+static std::atomic<bool> g_stop{false};
+
+static void on_signal(int) { g_stop.store(true); }
+
+static long int_arg(int argc, char **argv, const char *name, long fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            char *end = nullptr;
+            long v = std::strtol(argv[i+1], &end, 10);
+            if (end && *end == '\0' && v >= 0) return v;
+        }
+    }
+    return fallback;
+}
+
+static const char *str_arg(int argc, char **argv, const char *name, const char *fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) return argv[i+1];
+    }
+    return fallback;
+}
+
+static bool parse_mode(const char *s, GameMode &out) {
+    static const struct { const char *name; GameMode mode; } kModes[] = {
+        { "classic", GameMode::Classic }, { "three", GameMode::ThreeEnemies },
+        { "obstacles", GameMode::Obstacles }, { "multiball", GameMode::MultiBall },
+        { "obstacles-multi", GameMode::ObstaclesMulti },
+    };
+    for (const auto &m : kModes) {
+        if (std::strcmp(s, m.name) == 0) { out = m.mode; return true; }
+    }
+    return false;
+}
+
+static double percentile(std::vector<double> &v, double p) {
+    if (v.empty()) return 0.0;
+    size_t k = (size_t)(p * (double)(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + (std::ptrdiff_t)k, v.end());
+    return v[k];
+}
+
+static void add_stats(ServerStats &into, ServerStats &s) {
+    into.ticks += s.ticks;
+    into.match_ticks += s.match_ticks;
+    into.cpu_ns += s.cpu_ns;
+    into.steals += s.steals;
+    into.late_tasks += s.late_tasks;
+    into.overruns += s.overruns;
+    into.inputs += s.inputs;
+    into.stale_inputs += s.stale_inputs;
+    into.rejected_tcp += s.rejected_tcp;
+    into.deltas += s.deltas;
+    into.delta_bytes += s.delta_bytes;
+    into.keyframes += s.keyframes;
+    into.keyframe_bytes += s.keyframe_bytes;
+    into.send_drops += s.send_drops;
+    into.spectators = s.spectators ? s.spectators : into.spectators;
+    into.spectator_ticks += s.spectator_ticks;
+    into.spectator_frames += s.spectator_frames;
+    into.spectator_keyframes += s.spectator_keyframes;
+    into.spectator_frame_bytes += s.spectator_frame_bytes;
+    into.fanout_bytes += s.fanout_bytes;
+    into.fanout_syscalls += s.fanout_syscalls;
+    into.fanout_cpu_ns += s.fanout_cpu_ns;
+    into.spectator_resyncs += s.spectator_resyncs;
+    into.tick_ms.insert(into.tick_ms.end(), s.tick_ms.begin(), s.tick_ms.end());
+}
+
+int main(int argc, char **argv) {
+    ServerConfig cfg;
+    cfg.matches = (size_t)int_arg(argc, argv, "--matches", 1000);
+    cfg.threads = (unsigned)int_arg(argc, argv, "--threads", 0);
+    cfg.hz = (int)int_arg(argc, argv, "--hz", 60);
+    cfg.port = (uint16_t)int_arg(argc, argv, "--port", kServerDefaultPort);
+    cfg.matches_per_task = (size_t)int_arg(argc, argv, "--matches-per-task", 16);
+    if (!parse_mode(str_arg(argc, argv, "--mode", "classic"), cfg.mode)) {
+        std::fprintf(stderr, "unknown --mode (classic|three|obstacles|multiball|obstacles-multi)\n");
+        return 2;
+    }
+    const long seconds = int_arg(argc, argv, "--seconds", 10);
+
+    SimConfig sim;
+    sim.port = cfg.port;
+    sim.hz = cfg.hz;
+    sim.players = std::min((size_t)int_arg(argc, argv, "--players", (long)(2 * cfg.matches)), 2 * cfg.matches);
+    sim.tcp_clients = (size_t)int_arg(argc, argv, "--tcp-clients", 8);
+    sim.threads = (unsigned)int_arg(argc, argv, "--client-threads", 1);
+
+    SpectatorConfig spec;
+    spec.port = cfg.port;
+    spec.spectators = (size_t)int_arg(argc, argv, "--spectators", 0);
+    spec.matches = std::min((size_t)int_arg(argc, argv, "--spectate-matches", 1), cfg.matches);
+    spec.threads = (unsigned)int_arg(argc, argv, "--spectator-threads", 1);
+
+    MatchServer server(cfg);
+    std::string err;
+    if (!server.start(err)) {
+        std::fprintf(stderr, "pong_server: %s\n", err.c_str());
+        return 1;
+    }
+    SimClients clients(sim);
+    if (sim.players && !clients.start(err)) {
+        std::fprintf(stderr, "pong_server: clients: %s\n", err.c_str());
+        return 1;
+    }
+    SimSpectators watchers(spec);
+    watchers.start();
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    std::printf("pong_server: %zu matches, %u lanes, %d Hz, %zu clients (%zu tcp) on 127.0.0.1:%u\n",
+                cfg.matches, server.lanes(), cfg.hz, sim.players, std::min(sim.tcp_clients, sim.players),
+                (unsigned)cfg.port);
+    std::printf("%4s %6s %8s %8s %6s %6s %8s %8s %9s %9s %7s %7s %9s %7s\n",
+                "sec", "ticks", "p50 ms", "max ms", "late", "overr", "inputs", "snaps", "B/delta", "B/key", "errors",
+                "specs", "fan MB/s", "resync");
+
+    // Reporter: the server loop owns the calling thread
+    ServerStats total;
+    SimStats client_total;
+    SpectatorStats watcher_total;
+    std::thread reporter([&] {
+        for (long sec = 1; !g_stop.load(); ++sec) {
+            for (int i = 0; i < 10 && !g_stop.load(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            ServerStats s = server.take_stats();
+            SimStats c = clients.take_stats();
+            SpectatorStats w = watchers.take_stats();
+            std::vector<double> ms = s.tick_ms;
+            double max_ms = ms.empty() ? 0.0 : *std::max_element(ms.begin(), ms.end());
+            std::printf("%4ld %6llu %8.3f %8.3f %6llu %6llu %8llu %8llu %9.1f %9.1f %7llu %7llu %9.2f %7llu\n", sec,
+                        (unsigned long long)s.ticks, percentile(ms, 0.5), max_ms,
+                        (unsigned long long)s.late_tasks, (unsigned long long)s.overruns,
+                        (unsigned long long)s.inputs, (unsigned long long)(s.deltas + s.keyframes),
+                        s.deltas ? (double)s.delta_bytes / (double)s.deltas : 0.0,
+                        s.keyframes ? (double)s.keyframe_bytes / (double)s.keyframes : 0.0,
+                        (unsigned long long)(c.decode_errors + w.decode_errors + w.gaps),
+                        (unsigned long long)s.spectators, (double)s.fanout_bytes / 1e6,
+                        (unsigned long long)s.spectator_resyncs);
+            std::fflush(stdout);
+            add_stats(total, s);
+            client_total.inputs += c.inputs;
+            client_total.keyframes += c.keyframes;
+            client_total.deltas += c.deltas;
+            client_total.bytes += c.bytes;
+            client_total.decode_errors += c.decode_errors;
+            watcher_total.connected += w.connected;
+            watcher_total.keyframes += w.keyframes;
+            watcher_total.deltas += w.deltas;
+            watcher_total.gaps += w.gaps;
+            watcher_total.decode_errors += w.decode_errors;
+            if (seconds > 0 && sec >= seconds) g_stop.store(true);
+        }
+    });
+    server.run(g_stop);
+    reporter.join();
+    clients.stop();
+    watchers.stop();
+    ServerStats rest = server.take_stats();
+    add_stats(total, rest);
+
+    std::vector<double> &ms = total.tick_ms;
+    const double max_ms = ms.empty() ? 0.0 : *std::max_element(ms.begin(), ms.end());
+    const double p50 = percentile(ms, 0.5), p99 = percentile(ms, 0.99);
+    const double ns_per_match = total.match_ticks ? (double)total.cpu_ns / (double)total.match_ticks : 0.0;
+    std::printf("\nsummary\n");
+    std::printf("  ticks            %llu (overruns %llu, late tasks %llu, steals %llu)\n",
+                (unsigned long long)total.ticks, (unsigned long long)total.overruns,
+                (unsigned long long)total.late_tasks, (unsigned long long)total.steals);
+    std::printf("  tick wall ms     p50 %.3f  p99 %.3f  max %.3f  (budget %.3f)\n", p50, p99, max_ms, 1000.0 / cfg.hz);
+    std::printf("  inputs           %llu accepted, %llu stale, %llu rejected (TCP bound to another match or role)\n",
+                (unsigned long long)total.inputs, (unsigned long long)total.stale_inputs,
+                (unsigned long long)total.rejected_tcp);
+    std::printf("  snapshots        %llu deltas (%.1f B avg), %llu keyframes (%.1f B avg), %llu dropped\n",
+                (unsigned long long)total.deltas,
+                total.deltas ? (double)total.delta_bytes / (double)total.deltas : 0.0,
+                (unsigned long long)total.keyframes,
+                total.keyframes ? (double)total.keyframe_bytes / (double)total.keyframes : 0.0,
+                (unsigned long long)total.send_drops);
+    std::printf("  clients          %llu deltas, %llu keyframes decoded, %llu errors\n",
+                (unsigned long long)client_total.deltas, (unsigned long long)client_total.keyframes,
+                (unsigned long long)client_total.decode_errors);
+    std::printf("  cpu/match-tick   %.0f ns (simulation + snapshot + send)\n", ns_per_match);
+    if (ns_per_match > 0.0)
+        std::printf("  matches/core     %.0f @ 60 Hz\n", 1e9 / (60.0 * ns_per_match));
+    if (spec.spectators) {
+        const double ns_per_spectator = total.spectator_ticks ? (double)total.fanout_cpu_ns / (double)total.spectator_ticks : 0.0;
+        std::printf("  spectators       %llu subscribed, %llu shared frames (%llu keyframes, %.1f B avg)\n",
+                    (unsigned long long)total.spectators, (unsigned long long)total.spectator_frames,
+                    (unsigned long long)total.spectator_keyframes,
+                    total.spectator_frames ? (double)total.spectator_frame_bytes / (double)total.spectator_frames : 0.0);
+        std::printf("  fan-out          %.1f MB in %llu syscalls, %llu resyncs; received %llu deltas, %llu keyframes, %llu gaps, %llu errors\n",
+                    (double)total.fanout_bytes / 1e6, (unsigned long long)total.fanout_syscalls,
+                    (unsigned long long)total.spectator_resyncs, (unsigned long long)watcher_total.deltas,
+                    (unsigned long long)watcher_total.keyframes, (unsigned long long)watcher_total.gaps,
+                    (unsigned long long)watcher_total.decode_errors);
+        std::printf("  cpu/spectator    %.0f ns per tick\n", ns_per_spectator);
+        if (ns_per_spectator > 0.0)
+            std::printf("  spectators/core  %.0f @ 60 Hz\n", 1e9 / (60.0 * ns_per_spectator));
+    }
+    return 0;
+}
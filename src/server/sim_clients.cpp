@@ -0,0 +1,206 @@
+/**
+ * @file sim_clients.cpp
+ * @brief Implementation of the simulated loopback clients
+ */
+
+#include "server/sim_clients.h"
+#include "server/snapshot.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+/// Snapshots a client keeps as potential delta bases (the server only
+/// deltas against the acknowledged tick, which is at most a few ticks old)
+constexpr size_t kClientHistory = 16;
+
+sockaddr_in server_addr(uint16_t port) {
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return a;
+}
+
+} // namespace
+
+struct SimClients::Client {
+    uint32_t match_id = 0;
+    uint8_t side = 0;
+    uint32_t seq = 0;
+    uint32_t ack_tick = 0;
+    float target_y = 0.0f;
+    int fd = -1;                             ///< Own TCP connection, -1 for UDP
+    std::vector<uint8_t> in;                 ///< TCP receive buffer
+    uint32_t seen_tick[kClientHistory] = {};
+    std::vector<int32_t> seen[kClientHistory];
+};
+
+struct SimClients::Group {
+    int udp_fd = -1;
+    size_t first = 0;                        ///< Global index of clients[0]
+    std::vector<Client> clients;
+};
+
+SimClients::SimClients(const SimConfig &c) : cfg(c) {
+    if (cfg.hz <= 0) cfg.hz = 60;
+    if (cfg.threads == 0) cfg.threads = 1;
+}
+
+SimClients::~SimClients() {
+    stop();
+    for (Group *g : groups) {
+        for (Client &c : g->clients) if (c.fd >= 0) close(c.fd);
+        if (g->udp_fd >= 0) close(g->udp_fd);
+        delete g;
+    }
+}
+
+bool SimClients::start(std::string &err) {
+    const sockaddr_in addr = server_addr(cfg.port);
+    const size_t per = (cfg.players + cfg.threads - 1) / cfg.threads;
+    for (size_t first = 0; first < cfg.players; first += per) {
+        Group *g = new Group();
+        groups.push_back(g);
+        g->first = first;
+        g->udp_fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (g->udp_fd < 0) { err = std::string("udp socket: ") + std::strerror(errno); return false; }
+        int buf = 8 << 20;
+        setsockopt(g->udp_fd, SOL_SOCKET, SO_RCVBUF, &buf, sizeof(buf));
+        setsockopt(g->udp_fd, SOL_SOCKET, SO_SNDBUF, &buf, sizeof(buf));
+        fcntl(g->udp_fd, F_SETFL, fcntl(g->udp_fd, F_GETFL, 0) | O_NONBLOCK);
+
+        const size_t end = std::min(cfg.players, first + per);
+        g->clients.resize(end - first);
+        for (size_t i = first; i < end; ++i) {
+            Client &c = g->clients[i - first];
+            c.match_id = (uint32_t)(i / 2);
+            c.side = (uint8_t)(i % 2);
+            if (i >= cfg.tcp_clients) continue;
+            c.fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (c.fd < 0 || connect(c.fd, (const sockaddr *)&addr, sizeof(addr)) != 0) {
+                err = std::string("tcp connect: ") + std::strerror(errno);
+                return false;
+            }
+            int one = 1;
+            setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            fcntl(c.fd, F_SETFL, fcntl(c.fd, F_GETFL, 0) | O_NONBLOCK);
+        }
+    }
+    for (Group *g : groups) threads.emplace_back([this, g] { thread_loop(*g); });
+    return true;
+}
+
+void SimClients::stop() {
+    stopping.store(true);
+    for (auto &t : threads) t.join();
+    threads.clear();
+}
+
+SimStats SimClients::take_stats() {
+    SimStats s;
+    s.inputs = inputs.exchange(0);
+    s.keyframes = keyframes.exchange(0);
+    s.deltas = deltas.exchange(0);
+    s.bytes = bytes.exchange(0);
+    s.decode_errors = decode_errors.exchange(0);
+    return s;
+}
+
+void SimClients::thread_loop(Group &g) {
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / cfg.hz));
+    const sockaddr_in addr = server_addr(cfg.port);
+    SimStats local;
+    std::vector<uint8_t> msg;
+    std::vector<int32_t> fields;
+
+    auto on_snapshot = [&](const uint8_t *data, size_t len) {
+        SnapshotHeader hdr;
+        if (!decode_snapshot_header(data, len, hdr)) { ++local.decode_errors; return; }
+        const size_t idx = (size_t)hdr.match_id * 2 + hdr.side;
+        if (idx < g.first || idx - g.first >= g.clients.size()) { ++local.decode_errors; return; }
+        Client &c = g.clients[idx - g.first];
+        const std::vector<int32_t> *base = nullptr;
+        if (hdr.base_tick) {
+            const size_t slot = hdr.base_tick % kClientHistory;
+            if (c.seen_tick[slot] == hdr.base_tick) base = &c.seen[slot];
+        }
+        if (!decode_snapshot(data, len, hdr, base, fields)) { ++local.decode_errors; return; }
+        local.bytes += len;
+        ++(hdr.base_tick ? local.deltas : local.keyframes);
+        if (hdr.tick <= c.ack_tick) return;   // reordered datagram
+        const size_t slot = hdr.tick % kClientHistory;
+        c.seen_tick[slot] = hdr.tick;
+        c.seen[slot] = fields;
+        c.ack_tick = hdr.tick;
+        if (fields.size() > kSnapshotFixedFields + 1 && fields[8] > 0)
+            c.target_y = (float)(fields[kSnapshotFixedFields + 1] / kSnapshotScale);
+    };
+
+    std::vector<pollfd> fds;
+    auto next = Clock::now();
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (Clock::now() >= next) {
+            next += period;
+            for (Client &c : g.clients) {
+                InputMsg in;
+                in.match_id = c.match_id;
+                in.side = c.side;
+                in.seq = ++c.seq;
+                in.ack_tick = c.ack_tick;
+                in.paddle_y = c.target_y;
+                msg.clear();
+                if (c.fd >= 0) {
+                    std::vector<uint8_t> body;
+                    encode_input(in, body);
+                    append_frame(body.data(), body.size(), msg);
+                    if (send(c.fd, msg.data(), msg.size(), MSG_NOSIGNAL) < 0) continue;
+                } else {
+                    encode_input(in, msg);
+                    if (sendto(g.udp_fd, msg.data(), msg.size(), 0, (const sockaddr *)&addr, sizeof(addr)) < 0) continue;
+                }
+                ++local.inputs;
+            }
+        }
+
+        fds.clear();
+        fds.push_back({ g.udp_fd, POLLIN, 0 });
+        for (const Client &c : g.clients) if (c.fd >= 0) fds.push_back({ c.fd, POLLIN, 0 });
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now()).count();
+        if (poll(fds.data(), (nfds_t)fds.size(), wait > 0 ? (int)wait : 0) > 0) {
+            uint8_t buf[kMaxMessageBytes];
+            if (fds[0].revents & POLLIN) {
+                ssize_t n;
+                while ((n = recv(g.udp_fd, buf, sizeof(buf), 0)) > 0) on_snapshot(buf, (size_t)n);
+            }
+            size_t k = 1;
+            for (Client &c : g.clients) {
+                if (c.fd < 0) continue;
+                if (!(fds[k++].revents & POLLIN)) continue;
+                uint8_t tbuf[16384];
+                ssize_t n;
+                while ((n = recv(c.fd, tbuf, sizeof(tbuf), 0)) > 0) {
+                    c.in.insert(c.in.end(), tbuf, tbuf + n);
+                    if (!drain_frames(c.in, on_snapshot)) { ++local.decode_errors; c.in.clear(); }
+                }
+            }
+        }
+
+        inputs.fetch_add(local.inputs);
+        keyframes.fetch_add(local.keyframes);
+        deltas.fetch_add(local.deltas);
+        bytes.fetch_add(local.bytes);
+        decode_errors.fetch_add(local.decode_errors);
+        local = SimStats{};
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file sim_clients.h
+ * @brief Simulated players driving pong_server over loopback
+ *
+ * Each client owns one paddle (match_id = index / 2, side = index % 2),
+ * sends an input every tick that tracks the first ball and acknowledges
+ * the newest snapshot it decoded, and reconstructs snapshots from the
+ * deltas it receives. UDP clients of one thread share a socket and are
+ * demultiplexed by the snapshot header; the first tcp_clients clients
+ * each hold their own TCP connection instead.
+ */
+
+#pragma once
+
+#include "server/protocol.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Load generator configuration
+ */
+struct SimConfig {
+    uint16_t port = kServerDefaultPort;
+    int hz = 60;               ///< Input rate
+    size_t players = 0;        ///< Number of clients (at most two per match)
+    size_t tcp_clients = 0;    ///< Clients using TCP instead of UDP
+    unsigned threads = 1;      ///< Client threads
+};
+
+/**
+ * @brief Client-side counters since start (or the last take_stats())
+ */
+struct SimStats {
+    uint64_t inputs = 0;          ///< Input messages sent
+    uint64_t keyframes = 0;       ///< Keyframe snapshots decoded
+    uint64_t deltas = 0;          ///< Delta snapshots decoded
+    uint64_t bytes = 0;           ///< Snapshot bytes received
+    uint64_t decode_errors = 0;   ///< Malformed snapshots or unknown delta bases
+};
+
+/**
+ * @brief Pool of simulated clients
+ */
+class SimClients {
+public:
+    explicit SimClients(const SimConfig &cfg);
+    ~SimClients();
+    SimClients(const SimClients &) = delete;
+    SimClients &operator=(const SimClients &) = delete;
+
+    /**
+     * @brief Open sockets and start the client threads
+     *
+     * @param err Receives a description on failure
+     * @return true on success
+     */
+    bool start(std::string &err);
+
+    /// @brief Stop and join the client threads
+    void stop();
+
+    /// @brief Return and reset the counters (thread-safe)
+    SimStats take_stats();
+
+private:
+    struct Client;
+    struct Group;
+
+    void thread_loop(Group &g);
+
+    SimConfig cfg;
+    std::vector<Group *> groups;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> inputs{0}, keyframes{0}, deltas{0}, bytes{0}, decode_errors{0};
+};
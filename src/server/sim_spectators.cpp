@@ -0,0 +1,131 @@
+/**
+ * @file sim_spectators.cpp
+ * @brief Implementation of the simulated spectators
+ */
+
+#include "server/sim_spectators.h"
+#include "server/snapshot.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+struct Watcher {
+    int fd = -1;
+    uint32_t last_tick = 0;
+    std::vector<uint8_t> in;
+    std::vector<int32_t> fields;
+};
+
+} // namespace
+
+SimSpectators::SimSpectators(const SpectatorConfig &c) : cfg(c) {
+    if (cfg.threads == 0) cfg.threads = 1;
+    if (cfg.matches == 0) cfg.matches = 1;
+}
+
+SimSpectators::~SimSpectators() { stop(); }
+
+void SimSpectators::start() {
+    const size_t per = (cfg.spectators + cfg.threads - 1) / cfg.threads;
+    for (size_t first = 0; first < cfg.spectators; first += per) {
+        const size_t count = std::min(per, cfg.spectators - first);
+        threads.emplace_back([this, first, count] { thread_loop(first, count); });
+    }
+}
+
+void SimSpectators::stop() {
+    stopping.store(true);
+    for (auto &t : threads) t.join();
+    threads.clear();
+}
+
+SpectatorStats SimSpectators::take_stats() {
+    SpectatorStats s;
+    s.connected = connected.exchange(0);
+    s.keyframes = keyframes.exchange(0);
+    s.deltas = deltas.exchange(0);
+    s.bytes = bytes.exchange(0);
+    s.gaps = gaps.exchange(0);
+    s.decode_errors = decode_errors.exchange(0);
+    return s;
+}
+
+void SimSpectators::thread_loop(size_t first, size_t count) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(cfg.port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    // Non-blocking connects: a burst larger than the listen backlog only
+    // slows the ramp-up and never blocks stop()
+    std::vector<Watcher> ws(count);
+    std::vector<uint8_t> msg, body;
+    for (size_t i = 0; i < count && !stopping.load(); ++i) {
+        Watcher &w = ws[i];
+        w.fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (w.fd < 0) { decode_errors.fetch_add(1); continue; }
+        fcntl(w.fd, F_SETFL, fcntl(w.fd, F_GETFL, 0) | O_NONBLOCK);
+        bool up = connect(w.fd, (const sockaddr *)&addr, sizeof(addr)) == 0;
+        if (!up && errno == EINPROGRESS) {
+            pollfd p{ w.fd, POLLOUT, 0 };
+            while (!stopping.load() && poll(&p, 1, 100) == 0) {}
+            int soerr = 0;
+            socklen_t sl = sizeof(soerr);
+            up = (p.revents & POLLOUT) && getsockopt(w.fd, SOL_SOCKET, SO_ERROR, &soerr, &sl) == 0 && soerr == 0;
+        }
+        body.clear();
+        msg.clear();
+        encode_spectate((uint32_t)((first + i) % cfg.matches), body);
+        append_frame(body.data(), body.size(), msg);
+        if (!up || send(w.fd, msg.data(), msg.size(), MSG_NOSIGNAL) != (ssize_t)msg.size()) {
+            if (!stopping.load()) decode_errors.fetch_add(1);
+            close(w.fd);
+            w.fd = -1;
+            continue;
+        }
+        connected.fetch_add(1);
+    }
+
+    SpectatorStats local;
+    std::vector<pollfd> fds;
+    std::vector<int32_t> next;
+    uint8_t buf[65536];
+    while (!stopping.load(std::memory_order_relaxed)) {
+        fds.clear();
+        for (const Watcher &w : ws) fds.push_back({ w.fd, POLLIN, 0 });
+        if (poll(fds.data(), (nfds_t)fds.size(), 50) <= 0) continue;
+        for (size_t i = 0; i < ws.size(); ++i) {
+            if (!(fds[i].revents & POLLIN)) continue;
+            Watcher &w = ws[i];
+            ssize_t n;
+            while ((n = recv(w.fd, buf, sizeof(buf), 0)) > 0) {
+                local.bytes += (uint64_t)n;
+                w.in.insert(w.in.end(), buf, buf + n);
+                bool ok = drain_frames(w.in, [&](const uint8_t *data, size_t len) {
+                    SnapshotHeader hdr;
+                    if (!decode_snapshot_header(data, len, hdr) || hdr.side != kSpectatorSide) { ++local.decode_errors; return; }
+                    if (hdr.base_tick != 0 && hdr.base_tick != w.last_tick) { ++local.gaps; return; }
+                    if (!decode_snapshot(data, len, hdr, &w.fields, next)) { ++local.decode_errors; return; }
+                    w.fields.swap(next);
+                    w.last_tick = hdr.tick;
+                    ++(hdr.base_tick ? local.deltas : local.keyframes);
+                });
+                if (!ok) { ++local.decode_errors; w.in.clear(); }
+            }
+        }
+        keyframes.fetch_add(local.keyframes);
+        deltas.fetch_add(local.deltas);
+        bytes.fetch_add(local.bytes);
+        gaps.fetch_add(local.gaps);
+        decode_errors.fetch_add(local.decode_errors);
+        local = SpectatorStats{};
+    }
+    for (Watcher &w : ws) if (w.fd >= 0) close(w.fd);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file sim_spectators.h
+ * @brief Simulated spectators loading pong_server's fan-out path
+ *
+ * Each spectator opens its own TCP connection, subscribes to one of the
+ * first `matches` matches (round robin) and follows the chained stream:
+ * keyframes replace its state, deltas must apply on top of the previous
+ * message. A delta that does not chain (should never happen, the server
+ * resyncs slow consumers at keyframes) counts as a gap.
+ */
+
+#pragma once
+
+#include "server/protocol.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Spectator load configuration
+ */
+struct SpectatorConfig {
+    uint16_t port = kServerDefaultPort;
+    size_t spectators = 0;     ///< Connections to open
+    size_t matches = 1;        ///< Spread over match ids [0, matches)
+    unsigned threads = 1;      ///< Client threads
+};
+
+/**
+ * @brief Spectator-side counters since start (or the last take_stats())
+ */
+struct SpectatorStats {
+    uint64_t connected = 0;       ///< Subscriptions sent
+    uint64_t keyframes = 0;
+    uint64_t deltas = 0;
+    uint64_t bytes = 0;           ///< Stream bytes received
+    uint64_t gaps = 0;            ///< Deltas whose base was not the previous message
+    uint64_t decode_errors = 0;
+};
+
+/**
+ * @brief Pool of simulated spectator connections
+ */
+class SimSpectators {
+public:
+    explicit SimSpectators(const SpectatorConfig &cfg);
+    ~SimSpectators();
+    SimSpectators(const SimSpectators &) = delete;
+    SimSpectators &operator=(const SimSpectators &) = delete;
+
+    /// @brief Start the client threads (connections are opened by the threads)
+    void start();
+
+    /// @brief Stop and join the client threads
+    void stop();
+
+    /// @brief Return and reset the counters (thread-safe)
+    SpectatorStats take_stats();
+
+private:
+    void thread_loop(size_t first, size_t count);
+
+    SpectatorConfig cfg;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> connected{0}, keyframes{0}, deltas{0}, bytes{0}, gaps{0}, decode_errors{0};
+};
@@ -0,0 +1,105 @@
+/**
+ * @file snapshot.cpp
+ * @brief Snapshot quantization and delta encoding
+ */
+
+#include "server/snapshot.h"
+#include <cmath>
+
+static int32_t quantize(double v) { return (int32_t)std::lround(v * kSnapshotScale); }
+
+void snapshot_fields(const GameState &gs, std::vector<int32_t> &out) {
+    const Archetype &balls = gs.entities.balls();
+    const Archetype &obs = gs.entities.obstacles();
+    const Archetype &holes = gs.entities.blackholes();
+    out.clear();
+    out.reserve(kSnapshotFixedFields + 2 * (balls.size() + obs.size() + holes.size()));
+    out.push_back(gs.score_left);
+    out.push_back(gs.score_right);
+    out.push_back((int32_t)gs.mode);
+    out.push_back(gs.paddle_h);
+    out.push_back(quantize(gs.left_y));
+    out.push_back(quantize(gs.right_y));
+    out.push_back(quantize(gs.top_x));
+    out.push_back(quantize(gs.bottom_x));
+    out.push_back((int32_t)balls.size());
+    out.push_back((int32_t)obs.size());
+    out.push_back((int32_t)holes.size());
+    for (const Archetype *a : { &balls, &obs, &holes }) {
+        for (size_t i = 0; i < a->size(); ++i) {
+            out.push_back(quantize(a->position[i].x));
+            out.push_back(quantize(a->position[i].y));
+        }
+    }
+}
+
+bool encode_snapshot(SnapshotHeader hdr, const std::vector<int32_t> &cur,
+                     const std::vector<int32_t> *base, std::vector<uint8_t> &out) {
+    // Entity counts changed (mode switch, spawned balls): deltas would be misaligned
+    if (!base || base->size() != cur.size() || hdr.base_tick == 0) {
+        base = nullptr;
+        hdr.base_tick = 0;
+    }
+    hdr.field_count = (uint16_t)cur.size();
+
+    WireWriter w(out);
+    w.u8((uint8_t)MsgType::Snapshot);
+    w.u32(hdr.match_id);
+    w.u8(hdr.side);
+    w.u32(hdr.tick);
+    w.u32(hdr.base_tick);
+    w.u16(hdr.field_count);
+
+    const size_t mask_at = out.size();
+    out.resize(mask_at + (cur.size() + 7) / 8, 0);
+    for (size_t i = 0; i < cur.size(); ++i) {
+        int32_t d = cur[i] - (base ? (*base)[i] : 0);
+        if (d == 0) continue;
+        out[mask_at + i / 8] |= (uint8_t)(1u << (i % 8));
+        w.varint(zigzag(d));
+    }
+    return base != nullptr;
+}
+
+bool decode_snapshot_header(const uint8_t *data, size_t len, SnapshotHeader &hdr) {
+    if (len < kSnapshotHeaderBytes || data[0] != (uint8_t)MsgType::Snapshot) return false;
+    WireReader r(data + 1, len - 1);
+    hdr.match_id = r.u32();
+    hdr.side = r.u8();
+    hdr.tick = r.u32();
+    hdr.base_tick = r.u32();
+    hdr.field_count = r.u16();
+    return r.ok();
+}
+
+bool decode_snapshot(const uint8_t *data, size_t len, const SnapshotHeader &hdr,
+                     const std::vector<int32_t> *base, std::vector<int32_t> &out) {
+    if (hdr.base_tick != 0 && (!base || base->size() != hdr.field_count)) return false;
+    WireReader r(data + kSnapshotHeaderBytes, len - kSnapshotHeaderBytes);
+    const size_t mask_bytes = ((size_t)hdr.field_count + 7) / 8;
+    const uint8_t *mask = r.cursor();
+    r.skip(mask_bytes);
+    if (!r.ok()) return false;
+    out.resize(hdr.field_count);
+    for (size_t i = 0; i < hdr.field_count; ++i) {
+        int32_t v = hdr.base_tick ? (*base)[i] : 0;
+        if (mask[i / 8] & (1u << (i % 8))) v += unzigzag(r.varint());
+        out[i] = v;
+    }
+    return r.ok() && r.remaining() == 0;
+}
+
+void SnapshotHistory::push(uint32_t tick, const std::vector<int32_t> &fields) {
+    Entry &e = ring[tick % kDepth];
+    e.tick = tick;
+    e.fields = fields;
+    newest = tick;
+}
+
+const std::vector<int32_t> *SnapshotHistory::find(uint32_t tick) const {
+    if (tick == 0) return nullptr;
+    const Entry &e = ring[tick % kDepth];
+    return e.tick == tick ? &e.fields : nullptr;
+}
+
+const std::vector<int32_t> *SnapshotHistory::latest() const { return find(newest); }
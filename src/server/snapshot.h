@@ -0,0 +1,89 @@
+/**
+ * @file snapshot.h
+ * @brief Quantized match snapshots and their delta codec
+ *
+ * A snapshot is a flat vector of int32 fields so deltas are a plain
+ * element-wise difference. Layout:
+ *
+ *   [0] score_left   [1] score_right  [2] mode       [3] paddle_h
+ *   [4] left_y       [5] right_y      [6] top_x      [7] bottom_x
+ *   [8] ball count   [9] obstacle count              [10] black hole count
+ *   then x,y pairs for balls, obstacles and black holes
+ *
+ * Positions are fixed point with kSnapshotScale steps per game unit.
+ * Only changed fields are transmitted in a delta; a match at rest costs
+ * the header plus the change mask.
+ */
+
+#pragma once
+
+#include "core/game_core.h"
+#include "server/protocol.h"
+#include <cstdint>
+#include <vector>
+
+/// @brief Fixed-point steps per game unit
+constexpr double kSnapshotScale = 64.0;
+
+/// @brief Index of the first per-entity field
+constexpr size_t kSnapshotFixedFields = 11;
+
+/// @brief Quantize the renderable state of a match
+void snapshot_fields(const GameState &gs, std::vector<int32_t> &out);
+
+/**
+ * @brief Encode a snapshot message
+ *
+ * @param hdr Header (base_tick is forced to 0 when no usable base is given)
+ * @param cur Current fields
+ * @param base Fields of hdr.base_tick as acknowledged by the client, or nullptr
+ * @param out Destination (appended)
+ * @return true when encoded as a delta, false for a keyframe
+ */
+bool encode_snapshot(SnapshotHeader hdr, const std::vector<int32_t> &cur,
+                     const std::vector<int32_t> *base, std::vector<uint8_t> &out);
+
+/**
+ * @brief Parse the header of a snapshot message
+ *
+ * @return false when the message is not a well-formed snapshot header
+ */
+bool decode_snapshot_header(const uint8_t *data, size_t len, SnapshotHeader &hdr);
+
+/**
+ * @brief Reconstruct snapshot fields
+ *
+ * @param data Whole message (header included)
+ * @param len Message length
+ * @param hdr Header returned by decode_snapshot_header()
+ * @param base Fields for hdr.base_tick (ignored for keyframes)
+ * @param out Reconstructed fields
+ * @return false when the payload is malformed or the base does not match
+ */
+bool decode_snapshot(const uint8_t *data, size_t len, const SnapshotHeader &hdr,
+                     const std::vector<int32_t> *base, std::vector<int32_t> &out);
+
+/**
+ * @brief Last few snapshots of a match, kept as delta bases
+ */
+class SnapshotHistory {
+public:
+    static constexpr size_t kDepth = 32;  ///< Ticks a client may lag behind before falling back to keyframes
+
+    /// @brief Store the fields for a tick (overwrites the oldest entry)
+    void push(uint32_t tick, const std::vector<int32_t> &fields);
+
+    /// @brief Fields stored for @p tick, or nullptr when evicted / never stored
+    const std::vector<int32_t> *find(uint32_t tick) const;
+
+    /// @brief Fields of the most recent push(), or nullptr when empty
+    const std::vector<int32_t> *latest() const;
+
+    /// @brief Tick of the most recent push() (0 when empty)
+    uint32_t latest_tick() const { return newest; }
+
+private:
+    struct Entry { uint32_t tick = 0; std::vector<int32_t> fields; };
+    Entry ring[kDepth];
+    uint32_t newest = 0;
+};
@@ -0,0 +1,136 @@
+/**
+ * @file tick_scheduler.cpp
+ * @brief Implementation of the work-stealing tick scheduler
+ */
+
+#include "server/tick_scheduler.h"
+#include <time.h>
+
+TickScheduler::TickScheduler(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (unsigned i = 0; i < threads; ++i) lanes_.push_back(std::make_unique<Lane>());
+    for (unsigned i = 1; i < threads; ++i) workers.emplace_back([this, i] { worker_loop(i); });
+}
+
+TickScheduler::~TickScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    start_cv.notify_all();
+    for (auto &t : workers) t.join();
+}
+
+uint64_t TickScheduler::thread_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+bool TickScheduler::pop_own(unsigned lane, uint32_t &task) {
+    Lane &l = *lanes_[lane];
+    std::lock_guard<std::mutex> lock(l.mtx);
+    if (l.head == l.tasks.size()) return false;
+    task = l.tasks.back();
+    l.tasks.pop_back();
+    return true;
+}
+
+bool TickScheduler::steal(unsigned thief, uint32_t &task) {
+    const unsigned n = (unsigned)lanes_.size();
+    for (unsigned k = 1; k < n; ++k) {
+        Lane &l = *lanes_[(thief + k) % n];
+        std::lock_guard<std::mutex> lock(l.mtx);
+        if (l.head == l.tasks.size()) continue;
+        task = l.tasks[l.head++];
+        return true;
+    }
+    return false;
+}
+
+void TickScheduler::work(unsigned lane) {
+    const uint64_t cpu0 = thread_cpu_ns();
+    size_t done = 0;
+    uint32_t task;
+    for (;;) {
+        bool stolen = false;
+        if (!pop_own(lane, task)) {
+            if (!steal(lane, task)) break;
+            stolen = true;
+        }
+        bool is_late = Clock::now() > tick_deadline;
+        (*task_fn)(task, is_late);
+        if (stolen) steals.fetch_add(1, std::memory_order_relaxed);
+        if (is_late) late.fetch_add(1, std::memory_order_relaxed);
+        ++done;
+    }
+    cpu_ns.fetch_add(thread_cpu_ns() - cpu0, std::memory_order_relaxed);
+    if (done) {
+        std::lock_guard<std::mutex> lock(mtx);
+        pending -= done;
+        if (pending == 0) done_cv.notify_all();
+    }
+}
+
+void TickScheduler::worker_loop(unsigned lane) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            // Only join a tick while it is open: a worker waking after the tick
+            // completed must not touch lanes that run() is refilling
+            start_cv.wait(lock, [&] { return stopping || (open && epoch != seen); });
+            if (stopping) return;
+            seen = epoch;
+            ++active;
+        }
+        work(lane);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (--active == 0 && pending == 0) done_cv.notify_all();
+        }
+    }
+}
+
+TickScheduler::TickStats TickScheduler::run(size_t task_count, const TaskFn &fn, Clock::time_point deadline) {
+    TickStats st;
+    if (task_count == 0) return st;
+    const auto t0 = Clock::now();
+
+    // Contiguous blocks per lane; owners pop from the back, thieves take from the front
+    const size_t n = lanes_.size();
+    for (size_t i = 0; i < n; ++i) {
+        Lane &l = *lanes_[i];
+        std::lock_guard<std::mutex> lock(l.mtx);
+        l.tasks.clear();
+        l.head = 0;
+        size_t begin = task_count * i / n, end = task_count * (i + 1) / n;
+        for (size_t t = begin; t < end; ++t) l.tasks.push_back((uint32_t)t);
+    }
+    cpu_ns.store(0, std::memory_order_relaxed);
+    steals.store(0, std::memory_order_relaxed);
+    late.store(0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        task_fn = &fn;
+        tick_deadline = deadline;
+        pending = task_count;
+        ++epoch;
+        open = true;
+    }
+    start_cv.notify_all();
+
+    work(0);
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        done_cv.wait(lock, [&] { return pending == 0 && active == 0; });
+        open = false;
+    }
+
+    st.wall_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    st.cpu_ns = cpu_ns.load(std::memory_order_relaxed);
+    st.steals = steals.load(std::memory_order_relaxed);
+    st.late = late.load(std::memory_order_relaxed);
+    return st;
+}
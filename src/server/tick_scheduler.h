@@ -0,0 +1,99 @@
+/**
+ * @file tick_scheduler.h
+ * @brief Work-stealing scheduler that runs one server tick across cores
+ *
+ * Every tick the task range is split into contiguous blocks, one per
+ * lane. Each worker drains its own lane from the back (keeping
+ * neighbouring matches on one core) and, once empty, steals from the
+ * front of other lanes, so a lane holding unusually expensive matches
+ * does not hold up the tick. The calling thread works as lane 0.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool executing one batch of tasks per tick
+ */
+class TickScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Task callback
+     *
+     * @param task Task index in [0, task_count)
+     * @param late True when the task started after the tick deadline
+     */
+    using TaskFn = std::function<void(size_t task, bool late)>;
+
+    /**
+     * @brief Per-tick execution statistics
+     */
+    struct TickStats {
+        double wall_ms = 0.0;    ///< Time from dispatch until every task finished
+        uint64_t cpu_ns = 0;     ///< Thread CPU time spent in tasks, summed over workers
+        uint32_t steals = 0;     ///< Tasks executed by a worker other than their lane owner
+        uint32_t late = 0;       ///< Tasks started after the deadline
+    };
+
+    /// @param threads Worker count including the calling thread (0 = hardware concurrency)
+    explicit TickScheduler(unsigned threads = 0);
+    ~TickScheduler();
+    TickScheduler(const TickScheduler &) = delete;
+    TickScheduler &operator=(const TickScheduler &) = delete;
+
+    /**
+     * @brief Execute tasks [0, task_count) and wait for completion
+     *
+     * @param task_count Number of tasks
+     * @param fn Task callback (called concurrently for distinct tasks)
+     * @param deadline Point after which started tasks are reported late
+     * @return Statistics for this tick
+     */
+    TickStats run(size_t task_count, const TaskFn &fn, Clock::time_point deadline);
+
+    /// @brief Number of lanes (workers including the caller)
+    unsigned lanes() const { return (unsigned)lanes_.size(); }
+
+private:
+    struct Lane {
+        std::mutex mtx;
+        std::vector<uint32_t> tasks;  ///< Pending task ids, [head, tasks.size()) still queued
+        size_t head = 0;
+    };
+
+    void worker_loop(unsigned lane);
+    void work(unsigned lane);
+    bool pop_own(unsigned lane, uint32_t &task);
+    bool steal(unsigned thief, uint32_t &task);
+    static uint64_t thread_cpu_ns();
+
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::vector<std::thread> workers;
+
+    // Current tick (published under mtx via epoch)
+    std::mutex mtx;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    uint64_t epoch = 0;
+    bool stopping = false;
+    bool open = false;               ///< Workers may join the current epoch
+    unsigned active = 0;             ///< Workers inside work() for the current epoch
+    size_t pending = 0;              ///< Tasks not yet finished (guarded by mtx)
+    const TaskFn *task_fn = nullptr;
+    Clock::time_point tick_deadline;
+
+    std::atomic<uint64_t> cpu_ns{0};
+    std::atomic<uint32_t> steals{0};
+    std::atomic<uint32_t> late{0};
+};
@@ -0,0 +1,121 @@
+/**
+ * @file telemetry/column_codec.cpp
+ * @brief Plain and delta bit packing of int32 column chunks
+ */
+
+#include "telemetry/column_codec.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+unsigned bits_for(uint64_t range) {
+    unsigned b = 0;
+    while (b < 64 && (range >> b) != 0) ++b;
+    return b;
+}
+
+/// LSB-first packer of fixed-width values into 64-bit words
+struct BitPacker {
+    std::vector<uint64_t> words;
+    unsigned bits;
+    size_t pos = 0;
+
+    BitPacker(size_t n, unsigned b) : words((n * b + 63) / 64), bits(b) {}
+
+    void put(uint64_t v) {
+        const size_t w = pos >> 6;
+        const unsigned shift = (unsigned)(pos & 63);
+        words[w] |= v << shift;
+        if (shift + bits > 64) words[w + 1] |= v >> (64 - shift);
+        pos += bits;
+    }
+};
+
+inline uint64_t load_word(const uint8_t *data, size_t w) {
+    uint64_t v;
+    std::memcpy(&v, data + w * 8, 8);
+    return v;
+}
+
+/// Call fn(i, packed value) for the first @p n values of @p bits width
+template <class F>
+void unpack(const uint8_t *data, size_t n, unsigned bits, F &&fn) {
+    const uint64_t mask = bits >= 64 ? ~0ull : (1ull << bits) - 1;
+    size_t pos = 0;
+    for (size_t i = 0; i < n; ++i, pos += bits) {
+        const size_t w = pos >> 6;
+        const unsigned shift = (unsigned)(pos & 63);
+        uint64_t v = load_word(data, w) >> shift;
+        if (shift + bits > 64) v |= load_word(data, w + 1) << (64 - shift);
+        fn(i, v & mask);
+    }
+}
+
+} // namespace
+
+ColumnChunkInfo encode_column(const int32_t *values, size_t n, std::vector<uint8_t> &out) {
+    ColumnChunkInfo info;
+    if (n == 0) return info;
+    int32_t lo = values[0], hi = values[0];
+    int64_t dlo = 0, dhi = 0;
+    for (size_t i = 1; i < n; ++i) {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+        const int64_t d = (int64_t)values[i] - values[i - 1];
+        if (i == 1 || d < dlo) dlo = d;
+        if (i == 1 || d > dhi) dhi = d;
+    }
+    info.min = lo;
+    info.max = hi;
+    const unsigned plain_bits = bits_for((uint64_t)((int64_t)hi - lo));
+    const unsigned delta_bits = n > 1 ? bits_for((uint64_t)(dhi - dlo)) : 64;
+    const bool delta = packed_bytes(n - 1, delta_bits) < packed_bytes(n, plain_bits);
+
+    BitPacker packer(delta ? n - 1 : n, delta ? delta_bits : plain_bits);
+    if (delta) {
+        info.encoding = ColumnEncoding::Delta;
+        info.bits = (uint8_t)delta_bits;
+        info.base = values[0];
+        info.delta_min = dlo;
+        if (delta_bits) {
+            for (size_t i = 1; i < n; ++i) packer.put((uint64_t)((int64_t)values[i] - values[i - 1] - dlo));
+        }
+    } else {
+        info.encoding = ColumnEncoding::Plain;
+        info.bits = (uint8_t)plain_bits;
+        info.base = lo;
+        if (plain_bits) {
+            for (size_t i = 0; i < n; ++i) packer.put((uint64_t)((int64_t)values[i] - lo));
+        }
+    }
+    info.bytes = (uint32_t)(packer.words.size() * 8);
+    const size_t at = out.size();
+    out.resize(at + info.bytes);
+    if (info.bytes) std::memcpy(out.data() + at, packer.words.data(), info.bytes);
+    return info;
+}
+
+bool decode_column(const ColumnChunkInfo &info, const uint8_t *data, size_t n, int32_t *values) {
+    if (n == 0) return true;
+    if (info.bits > 33) return false;
+    if (info.encoding == ColumnEncoding::Plain) {
+        if (info.bytes < packed_bytes(n, info.bits)) return false;
+        const int32_t base = (int32_t)info.base;
+        if (info.bits == 0) {
+            std::fill(values, values + n, base);
+            return true;
+        }
+        unpack(data, n, info.bits, [&](size_t i, uint64_t v) { values[i] = (int32_t)((int64_t)base + (int64_t)v); });
+        return true;
+    }
+    if (info.bytes < packed_bytes(n - 1, info.bits)) return false;
+    int64_t v = info.base;
+    values[0] = (int32_t)v;
+    if (info.bits == 0) {
+        for (size_t i = 1; i < n; ++i) values[i] = (int32_t)(v += info.delta_min);
+        return true;
+    }
+    unpack(data, n - 1, info.bits, [&](size_t i, uint64_t d) { values[i + 1] = (int32_t)(v += info.delta_min + (int64_t)d); });
+    return true;
+}
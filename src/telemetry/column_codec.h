@@ -0,0 +1,58 @@
+/**
+ * @file telemetry/column_codec.h
+ * @brief Bit-packed encodings for one column chunk of int32 values
+ *
+ * A chunk is stored with whichever of two encodings is smaller:
+ *
+ * - Plain: every value minus the chunk minimum, packed with the bit
+ *   width of (max - min). Right for values without order (offsets,
+ *   velocities).
+ * - Delta: the first value, then every difference to the previous value
+ *   minus the smallest difference, packed the same way. Right for
+ *   sorted or slowly changing columns (match ids, timestamps), whose
+ *   deltas need a few bits or none.
+ *
+ * A constant chunk packs to zero bits and stores no data. Values are
+ * packed LSB first into little-endian 64-bit words.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class ColumnEncoding : uint8_t {
+    Plain = 0,
+    Delta = 1
+};
+
+/**
+ * @brief Everything needed to decode a chunk, plus its statistics
+ */
+struct ColumnChunkInfo {
+    ColumnEncoding encoding = ColumnEncoding::Plain;
+    uint8_t bits = 0;         ///< Packed width per value (0 = all values derive from base)
+    int32_t min = 0;          ///< Statistics: smallest value of the chunk
+    int32_t max = 0;          ///< Statistics: largest value of the chunk
+    int64_t base = 0;         ///< Plain: min; Delta: first value
+    int64_t delta_min = 0;    ///< Delta: smallest difference
+    uint32_t bytes = 0;       ///< Packed data size
+};
+
+/**
+ * @brief Encode @p n values, appending the packed data to @p out
+ *
+ * @return Chunk description (bytes = size appended)
+ */
+ColumnChunkInfo encode_column(const int32_t *values, size_t n, std::vector<uint8_t> &out);
+
+/**
+ * @brief Decode @p n values of a chunk
+ *
+ * @param data Packed data (info.bytes long)
+ * @return false when the data is too short for @p n values of info.bits
+ */
+bool decode_column(const ColumnChunkInfo &info, const uint8_t *data, size_t n, int32_t *values);
+
+/// @brief Bytes the packed data of @p n values of @p bits takes
+inline size_t packed_bytes(size_t n, unsigned bits) { return ((n * bits + 63) / 64) * 8; }
@@ -0,0 +1,199 @@
+/**
+ * @file telemetry/telemetry_file.cpp
+ * @brief Telemetry row group writer and footer-driven reader
+ */
+
+#include "telemetry/telemetry_file.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr char kMagic[8] = { 'P', 'O', 'N', 'G', 'T', 'E', 'L', '1' };
+constexpr char kTailMagic[8] = { 'P', 'O', 'N', 'G', 'T', 'E', 'L', 'F' };
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderBytes = 16;
+constexpr size_t kTailBytes = 16;
+constexpr size_t kChunkMetaBytes = 1 + 1 + 4 + 4 + 8 + 8 + 8 + 4;
+
+template <typename T> void put(std::vector<uint8_t> &b, T v) {
+    const size_t at = b.size();
+    b.resize(at + sizeof(T));
+    std::memcpy(b.data() + at, &v, sizeof(T));
+}
+template <typename T> T get(const uint8_t *&p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return v;
+}
+
+} // namespace
+
+const TelemetryColumnInfo kTelemetryColumnInfo[kTelemetryColumns] = {
+    { "match", 1.0 },
+    { "mode", 1.0 },
+    { "speed_mode", 1.0 },
+    { "kind", 1.0 },
+    { "side", 1.0 },
+    { "ball", 1.0 },
+    { "time", 1000.0 },
+    { "rally", 1.0 },
+    { "x", 64.0 },
+    { "y", 64.0 },
+    { "vx", 64.0 },
+    { "vy", 64.0 },
+    { "speed", 64.0 },
+    { "offset", 1000.0 },
+};
+
+bool telemetry_column_by_name(const std::string &name, TelemetryColumn &out) {
+    for (size_t c = 0; c < kTelemetryColumns; ++c) {
+        if (name == kTelemetryColumnInfo[c].name) { out = (TelemetryColumn)c; return true; }
+    }
+    return false;
+}
+
+bool TelemetryWriter::open(const std::filesystem::path &path, std::string &err) {
+    close();
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) { err = "cannot create " + path.string(); return false; }
+    std::vector<uint8_t> head(kMagic, kMagic + 8);
+    put<uint32_t>(head, kVersion);
+    put<uint32_t>(head, (uint32_t)kTelemetryColumns);
+    out.write((const char *)head.data(), (std::streamsize)head.size());
+    offset = head.size();
+    pending.clear();
+    footer.clear();
+    total_rows = 0;
+    footer_groups = 0;
+    failed = !out;
+    return !failed;
+}
+
+bool TelemetryWriter::append(const TelemetryRows &rows) {
+    if (!is_open()) return false;
+    const size_t n = rows.size();
+    for (size_t from = 0; from < n;) {
+        const size_t take = std::min(kTelemetryRowGroup - pending.size(), n - from);
+        for (size_t c = 0; c < kTelemetryColumns; ++c) {
+            const auto &src = rows.col[c];
+            pending.col[c].insert(pending.col[c].end(), src.begin() + (std::ptrdiff_t)from,
+                                  src.begin() + (std::ptrdiff_t)(from + take));
+        }
+        from += take;
+        if (pending.size() == kTelemetryRowGroup && !write_group(kTelemetryRowGroup)) return false;
+    }
+    return !failed;
+}
+
+bool TelemetryWriter::write_group(size_t n) {
+    chunk.clear();
+    put<uint32_t>(footer, (uint32_t)n);
+    for (size_t c = 0; c < kTelemetryColumns; ++c) {
+        const size_t at = chunk.size();
+        const ColumnChunkInfo info = encode_column(pending.col[c].data(), n, chunk);
+        put<uint8_t>(footer, (uint8_t)info.encoding);
+        put<uint8_t>(footer, info.bits);
+        put<int32_t>(footer, info.min);
+        put<int32_t>(footer, info.max);
+        put<int64_t>(footer, info.base);
+        put<int64_t>(footer, info.delta_min);
+        put<uint64_t>(footer, offset + at);
+        put<uint32_t>(footer, info.bytes);
+    }
+    out.write((const char *)chunk.data(), (std::streamsize)chunk.size());
+    offset += chunk.size();
+    total_rows += n;
+    ++footer_groups;
+    pending.clear();
+    failed = failed || !out;
+    return !failed;
+}
+
+bool TelemetryWriter::close() {
+    if (!is_open()) return !failed;
+    if (pending.size()) write_group(pending.size());
+    std::vector<uint8_t> tail;
+    put<uint32_t>(tail, (uint32_t)footer_groups);
+    tail.insert(tail.end(), footer.begin(), footer.end());
+    put<uint64_t>(tail, offset);
+    tail.insert(tail.end(), kTailMagic, kTailMagic + 8);
+    out.write((const char *)tail.data(), (std::streamsize)tail.size());
+    offset += tail.size();
+    out.close();
+    failed = failed || out.fail();
+    return !failed;
+}
+
+bool TelemetryReader::open(const std::filesystem::path &path, std::string &err) {
+    row_groups.clear();
+    total_rows = 0;
+    in.close();
+    in.open(path, std::ios::binary);
+    if (!in) { err = "cannot open " + path.string(); return false; }
+    in.seekg(0, std::ios::end);
+    size = (uint64_t)in.tellg();
+    uint8_t head[kHeaderBytes], tail[kTailBytes];
+    in.seekg(0);
+    if (size < kHeaderBytes + 4 + kTailBytes || !in.read((char *)head, kHeaderBytes) ||
+        std::memcmp(head, kMagic, 8) != 0) {
+        err = path.string() + ": not a telemetry file";
+        return false;
+    }
+    const uint8_t *p = head + 8;
+    const uint32_t version = get<uint32_t>(p), columns = get<uint32_t>(p);
+    if (version != kVersion || columns != kTelemetryColumns) {
+        err = path.string() + ": unsupported telemetry version or schema";
+        return false;
+    }
+    in.seekg((std::streamoff)(size - kTailBytes));
+    if (!in.read((char *)tail, kTailBytes) || std::memcmp(tail + 8, kTailMagic, 8) != 0) {
+        err = path.string() + ": footer missing (file not closed?)";
+        return false;
+    }
+    p = tail;
+    const uint64_t footer_at = get<uint64_t>(p);
+    if (footer_at < kHeaderBytes || footer_at > size - kTailBytes - 4) { err = path.string() + ": bad footer offset"; return false; }
+    std::vector<uint8_t> footer((size_t)(size - kTailBytes - footer_at));
+    in.seekg((std::streamoff)footer_at);
+    if (!in.read((char *)footer.data(), (std::streamsize)footer.size())) { err = path.string() + ": short footer"; return false; }
+    p = footer.data();
+    const uint32_t groups = get<uint32_t>(p);
+    if (footer.size() != 4 + (size_t)groups * (4 + kTelemetryColumns * kChunkMetaBytes)) {
+        err = path.string() + ": footer size mismatch";
+        return false;
+    }
+    row_groups.resize(groups);
+    for (Group &g : row_groups) {
+        g.rows = get<uint32_t>(p);
+        total_rows += g.rows;
+        for (Chunk &c : g.chunks) {
+            c.info.encoding = (ColumnEncoding)get<uint8_t>(p);
+            c.info.bits = get<uint8_t>(p);
+            c.info.min = get<int32_t>(p);
+            c.info.max = get<int32_t>(p);
+            c.info.base = get<int64_t>(p);
+            c.info.delta_min = get<int64_t>(p);
+            c.offset = get<uint64_t>(p);
+            c.info.bytes = get<uint32_t>(p);
+            if (c.offset < kHeaderBytes || c.offset + c.info.bytes > footer_at) {
+                err = path.string() + ": chunk outside the data section";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool TelemetryReader::read(size_t group, TelemetryColumn col, std::vector<int32_t> &out) {
+    const Group &g = row_groups[group];
+    const Chunk &c = g.chunks[(size_t)col];
+    out.resize(g.rows);
+    scratch.resize(c.info.bytes);
+    if (c.info.bytes) {
+        in.seekg((std::streamoff)c.offset);
+        if (!in.read((char *)scratch.data(), (std::streamsize)c.info.bytes)) { in.clear(); return false; }
+    }
+    return decode_column(c.info, scratch.data(), g.rows, out.data());
+}
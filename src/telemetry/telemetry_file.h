@@ -0,0 +1,142 @@
+/**
+ * @file telemetry/telemetry_file.h
+ * @brief Columnar file of match telemetry events, in row groups with min/max statistics
+ *
+ * Every row is one simulation event (core/game_events.h) of one match,
+ * stored as fixed-point int32 columns (TelemetryColumn). Rows are cut
+ * into row groups of up to kTelemetryRowGroup rows; inside a group every
+ * column is one chunk encoded with telemetry/column_codec.h. Layout
+ * (little endian):
+ *
+ *     "PONGTEL1" | u32 version | u32 column count
+ *     row groups: packed chunk data, column after column
+ *     footer: u32 groups | per group: u32 rows |
+ *             per column: u8 encoding | u8 bits | i32 min | i32 max |
+ *                         i64 base | i64 delta_min | u64 offset | u32 bytes
+ *     u64 footer offset | "PONGTELF"
+ *
+ * The footer holds every chunk's statistics, so a reader can decide
+ * which groups a predicate can match before it reads any data, and then
+ * reads only the columns a query touches.
+ */
+#pragma once
+
+#include "telemetry/column_codec.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/// @brief Columns of a telemetry row, in file order
+enum class TelemetryColumn : uint8_t {
+    Match = 0,   ///< Match number within the run
+    Mode,        ///< GameMode
+    SpeedMode,   ///< 1 when "I am Speed" mode was on
+    Kind,        ///< GameEventKind
+    Side,        ///< PaddleSide: hitting paddle, or scoring side for points
+    Ball,        ///< Ball index
+    TimeMs,      ///< Simulated milliseconds since the match started
+    Rally,       ///< Paddle hits of this ball since its last serve (points: the rally length)
+    X,           ///< Ball position, 1/64 units
+    Y,
+    Vx,          ///< Ball velocity, 1/64 units per second
+    Vy,
+    Speed,       ///< |velocity|, 1/64 units per second
+    Offset,      ///< Paddle contact offset, 1/1000 (-1000..1000)
+    Count
+};
+
+constexpr size_t kTelemetryColumns = (size_t)TelemetryColumn::Count;
+constexpr size_t kTelemetryRowGroup = 65536;
+
+/**
+ * @brief Name and fixed-point scale of a column (stored = round(value * scale))
+ */
+struct TelemetryColumnInfo {
+    const char *name;
+    double scale;
+};
+
+/// @brief Column descriptions indexed by TelemetryColumn
+extern const TelemetryColumnInfo kTelemetryColumnInfo[kTelemetryColumns];
+
+/// @brief Look up a column by name; false if unknown
+bool telemetry_column_by_name(const std::string &name, TelemetryColumn &out);
+
+/**
+ * @brief Rows being built, one vector per column
+ */
+struct TelemetryRows {
+    std::vector<int32_t> col[kTelemetryColumns];
+
+    size_t size() const { return col[0].size(); }
+    void clear() { for (auto &c : col) c.clear(); }
+    std::vector<int32_t> &operator[](TelemetryColumn c) { return col[(size_t)c]; }
+    const std::vector<int32_t> &operator[](TelemetryColumn c) const { return col[(size_t)c]; }
+};
+
+/**
+ * @brief Appends rows and writes a row group whenever kTelemetryRowGroup rows are pending
+ */
+class TelemetryWriter {
+public:
+    ~TelemetryWriter() { close(); }
+
+    bool open(const std::filesystem::path &path, std::string &err);
+    /// @brief Append every row of @p rows (columns must have equal length)
+    bool append(const TelemetryRows &rows);
+    /// @brief Write the pending rows and the footer; false if any write failed
+    bool close();
+    bool is_open() const { return out.is_open(); }
+
+    uint64_t rows() const { return total_rows; }
+    size_t groups() const { return footer_groups; }
+    uint64_t bytes() const { return offset; }
+
+private:
+    bool write_group(size_t n);
+
+    std::ofstream out;
+    TelemetryRows pending;
+    std::vector<uint8_t> chunk, footer;
+    uint64_t offset = 0;          ///< File position
+    uint64_t total_rows = 0;
+    size_t footer_groups = 0;
+    bool failed = false;
+};
+
+/**
+ * @brief Footer-driven reader that loads single column chunks on demand
+ */
+class TelemetryReader {
+public:
+    struct Chunk {
+        ColumnChunkInfo info;
+        uint64_t offset = 0;
+    };
+    struct Group {
+        uint32_t rows = 0;
+        Chunk chunks[kTelemetryColumns];
+    };
+
+    bool open(const std::filesystem::path &path, std::string &err);
+    const std::vector<Group> &groups() const { return row_groups; }
+    uint64_t rows() const { return total_rows; }
+    uint64_t file_bytes() const { return size; }
+
+    /**
+     * @brief Decode one column of one row group into @p out (resized to the group's rows)
+     *
+     * @return false on a read error or damaged chunk
+     */
+    bool read(size_t group, TelemetryColumn col, std::vector<int32_t> &out);
+
+private:
+    std::ifstream in;
+    std::vector<Group> row_groups;
+    std::vector<uint8_t> scratch;
+    uint64_t total_rows = 0;
+    uint64_t size = 0;
+};
@@ -0,0 +1,167 @@
+/**
+ * @file telemetry/telemetry_query.cpp
+ * @brief Statistics pruning, vectorized range filters and aggregation
+ */
+
+#include "telemetry/telemetry_query.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PONG_TELEMETRY_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define PONG_TELEMETRY_NEON 1
+#include <arm_neon.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace {
+
+/// Bit i set when row i of the 64-row block fails [lo, hi]
+inline uint64_t outside_scalar(const int32_t *v, size_t n, int32_t lo, int32_t hi) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < n; ++i) bits |= (uint64_t)(v[i] < lo || v[i] > hi) << i;
+    return bits;
+}
+
+inline uint64_t outside_block(const int32_t *v, int32_t lo, int32_t hi) {
+#if PONG_TELEMETRY_SSE2
+    const __m128i vlo = _mm_set1_epi32(lo), vhi = _mm_set1_epi32(hi);
+    uint64_t bits = 0;
+    for (int k = 0; k < 16; ++k) {
+        const __m128i x = _mm_loadu_si128((const __m128i *)(v + k * 4));
+        const __m128i out = _mm_or_si128(_mm_cmpgt_epi32(vlo, x), _mm_cmpgt_epi32(x, vhi));
+        bits |= (uint64_t)_mm_movemask_ps(_mm_castsi128_ps(out)) << (k * 4);
+    }
+    return bits;
+#elif PONG_TELEMETRY_NEON
+    const int32x4_t vlo = vdupq_n_s32(lo), vhi = vdupq_n_s32(hi);
+    static const uint32_t kLane[4] = { 1, 2, 4, 8 };
+    const uint32x4_t lane = vld1q_u32(kLane);
+    uint64_t bits = 0;
+    for (int k = 0; k < 16; ++k) {
+        const int32x4_t x = vld1q_s32(v + k * 4);
+        const uint32x4_t out = vandq_u32(vorrq_u32(vcltq_s32(x, vlo), vcgtq_s32(x, vhi)), lane);
+        const uint32x2_t half = vadd_u32(vget_low_u32(out), vget_high_u32(out));
+        bits |= (uint64_t)vget_lane_u32(vpadd_u32(half, half), 0) << (k * 4);
+    }
+    return bits;
+#else
+    return outside_scalar(v, 64, lo, hi);
+#endif
+}
+
+inline unsigned popcount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_popcountll(x);
+#else
+    unsigned n = 0;
+    for (; x; x &= x - 1) ++n;
+    return n;
+#endif
+}
+
+/// Index of the lowest set bit (x != 0)
+inline unsigned lowest_bit(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(x);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return (unsigned)i;
+#else
+    unsigned i = 0;
+    while (!(x & 1)) { x >>= 1; ++i; }
+    return i;
+#endif
+}
+
+/// Tail words keep only the bits of real rows
+inline uint64_t row_bits(size_t rows) { return rows >= 64 ? ~0ull : (1ull << rows) - 1; }
+
+} // namespace
+
+void filter_range(const int32_t *v, size_t n, int32_t lo, int32_t hi, bool negate, uint64_t *mask) {
+    const size_t full = n / 64;
+    for (size_t w = 0; w < full; ++w) {
+        if (!mask[w]) continue;
+        const uint64_t out = outside_block(v + w * 64, lo, hi);
+        mask[w] &= negate ? out : ~out;
+    }
+    if (n % 64) {
+        const uint64_t out = outside_scalar(v + full * 64, n % 64, lo, hi);
+        mask[full] &= (negate ? out : ~out) & row_bits(n % 64);
+    }
+}
+
+void filter_range_scalar(const int32_t *v, size_t n, int32_t lo, int32_t hi, bool negate, uint64_t *mask) {
+    for (size_t w = 0; w * 64 < n; ++w) {
+        const size_t rows = std::min<size_t>(64, n - w * 64);
+        const uint64_t out = outside_scalar(v + w * 64, rows, lo, hi);
+        mask[w] &= (negate ? out : ~out) & row_bits(rows);
+    }
+}
+
+bool run_telemetry_query(TelemetryReader &reader, const TelemetryQuery &q, TelemetryQueryResult &out, std::string &err) {
+    out = TelemetryQueryResult{};
+    std::vector<int32_t> col, keys, values;
+    std::vector<uint64_t> mask;
+    std::vector<const TelemetryPredicate *> filters;
+    const auto &groups = reader.groups();
+    auto load = [&](size_t g, TelemetryColumn c, std::vector<int32_t> &dst) {
+        if (!reader.read(g, c, dst)) {
+            err = "row group " + std::to_string(g) + ", column " + kTelemetryColumnInfo[(size_t)c].name + ": read failed";
+            return false;
+        }
+        ++out.chunks_read;
+        out.bytes_read += groups[g].chunks[(size_t)c].info.bytes;
+        return true;
+    };
+
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const TelemetryReader::Group &grp = groups[g];
+        // Statistics: rule the group out, or drop predicates every row passes
+        filters.clear();
+        bool skip = false;
+        for (const TelemetryPredicate &p : q.where) {
+            const ColumnChunkInfo &st = grp.chunks[(size_t)p.col].info;
+            const bool none_inside = st.max < p.lo || st.min > p.hi;
+            const bool all_inside = st.min >= p.lo && st.max <= p.hi;
+            if (p.negate ? all_inside : none_inside) { skip = true; break; }
+            if (!(p.negate ? none_inside : all_inside)) filters.push_back(&p);
+        }
+        if (skip) { ++out.groups_skipped; continue; }
+        out.rows_scanned += grp.rows;
+
+        const size_t words = (grp.rows + 63) / 64;
+        mask.assign(words, ~0ull);
+        if (grp.rows % 64) mask[words - 1] = row_bits(grp.rows % 64);
+        for (const TelemetryPredicate *p : filters) {
+            if (!load(g, p->col, col)) return false;
+            (q.simd ? filter_range : filter_range_scalar)(col.data(), grp.rows, p->lo, p->hi, p->negate, mask.data());
+        }
+        uint64_t selected = 0;
+        for (uint64_t w : mask) selected += popcount64(w);
+        if (!selected) continue;
+        out.rows_matched += selected;
+
+        if (!load(g, q.value, values)) return false;
+        if (q.grouped && !load(g, q.group_by, keys)) return false;
+        TelemetryGroupResult *only = q.grouped ? nullptr : &out.groups[0];
+        for (size_t w = 0; w < words; ++w) {
+            for (uint64_t bits = mask[w]; bits; bits &= bits - 1) {
+                const size_t i = w * 64 + lowest_bit(bits);
+                TelemetryGroupResult &r = only ? *only : out.groups[keys[i]];
+                const int32_t v = values[i];
+                ++r.count;
+                r.sum += v;
+                r.min = std::min(r.min, v);
+                r.max = std::max(r.max, v);
+                r.values.push_back(v);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file telemetry/telemetry_query.h
+ * @brief Filtered, grouped scans over a telemetry file
+ *
+ * A query is a conjunction of range predicates on columns, an optional
+ * group-by column and a value column to aggregate. The scan works one
+ * row group at a time:
+ *
+ * 1. Chunk statistics decide, per predicate, whether the group cannot
+ *    match (skipped without reading), matches entirely (no decode
+ *    needed) or has to be filtered.
+ * 2. Filtered columns are decoded and compared 4 values per instruction
+ *    (SSE2 or NEON, scalar elsewhere) into a selection bitmap, 64 rows
+ *    per word, ANDed across predicates.
+ * 3. Only groups with selected rows decode the group-by and value
+ *    columns, and only selected rows are aggregated.
+ */
+#pragma once
+
+#include "telemetry/telemetry_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Row passes when lo <= value <= hi (or outside that range when negate)
+ */
+struct TelemetryPredicate {
+    TelemetryColumn col = TelemetryColumn::Match;
+    int32_t lo = INT32_MIN;
+    int32_t hi = INT32_MAX;
+    bool negate = false;
+};
+
+struct TelemetryQuery {
+    std::vector<TelemetryPredicate> where;
+    bool grouped = false;
+    TelemetryColumn group_by = TelemetryColumn::Mode;
+    TelemetryColumn value = TelemetryColumn::Rally;
+    bool simd = true;            ///< false forces the scalar filter (for comparison)
+};
+
+/**
+ * @brief Aggregate of one group (stored fixed-point values)
+ */
+struct TelemetryGroupResult {
+    uint64_t count = 0;
+    int64_t sum = 0;
+    int32_t min = INT32_MAX;
+    int32_t max = INT32_MIN;
+    std::vector<int32_t> values;  ///< Every selected value, for percentiles
+};
+
+struct TelemetryQueryResult {
+    std::map<int32_t, TelemetryGroupResult> groups;  ///< Keyed by group-by value (0 when not grouped)
+    uint64_t rows_scanned = 0;     ///< Rows of the groups that were not skipped
+    uint64_t rows_matched = 0;
+    size_t groups_skipped = 0;     ///< Row groups ruled out by statistics
+    size_t chunks_read = 0;
+    uint64_t bytes_read = 0;       ///< Packed chunk bytes
+};
+
+/**
+ * @brief Run @p q over every row group of @p reader
+ *
+ * @return false (with @p err) if a chunk could not be read
+ */
+bool run_telemetry_query(TelemetryReader &reader, const TelemetryQuery &q, TelemetryQueryResult &out, std::string &err);
+
+/**
+ * @brief AND the rows of @p v that pass [lo, hi] (or fail it, when negate) into @p mask
+ *
+ * @p mask holds one bit per row, (n + 63) / 64 words.
+ */
+void filter_range(const int32_t *v, size_t n, int32_t lo, int32_t hi, bool negate, uint64_t *mask);
+/// @brief Scalar reference of filter_range()
+void filter_range_scalar(const int32_t *v, size_t n, int32_t lo, int32_t hi, bool negate, uint64_t *mask);
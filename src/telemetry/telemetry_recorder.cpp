@@ -0,0 +1,60 @@
+/**
+ * @file telemetry/telemetry_recorder.cpp
+ * @brief Event to row conversion and the headless match loop
+ */
+
+#include "telemetry/telemetry_recorder.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+
+int32_t fixed(double v, TelemetryColumn c) {
+    const double q = std::round(v * kTelemetryColumnInfo[(size_t)c].scale);
+    if (!(q > (double)std::numeric_limits<int32_t>::min())) return std::numeric_limits<int32_t>::min();
+    if (q > (double)std::numeric_limits<int32_t>::max()) return std::numeric_limits<int32_t>::max();
+    return (int32_t)q;
+}
+
+} // namespace
+
+void TelemetryRecorder::begin(const TelemetryMatch &m) {
+    match = m;
+    rally.clear();
+}
+
+void TelemetryRecorder::on_event(const GameEvent &e) {
+    if (e.ball >= rally.size()) rally.resize(e.ball + 1, 0);
+    int32_t &hits = rally[e.ball];
+    if (e.kind == GameEventKind::PaddleHit) ++hits;
+    out[TelemetryColumn::Match].push_back((int32_t)match.match);
+    out[TelemetryColumn::Mode].push_back((int32_t)match.mode);
+    out[TelemetryColumn::SpeedMode].push_back(match.speed_mode ? 1 : 0);
+    out[TelemetryColumn::Kind].push_back((int32_t)e.kind);
+    out[TelemetryColumn::Side].push_back((int32_t)e.side);
+    out[TelemetryColumn::Ball].push_back((int32_t)e.ball);
+    out[TelemetryColumn::TimeMs].push_back(fixed(e.time, TelemetryColumn::TimeMs));
+    out[TelemetryColumn::Rally].push_back(hits);
+    out[TelemetryColumn::X].push_back(fixed(e.x, TelemetryColumn::X));
+    out[TelemetryColumn::Y].push_back(fixed(e.y, TelemetryColumn::Y));
+    out[TelemetryColumn::Vx].push_back(fixed(e.vx, TelemetryColumn::Vx));
+    out[TelemetryColumn::Vy].push_back(fixed(e.vy, TelemetryColumn::Vy));
+    out[TelemetryColumn::Speed].push_back(fixed(std::sqrt(e.vx * e.vx + e.vy * e.vy), TelemetryColumn::Speed));
+    out[TelemetryColumn::Offset].push_back(fixed(e.offset, TelemetryColumn::Offset));
+    if (e.kind == GameEventKind::Point) hits = 0;
+}
+
+void run_telemetry_match(const TelemetryMatch &m, TelemetryRecorder &rec) {
+    GameCore core;
+    core.set_mode(m.mode);
+    core.enable_left_ai(true);
+    core.enable_right_ai(true);
+    core.set_ai_speed(m.ai_speed);
+    core.set_speed_mode(m.speed_mode);
+    rec.begin(m);
+    core.set_event_sink(&rec);
+    const int hz = m.hz > 0 ? m.hz : 60;
+    const long frames = std::lround(m.seconds * hz);
+    const double dt = 1.0 / hz;
+    for (long f = 0; f < frames; ++f) core.update(dt);
+}
@@ -0,0 +1,44 @@
+/**
+ * @file telemetry/telemetry_recorder.h
+ * @brief Headless GameCore matches whose events become telemetry rows
+ *
+ * The recorder is the GameCore event sink: it stamps each event with the
+ * match, mode and rally count and converts it to the fixed-point columns
+ * of telemetry/telemetry_file.h. run_telemetry_match() plays one match
+ * with both paddles on AI as fast as the CPU allows.
+ */
+#pragma once
+
+#include "core/game_core.h"
+#include "telemetry/telemetry_file.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief One simulated match
+ */
+struct TelemetryMatch {
+    uint32_t match = 0;
+    GameMode mode = GameMode::Classic;
+    bool speed_mode = false;
+    double ai_speed = 1.0;     ///< Both paddles
+    double seconds = 60.0;     ///< Simulated time
+    int hz = 60;               ///< Frame rate (GameCore substeps at 240 Hz inside a frame)
+};
+
+class TelemetryRecorder : public GameEventSink {
+public:
+    /// @brief Start a match: following events are stamped with @p m
+    void begin(const TelemetryMatch &m);
+    void on_event(const GameEvent &e) override;
+
+    TelemetryRows &rows() { return out; }
+
+private:
+    TelemetryMatch match;
+    std::vector<int32_t> rally;   ///< Hits per ball index since its last serve
+    TelemetryRows out;
+};
+
+/// @brief Play @p m headless, appending its events to @p rec
+void run_telemetry_match(const TelemetryMatch &m, TelemetryRecorder &rec);
@@ -0,0 +1,158 @@
+/**
+ * @file archive_main.cpp
+ * @brief pong_archive: inspect a frame archive and export it to images or video
+ *
+ * Usage:
+ *   pong_archive info <recording.pfa>
+ *   pong_archive bmp <recording.pfa> <dir>     # frame_%06d.bmp
+ *   pong_archive qoi <recording.pfa> <dir>     # frame_%06d.qoi
+ *   pong_archive y4m <recording.pfa> <target>  # file, "-" (stdout) or "|command"
+ *
+ * The archive is memory mapped, so raw frames are exported straight from
+ * the mapping; QOI frames are decoded first. For video, pipe into an
+ * encoder: pong_archive y4m recording.pfa "|ffmpeg -i - -c:v libx264 out.mp4"
+ */
+
+#include "capture/frame_archive.h"
+#include "capture/frame_capture.h"
+#include "capture/qoi.h"
+#include "capture/y4m_writer.h"
+#include "capture/yuv.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static void usage() {
+    std::fprintf(stderr,
+                 "usage: pong_archive info <archive>\n"
+                 "       pong_archive bmp <archive> <dir>\n"
+                 "       pong_archive qoi <archive> <dir>\n"
+                 "       pong_archive y4m <archive> <file | - | \"|command\">\n");
+}
+
+/// Bottom-up BGRA view of a frame; QOI frames are decoded into @p scratch
+static const uint8_t *frame_bgra(const FrameArchiveReader &ar, const FrameArchiveReader::Frame &f,
+                                 std::vector<uint8_t> &rgba, std::vector<uint8_t> &scratch) {
+    if (ar.codec() == ArchiveCodec::RawBgra) {
+        return f.bytes >= (size_t)f.width * (size_t)f.height * 4 ? f.data : nullptr;
+    }
+    int w = 0, h = 0;
+    if (!qoi_decode(f.data, f.bytes, w, h, rgba) || w != f.width || h != f.height) return nullptr;
+    // Top-down RGBA -> bottom-up BGRA
+    scratch.resize(rgba.size());
+    for (int y = 0; y < h; ++y) {
+        const uint8_t *src = rgba.data() + (size_t)(h - 1 - y) * (size_t)w * 4;
+        uint8_t *dst = scratch.data() + (size_t)y * (size_t)w * 4;
+        for (int x = 0; x < w; ++x) {
+            dst[x * 4] = src[x * 4 + 2]; dst[x * 4 + 1] = src[x * 4 + 1]; dst[x * 4 + 2] = src[x * 4]; dst[x * 4 + 3] = 0;
+        }
+    }
+    return scratch.data();
+}
+
+static bool write_file(const std::filesystem::path &path, const uint8_t *head, size_t head_bytes,
+                       const uint8_t *data, size_t bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(head), (std::streamsize)head_bytes);
+    out.write(reinterpret_cast<const char *>(data), (std::streamsize)bytes);
+    return (bool)out;
+}
+
+static int export_images(const FrameArchiveReader &ar, const std::filesystem::path &dir, bool bmp) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    std::vector<uint8_t> rgba, scratch, encoded;
+    size_t written = 0;
+    for (size_t i = 0; i < ar.size(); ++i) {
+        const FrameArchiveReader::Frame &f = ar.frame(i);
+        char name[32];
+        std::snprintf(name, sizeof(name), bmp ? "frame_%06u.bmp" : "frame_%06u.qoi", f.index);
+        bool ok = false;
+        if (!bmp && ar.codec() == ArchiveCodec::Qoi) {
+            ok = write_file(dir / name, nullptr, 0, f.data, f.bytes);  // already a QOI file
+        } else if (const uint8_t *px = frame_bgra(ar, f, rgba, scratch)) {
+            if (bmp) {
+                uint8_t h[kBmpHeaderBytes];
+                write_bmp_header(h, f.width, f.height);
+                ok = write_file(dir / name, h, sizeof(h), px, (size_t)f.width * 4u * (size_t)f.height);
+            } else {
+                encoded.resize(qoi_max_size(f.width, f.height));
+                const size_t n = qoi_encode_bgra_bottom_up(px, f.width, f.height, f.width, f.height, encoded.data());
+                ok = write_file(dir / name, nullptr, 0, encoded.data(), n);
+            }
+        }
+        if (!ok) { std::fprintf(stderr, "frame %u: export failed\n", f.index); continue; }
+        ++written;
+    }
+    std::fprintf(stderr, "%zu of %zu frames written to %s\n", written, ar.size(), dir.string().c_str());
+    return written == ar.size() ? 0 : 1;
+}
+
+static int export_y4m(const FrameArchiveReader &ar, const std::string &target) {
+    if (ar.size() == 0) { std::fprintf(stderr, "archive holds no frames\n"); return 1; }
+    // Y4M has one frame size: the first frame's; frames recorded at another size are skipped
+    const int w = ar.frame(0).width, h = ar.frame(0).height;
+    Y4mWriter y4m;
+    std::string err;
+    if (!y4m.open(target, w, h, (int)ar.header().fps, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    std::vector<uint8_t> out(Y4mWriter::kFramePrefix + yuv420_size(w, h)), rgba, scratch;
+    std::memcpy(out.data(), Y4mWriter::frame_prefix(), Y4mWriter::kFramePrefix);
+    const YuvPlanes planes = yuv420_planes(out.data() + Y4mWriter::kFramePrefix, w, h);
+    const ptrdiff_t stride = (ptrdiff_t)w * 4;
+    size_t written = 0, skipped = 0;
+    for (size_t i = 0; i < ar.size(); ++i) {
+        const FrameArchiveReader::Frame &f = ar.frame(i);
+        const uint8_t *px = f.width == w && f.height == h ? frame_bgra(ar, f, rgba, scratch) : nullptr;
+        if (!px) { ++skipped; continue; }
+        bgra_to_yuv420(px + (ptrdiff_t)(h - 1) * stride, -stride, w, h, planes);
+        if (!y4m.write_frame(out.data(), out.size())) { std::fprintf(stderr, "write failed\n"); return 1; }
+        ++written;
+    }
+    y4m.close();
+    std::fprintf(stderr, "%zu frames %dx%d as y4m (%s)", written, w, h, yuv_simd_path());
+    if (skipped) std::fprintf(stderr, ", %zu skipped (other size or undecodable)", skipped);
+    std::fprintf(stderr, "\n");
+    return skipped ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) { usage(); return 2; }
+    const std::string cmd = argv[1];
+    FrameArchiveReader ar;
+    std::string err;
+    if (!ar.open(argv[2], err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    int rc;
+    if (cmd == "info") {
+        const ArchiveHeader &h = ar.header();
+        uint64_t payload = 0;
+        for (size_t i = 0; i < ar.size(); ++i) payload += ar.frame(i).bytes;
+        std::printf("format      frame archive v%u, %s frames\n", h.version,
+                    ar.codec() == ArchiveCodec::Qoi ? "QOI" : "raw BGRA");
+        std::printf("size        %ux%u @ %u fps\n", h.width, h.height, h.fps);
+        std::printf("slots       %s\n", h.slot_stride ? ("fixed, " + std::to_string(h.slot_stride) + " bytes").c_str() : "packed");
+        std::printf("frames      %zu%s\n", ar.size(), ar.recovered() ? " (no index: recovered from slot headers)" : "");
+        if (ar.size()) {
+            std::printf("range       %u .. %u\n", ar.frame(0).index, ar.frame(ar.size() - 1).index);
+            std::printf("payload     %.1f MB (%.3f MB/frame)\n", (double)payload / 1e6, (double)payload / 1e6 / (double)ar.size());
+        }
+        return 0;
+    } else if (cmd == "bmp" || cmd == "qoi") {
+        if (argc < 4) { usage(); return 2; }
+        rc = export_images(ar, argv[3], cmd == "bmp");
+    } else if (cmd == "y4m") {
+        if (argc < 4) { usage(); return 2; }
+        rc = export_y4m(ar, argv[3]);
+    } else {
+        usage();
+        return 2;
+    }
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::fprintf(stderr, "exported in %.2f s (%.0f fps)\n", s, s > 0 ? (double)ar.size() / s : 0.0);
+    return rc;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file bench.h
+ * @brief Shared declarations for the pong_bench benchmark driver
+ *
+ * Each benchmark lives in its own bench_*.cpp file and is registered in
+ * the table in bench_main.cpp. Benchmarks take the remaining command line
+ * arguments, print a small plain-text report to stdout and return a
+ * process exit code.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * @brief Registered benchmark entry
+ */
+struct BenchCase {
+    const char *name;                   ///< Sub-command name (e.g. "arena")
+    const char *summary;                ///< One-line description for the listing
+    int (*run)(int argc, char **argv);  ///< Entry point; argv excludes the sub-command
+};
+
+/// @brief Monotonic time in milliseconds for benchmark timing
+inline double bench_now_ms() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Fetch an integer option of the form "--name value"
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @param name Option name including leading dashes
+ * @param fallback Value returned when the option is absent or malformed
+ * @return Parsed value or fallback
+ */
+inline long bench_int_arg(int argc, char **argv, const char *name, long fallback) {
+    for (int i = 0; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            char *end = nullptr;
+            long v = std::strtol(argv[i+1], &end, 10);
+            if (end && *end == '\0') return v;
+        }
+    }
+    return fallback;
+}
+
+/// @name Benchmarks
+/// @{
+int bench_arena(int argc, char **argv);
+int bench_shm(int argc, char **argv);     ///< POSIX only
+int bench_console(int argc, char **argv);
+int bench_input(int argc, char **argv);
+int bench_capture(int argc, char **argv);
+int bench_yuv(int argc, char **argv);
+int bench_qoi(int argc, char **argv);
+int bench_archive(int argc, char **argv);
+int bench_raster(int argc, char **argv);
+int bench_text(int argc, char **argv);
+int bench_settings(int argc, char **argv);
+int bench_scores(int argc, char **argv);
+int bench_telemetry(int argc, char **argv);
+int bench_metrics(int argc, char **argv);   ///< POSIX only
+/// @}
@@ -0,0 +1,114 @@
+/**
+ * @file bench_archive.cpp
+ * @brief Sustained recording throughput: per-file BMP vs the frame archive
+ *
+ * The same frames go through FrameCapture three times: one BMP file per
+ * frame, a raw archive (fixed-stride slots) and a QOI archive (packed
+ * slots). MB/s counts frame payload from the first submit until finish()
+ * returns. Per-file BMP writes land in the page cache, archive writes go
+ * to the device when O_DIRECT is available (reported per row), so on a
+ * machine with plenty of free RAM the BMP row flatters itself for short
+ * runs; raise --frames past the dirty-page limit to see sustained rates.
+ * Afterwards the archives are read back through the mapping and checked
+ * against the source frame.
+ */
+
+#include "tools/bench/bench.h"
+#include "capture/frame_archive.h"
+#include "capture/frame_capture.h"
+#include "capture/qoi.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Pass {
+    const char *name;
+    CaptureFormat format;
+    ArchiveCodec codec;
+};
+
+/// Raw archives must hold the source frame as is; QOI archives must decode back to it
+bool check_archive(const std::filesystem::path &file, ArchiveCodec codec, const std::vector<uint8_t> &src,
+                   int w, int h, long frames) {
+    FrameArchiveReader ar;
+    std::string err;
+    if (!ar.open(file, err) || (long)ar.size() != frames || ar.recovered()) return false;
+    const FrameArchiveReader::Frame &f = ar.frame(0);
+    if (f.width != w || f.height != h) return false;
+    if (codec == ArchiveCodec::RawBgra) return f.bytes == src.size() && std::memcmp(f.data, src.data(), src.size()) == 0;
+    std::vector<uint8_t> rgba;
+    int dw = 0, dh = 0;
+    if (!qoi_decode(f.data, f.bytes, dw, dh, rgba) || dw != w || dh != h) return false;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            const uint8_t *d = &rgba[((size_t)(h - 1 - y) * w + x) * 4], *s = &src[((size_t)y * w + x) * 4];
+            if (d[0] != s[2] || d[1] != s[1] || d[2] != s[0]) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int bench_archive(int argc, char **argv) {
+    // Even sizes so the source frame is also the stored (padded) frame
+    const int w = FrameCapture::padded((int)bench_int_arg(argc, argv, "--width", 1920));
+    const int h = FrameCapture::padded((int)bench_int_arg(argc, argv, "--height", 1080));
+    const long frames = bench_int_arg(argc, argv, "--frames", 240);
+    const int threads = (int)bench_int_arg(argc, argv, "--threads", 2);
+    if (w <= 0 || h <= 0 || frames <= 0) { std::printf("bad size\n"); return 2; }
+
+    // Flat areas with some texture: QOI shrinks it, raw and BMP do not care
+    std::vector<uint8_t> src((size_t)w * (size_t)h * 4);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            uint8_t *p = &src[((size_t)y * w + x) * 4];
+            const bool edge = ((x / 64) ^ (y / 48)) & 1;
+            p[0] = edge ? 40 : (uint8_t)(x >> 3); p[1] = edge ? 200 : 20; p[2] = (uint8_t)(y >> 2); p[3] = 0;
+        }
+    }
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "pong_bench_archive";
+    const Pass passes[] = {
+        { "bmp files", CaptureFormat::Bmp, ArchiveCodec::RawBgra },
+        { "archive raw", CaptureFormat::Archive, ArchiveCodec::RawBgra },
+        { "archive qoi", CaptureFormat::Archive, ArchiveCodec::Qoi },
+    };
+
+    std::printf("%dx%d, %ld frames, %d writer threads, %.1f MB/frame raw\n", w, h, frames, threads,
+                (double)src.size() / 1e6);
+    std::printf("%-12s %9s %9s %11s %9s %9s %8s\n", "path", "MB/s", "fps", "write ms/f", "stall ms", "direct", "readback");
+    bool ok_all = true;
+    for (const Pass &p : passes) {
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        FrameCapture capture(threads, threads + 6);
+        CaptureOptions opt;
+        opt.format = p.format;
+        opt.archive_codec = p.codec;
+        opt.dir = dir;
+        std::string err;
+        if (!capture.start(opt, w, h, err)) { std::printf("%s: %s\n", p.name, err.c_str()); return 1; }
+        const double t0 = bench_now_ms();
+        for (long i = 0; i < frames; ++i) {
+            CaptureFrame *f = capture.acquire();
+            std::memcpy(f->pixels, src.data(), src.size());
+            f->width = w; f->height = h;
+            capture.submit(f);
+        }
+        capture.finish();
+        const double s = (bench_now_ms() - t0) / 1000.0;
+        const CaptureStats cs = capture.stats();
+        const bool archive = p.format == CaptureFormat::Archive;
+        const bool ok = cs.failed == 0 && (!archive || check_archive(dir / "recording.pfa", p.codec, src, w, h, frames));
+        ok_all = ok_all && ok;
+        std::printf("%-12s %9.0f %9.1f %11.2f %9.1f %9s %8s\n", p.name, (double)cs.bytes / s / 1e6, (double)cs.frames / s,
+                    cs.frames ? cs.write_ms / (double)cs.frames : 0.0, cs.stall_ms,
+                    archive ? (cs.direct_io ? "yes" : "no") : "-", ok ? "ok" : "FAILED");
+    }
+    std::filesystem::remove_all(dir);
+    return ok_all ? 0 : 1;
+}
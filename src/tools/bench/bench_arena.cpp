@@ -0,0 +1,45 @@
+/**
+ * @file bench_arena.cpp
+ * @brief GameCore tick cost across arena sizes
+ *
+ * Runs the ObstaclesMulti configuration (moving obstacles + multi-ball)
+ * at the classic 80x24 field and at 10x and 100x larger arenas. Obstacle
+ * count grows with the arena area (one reference pattern per 80x24 tile),
+ * so the interesting number is the cost per entity, which should stay
+ * roughly flat thanks to the chunked collision grid.
+ */
+
+#include "tools/bench/bench.h"
+#include "core/game_core.h"
+#include <cstdio>
+
+int bench_arena(int argc, char **argv) {
+    const long ticks = bench_int_arg(argc, argv, "--ticks", 120);
+    const int sizes[][2] = { {80, 24}, {800, 240}, {8000, 2400} };
+
+    std::printf("%-11s %9s %6s %10s %12s %9s %9s\n",
+                "arena", "obstacles", "balls", "ms/tick", "ns/entity", "chunks", "alloc");
+    for (const auto &sz : sizes) {
+        ArenaConfig arena; arena.width = sz[0]; arena.height = sz[1];
+        GameCore core(arena);
+        core.enable_left_ai(true);
+        core.enable_right_ai(true);
+        core.apply_mode_config(true, true, true, false, false, 1, 5, false, false, true);
+
+        // Warm up so chunk storage is materialized before timing
+        for (int i = 0; i < 10; ++i) core.update(1.0/60.0);
+
+        double t0 = bench_now_ms();
+        for (long i = 0; i < ticks; ++i) core.update(1.0/60.0);
+        double ms = (bench_now_ms() - t0) / (double)(ticks > 0 ? ticks : 1);
+
+        const GameState &gs = core.state();
+        size_t entities = gs.entities.entity_count();
+        char label[32]; std::snprintf(label, sizeof(label), "%dx%d", sz[0], sz[1]);
+        std::printf("%-11s %9zu %6zu %10.3f %12.1f %9zu %9zu\n",
+                    label, gs.entities.obstacles().size(), gs.entities.balls().size(), ms,
+                    ms * 1e6 / (double)entities,
+                    core.broadphase_active_chunks(), core.broadphase_allocated_chunks());
+    }
+    return 0;
+}
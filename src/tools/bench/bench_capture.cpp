@@ -0,0 +1,124 @@
+/**
+ * @file bench_capture.cpp
+ * @brief Recording cost on the game loop: synchronous BMP writes vs FrameCapture
+ *
+ * Both paths write the same even-padded 32 bpp BMP per frame:
+ *  - sync: what pong_win did before FrameCapture — two fresh vectors per
+ *    frame, a padding copy and a buffered std::ofstream write on the loop
+ *  - async: FrameCapture::acquire, one copy into the pooled slot (stands in
+ *    for GetDIBits), submit; writer threads do the rest
+ * Each path runs once as fast as possible (throughput) and once paced at
+ * 60 fps (loop time per frame, the budget being 16.7 ms). Files go to a
+ * temporary directory that is removed afterwards.
+ */
+
+#include "tools/bench/bench.h"
+#include "capture/frame_capture.h"
+#include "core/time_histogram.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct PassResult {
+    double wall_ms = 0.0;       ///< First frame to last byte on disk
+    TimeHistogram loop{10, 20000}; ///< Loop-thread time per frame
+    uint64_t bytes = 0;
+    CaptureStats cap;
+};
+
+void write_sync(const std::filesystem::path &dir, int index, const std::vector<uint8_t> &src, int w, int h) {
+    std::vector<uint8_t> raw((size_t)w * (size_t)h * 4);
+    std::memcpy(raw.data(), src.data(), raw.size());
+    const int pw = FrameCapture::padded(w), ph = FrameCapture::padded(h);
+    std::vector<uint8_t> pixels((size_t)pw * (size_t)ph * 4, 0);
+    for (int y = 0; y < h; ++y) std::memcpy(&pixels[(size_t)y * pw * 4], &raw[(size_t)y * w * 4], (size_t)w * 4);
+    char name[32];
+    std::snprintf(name, sizeof(name), "frame_%06d.bmp", index);
+    std::ofstream ofs(dir / name, std::ios::binary);
+    uint8_t hdr[54] = { 'B', 'M' };
+    const uint32_t data = (uint32_t)pixels.size(), file = 54 + data, off = 54, ihs = 40;
+    std::memcpy(hdr + 2, &file, 4); std::memcpy(hdr + 10, &off, 4); std::memcpy(hdr + 14, &ihs, 4);
+    std::memcpy(hdr + 18, &pw, 4); std::memcpy(hdr + 22, &ph, 4);
+    hdr[26] = 1; hdr[28] = 32;
+    std::memcpy(hdr + 34, &data, 4);
+    ofs.write((const char *)hdr, 54);
+    ofs.write((const char *)pixels.data(), (std::streamsize)pixels.size());
+}
+
+PassResult run_pass(bool async, bool paced, const std::filesystem::path &dir, const std::vector<uint8_t> &src,
+                    int w, int h, long frames, int threads) {
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    PassResult r;
+    FrameCapture capture(threads);
+    std::string err;
+    CaptureOptions opt;
+    opt.dir = dir;
+    if (async && !capture.start(opt, w, h, err)) std::printf("capture: %s\n", err.c_str());
+    const double period = 1000.0 / 60.0;
+    const double t0 = bench_now_ms();
+    for (long i = 0; i < frames; ++i) {
+        if (paced) {
+            const double deadline = t0 + (double)i * period;
+            const double now = bench_now_ms();
+            if (now < deadline) std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(deadline - now));
+        }
+        const double f0 = bench_now_ms();
+        if (async) {
+            CaptureFrame *f = capture.acquire();
+            std::memcpy(f->pixels, src.data(), src.size());
+            f->width = w; f->height = h;
+            capture.submit(f);
+        } else {
+            write_sync(dir, (int)i, src, w, h);
+        }
+        r.loop.add_ms(bench_now_ms() - f0);
+    }
+    if (async) {
+        capture.finish();
+        r.cap = capture.stats();
+        r.bytes = r.cap.bytes;
+    } else {
+        r.bytes = (uint64_t)frames * (54 + (uint64_t)FrameCapture::padded(w) * FrameCapture::padded(h) * 4);
+    }
+    r.wall_ms = bench_now_ms() - t0;
+    std::filesystem::remove_all(dir);
+    return r;
+}
+
+void report(const char *name, const PassResult &r, long frames) {
+    const double mb = (double)r.bytes / 1e6;
+    std::printf("%-14s %9.0f %9.1f %9.2f %9.2f %9.2f %9.1f\n", name, mb / (r.wall_ms / 1000.0),
+                (double)frames / (r.wall_ms / 1000.0), r.loop.mean_ms(), r.loop.percentile_ms(0.5),
+                r.loop.percentile_ms(0.99), r.cap.stall_ms);
+}
+
+} // namespace
+
+int bench_capture(int argc, char **argv) {
+    const int w = (int)bench_int_arg(argc, argv, "--width", 1920);
+    const int h = (int)bench_int_arg(argc, argv, "--height", 1080);
+    const long frames = bench_int_arg(argc, argv, "--frames", 60);
+    const int threads = (int)bench_int_arg(argc, argv, "--threads", 2);
+    if (w <= 0 || h <= 0 || frames <= 0) { std::printf("bad size\n"); return 2; }
+
+    // Frame content does not matter for uncompressed BMP; vary it so pages are real
+    std::vector<uint8_t> src((size_t)w * (size_t)h * 4);
+    for (size_t i = 0; i < src.size(); ++i) src[i] = (uint8_t)(i * 2654435761u >> 24);
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "pong_bench_capture";
+
+    std::printf("%dx%d, %ld frames, %d writer threads, %.1f MB/frame\n", w, h, frames, threads,
+                (double)FrameCapture::padded(w) * FrameCapture::padded(h) * 4 / 1e6);
+    std::printf("%-14s %9s %9s %9s %9s %9s %9s\n", "path", "MB/s", "fps", "loop ms", "p50", "p99", "stall ms");
+    report("sync", run_pass(false, false, dir, src, w, h, frames, threads), frames);
+    report("async", run_pass(true, false, dir, src, w, h, frames, threads), frames);
+    report("sync @60", run_pass(false, true, dir, src, w, h, frames, threads), frames);
+    report("async @60", run_pass(true, true, dir, src, w, h, frames, threads), frames);
+    return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file bench_console.cpp
+ * @brief Console frontend output cost: rasterize + diff per frame
+ *
+ * Plays each mode with both AIs at 60 Hz and, every frame, rasterizes the
+ * arena and diff-encodes it the way the console frontend does, once per
+ * output style (ASCII cells, half blocks, braille). Reports the time for
+ * both steps and the bytes a frame puts on the wire (what matters over
+ * SSH) against a full repaint of the same screen.
+ */
+
+#include "tools/bench/bench.h"
+#include "console/hires.h"
+#include "console/screen.h"
+#include "core/game_core.h"
+#include <cstdio>
+#include <string>
+
+int bench_console(int argc, char **argv) {
+    const long frames = bench_int_arg(argc, argv, "--frames", 600);
+    struct Case { const char *name; GameMode mode; int w, h; };
+    const Case cases[] = {
+        { "classic", GameMode::Classic, 80, 24 },
+        { "3enemies", GameMode::ThreeEnemies, 80, 24 },
+        { "obstacles", GameMode::Obstacles, 80, 24 },
+        { "multiball", GameMode::MultiBall, 80, 24 },
+        { "multiball", GameMode::MultiBall, 240, 72 },
+    };
+    struct Style { const char *name; ConsoleStyle style; };
+    const Style styles[] = {
+        { "ascii", ConsoleStyle::Ascii },
+        { "half", ConsoleStyle::HalfBlock },
+        { "braille", ConsoleStyle::Braille },
+    };
+
+    std::printf("%-10s %7s %-8s %8s %11s %11s %12s %12s %10s\n",
+                "mode", "screen", "style", "pixels", "raster ns", "diff ns", "diff B/frm", "full B/frm", "cells/frm");
+    for (const Case &c : cases) {
+        for (const Style &s : styles) {
+            ArenaConfig arena; arena.width = c.w; arena.height = c.h;
+            GameCore core(arena);
+            core.set_mode(c.mode);
+            core.enable_left_ai(true);
+            core.enable_right_ai(true);
+
+            const int sx = style_pixels_x(s.style), sy = style_pixels_y(s.style);
+            ScreenBuffer fb;
+            fb.resize(c.w, c.h);
+            DiffPresenter presenter;
+            PixelBuffer pb;
+            pb.resize(c.w * sx, c.h * sy);
+            ColorScreen cs;
+            cs.resize(c.w, c.h);
+            ColorDiffPresenter color_presenter;
+            std::string out;
+            double raster_ms = 0.0, diff_ms = 0.0;
+            size_t diff_bytes = 0, full_bytes = 0, changed = 0;
+            for (long f = 0; f < frames; ++f) {
+                core.update(1.0/60.0);
+                const GameState &gs = core.state();
+                double t0 = bench_now_ms();
+                if (s.style == ConsoleStyle::Ascii) {
+                    fb.clear();
+                    draw_arena(gs, fb);
+                } else {
+                    draw_arena_pixels(gs, pb, sx, sy);
+                    if (s.style == ConsoleStyle::Braille) pack_braille(pb, kArenaBackground, cs, c.h);
+                    else pack_half_blocks(pb, cs, c.h);
+                }
+                double t1 = bench_now_ms();
+                out.clear();
+                PresentStats ps = s.style == ConsoleStyle::Ascii ? presenter.encode(fb, out)
+                                                                 : color_presenter.encode(cs, out);
+                double t2 = bench_now_ms();
+                raster_ms += t1 - t0;
+                diff_ms += t2 - t1;
+                if (ps.full) { full_bytes = ps.bytes; continue; }
+                diff_bytes += ps.bytes;
+                changed += ps.changed;
+            }
+            const double n = (double)(frames > 1 ? frames - 1 : 1);
+            char screen[16]; std::snprintf(screen, sizeof(screen), "%dx%d", c.w, c.h);
+            std::printf("%-10s %7s %-8s %8d %11.0f %11.0f %12.1f %12zu %10.1f\n", c.name, screen, s.name,
+                        c.w * sx * c.h * sy,
+                        raster_ms * 1e6 / (double)frames, diff_ms * 1e6 / (double)frames,
+                        (double)diff_bytes / n, full_bytes, (double)changed / n);
+        }
+    }
+    return 0;
+}
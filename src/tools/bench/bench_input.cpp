@@ -0,0 +1,117 @@
+/**
+ * @file bench_input.cpp
+ * @brief Paddle hit response: frame-quantized vs substep-timed input
+ *
+ * A ball flies into the stationary right paddle while the player presses
+ * "up" once, at a swept time around the hit. Each press is simulated
+ * three ways:
+ *  - reference: 240 Hz frames, so every press lands in its own substep
+ *  - frame: 60 Hz frames with the press applied at the start of the frame
+ *    interval it arrived in (what reading keys once per frame does)
+ *  - substep: 60 Hz frames with the press passed to update() with its
+ *    real timestamp
+ * and the ball's vertical velocity after the hit is compared with the
+ * reference. "Early" counts presses that happened after the hit but still
+ * changed it. The substep run must match the reference (same vy after the
+ * hit, same paddle position, no early presses); the bench exits 1 if it
+ * does not, so it doubles as a regression check.
+ */
+
+#include "tools/bench/bench.h"
+#include "core/game_core.h"
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr double kSimSeconds = 0.5;
+/// Substep and reference runs may differ by rounding only
+constexpr double kTolerance = 1e-6;
+
+/// Outcome of one run: hit time (first vx sign flip), vy just after it and where the paddle ended up
+struct HitResult { double hit_t = -1.0; double vy = 0.0; double paddle_y = 0.0; };
+
+GameCore make_core() {
+    ArenaConfig arena; arena.width = 80; arena.height = 24;
+    GameCore core(arena);
+    core.enable_left_ai(false);
+    core.enable_right_ai(false);
+    GameState &gs = core.state();
+    Archetype &balls = gs.entities.balls();
+    const double paddle_mid = gs.right_y + gs.paddle_h / 2.0;
+    balls.position[0] = { 70.0, paddle_mid + 0.7 };
+    balls.velocity[0] = { 40.0, 0.0 };
+    return core;
+}
+
+/// press_t < 0: no press. quantize: stamp the press at its frame interval start.
+HitResult simulate(double frame_dt, double press_t, bool quantize) {
+    GameCore core = make_core();
+    HitResult r;
+    PaddleCommand press;
+    press.side = PaddleSide::Right;
+    press.kind = PaddleCommandKind::MoveBy;
+    press.value = -1.5;
+    bool pressed = press_t < 0.0;
+    const long frames = std::lround(kSimSeconds / frame_dt);
+    for (long f = 0; f < frames; ++f) {
+        const double t0 = (double)f * frame_dt;
+        const int64_t start_ns = (int64_t)std::llround(t0 * 1e9);
+        size_t n = 0;
+        if (!pressed && press_t < t0 + frame_dt) {
+            press.sent_ns = quantize ? start_ns : (int64_t)std::llround(press_t * 1e9);
+            n = 1;
+            pressed = true;
+        }
+        const double vx0 = core.state().entities.balls().velocity[0].vx;
+        core.update(frame_dt, &press, n, start_ns);
+        const Velocity &v = core.state().entities.balls().velocity[0];
+        if (r.hit_t < 0.0 && vx0 > 0.0 && v.vx < 0.0) r.hit_t = t0 + frame_dt;
+        if (r.hit_t >= 0.0 && t0 + frame_dt >= r.hit_t + 0.05) {
+            r.vy = v.vy;
+            r.paddle_y = core.state().right_y;
+            break;
+        }
+    }
+    return r;
+}
+
+} // namespace
+
+int bench_input(int argc, char **argv) {
+    const long presses = bench_int_arg(argc, argv, "--presses", 120);
+    const HitResult base = simulate(1.0 / 240.0, -1.0, false);
+    if (base.hit_t < 0.0) { std::printf("setup error: ball never reached the paddle\n"); return 1; }
+
+    // Sweep the press from 40 ms before to 20 ms after the (240 Hz) hit frame
+    double err_frame = 0.0, err_sub = 0.0, max_frame = 0.0, max_sub = 0.0;
+    long early_frame = 0, early_sub = 0, after = 0, diverged = 0;
+    for (long i = 0; i < presses; ++i) {
+        const double press_t = base.hit_t - 0.040 + 0.060 * (double)i / (double)presses;
+        const HitResult ref = simulate(1.0 / 240.0, press_t, false);
+        const HitResult fq = simulate(1.0 / 60.0, press_t, true);
+        const HitResult ss = simulate(1.0 / 60.0, press_t, false);
+        const double ef = std::abs(fq.vy - ref.vy), es = std::abs(ss.vy - ref.vy);
+        err_frame += ef; err_sub += es;
+        max_frame = std::max(max_frame, ef); max_sub = std::max(max_sub, es);
+        if (es > kTolerance || std::abs(ss.paddle_y - ref.paddle_y) > kTolerance) {
+            if (diverged++ == 0)
+                std::printf("press at %.1f ms: substep vy %.3f, paddle %.3f; reference vy %.3f, paddle %.3f\n",
+                            press_t * 1000.0, ss.vy, ss.paddle_y, ref.vy, ref.paddle_y);
+        }
+        // A press after the hit must not change it
+        if (press_t >= base.hit_t) {
+            ++after;
+            if (std::abs(fq.vy - base.vy) > 1e-9) ++early_frame;
+            if (std::abs(ss.vy - base.vy) > 1e-9) ++early_sub;
+        }
+    }
+    const double n = (double)(presses > 0 ? presses : 1);
+    std::printf("ball vy after hit, no press: %.3f (hit at %.1f ms)\n", base.vy, base.hit_t * 1000.0);
+    std::printf("%-9s %14s %14s %14s\n", "input", "mean |dvy|", "max |dvy|", "early");
+    std::printf("%-9s %14.3f %14.3f %9ld/%ld\n", "frame", err_frame / n, max_frame, early_frame, after);
+    std::printf("%-9s %14.3f %14.3f %9ld/%ld\n", "substep", err_sub / n, max_sub, early_sub, after);
+    const bool ok = diverged == 0 && early_sub == 0;
+    std::printf("substep vs reference: %s (%ld of %ld presses diverged)\n", ok ? "ok" : "MISMATCH", diverged, presses);
+    return ok ? 0 : 1;
+}
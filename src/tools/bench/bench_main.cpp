@@ -0,0 +1,56 @@
+/**
+ * @file bench_main.cpp
+ * @brief Entry point of the pong_bench benchmark driver
+ *
+ * Usage:
+ *   pong_bench                 # list benchmarks
+ *   pong_bench <name> [args]   # run one benchmark
+ *   pong_bench all             # run every benchmark with default arguments
+ */
+
+#include "tools/bench/bench.h"
+#include <cstdio>
+#include <cstring>
+
+static const BenchCase kCases[] = {
+    { "arena", "GameCore tick cost at 80x24, 800x240 and 8000x2400 (--ticks N)", bench_arena },
+    { "console", "Console frame raster + diff cost and bytes per frame (--frames N)", bench_console },
+    { "input", "Paddle hit response, frame-quantized vs substep-timed input (--presses N)", bench_input },
+    { "capture", "Recording write cost on the loop, sync BMP vs FrameCapture (--width --height --frames --threads)", bench_capture },
+    { "yuv", "BGRA->yuv420p conversion GB/s (scalar vs SIMD) and Y4M stream throughput (--width --height --reps --frames)", bench_yuv },
+    { "qoi", "Lossless QOI recording: ratio, encode ms/frame per thread count (--width --height --frames --noise)", bench_qoi },
+    { "archive", "Recording MB/s, per-file BMP vs single-file frame archive (--width --height --frames --threads)", bench_archive },
+    { "raster", "Classic-look CPU rasterizer fps per thread count and render + archive (--width --height --frames)", bench_raster },
+    { "text", "Glyph-atlas HUD text cost per frame, cached vs recomposed lines (--frames --height)", bench_text },
+    { "settings", "Settings load, schema-table tokenizer vs per-key find, with N unknown keys (--unknown N)", bench_settings },
+    { "scores", "High-score log: submission cost vs table rewrite, queries over millions of entries (--entries --submits)", bench_scores },
+    { "telemetry", "Columnar match telemetry: bytes/event, decode and SIMD filter speed, pruned queries (--matches --rows)", bench_telemetry },
+#ifndef _WIN32
+    { "shm", "Shared-memory GameState export latency (--frames N --interval-us N)", bench_shm },
+    { "metrics", "Metrics endpoint: lock-free vs mutex update rate while scraped, per-frame feed cost (--threads --updates --frames)", bench_metrics },
+#endif
+};
+
+static void list_cases() {
+    std::printf("usage: pong_bench <benchmark> [options] | all\n\n");
+    for (const BenchCase &c : kCases) std::printf("  %-12s %s\n", c.name, c.summary);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) { list_cases(); return 0; }
+    if (std::strcmp(argv[1], "all") == 0) {
+        int rc = 0;
+        for (const BenchCase &c : kCases) {
+            std::printf("== %s ==\n", c.name);
+            rc |= c.run(0, argv + argc);
+            std::printf("\n");
+        }
+        return rc;
+    }
+    for (const BenchCase &c : kCases) {
+        if (std::strcmp(argv[1], c.name) == 0) return c.run(argc - 2, argv + 2);
+    }
+    std::fprintf(stderr, "unknown benchmark '%s'\n\n", argv[1]);
+    list_cases();
+    return 2;
+}
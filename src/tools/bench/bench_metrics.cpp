@@ -0,0 +1,203 @@
+/**
+ * @file bench_metrics.cpp
+ * @brief Metrics endpoint: update cost with and without scrapes, scrape latency (POSIX)
+ *
+ * --threads threads each record --updates counter increments and
+ * histogram observations, first with no one reading, then while a client
+ * scrapes http://127.0.0.1/metrics back to back. The same runs are
+ * repeated against a mutex-guarded registry whose scrape holds the lock
+ * while formatting, the design the lock-free slots replace. Finally a
+ * game loop runs GameCore with GameMetrics attached under continuous
+ * scraping and reports what feeding the metrics cost each frame.
+ */
+
+#include "tools/bench/bench.h"
+#ifndef _WIN32
+#include "metrics/game_metrics.h"
+#include "metrics/metrics_server.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/// One GET /metrics; returns the body size or -1
+long scrape(uint16_t port, std::string &buf) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in a{};
+    a.sin_family = AF_INET;
+    a.sin_port = htons(port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    static const char kReq[] = "GET /metrics HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+    long body = -1;
+    if (connect(fd, (sockaddr *)&a, sizeof(a)) == 0 && send(fd, kReq, sizeof(kReq) - 1, MSG_NOSIGNAL) > 0) {
+        buf.clear();
+        char chunk[16384];
+        ssize_t n;
+        while ((n = recv(fd, chunk, sizeof(chunk), 0)) > 0) buf.append(chunk, (size_t)n);
+        const size_t head = buf.find("\r\n\r\n");
+        if (buf.compare(0, 12, "HTTP/1.1 200") == 0 && head != std::string::npos) body = (long)(buf.size() - head - 4);
+    }
+    close(fd);
+    return body;
+}
+
+/// The design being replaced: one lock around the values, held by updates and by the whole scrape
+struct LockedMetrics {
+    std::mutex mtx;
+    uint64_t count = 0;
+    std::vector<uint64_t> buckets = std::vector<uint64_t>(13, 0);
+    double sum = 0.0;
+    void update(double x) {
+        std::lock_guard<std::mutex> lk(mtx);
+        ++count;
+        size_t b = 0;
+        while (b < 12 && x > 0.001 * (double)(1u << b)) ++b;
+        ++buckets[b];
+        sum += x;
+    }
+    void render(std::string &out) {
+        std::lock_guard<std::mutex> lk(mtx);
+        out.clear();
+        char line[96];
+        // Roughly the size of the game's exposition, formatted under the lock
+        for (int rep = 0; rep < 16; ++rep) {
+            uint64_t cum = 0;
+            for (size_t b = 0; b < buckets.size(); ++b) {
+                cum += buckets[b];
+                std::snprintf(line, sizeof(line), "pong_x_bucket{le=\"%g\"} %llu\n", 0.001 * (double)(1u << b), (unsigned long long)cum);
+                out += line;
+            }
+        }
+    }
+};
+
+struct RunResult {
+    double mups = 0.0;        ///< Million updates per second, all threads
+    uint64_t scrapes = 0;
+    std::vector<double> scrape_ms;
+};
+
+double pct(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, (size_t)(p * (double)v.size()))];
+}
+
+/// @p update(thread, i) from @p threads threads; @p scrape_once() in a loop meanwhile when set
+template <class Update, class Scrape>
+RunResult run(int threads, long updates, Update update, Scrape scrape_once, bool scraping) {
+    RunResult r;
+    std::atomic<bool> done{false};
+    std::thread scraper;
+    if (scraping) {
+        scraper = std::thread([&] {
+            while (!done.load()) {
+                const double t0 = bench_now_ms();
+                if (scrape_once()) {
+                    r.scrape_ms.push_back(bench_now_ms() - t0);
+                    ++r.scrapes;
+                }
+            }
+        });
+    }
+    const double t0 = bench_now_ms();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] { for (long i = 0; i < updates; ++i) update(t, i); });
+    }
+    for (std::thread &th : pool) th.join();
+    const double ms = bench_now_ms() - t0;
+    done.store(true);
+    if (scraper.joinable()) scraper.join();
+    r.mups = (double)threads * (double)updates / ms / 1e3;
+    return r;
+}
+
+} // namespace
+
+int bench_metrics(int argc, char **argv) {
+    const int threads = (int)bench_int_arg(argc, argv, "--threads", 4);
+    const long updates = bench_int_arg(argc, argv, "--updates", 2000000);
+    const long frames = bench_int_arg(argc, argv, "--frames", 20000);
+    if (threads <= 0 || updates <= 0 || frames <= 0) { std::fprintf(stderr, "bad options\n"); return 2; }
+
+    MetricsRegistry reg;
+    GameMetrics game(reg);
+    MetricCounter &counter = reg.counter("bench_updates_total", "Updates made by the bench threads");
+    MetricHistogram &hist = reg.histogram("bench_value_seconds", "Values observed by the bench threads",
+                                          { 0.001, 0.002, 0.004, 0.008, 0.016, 0.032, 0.064, 0.128, 0.256, 0.512, 1.0, 2.0 });
+    MetricsServer server(reg);
+    std::string err;
+    if (!server.start(0, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    std::string body;
+    auto http = [&] { return scrape(server.port(), body) > 0; };
+    auto sample = [](int t, long i) { return 0.0005 * (double)((i * 7 + t) % 4096); };
+    auto lockfree = [&](int t, long i) { counter.add(); hist.observe(sample(t, i)); };
+
+    std::printf("%d threads x %ld updates (counter + histogram), http://127.0.0.1:%u/metrics\n", threads, updates, server.port());
+    const RunResult quiet = run(threads, updates, lockfree, http, false);
+    const RunResult scraped = run(threads, updates, lockfree, http, true);
+    std::vector<uint64_t> counts;
+    uint64_t hist_count = 0;
+    double hist_sum = 0.0;
+    hist.read(counts, hist_count, hist_sum);
+    const uint64_t expect = 2ull * (uint64_t)threads * (uint64_t)updates;
+    const bool exact = counter.value() == expect && hist_count == expect;
+    std::printf("lock-free  %.0f M updates/s idle, %.0f M/s while scraped (%llu scrapes, p50 %.3f ms, p99 %.3f ms, %zu B)\n",
+                quiet.mups, scraped.mups, (unsigned long long)scraped.scrapes, pct(scraped.scrape_ms, 0.5),
+                pct(scraped.scrape_ms, 0.99), body.size());
+    std::printf("           totals %s (%llu counted, %llu observed, expected %llu)\n", exact ? "exact" : "WRONG",
+                (unsigned long long)counter.value(), (unsigned long long)hist_count, (unsigned long long)expect);
+
+    LockedMetrics locked;
+    std::string locked_out;
+    auto locked_update = [&](int t, long i) { locked.update(sample(t, i)); };
+    auto locked_scrape = [&] { locked.render(locked_out); return true; };
+    const RunResult lq = run(threads, updates, locked_update, locked_scrape, false);
+    const RunResult ls = run(threads, updates, locked_update, locked_scrape, true);
+    std::printf("mutex      %.0f M updates/s idle, %.0f M/s while scraped (%llu scrapes)\n", lq.mups, ls.mups,
+                (unsigned long long)ls.scrapes);
+
+    // Game loop: GameCore + GameMetrics feed under continuous scraping
+    GameCore core;
+    core.set_mode(GameMode::MultiBall);
+    core.enable_left_ai(true);
+    core.enable_right_ai(true);
+    core.set_event_sink(&game);
+    std::atomic<bool> done{false};
+    uint64_t loop_scrapes = 0;
+    std::thread scraper([&] { std::string b; while (!done.load()) loop_scrapes += scrape(server.port(), b) > 0; });
+    std::vector<double> feed_us;
+    feed_us.reserve((size_t)frames);
+    for (long f = 0; f < frames; ++f) {
+        core.update(1.0 / 60.0);
+        const double t0 = bench_now_ms();
+        game.frame(1.0 / 60.0, 0.002, 0);
+        game.state(core.state());
+        feed_us.push_back((bench_now_ms() - t0) * 1e3);
+    }
+    done.store(true);
+    scraper.join();
+    core.set_event_sink(nullptr);
+    scrape(server.port(), body);
+    const bool served = body.find("pong_frames_total " + std::to_string(frames)) != std::string::npos &&
+                        body.find("pong_paddle_hits_total{side=\"left\"}") != std::string::npos;
+    std::printf("game loop  %ld frames, metrics feed p50 %.2f us, p99 %.2f us, max %.1f us (%llu scrapes meanwhile), exposition %s\n",
+                frames, pct(feed_us, 0.5), pct(feed_us, 0.99), pct(feed_us, 1.0), (unsigned long long)loop_scrapes,
+                served ? "ok" : "MISSING SERIES");
+    server.stop();
+    return exact && served ? 0 : 1;
+}
+
+#endif
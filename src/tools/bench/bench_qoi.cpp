@@ -0,0 +1,133 @@
+/**
+ * @file bench_qoi.cpp
+ * @brief Lossless QOI recording: compression ratio, encode time, threads
+ *
+ * Frames are real game frames: a GameCore is stepped at 60 Hz and drawn
+ * with draw_arena_pixels scaled to the requested size (flat colours like
+ * the classic GDI renderer). --noise adds per-pixel grain of that
+ * amplitude to approximate the path tracer's output, which compresses
+ * much worse. Each thread count records the same frames through
+ * FrameCapture in QOI mode; the first file is decoded and compared with
+ * the source to check the round trip.
+ */
+
+#include "tools/bench/bench.h"
+#include "capture/frame_capture.h"
+#include "capture/qoi.h"
+#include "console/hires.h"
+#include "core/game_core.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// Game frames as bottom-up BGRA (what GetDIBits hands the recorder)
+std::vector<std::vector<uint8_t>> make_frames(int w, int h, long count, int noise) {
+    GameCore core;
+    core.enable_left_ai(true);
+    core.enable_right_ai(true);
+    const GameState &gs = core.state();
+    const int sx = std::max(1, w / gs.gw), sy = std::max(1, h / gs.gh);
+    PixelBuffer pb;
+    pb.resize(w, h);
+    uint32_t seed = 12345;
+    std::vector<std::vector<uint8_t>> frames((size_t)count);
+    for (long i = 0; i < count; ++i) {
+        core.update(1.0 / 60.0);
+        draw_arena_pixels(gs, pb, sx, sy);
+        std::vector<uint8_t> &f = frames[(size_t)i];
+        f.resize((size_t)w * (size_t)h * 4);
+        for (int y = 0; y < h; ++y) {
+            const Rgb *src = pb.row(h - 1 - y);
+            uint8_t *dst = f.data() + (size_t)y * (size_t)w * 4;
+            for (int x = 0; x < w; ++x) {
+                int c[3] = { (int)(src[x] & 0xFF), (int)(src[x] >> 8 & 0xFF), (int)(src[x] >> 16 & 0xFF) };
+                if (noise > 0) {
+                    for (int &v : c) {
+                        seed = seed * 1664525u + 1013904223u;
+                        v = std::clamp(v + (int)(seed >> 24) % (2 * noise + 1) - noise, 0, 255);
+                    }
+                }
+                dst[x * 4] = (uint8_t)c[0]; dst[x * 4 + 1] = (uint8_t)c[1]; dst[x * 4 + 2] = (uint8_t)c[2]; dst[x * 4 + 3] = 0;
+            }
+        }
+    }
+    return frames;
+}
+
+/// Decoded (top-down RGBA) image equals the padded bottom-up BGRA source
+bool same_image(const std::vector<uint8_t> &rgba, const std::vector<uint8_t> &bgra, int w, int h) {
+    const int pw = FrameCapture::padded(w), ph = FrameCapture::padded(h);
+    for (int y = 0; y < ph; ++y) {
+        const int sy = ph - 1 - y;  // row in the bottom-up source; sy == h is the padding row
+        for (int x = 0; x < pw; ++x) {
+            const uint8_t *d = &rgba[((size_t)y * pw + x) * 4];
+            uint8_t r = 0, g = 0, b = 0;
+            if (sy < h && x < w) { const uint8_t *s = &bgra[((size_t)sy * w + x) * 4]; b = s[0]; g = s[1]; r = s[2]; }
+            if (d[0] != r || d[1] != g || d[2] != b || d[3] != 255) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int bench_qoi(int argc, char **argv) {
+    const int w = (int)bench_int_arg(argc, argv, "--width", 1920);
+    const int h = (int)bench_int_arg(argc, argv, "--height", 1080);
+    const long frames = bench_int_arg(argc, argv, "--frames", 60);
+    const int noise = (int)bench_int_arg(argc, argv, "--noise", 0);
+    if (w <= 0 || h <= 0 || frames <= 0) { std::printf("bad size\n"); return 2; }
+
+    const std::vector<std::vector<uint8_t>> src = make_frames(w, h, frames, noise);
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "pong_bench_qoi";
+    const int hw = std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<int> thread_counts = { 1, 2, 4, hw };
+    std::sort(thread_counts.begin(), thread_counts.end());
+    thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()), thread_counts.end());
+
+    std::printf("%dx%d game frames, %ld frames, noise %d, %d hardware threads\n", w, h, frames, noise, hw);
+    std::printf("%-8s %9s %12s %10s %10s %10s\n", "threads", "ratio", "encode ms/f", "fps", "MB/frame", "roundtrip");
+    bool ok_all = true;
+    for (int threads : thread_counts) {
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        FrameCapture capture(threads, threads + 6);
+        CaptureOptions opt;
+        opt.format = CaptureFormat::Qoi;
+        opt.dir = dir;
+        std::string err;
+        if (!capture.start(opt, w, h, err)) { std::printf("qoi: %s\n", err.c_str()); return 1; }
+        const double t0 = bench_now_ms();
+        for (const std::vector<uint8_t> &f : src) {
+            CaptureFrame *slot = capture.acquire();
+            std::memcpy(slot->pixels, f.data(), f.size());
+            slot->width = w; slot->height = h;
+            capture.submit(slot);
+        }
+        capture.finish();
+        const double s = (bench_now_ms() - t0) / 1000.0;
+        const CaptureStats cs = capture.stats();
+
+        std::ifstream in(dir / "frame_000000.qoi", std::ios::binary);
+        const std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::vector<uint8_t> rgba;
+        int dw = 0, dh = 0;
+        const bool ok = qoi_decode(file.data(), file.size(), dw, dh, rgba) &&
+                        dw == FrameCapture::padded(w) && dh == FrameCapture::padded(h) && same_image(rgba, src[0], w, h);
+        ok_all = ok_all && ok;
+        std::printf("%-8d %8.1f:1 %12.2f %10.1f %10.3f %10s\n", threads,
+                    cs.bytes ? (double)cs.raw_bytes / (double)cs.bytes : 0.0,
+                    cs.frames ? cs.encode_ms / (double)cs.frames : 0.0, (double)cs.frames / s,
+                    cs.frames ? (double)cs.bytes / (double)cs.frames / 1e6 : 0.0, ok ? "ok" : "MISMATCH");
+    }
+    std::filesystem::remove_all(dir);
+    return ok_all ? 0 : 1;
+}
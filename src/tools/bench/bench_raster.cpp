@@ -0,0 +1,115 @@
+/**
+ * @file bench_raster.cpp
+ * @brief Classic-look CPU rasterizer: fps per thread count and render + capture
+ *
+ * Plays an ObstaclesMulti match (obstacles, multi-ball) and draws each
+ * tick with ClassicRaster at the given size, once per tile-worker count,
+ * reporting frames per second and the scalar vs SIMD span fill rate.
+ * The last run draws straight into FrameCapture slots (bottom-up, through
+ * a negative stride) recording a raw frame archive, which is the cost of
+ * a headless classic-look recording end to end.
+ */
+
+#include "tools/bench/bench.h"
+#include "capture/frame_capture.h"
+#include "core/game_core.h"
+#include "raster/classic_raster.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void start_match(GameCore &core) {
+    core.enable_left_ai(true);
+    core.enable_right_ai(true);
+    core.apply_mode_config(true, true, true, false, false, 1, 5, false, false, true);
+}
+
+/// Span fill rate in GB/s of written pixels
+double fill_gbps(bool simd, std::vector<uint32_t> &px, long reps) {
+    const double t0 = bench_now_ms();
+    for (long i = 0; i < reps; ++i) {
+        if (simd) {
+            raster_fill_span(px.data(), (int)px.size(), (uint32_t)i);
+        } else {
+            volatile uint32_t *p = px.data();  // keeps the compiler from vectorizing the reference loop
+            for (size_t k = 0; k < px.size(); ++k) p[k] = (uint32_t)i;
+        }
+    }
+    const double s = (bench_now_ms() - t0) / 1000.0;
+    return (double)px.size() * 4.0 * (double)reps / s / 1e9;
+}
+
+} // namespace
+
+int bench_raster(int argc, char **argv) {
+    const int w = (int)bench_int_arg(argc, argv, "--width", 1920);
+    const int h = (int)bench_int_arg(argc, argv, "--height", 1080);
+    const long frames = bench_int_arg(argc, argv, "--frames", 600);
+    if (w <= 0 || h <= 0 || frames <= 0) { std::printf("bad size\n"); return 2; }
+
+    std::vector<uint32_t> row((size_t)w * 64);
+    const double scalar = fill_gbps(false, row, 2000), simd = fill_gbps(true, row, 2000);
+    std::printf("span fill: scalar %.1f GB/s, %s %.1f GB/s (%.1fx)\n", scalar, raster_simd_path(), simd, simd / scalar);
+
+    const int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> counts = { 1, 2, 4, hw };
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+
+    std::vector<uint32_t> fb((size_t)w * (size_t)h);
+    const RasterTarget target{ fb.data(), w, h, w };
+    std::printf("%dx%d, %ld frames, %d hardware threads\n", w, h, frames, hw);
+    std::printf("%-8s %6s %10s %10s\n", "threads", "prims", "fps", "ms/frame");
+    for (int t : counts) {
+        GameCore core;
+        start_match(core);
+        ClassicRaster raster(t);
+        double ms = 0.0;
+        for (long i = 0; i < frames; ++i) {
+            core.update(1.0 / 60.0);
+            const double t0 = bench_now_ms();
+            raster.render(core.state(), target);
+            ms += bench_now_ms() - t0;
+        }
+        std::printf("%-8d %6zu %10.0f %10.3f\n", t, raster.prims().size(), (double)frames * 1000.0 / ms, ms / (double)frames);
+    }
+
+    // Render + record: draw upright into the bottom-up slot, archive writers do the I/O
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "pong_bench_raster";
+    std::filesystem::create_directories(dir);
+    bool ok = true;
+    {
+        FrameCapture capture(2);
+        CaptureOptions opt;
+        opt.format = CaptureFormat::Archive;
+        opt.dir = dir;
+        std::string err;
+        if (!capture.start(opt, w, h, err)) { std::printf("archive: %s\n", err.c_str()); return 1; }
+        GameCore core;
+        start_match(core);
+        ClassicRaster raster(hw);
+        const double t0 = bench_now_ms();
+        for (long i = 0; i < frames; ++i) {
+            core.update(1.0 / 60.0);
+            CaptureFrame *f = capture.acquire();
+            uint32_t *bottom_up = reinterpret_cast<uint32_t *>(f->pixels);
+            raster.render(core.state(), RasterTarget{ bottom_up + (ptrdiff_t)(h - 1) * w, w, h, -(ptrdiff_t)w });
+            f->width = w; f->height = h;
+            capture.submit(f);
+        }
+        capture.finish();
+        const double s = (bench_now_ms() - t0) / 1000.0;
+        const CaptureStats cs = capture.stats();
+        ok = cs.failed == 0;
+        std::printf("render + archive: %llu frames, %.0f fps, %.0f MB/s, %llu stalls%s\n",
+                    (unsigned long long)cs.frames, (double)cs.frames / s, (double)cs.bytes / s / 1e6,
+                    (unsigned long long)cs.stalls, ok ? "" : ", FAILED");
+    }
+    std::filesystem::remove_all(dir);
+    return ok ? 0 : 1;
+}
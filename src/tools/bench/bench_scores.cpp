@@ -0,0 +1,192 @@
+/**
+ * @file bench_scores.cpp
+ * @brief High-score log: per-submission cost vs rewriting the table, and scale to millions
+ *
+ * "rewrite" repeats what HighScores did before the score log: read the
+ * JSON table, parse it, add the score, sort, trim to ten and write the
+ * whole file back, once per submission. "log" is one appended record,
+ * with and without an fsync per record. The bulk part fills a ScoreBoard
+ * with --entries random scores and times top-10, rank and page queries,
+ * a reopen (full replay), deleting most entries (which triggers
+ * compaction) and recovery from a torn final record. Last it checks that
+ * ids freed before a compaction are not reused after a reopen and that
+ * long names are cut on a UTF-8 boundary.
+ */
+
+#include "tools/bench/bench.h"
+#include "scores/score_board.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct LegacyEntry { std::string name; int score; };
+
+/// HighScores::add_and_get before the score log, minus the wide-string conversions
+void legacy_add(const std::filesystem::path &path, const std::string &name, int score) {
+    std::vector<LegacyEntry> list;
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        std::string line;
+        while (std::getline(ifs, line)) {
+            size_t npos = line.find("\"name\""), spos = line.find("\"score\"");
+            if (npos == std::string::npos || spos == std::string::npos) continue;
+            size_t q1 = line.find('"', npos + 6), q2 = line.find('"', q1 + 1);
+            if (q1 == std::string::npos || q2 == std::string::npos) continue;
+            list.push_back({ line.substr(q1 + 1, q2 - q1 - 1), std::atoi(line.c_str() + line.find(':', spos) + 1) });
+        }
+    }
+    list.push_back({ name, score });
+    std::sort(list.begin(), list.end(), [](const LegacyEntry &a, const LegacyEntry &b) { return a.score > b.score; });
+    if (list.size() > 10) list.resize(10);
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs << "[\n";
+    for (size_t i = 0; i < list.size(); ++i)
+        ofs << "  {\"name\":\"" << list[i].name << "\",\"score\":" << list[i].score << "}" << (i + 1 < list.size() ? ",\n" : "\n");
+    ofs << "]\n";
+}
+
+std::string player(uint64_t i) { return "Player " + std::to_string(i % 5000); }
+
+} // namespace
+
+int bench_scores(int argc, char **argv) {
+    const long entries = bench_int_arg(argc, argv, "--entries", 1000000);
+    const long submits = bench_int_arg(argc, argv, "--submits", 1000);
+    if (entries <= 0 || submits <= 0) { std::printf("bad arguments\n"); return 2; }
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "pong_bench_scores";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(0, 100000);
+    bool ok = true;
+
+    // Per-submission cost as the game sees it
+    std::printf("%-22s %12s\n", "submission", "us each");
+    {
+        const double t0 = bench_now_ms();
+        for (long i = 0; i < submits; ++i) legacy_add(dir / "legacy.json", player((uint64_t)i), dist(rng));
+        std::printf("%-22s %12.1f\n", "rewrite table", (bench_now_ms() - t0) * 1000.0 / (double)submits);
+    }
+    for (int durable = 1; durable >= 0; --durable) {
+        ScoreBoard board;
+        std::string err;
+        if (!board.open(dir / (durable ? "durable.log" : "buffered.log"), err)) { std::printf("%s\n", err.c_str()); return 1; }
+        board.storage().set_durable(durable != 0);
+        const double t0 = bench_now_ms();
+        for (long i = 0; i < submits; ++i) ok = board.submit(player((uint64_t)i), dist(rng)) != 0 && ok;
+        std::printf("%-22s %12.1f\n", durable ? "log append + fsync" : "log append", (bench_now_ms() - t0) * 1000.0 / (double)submits);
+    }
+
+    // Scale: a shared board with millions of entries
+    const std::filesystem::path path = dir / "board.log";
+    std::vector<ScoreEntry> best;
+    {
+        ScoreBoard board;
+        std::string err;
+        if (!board.open(path, err)) { std::printf("%s\n", err.c_str()); return 1; }
+        board.storage().set_durable(false);
+        double t0 = bench_now_ms();
+        for (long i = 0; i < entries; ++i) board.submit(player((uint64_t)i), dist(rng));
+        board.storage().flush(true);
+        const double fill = bench_now_ms() - t0;
+        std::printf("\n%ld entries: %.0f submits/s, log %.1f MB\n", entries, (double)entries * 1000.0 / fill,
+                    (double)board.storage().bytes() / 1e6);
+
+        const int q = 100000;
+        t0 = bench_now_ms();
+        size_t sink = 0;
+        for (int i = 0; i < q; ++i) sink += board.top(10).size();
+        const double top_us = (bench_now_ms() - t0) * 1000.0 / q;
+        t0 = bench_now_ms();
+        for (int i = 0; i < q; ++i) sink += board.rank_of_score(dist(rng));
+        const double rank_us = (bench_now_ms() - t0) * 1000.0 / q;
+        t0 = bench_now_ms();
+        for (int i = 0; i < q; ++i) sink += board.rank_of((uint64_t)(rng() % (uint32_t)entries) + 1);
+        const double rank_id_us = (bench_now_ms() - t0) * 1000.0 / q;
+        t0 = bench_now_ms();
+        for (int i = 0; i < q; ++i) sink += board.page((size_t)(rng() % (uint32_t)entries), 10).size();
+        const double page_us = (bench_now_ms() - t0) * 1000.0 / q;
+        std::printf("top 10 %.2f us, rank of score %.2f us, rank of entry %.2f us, page of 10 %.2f us (%zu)\n",
+                    top_us, rank_us, rank_id_us, page_us, sink % 10);
+
+        // The heap answers top(10); the index must agree
+        best = board.top(10);
+        const std::vector<ScoreEntry> paged = board.page(0, 10);
+        for (size_t i = 0; i < best.size(); ++i) ok = ok && best[i].id == paged[i].id && board.rank_of(best[i].id) == i + 1;
+    }
+    {
+        ScoreBoard board;
+        std::string err;
+        const double t0 = bench_now_ms();
+        if (!board.open(path, err)) { std::printf("%s\n", err.c_str()); return 1; }
+        const double replay = bench_now_ms() - t0;
+        const std::vector<ScoreEntry> again = board.top(10);
+        bool same = board.size() == (size_t)entries && again.size() == best.size();
+        for (size_t i = 0; same && i < again.size(); ++i) same = again[i].id == best[i].id && again[i].name == best[i].name;
+        ok = ok && same;
+        std::printf("reopen: replay %.0f ms, %s\n", replay, same ? "same top 10" : "MISMATCH");
+
+        // Delete 3 of every 4 entries: compaction kicks in once the dead records outweigh the live ones
+        board.storage().set_durable(false);
+        const uint64_t before = board.storage().bytes();
+        const double t1 = bench_now_ms();
+        for (uint64_t id = 1; id <= (uint64_t)entries; ++id)
+            if (id % 4) board.remove(id);
+        const double removed = bench_now_ms() - t1;
+        std::printf("remove 75%%: %.0f ms, log %.1f MB -> %.1f MB (%llu records)\n", removed, (double)before / 1e6,
+                    (double)board.storage().bytes() / 1e6, (unsigned long long)board.storage().records());
+        best = board.top(10);
+    }
+    {
+        // A crash in the middle of an append leaves a partial record; it must be dropped, not misread
+        { std::ofstream torn(path, std::ios::binary | std::ios::app); torn.write("\x20\x00\x00\x00torn", 8); }
+        ScoreBoard board;
+        std::string err;
+        bool same = board.open(path, err) && board.storage().truncated() == 8 && board.size() == (size_t)(entries / 4);
+        const std::vector<ScoreEntry> again = board.top(10);
+        for (size_t i = 0; same && i < again.size(); ++i) same = again[i].id == best[i].id;
+        ok = ok && same;
+        std::printf("torn tail: %llu bytes dropped, %zu entries, %s\n", (unsigned long long)board.storage().truncated(),
+                    board.size(), same ? "ok" : "MISMATCH");
+    }
+    {
+        // Ids of entries removed before a compaction must not be handed out again after a reopen
+        const std::filesystem::path ids = dir / "ids.log";
+        const uint64_t n = 5000;
+        bool fresh = false;
+        {
+            ScoreBoard board;
+            std::string err;
+            if (!board.open(ids, err)) { std::printf("%s\n", err.c_str()); return 1; }
+            board.storage().set_durable(false);
+            for (uint64_t i = 0; i < n; ++i) board.submit(player(i), dist(rng));
+            for (uint64_t id = 3; id <= n; ++id) board.remove(id);
+            fresh = board.compact(err);
+        }
+        ScoreBoard board;
+        std::string err;
+        const uint64_t id = board.open(ids, err) ? board.submit("after compaction", 1) : 0;
+        // A name cut at kMaxName bytes keeps whole UTF-8 characters ("\xC3\xA9" is two bytes)
+        std::string accents;
+        while (accents.size() < ScoreLog::kMaxName + 1) accents += "\xC3\xA9";
+        const uint64_t named = board.submit(accents, 2);
+        const std::vector<ScoreEntry> page = board.page(0, board.size());
+        std::string stored;
+        for (const ScoreEntry &e : page) if (e.id == named) stored = e.name;
+        const bool clean_cut = stored.size() == ScoreLog::kMaxName - 1 && accents.compare(0, stored.size(), stored) == 0;
+        fresh = fresh && id == n + 1 && clean_cut;
+        ok = ok && fresh;
+        std::printf("ids after compact + reopen: next %llu (expected %llu), name cut to %zu bytes, %s\n",
+                    (unsigned long long)id, (unsigned long long)(n + 1), stored.size(), fresh ? "ok" : "MISMATCH");
+    }
+    std::filesystem::remove_all(dir);
+    return ok ? 0 : 1;
+}
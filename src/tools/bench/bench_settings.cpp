@@ -0,0 +1,162 @@
+/**
+ * @file bench_settings.cpp
+ * @brief Settings load: schema-table tokenizer vs the old per-key find
+ *
+ * Builds a settings file with every schema key after N unknown keys
+ * (numbers, strings, nested objects, as left behind by other versions or
+ * hand edits) and times SettingsManager::parse against a copy of the
+ * previous loader, which searched the whole text once per key. Both must
+ * produce the same Settings, and serialize() must round-trip.
+ */
+
+#include "tools/bench/bench.h"
+#include "win/settings.h"
+#include <cstdio>
+#include <string>
+
+namespace {
+
+/// The loader SettingsManager used before the schema table (validation omitted, it is identical)
+Settings legacy_parse(const std::string &raw) {
+    Settings s;
+    auto extractInt = [&](const std::string &key, int &dst) {
+        size_t pos = raw.find("\"" + key + "\"");
+        if (pos == std::string::npos) return;
+        pos = raw.find(':', pos);
+        if (pos == std::string::npos) return;
+        pos++;
+        while (pos < raw.size() && (raw[pos] == ' ' || raw[pos] == '\t')) pos++;
+        bool neg = false; if (pos < raw.size() && raw[pos] == '-') { neg = true; pos++; }
+        long val = 0; bool any = false;
+        while (pos < raw.size() && raw[pos] >= '0' && raw[pos] <= '9') { any = true; val = val * 10 + (raw[pos] - '0'); pos++; }
+        if (!any) return;
+        if (neg) val = -val;
+        dst = (int)val;
+    };
+    auto extractBool = [&](const std::string &key, bool &dst) {
+        int v = dst ? 1 : 0; extractInt(key, v); dst = v != 0;
+    };
+    extractInt("control_mode", s.control_mode);
+    extractInt("ai", s.ai);
+    extractInt("renderer", s.renderer);
+    extractInt("quality", s.quality);
+    extractInt("game_mode", s.game_mode);
+    extractBool("gm_multiball", s.mode_config.multiball);
+    extractInt("gm_multiball_count", s.mode_config.multiball_count);
+    extractBool("gm_obstacles", s.mode_config.obstacles);
+    extractBool("gm_obstacles_moving", s.mode_config.obstacles_moving);
+    extractBool("gm_blackholes", s.mode_config.blackholes);
+    extractBool("gm_blackholes_moving", s.mode_config.blackholes_moving);
+    extractInt("gm_blackhole_count", s.mode_config.blackhole_count);
+    extractBool("gm_three_enemies", s.mode_config.three_enemies);
+    extractBool("gm_obstacles_gravity", s.mode_config.obstacles_gravity);
+    extractBool("gm_blackholes_destroy_balls", s.mode_config.blackholes_destroy_balls);
+    extractInt("pt_rays_per_frame", s.pt_rays_per_frame);
+    extractInt("pt_max_bounces", s.pt_max_bounces);
+    extractInt("pt_internal_scale", s.pt_internal_scale);
+    extractInt("pt_roughness", s.pt_roughness);
+    extractInt("pt_emissive", s.pt_emissive);
+    extractInt("pt_paddle_emissive", s.pt_paddle_emissive);
+    extractInt("pt_force_4wide_simd", s.pt_force_4wide_simd);
+    extractInt("pt_accum_alpha", s.pt_accum_alpha);
+    extractInt("pt_denoise_strength", s.pt_denoise_strength);
+    extractInt("pt_force_full_pixel_rays", s.pt_force_full_pixel_rays);
+    extractInt("pt_use_ortho", s.pt_use_ortho);
+    extractInt("pt_rr_enable", s.pt_rr_enable);
+    extractInt("pt_rr_start_bounce", s.pt_rr_start_bounce);
+    extractInt("pt_rr_min_prob_pct", s.pt_rr_min_prob_pct);
+    extractInt("pt_fanout_enable", s.pt_fanout_enable);
+    extractInt("pt_fanout_cap", s.pt_fanout_cap);
+    extractInt("pt_fanout_abort", s.pt_fanout_abort);
+    extractInt("pt_soft_shadow_samples", s.pt_soft_shadow_samples);
+    extractInt("pt_light_radius_pct", s.pt_light_radius_pct);
+    extractInt("pt_pbr_enable", s.pt_pbr_enable);
+    extractInt("pt_tile_size", s.pt_tile_size);
+    extractInt("pt_use_blue_noise", s.pt_use_blue_noise);
+    extractInt("pt_use_cosine_weighted", s.pt_use_cosine_weighted);
+    extractInt("pt_use_stratified", s.pt_use_stratified);
+    extractInt("pt_use_halton", s.pt_use_halton);
+    extractInt("pt_adaptive_shadows", s.pt_adaptive_shadows);
+    extractInt("pt_use_bilateral", s.pt_use_bilateral);
+    extractInt("pt_bilateral_sigma_space", s.pt_bilateral_sigma_space);
+    extractInt("pt_bilateral_sigma_color", s.pt_bilateral_sigma_color);
+    extractInt("pt_light_cull_distance", s.pt_light_cull_distance);
+    extractInt("recording_mode", s.recording_mode);
+    extractInt("player_mode", s.player_mode);
+    extractInt("recording_fps", s.recording_fps);
+    extractInt("recording_duration", s.recording_duration);
+    extractInt("recording_format", s.recording_format);
+    extractInt("physics_mode", s.physics_mode);
+    extractInt("speed_mode", s.speed_mode);
+    extractInt("hud_show_play", s.hud_show_play);
+    extractInt("hud_show_record", s.hud_show_record);
+    return s;
+}
+
+/// Non-default, in-range values so a key that is not picked up shows as a mismatch
+Settings sample_settings() {
+    Settings s;
+    s.control_mode = 0; s.ai = 2; s.renderer = 1; s.game_mode = 3;
+    s.mode_config.multiball = true; s.mode_config.multiball_count = 4;
+    s.mode_config.blackholes = true; s.mode_config.blackhole_count = 2;
+    s.mode_config.blackholes_destroy_balls = false;
+    s.pt_rays_per_frame = 250000; s.pt_max_bounces = 4; s.pt_force_4wide_simd = 0;
+    s.pt_fanout_cap = 1234567; s.pt_soft_shadow_samples = 16; s.pt_light_radius_pct = 250;
+    s.player_mode = 2; s.recording_fps = 30; s.recording_format = 4; s.physics_mode = 0;
+    s.speed_mode = 1; s.hud_show_record = 0; s.pt_tile_size = 32; s.pt_light_cull_distance = 900;
+    return s;
+}
+
+/// @p unknown foreign keys, then the serialized settings; the known keys come last, the old loader's worst case
+std::string make_file(const Settings &s, long unknown) {
+    std::string out = "{\n";
+    char line[128];
+    for (long i = 0; i < unknown; ++i) {
+        switch (i % 3) {
+        case 0: std::snprintf(line, sizeof(line), "  \"ext_value_%ld\": %ld,\n", i, i * 7919 % 100000); break;
+        case 1: std::snprintf(line, sizeof(line), "  \"ext_name_%ld\": \"profile \\\"%ld\\\"\",\n", i, i); break;
+        default: std::snprintf(line, sizeof(line), "  \"ext_block_%ld\": { \"w\": [%ld, 2.5e3, true], \"n\": null },\n", i, i); break;
+        }
+        out += line;
+    }
+    out += SettingsManager::serialize(s).substr(2);  // drop the opening "{\n"
+    return out;
+}
+
+bool same(const Settings &a, const Settings &b) {
+    return SettingsManager::serialize(a) == SettingsManager::serialize(b);
+}
+
+/// Microseconds per parse, repeated until at least ~200 ms have passed
+template <typename F>
+double time_us(F &&parse) {
+    long reps = 0;
+    const double t0 = bench_now_ms();
+    double t = t0;
+    do { parse(); ++reps; t = bench_now_ms(); } while (t - t0 < 200.0);
+    return (t - t0) * 1000.0 / (double)reps;
+}
+
+} // namespace
+
+int bench_settings(int argc, char **argv) {
+    const long max_unknown = bench_int_arg(argc, argv, "--unknown", 100000);
+    if (max_unknown < 0) { std::printf("bad arguments\n"); return 2; }
+
+    const Settings ref = sample_settings();
+    bool ok = same(SettingsManager::parse(SettingsManager::serialize(ref)), ref);
+    std::printf("%zu schema keys, serialize -> parse round trip %s\n", SettingsManager::key_count(), ok ? "ok" : "MISMATCH");
+
+    std::printf("%-9s %10s %12s %12s %8s %6s\n", "unknown", "bytes", "old us", "schema us", "speedup", "same");
+    for (long n : { 0L, 1000L, 10000L, 100000L }) {
+        if (n > max_unknown) break;
+        const std::string file = make_file(ref, n);
+        Settings a, b;
+        const double old_us = time_us([&] { a = legacy_parse(file); });
+        const double new_us = time_us([&] { b = SettingsManager::parse(file); });
+        const bool match = same(a, b) && same(b, ref);
+        ok = ok && match;
+        std::printf("%-9ld %10zu %12.1f %12.1f %7.1fx %6s\n", n, file.size(), old_us, new_us, old_us / new_us, match ? "yes" : "NO");
+    }
+    return ok ? 0 : 1;
+}
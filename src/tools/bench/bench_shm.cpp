@@ -0,0 +1,104 @@
+/**
+ * @file bench_shm.cpp
+ * @brief Latency of the shared-memory GameState export (POSIX)
+ *
+ * Forks a reader process that maps the segment and spins on the
+ * sequence number, the way an overlay or bot would. The parent publishes
+ * a live ObstaclesMulti match every --interval-us microseconds. The
+ * reader reports publish-to-observe latency (from the timestamp inside
+ * the snapshot), the cost of one consistent copy and how often a copy
+ * raced the writer.
+ */
+
+#include "tools/bench/bench.h"
+#ifndef _WIN32
+#include "core/game_core.h"
+#include "ipc/state_export.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int shm_reader(const std::string &name, long frames) {
+    StateReader reader;
+    std::string err;
+    // The parent created the segment before forking, so open succeeds at once
+    if (!reader.open(name, err)) { std::fprintf(stderr, "reader: %s\n", err.c_str()); return 1; }
+
+    std::vector<double> latency_us;
+    latency_us.reserve((size_t)frames);
+    SharedGameState snap;
+    uint64_t last_frame = 0, missed = 0, reads = 0;
+    double copy_ns = 0.0;
+    uint64_t seen = 0;
+    const int64_t give_up = shm_now_ns() + 30'000'000'000LL;
+    while ((long)latency_us.size() < frames && shm_now_ns() < give_up) {
+        const uint64_t seq = reader.sequence();
+        if (seq == seen || (seq & 1)) continue;
+        const int64_t t0 = shm_now_ns();
+        seen = reader.read(snap);
+        const int64_t t1 = shm_now_ns();
+        if (!seen) continue;
+        ++reads;
+        copy_ns += (double)(t1 - t0);
+        latency_us.push_back((double)(t0 - snap.publish_ns) / 1000.0);
+        if (last_frame && snap.frame > last_frame + 1) missed += snap.frame - last_frame - 1;
+        last_frame = snap.frame;
+    }
+    if (latency_us.empty()) { std::fprintf(stderr, "reader: no frames observed\n"); return 1; }
+
+    std::sort(latency_us.begin(), latency_us.end());
+    auto pct = [&](double p) { return latency_us[(size_t)(p * (double)(latency_us.size() - 1))]; };
+    std::printf("%-24s %zu (missed %llu, retries %llu)\n", "frames observed", latency_us.size(),
+                (unsigned long long)missed, (unsigned long long)reader.retries());
+    std::printf("%-24s p50 %.2f  p99 %.2f  max %.2f\n", "publish->read us", pct(0.5), pct(0.99), latency_us.back());
+    std::printf("%-24s %.0f ns (%u balls, %u obstacles)\n", "consistent copy", copy_ns / (double)reads,
+                snap.ball_count, snap.obstacle_count);
+    return 0;
+}
+
+int bench_shm(int argc, char **argv) {
+    const long frames = bench_int_arg(argc, argv, "--frames", 5000);
+    const long interval_us = bench_int_arg(argc, argv, "--interval-us", 200);
+    const std::string name = "/pong_bench_state_" + std::to_string((long)getpid());
+
+    StateExporter exporter;
+    std::string err;
+    if (!exporter.open(name, err)) { std::fprintf(stderr, "shm: %s\n", err.c_str()); return 1; }
+
+    GameCore core;
+    core.enable_left_ai(true);
+    core.enable_right_ai(true);
+    core.apply_mode_config(true, true, true, false, false, 1, 5, false, false, true);
+
+    std::fflush(stdout);
+    pid_t child = fork();
+    if (child < 0) { std::perror("fork"); return 1; }
+    if (child == 0) {
+        int rc = shm_reader(name, frames);
+        std::fflush(stdout);
+        _exit(rc);
+    }
+
+    // Give the reader time to map and start spinning before the first frame
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    double publish_ns = 0.0;
+    long published = 0;
+    int status = 0;
+    while (waitpid(child, &status, WNOHANG) == 0) {
+        core.update(1.0/60.0);
+        const int64_t t0 = shm_now_ns();
+        exporter.publish(core.state());
+        publish_ns += (double)(shm_now_ns() - t0);
+        ++published;
+        std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+    }
+    std::printf("%-24s %ld frames, %.0f ns per publish\n", "writer", published,
+                published ? publish_ns / (double)published : 0.0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+#endif
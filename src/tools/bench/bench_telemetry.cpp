@@ -0,0 +1,137 @@
+/**
+ * @file bench_telemetry.cpp
+ * @brief Columnar match telemetry: size per event, decode and filter speed, pruned queries
+ *
+ * Simulates --matches headless matches and repeats their events with
+ * shifted match numbers up to --rows rows (simulating millions of
+ * matches takes minutes; repeating keeps the column statistics
+ * realistic). The file is written, read back and compared, then the
+ * bench times chunk decoding, the SIMD range filter against its scalar
+ * reference, and two queries: rally length per mode (full scan) and one
+ * restricted to 1% of the matches (row groups pruned by min/max).
+ */
+
+#include "tools/bench/bench.h"
+#include "telemetry/telemetry_query.h"
+#include "telemetry/telemetry_recorder.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+int bench_telemetry(int argc, char **argv) {
+    const long matches = bench_int_arg(argc, argv, "--matches", 300);
+    const size_t target = (size_t)bench_int_arg(argc, argv, "--rows", 4000000);
+    const int reps = (int)bench_int_arg(argc, argv, "--reps", 5);
+    if (matches <= 0 || target == 0 || reps <= 0) { std::fprintf(stderr, "bad options\n"); return 2; }
+
+    static const GameMode kModes[] = { GameMode::Classic, GameMode::ThreeEnemies, GameMode::Obstacles,
+                                       GameMode::MultiBall, GameMode::ObstaclesMulti };
+    TelemetryRecorder rec;
+    double t0 = bench_now_ms();
+    for (long i = 0; i < matches; ++i) {
+        TelemetryMatch m;
+        m.match = (uint32_t)i;
+        m.mode = kModes[i % 5];
+        m.speed_mode = i % 5 == 0;
+        m.ai_speed = 0.6 + 0.8 * (double)(i % 17) / 16.0;
+        run_telemetry_match(m, rec);
+    }
+    const TelemetryRows &sim = rec.rows();
+    if (sim.size() == 0) { std::fprintf(stderr, "no events recorded\n"); return 1; }
+    std::printf("simulated %ld matches x 60 s: %zu events in %.0f ms (%.1f events/match)\n", matches, sim.size(),
+                bench_now_ms() - t0, (double)sim.size() / (double)matches);
+
+    TelemetryRows rows;
+    for (uint32_t copy = 0; rows.size() < target; ++copy) {
+        const size_t n = std::min(sim.size(), target - rows.size());
+        for (size_t c = 0; c < kTelemetryColumns; ++c) rows.col[c].insert(rows.col[c].end(), sim.col[c].begin(), sim.col[c].begin() + (std::ptrdiff_t)n);
+        auto &match = rows[TelemetryColumn::Match];
+        for (size_t i = match.size() - n; i < match.size(); ++i) match[i] += (int32_t)(copy * (uint32_t)matches);
+    }
+    const size_t n = rows.size();
+    const uint32_t total_matches = (uint32_t)rows[TelemetryColumn::Match].back() + 1;
+
+    std::error_code ec;
+    const std::filesystem::path path = std::filesystem::temp_directory_path(ec) / "pong_bench_telemetry.ptl";
+    TelemetryWriter writer;
+    std::string err;
+    t0 = bench_now_ms();
+    if (!writer.open(path, err) || !writer.append(rows) || !writer.close()) {
+        std::fprintf(stderr, "write failed: %s\n", err.c_str());
+        return 1;
+    }
+    const double write_ms = bench_now_ms() - t0;
+    const double raw = (double)n * kTelemetryColumns * 4;
+    std::printf("write     %zu rows (%u matches) in %zu row groups: %.2f MB, %.2f bytes/row vs %zu raw (%.1fx), %.0f ms\n",
+                n, total_matches, writer.groups(), (double)writer.bytes() / 1e6, (double)writer.bytes() / (double)n,
+                kTelemetryColumns * 4, raw / (double)writer.bytes(), write_ms);
+
+    TelemetryReader reader;
+    if (!reader.open(path, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    std::vector<int32_t> col;
+    bool same = reader.rows() == n;
+    size_t at = 0;
+    for (size_t g = 0; g < reader.groups().size() && same; ++g) {
+        for (size_t c = 0; c < kTelemetryColumns && same; ++c) {
+            same = reader.read(g, (TelemetryColumn)c, col) &&
+                   std::equal(col.begin(), col.end(), rows.col[c].begin() + (std::ptrdiff_t)at);
+        }
+        at += reader.groups()[g].rows;
+    }
+    std::printf("readback  %s\n", same ? "identical" : "MISMATCH");
+
+    // Decode: every column of every group
+    double best = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        t0 = bench_now_ms();
+        for (size_t g = 0; g < reader.groups().size(); ++g)
+            for (size_t c = 0; c < kTelemetryColumns; ++c) reader.read(g, (TelemetryColumn)c, col);
+        best = std::min(best, bench_now_ms() - t0);
+    }
+    std::printf("decode    %.0f M values/s (all columns, file cached)\n", (double)n * kTelemetryColumns / best / 1e3);
+
+    // Filter: speed between 30 and 60 units/s over the whole column
+    const std::vector<int32_t> &speed = rows[TelemetryColumn::Speed];
+    const size_t words = (n + 63) / 64;
+    std::vector<uint64_t> simd_mask(words), scalar_mask(words);
+    double simd_ms = 1e30, scalar_ms = 1e30;
+    for (int r = 0; r < reps; ++r) {
+        std::fill(simd_mask.begin(), simd_mask.end(), ~0ull);
+        std::fill(scalar_mask.begin(), scalar_mask.end(), ~0ull);
+        t0 = bench_now_ms();
+        filter_range(speed.data(), n, 30 * 64, 60 * 64, false, simd_mask.data());
+        simd_ms = std::min(simd_ms, bench_now_ms() - t0);
+        t0 = bench_now_ms();
+        filter_range_scalar(speed.data(), n, 30 * 64, 60 * 64, false, scalar_mask.data());
+        scalar_ms = std::min(scalar_ms, bench_now_ms() - t0);
+    }
+    simd_mask.back() &= scalar_mask.back();   // only the scalar reference clears bits past the last row
+    std::printf("filter    simd %.0f M rows/s, scalar %.0f M rows/s (%.1fx), masks %s\n", (double)n / simd_ms / 1e3,
+                (double)n / scalar_ms / 1e3, scalar_ms / simd_ms, simd_mask == scalar_mask ? "identical" : "DIFFER");
+
+    // Queries
+    TelemetryQuery q;
+    q.where.push_back({ TelemetryColumn::Kind, (int32_t)GameEventKind::Point, (int32_t)GameEventKind::Point, false });
+    q.grouped = true;
+    q.group_by = TelemetryColumn::Mode;
+    q.value = TelemetryColumn::Rally;
+    TelemetryQueryResult res;
+    t0 = bench_now_ms();
+    if (!run_telemetry_query(reader, q, res, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    double ms = bench_now_ms() - t0;
+    std::printf("query     rally per mode: %llu points, %zu chunks / %.2f MB read, %.1f ms (%.0f M rows/s)\n",
+                (unsigned long long)res.rows_matched, res.chunks_read, (double)res.bytes_read / 1e6, ms, (double)n / ms / 1e3);
+
+    q.where.push_back({ TelemetryColumn::Match, 0, (int32_t)(total_matches / 100), false });
+    t0 = bench_now_ms();
+    if (!run_telemetry_query(reader, q, res, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    ms = bench_now_ms() - t0;
+    std::printf("query     same, first 1%% of matches: %zu of %zu row groups skipped, %.2f MB read, %.2f ms\n",
+                res.groups_skipped, reader.groups().size(), (double)res.bytes_read / 1e6, ms);
+
+    std::filesystem::remove(path, ec);
+    return same && simd_mask == scalar_mask ? 0 : 1;
+}
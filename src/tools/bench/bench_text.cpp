@@ -0,0 +1,62 @@
+/**
+ * @file bench_text.cpp
+ * @brief Glyph-atlas HUD text: atlas build, cached vs recomposed lines
+ *
+ * Draws a HUD-sized block of text (panel plus eight lines, like the
+ * pong_win overlay with path tracer stats) into a 1080p framebuffer each
+ * frame. "static" keeps every line unchanged, so after the first frame
+ * each one is a cached run; "live" changes two lines per frame, as the
+ * frame-time and FPS lines do in play; "all new" makes every line a
+ * cache miss, which is the cost of recomposing from the atlas each frame.
+ */
+
+#include "tools/bench/bench.h"
+#include "raster/text_raster.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+double run_hud(TextRenderer &text, const RasterTarget &fb, long frames, int changing) {
+    char line[96];
+    const double t0 = bench_now_ms();
+    for (long f = 0; f < frames; ++f) {
+        TextRenderer::fill(fb, 0, 0, 420, 8 * 20 + 16, 0x08080C, 200);
+        for (int i = 0; i < 8; ++i) {
+            if (i < changing) std::snprintf(line, sizeof(line), "Frame p50 %.1f  p99 %.1f  line %d", 16.0 + (double)(f % 97) * 0.1, 17.5, i);
+            else std::snprintf(line, sizeof(line), "Trace %.1f  Temp %.1f  Denoise %.1f #%d", 9.3, 0.4, 1.2, i);
+            text.draw(fb, 8, 8 + i * 20, line, 0xE6E6E6);
+        }
+        text.end_frame();
+    }
+    return (bench_now_ms() - t0) * 1000.0 / (double)frames;
+}
+
+} // namespace
+
+int bench_text(int argc, char **argv) {
+    const long frames = bench_int_arg(argc, argv, "--frames", 20000);
+    const int height = (int)bench_int_arg(argc, argv, "--height", 16);
+    if (frames <= 0 || height <= 0) { std::printf("bad arguments\n"); return 2; }
+
+    const int w = 1920, h = 1080;
+    std::vector<uint32_t> px((size_t)w * h, 0x202020);
+    const RasterTarget fb{ px.data(), w, h, w };
+
+    GlyphAtlas atlas;
+    const double a0 = bench_now_ms();
+    atlas.build(height);
+    std::printf("atlas %d px: %dx%d glyph cells, built in %.3f ms\n", height, atlas.cell_w(), atlas.cell_h(), bench_now_ms() - a0);
+
+    std::printf("%-9s %10s %9s %7s\n", "lines", "us/frame", "hit rate", "runs");
+    const struct { const char *name; int changing; } modes[] = { { "static", 0 }, { "live", 2 }, { "all new", 8 } };
+    for (const auto &m : modes) {
+        TextRenderer text;
+        text.set_height(height);
+        const double us = run_hud(text, fb, frames, m.changing);
+        const double total = (double)(text.hits() + text.misses());
+        std::printf("%-9s %10.2f %8.1f%% %7zu\n", m.name, us, total > 0 ? 100.0 * (double)text.hits() / total : 0.0, text.cached_runs());
+    }
+    return 0;
+}
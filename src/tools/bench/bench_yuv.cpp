@@ -0,0 +1,99 @@
+/**
+ * @file bench_yuv.cpp
+ * @brief BGRA to yuv420p conversion speed and Y4M streaming throughput
+ *
+ * Converts a bottom-up BGRA frame (as GetDIBits delivers it) with the
+ * scalar and the dispatched (AVX2 where available) path, checks that both
+ * produce the same bytes and reports GB/s of BGRA input. Then records
+ * the same frames through FrameCapture as a Y4M stream to a temporary
+ * file, which is what a recording in Y4M mode costs end to end. An odd
+ * size (e.g. --width 1919) exercises the padding.
+ */
+
+#include "tools/bench/bench.h"
+#include "capture/frame_capture.h"
+#include "capture/yuv.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Moving gradient + hard edges so chroma averaging sees real variation
+void fill_frame(std::vector<uint8_t> &px, int w, int h, int t) {
+    for (int y = 0; y < h; ++y) {
+        uint8_t *row = px.data() + (size_t)y * (size_t)w * 4;
+        for (int x = 0; x < w; ++x) {
+            row[x * 4 + 0] = (uint8_t)(x + t);
+            row[x * 4 + 1] = (uint8_t)(y * 3 - t);
+            row[x * 4 + 2] = ((x / 7 + y / 5 + t) & 1) ? 250 : 5;
+            row[x * 4 + 3] = 255;
+        }
+    }
+}
+
+double convert_gbps(bool simd, const std::vector<uint8_t> &px, int w, int h, std::vector<uint8_t> &out, long reps) {
+    const ptrdiff_t stride = (ptrdiff_t)w * 4;
+    const uint8_t *top = px.data() + (ptrdiff_t)(h - 1) * stride;
+    const YuvPlanes planes = yuv420_planes(out.data(), w, h);
+    const double t0 = bench_now_ms();
+    for (long i = 0; i < reps; ++i) {
+        if (simd) bgra_to_yuv420(top, -stride, w, h, planes);
+        else bgra_to_yuv420_scalar(top, -stride, w, h, planes);
+    }
+    const double s = (bench_now_ms() - t0) / 1000.0;
+    return (double)px.size() * (double)reps / s / 1e9;
+}
+
+} // namespace
+
+int bench_yuv(int argc, char **argv) {
+    const int w = (int)bench_int_arg(argc, argv, "--width", 1920);
+    const int h = (int)bench_int_arg(argc, argv, "--height", 1080);
+    const long reps = bench_int_arg(argc, argv, "--reps", 100);
+    const long frames = bench_int_arg(argc, argv, "--frames", 120);
+    if (w <= 0 || h <= 0 || reps <= 0) { std::printf("bad size\n"); return 2; }
+
+    std::vector<uint8_t> px((size_t)w * (size_t)h * 4);
+    fill_frame(px, w, h, 0);
+    std::vector<uint8_t> a(yuv420_size(w, h)), b(yuv420_size(w, h));
+    const double scalar = convert_gbps(false, px, w, h, a, reps);
+    const double simd = convert_gbps(true, px, w, h, b, reps);
+    const bool same = a == b;
+    std::printf("%dx%d BGRA -> %dx%d yuv420p, %ld reps\n", w, h, FrameCapture::padded(w), FrameCapture::padded(h), reps);
+    std::printf("%-8s %8.2f GB/s  %7.3f ms/frame\n", "scalar", scalar, (double)px.size() / scalar / 1e6);
+    std::printf("%-8s %8.2f GB/s  %7.3f ms/frame  (%.1fx, output %s)\n", yuv_simd_path(), simd,
+                (double)px.size() / simd / 1e6, simd / scalar, same ? "identical" : "DIFFERS");
+
+    // End to end: loop copies into the slot, writers convert + stream
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "pong_bench_yuv";
+    std::filesystem::create_directories(dir);
+    {
+        FrameCapture capture(2);
+        CaptureOptions opt;
+        opt.format = CaptureFormat::Y4m;
+        opt.dir = dir;
+        std::string err;
+        if (!capture.start(opt, w, h, err)) { std::printf("y4m: %s\n", err.c_str()); return 1; }
+        const double t0 = bench_now_ms();
+        for (long i = 0; i < frames; ++i) {
+            CaptureFrame *f = capture.acquire();
+            std::memcpy(f->pixels, px.data(), px.size());
+            f->width = w; f->height = h;
+            capture.submit(f);
+        }
+        capture.finish();
+        const double s = (bench_now_ms() - t0) / 1000.0;
+        const CaptureStats cs = capture.stats();
+        std::printf("y4m stream: %llu frames, %.0f fps, %.0f MB/s written, convert %.2f ms/frame, %llu stalls\n",
+                    (unsigned long long)cs.frames, (double)cs.frames / s, (double)cs.bytes / s / 1e6,
+                    cs.frames ? cs.encode_ms / (double)cs.frames : 0.0, (unsigned long long)cs.stalls);
+        const auto file_bytes = std::filesystem::file_size(dir / "recording.y4m");
+        std::printf("file %.1f MB (%.1f MB as BMP frames)\n", (double)file_bytes / 1e6,
+                    (double)frames * (54.0 + 4.0 * FrameCapture::padded(w) * FrameCapture::padded(h)) / 1e6);
+    }
+    std::filesystem::remove_all(dir);
+    return same ? 0 : 1;
+}
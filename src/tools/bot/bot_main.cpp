@@ -0,0 +1,113 @@
+/**
+ * @file bot_main.cpp
+ * @brief pong_bot: sample external bot using the shared-memory channels (POSIX)
+ *
+ * Follows the game through the exported state segment and steers the
+ * right paddle through the bot input ring, keeping one command in flight:
+ * push a SetCentre toward the ball, spin until a published snapshot
+ * reports that command as applied, record the round trip, repeat after
+ * --interval-us. Start the game first, e.g.
+ *
+ *   pong --headless --export-state --bot-input
+ *   pong_bot --samples 2000
+ *
+ * Reports round-trip percentiles split into the wait for the next
+ * substep (send -> publish) and the export leg (publish -> observed).
+ */
+
+#include "ipc/input_ring.h"
+#include "ipc/state_export.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static double percentile(std::vector<double> &v, double p) {
+    if (v.empty()) return 0.0;
+    size_t k = (size_t)(p * (double)(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + (long)k, v.end());
+    return v[k];
+}
+
+static void report(const char *label, std::vector<double> &us) {
+    std::printf("  %-16s p50 %8.1f us  p99 %8.1f us  max %8.1f us\n", label,
+                percentile(us, 0.50), percentile(us, 0.99),
+                us.empty() ? 0.0 : *std::max_element(us.begin(), us.end()));
+}
+
+int main(int argc, char **argv) {
+    std::string state_name = kStateShmDefaultName;
+    std::string input_name = kInputRingDefaultName;
+    long samples = 2000;
+    long interval_us = 1500;
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--state") == 0 && has_value) state_name = argv[++i];
+        else if (std::strcmp(argv[i], "--input") == 0 && has_value) input_name = argv[++i];
+        else if (std::strcmp(argv[i], "--samples") == 0 && has_value) samples = std::atol(argv[++i]);
+        else if (std::strcmp(argv[i], "--interval-us") == 0 && has_value) interval_us = std::atol(argv[++i]);
+        else {
+            std::fprintf(stderr, "usage: pong_bot [--state /name] [--input /name] [--samples N] [--interval-us N]\n");
+            return 2;
+        }
+    }
+
+    StateReader reader;
+    InputRingWriter writer;
+    std::string err;
+    if (!reader.open(state_name, err) || !writer.open(input_name, err)) {
+        std::fprintf(stderr, "pong_bot: %s\n", err.c_str());
+        return 1;
+    }
+
+    std::vector<double> rtt_us, apply_us, export_us;
+    rtt_us.reserve((size_t)samples);
+    apply_us.reserve((size_t)samples);
+    export_us.reserve((size_t)samples);
+    SharedGameState snap;
+    long timeouts = 0;
+    // Continue the game's id sequence: commands of an earlier bot, applied or still queued,
+    // carry ids from 1 up and would otherwise acknowledge ours
+    while (!reader.read(snap)) std::this_thread::yield();
+    uint64_t id = std::max(snap.last_command_id, writer.last_id());
+    while ((long)rtt_us.size() < samples) {
+        if (!reader.read(snap)) continue;
+        PaddleCommand cmd;
+        cmd.id = ++id;
+        cmd.side = PaddleSide::Right;
+        cmd.kind = PaddleCommandKind::SetCentre;
+        cmd.value = snap.ball_count ? snap.ball_pos[0].y : snap.height * 0.5;
+        cmd.sent_ns = shm_now_ns();
+        if (!writer.push(cmd)) { std::fprintf(stderr, "pong_bot: input ring full, is the game running?\n"); return 1; }
+
+        const int64_t give_up = cmd.sent_ns + 1'000'000'000LL;
+        uint64_t seen = 0;
+        bool acked = false;
+        while (shm_now_ns() < give_up) {
+            const uint64_t seq = reader.sequence();
+            // Yield rather than burn the core the game may need to publish on
+            if (seq == seen || (seq & 1)) { std::this_thread::yield(); continue; }
+            seen = reader.read(snap);
+            if (seen && snap.last_command_id >= cmd.id) { acked = true; break; }
+        }
+        const int64_t now = shm_now_ns();
+        if (!acked) {
+            if (++timeouts == 3) { std::fprintf(stderr, "pong_bot: game stopped responding\n"); break; }
+            continue;
+        }
+        rtt_us.push_back((double)(now - cmd.sent_ns) / 1000.0);
+        apply_us.push_back((double)(snap.publish_ns - cmd.sent_ns) / 1000.0);
+        export_us.push_back((double)(now - snap.publish_ns) / 1000.0);
+        if (interval_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+    }
+
+    std::printf("pong_bot: %zu commands acknowledged, %llu snapshot retries\n",
+                rtt_us.size(), (unsigned long long)reader.retries());
+    report("round trip", rtt_us);
+    report("send->publish", apply_us);
+    report("publish->seen", export_us);
+    return rtt_us.empty() ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file rerender_main.cpp
+ * @brief pong_rerender: path-trace a recorded GameState stream offline
+ *
+ * Usage:
+ *   pong_rerender <recording.pgs> <target> [options]
+ *
+ *   target               Y4M file, "-" (stdout) or "|command", e.g.
+ *                        "|ffmpeg -i - -c:v libx264 -crf 18 match.mp4"
+ *   --width W --height H output size (default 1920x1080)
+ *   --spp N              rays per pixel (default 16)
+ *   --bounces N          path depth 1..8 (default 4)
+ *   --scale PCT          internal resolution 25..100 (default 100)
+ *   --accum A            temporal accumulation factor 0.01..0.9 (default 0.5)
+ *   --denoise S          spatial denoise strength 0..1 (default 0.35)
+ *   --threads N          renderer threads (default: every core)
+ *   --start N --frames N sub-range of the recording
+ *   --fps N              output frame rate (default: the recording's)
+ *   --hud                draw the score and frame number (glyph-atlas text)
+ *
+ * Recordings come from pong_win (recording.pgs next to the frames) or
+ * from `pong --headless --record-state FILE`. Frames are rendered in
+ * order so temporal accumulation sees the same history as live play;
+ * each frame is traced by the renderer's own worker threads on every
+ * core, while FrameCapture's writer threads convert the previous frames
+ * to yuv420p and stream them out.
+ */
+
+#include "capture/frame_capture.h"
+#include "capture/yuv.h"
+#include "core/state_stream.h"
+#include "raster/text_raster.h"
+#include "render/soft_renderer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+static void usage() {
+    std::fprintf(stderr,
+                 "usage: pong_rerender <recording.pgs> <file.y4m | - | \"|command\"> [--width W] [--height H]\n"
+                 "       [--spp N] [--bounces N] [--scale PCT] [--accum A] [--denoise S] [--threads N]\n"
+                 "       [--start N] [--frames N] [--fps N] [--hud]\n");
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) { usage(); return 2; }
+    const char *input = argv[1];
+    const std::string target = argv[2];
+    int w = 1920, h = 1080, spp = 16, bounces = 4, scale = 100, fps = 0;
+    int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    long start = 0, count = -1;
+    float accum = 0.5f, denoise = 0.35f;
+    bool hud = false;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--hud") == 0) { hud = true; continue; }
+        if (i + 1 >= argc) { usage(); return 2; }
+        const char *k = argv[i], *v = argv[++i];
+        if (std::strcmp(k, "--width") == 0) w = std::atoi(v);
+        else if (std::strcmp(k, "--height") == 0) h = std::atoi(v);
+        else if (std::strcmp(k, "--spp") == 0) spp = std::atoi(v);
+        else if (std::strcmp(k, "--bounces") == 0) bounces = std::atoi(v);
+        else if (std::strcmp(k, "--scale") == 0) scale = std::atoi(v);
+        else if (std::strcmp(k, "--accum") == 0) accum = (float)std::atof(v);
+        else if (std::strcmp(k, "--denoise") == 0) denoise = (float)std::atof(v);
+        else if (std::strcmp(k, "--threads") == 0) threads = std::max(1, std::atoi(v));
+        else if (std::strcmp(k, "--start") == 0) start = std::max(0L, std::atol(v));
+        else if (std::strcmp(k, "--frames") == 0) count = std::atol(v);
+        else if (std::strcmp(k, "--fps") == 0) fps = std::atoi(v);
+        else { usage(); return 2; }
+    }
+    if (w <= 0 || h <= 0 || spp <= 0) { usage(); return 2; }
+
+    StateStreamReader states;
+    std::string err;
+    if (!states.open(input, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    const long end = count < 0 ? (long)states.size() : std::min((long)states.size(), start + count);
+    if (start >= end) { std::fprintf(stderr, "%s: no frames in range (%zu recorded)\n", input, states.size()); return 1; }
+    if (fps <= 0) fps = states.fps();
+
+    // The renderer's thread count comes from PONG_PT_THREADS; otherwise it adapts towards a 60 fps budget
+    const std::string nthreads = std::to_string(threads);
+#ifdef _WIN32
+    _putenv_s("PONG_PT_THREADS", nthreads.c_str());
+#else
+    setenv("PONG_PT_THREADS", nthreads.c_str(), 1);
+#endif
+    SRConfig cfg;
+    cfg.forceFullPixelRays = true;
+    cfg.raysPerFrame = spp;
+    cfg.maxBounces = bounces;
+    cfg.internalScalePct = scale;
+    cfg.accumAlpha = accum;
+    cfg.denoiseStrength = denoise;
+    SoftRenderer sr;
+    sr.configure(cfg);
+    sr.resize(w, h);
+
+    FrameCapture capture(2, 4);
+    CaptureOptions opt;
+    opt.format = CaptureFormat::Y4m;
+    opt.stream = target;
+    opt.fps = fps;
+    if (!capture.start(opt, w, h, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+
+    std::fprintf(stderr, "pong_rerender: %ld frames of %s -> %dx%d @ %d fps, %d spp, %d bounces, %d%% scale, %d threads\n",
+                 end - start, input, w, h, fps, spp, bounces, scale, threads);
+    using clock = std::chrono::steady_clock;
+    const auto t0 = clock::now();
+    double render_ms = 0.0;
+    GameState gs;
+    TextRenderer text;
+    text.set_height(std::max(12, h / 30));
+    long done = 0, bad = 0;
+    for (long i = start; i < end; ++i) {
+        if (!states.load((size_t)i, gs)) { ++bad; continue; }
+        const auto r0 = clock::now();
+        sr.render(gs);
+        render_ms += std::chrono::duration<double, std::milli>(clock::now() - r0).count();
+        // Renderer output is top-down 0x00RRGGBB (BGRA bytes); slots are bottom-up
+        CaptureFrame *f = capture.acquire();
+        const uint32_t *px = sr.pixels();
+        for (int y = 0; y < h; ++y)
+            std::memcpy(f->pixels + (size_t)y * (size_t)w * 4, px + (size_t)(h - 1 - y) * (size_t)w, (size_t)w * 4);
+        if (hud) {
+            // Drawn upright into the bottom-up slot through a negative stride
+            const RasterTarget slot{ reinterpret_cast<uint32_t *>(f->pixels) + (ptrdiff_t)(h - 1) * w, w, h, -(ptrdiff_t)w };
+            char line[64];
+            const int pad = text.height() / 2;
+            std::snprintf(line, sizeof(line), "%d - %d", gs.score_left, gs.score_right);
+            text.draw(slot, (w - text.measure(line)) / 2, pad, line, 0xE6E6E6);
+            std::snprintf(line, sizeof(line), "frame %ld", i);
+            text.draw(slot, pad, h - text.height() - pad, line, 0x808080);
+            text.end_frame();
+        }
+        f->width = w;
+        f->height = h;
+        capture.submit(f);
+        if (++done % 60 == 0) {
+            const double s = std::chrono::duration<double>(clock::now() - t0).count();
+            std::fprintf(stderr, "\r  %ld/%ld frames, %.2f fps", done, end - start, (double)done / s);
+        }
+    }
+    capture.finish();
+    const double s = std::chrono::duration<double>(clock::now() - t0).count();
+    const CaptureStats cs = capture.stats();
+    std::fprintf(stderr, "\rpong_rerender: %llu frames in %.1f s: %.2f fps offline (%.2fx real time)\n",
+                 (unsigned long long)cs.frames, s, (double)cs.frames / s, (double)cs.frames / s / fps);
+    std::fprintf(stderr, "  render %.1f ms/frame, yuv %.2f ms/frame (%s), %llu encoder stalls",
+                 done ? render_ms / (double)done : 0.0, cs.frames ? cs.encode_ms / (double)cs.frames : 0.0,
+                 yuv_simd_path(), (unsigned long long)cs.stalls);
+    if (bad) std::fprintf(stderr, ", %ld damaged records skipped", bad);
+    if (cs.failed) std::fprintf(stderr, ", %llu frames not written", (unsigned long long)cs.failed);
+    std::fprintf(stderr, "\n");
+    return cs.failed || bad ? 1 : 0;
+}
@@ -0,0 +1,308 @@
+/**
+ * @file telemetry_main.cpp
+ * @brief pong_telemetry: record headless matches into a columnar file and query it
+ *
+ * Usage:
+ *   pong_telemetry record <file.ptl> [options]
+ *     --matches N          matches to simulate (default 1000)
+ *     --seconds S          simulated seconds per match (default 60)
+ *     --hz N               frame rate (default 60)
+ *     --modes LIST         comma-separated modes, dealt round robin (default: all)
+ *     --speed-pct N        percentage of matches in "I am Speed" mode (default 20)
+ *     --threads N          simulation threads (default: every core)
+ *     --seed N             AI speed draw (default 1)
+ *   pong_telemetry info <file.ptl>
+ *   pong_telemetry query <file.ptl> [--where EXPR]... [--group COL] [--stat COL] [--scalar]
+ *
+ * A query filters rows with every --where (COL OP VALUE, OP one of
+ * = != < <= > >=; values in game units, or a name for mode, kind and
+ * side), groups them by --group and prints count, mean, percentiles and
+ * extremes of --stat (default rally) per group, followed by how much of
+ * the file the scan had to read. Examples:
+ *
+ *   rally length per mode:          query f.ptl --where kind=point --group mode --stat rally
+ *   hit offsets of the left paddle: query f.ptl --where kind=hit --where side=left --stat offset
+ *   speed in speed mode:            query f.ptl --where speed_mode=1 --where kind=hit --group mode --stat speed
+ */
+
+#include "telemetry/telemetry_file.h"
+#include "telemetry/telemetry_query.h"
+#include "telemetry/telemetry_recorder.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void usage() {
+    std::fprintf(stderr,
+                 "usage: pong_telemetry record <file> [--matches N] [--seconds S] [--hz N] [--modes LIST]\n"
+                 "                             [--speed-pct N] [--threads N] [--seed N]\n"
+                 "       pong_telemetry info <file>\n"
+                 "       pong_telemetry query <file> [--where COL{=,!=,<,<=,>,>=}VALUE]... [--group COL]\n"
+                 "                            [--stat COL] [--scalar]\n");
+}
+
+struct NamedValue { const char *name; int32_t value; };
+
+static const NamedValue kModes[] = {
+    { "classic", (int32_t)GameMode::Classic }, { "three", (int32_t)GameMode::ThreeEnemies },
+    { "obstacles", (int32_t)GameMode::Obstacles }, { "multiball", (int32_t)GameMode::MultiBall },
+    { "obstacles-multi", (int32_t)GameMode::ObstaclesMulti },
+};
+static const NamedValue kKinds[] = { { "hit", (int32_t)GameEventKind::PaddleHit }, { "point", (int32_t)GameEventKind::Point } };
+static const NamedValue kSides[] = {
+    { "left", (int32_t)PaddleSide::Left }, { "right", (int32_t)PaddleSide::Right },
+    { "top", (int32_t)PaddleSide::Top }, { "bottom", (int32_t)PaddleSide::Bottom },
+};
+
+template <size_t N>
+static bool find_name(const NamedValue (&table)[N], const std::string &s, int32_t &out) {
+    for (const NamedValue &n : table) {
+        if (s == n.name) { out = n.value; return true; }
+    }
+    return false;
+}
+
+template <size_t N>
+static const char *find_value(const NamedValue (&table)[N], int32_t v) {
+    for (const NamedValue &n : table) {
+        if (v == n.value) return n.name;
+    }
+    return nullptr;
+}
+
+/// Display name of a stored value of an enumerated column (nullptr for numeric columns)
+static const char *value_name(TelemetryColumn c, int32_t v) {
+    switch (c) {
+    case TelemetryColumn::Mode: return find_value(kModes, v);
+    case TelemetryColumn::Kind: return find_value(kKinds, v);
+    case TelemetryColumn::Side: return find_value(kSides, v);
+    default: return nullptr;
+    }
+}
+
+/// Stored value of a name of an enumerated column
+static bool name_value(TelemetryColumn c, const std::string &s, int32_t &out) {
+    switch (c) {
+    case TelemetryColumn::Mode: return find_name(kModes, s, out);
+    case TelemetryColumn::Kind: return find_name(kKinds, s, out);
+    case TelemetryColumn::Side: return find_name(kSides, s, out);
+    default: return false;
+    }
+}
+
+static int32_t clamp32(double v) {
+    if (v <= (double)std::numeric_limits<int32_t>::min()) return std::numeric_limits<int32_t>::min();
+    if (v >= (double)std::numeric_limits<int32_t>::max()) return std::numeric_limits<int32_t>::max();
+    return (int32_t)v;
+}
+
+/// Parse COL OP VALUE into a stored-value range
+static bool parse_where(const std::string &expr, TelemetryPredicate &p) {
+    const size_t at = expr.find_first_of("=!<>");
+    if (at == std::string::npos || at == 0) return false;
+    if (!telemetry_column_by_name(expr.substr(0, at), p.col)) return false;
+    size_t len = expr.compare(at, 2, "!=") == 0 || expr.compare(at, 2, "<=") == 0 || expr.compare(at, 2, ">=") == 0 ? 2 : 1;
+    const std::string op = expr.substr(at, len), text = expr.substr(at + len);
+    if (text.empty() || op == "!") return false;
+
+    int32_t named = 0;
+    double v;
+    if (name_value(p.col, text, named)) {
+        v = named;
+    } else {
+        char *end = nullptr;
+        v = std::strtod(text.c_str(), &end) * kTelemetryColumnInfo[(size_t)p.col].scale;
+        if (!end || *end != '\0') return false;
+    }
+    p = TelemetryPredicate{ p.col };
+    if (op == "=" || op == "!=") { p.lo = p.hi = clamp32(std::round(v)); p.negate = op == "!="; }
+    else if (op == "<") p.hi = clamp32(std::ceil(v) - 1);
+    else if (op == "<=") p.hi = clamp32(std::floor(v));
+    else if (op == ">") p.lo = clamp32(std::floor(v) + 1);
+    else p.lo = clamp32(std::ceil(v));
+    return true;
+}
+
+static int cmd_record(const char *path, int argc, char **argv) {
+    long matches = 1000, hz = 60, speed_pct = 20, seed = 1;
+    double seconds = 60.0;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<GameMode> modes;
+    for (int i = 0; i < argc; ++i) {
+        if (i + 1 >= argc) { usage(); return 2; }
+        const char *k = argv[i], *v = argv[++i];
+        if (std::strcmp(k, "--matches") == 0) matches = std::atol(v);
+        else if (std::strcmp(k, "--seconds") == 0) seconds = std::atof(v);
+        else if (std::strcmp(k, "--hz") == 0) hz = std::atol(v);
+        else if (std::strcmp(k, "--speed-pct") == 0) speed_pct = std::atol(v);
+        else if (std::strcmp(k, "--threads") == 0) threads = (unsigned)std::max(1, std::atoi(v));
+        else if (std::strcmp(k, "--seed") == 0) seed = std::atol(v);
+        else if (std::strcmp(k, "--modes") == 0) {
+            std::string list = v;
+            for (size_t from = 0; from <= list.size();) {
+                const size_t comma = std::min(list.find(',', from), list.size());
+                int32_t m;
+                if (!find_name(kModes, list.substr(from, comma - from), m)) {
+                    std::fprintf(stderr, "unknown mode in --modes (classic|three|obstacles|multiball|obstacles-multi)\n");
+                    return 2;
+                }
+                modes.push_back((GameMode)m);
+                from = comma + 1;
+            }
+        }
+        else { usage(); return 2; }
+    }
+    if (matches <= 0 || seconds <= 0.0 || hz <= 0) { usage(); return 2; }
+    if (modes.empty()) for (const NamedValue &m : kModes) modes.push_back((GameMode)m.value);
+
+    TelemetryWriter writer;
+    std::string err;
+    if (!writer.open(path, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+
+    // Threads simulate batches of consecutive matches; batches are written in
+    // order, so the match column stays sorted and packs to a few bits per row
+    const long kBatch = 16;
+    const long batches = (matches + kBatch - 1) / kBatch;
+    std::atomic<long> next{0};
+    std::mutex mtx;
+    std::condition_variable turn;
+    long written = 0;
+    bool ok = true;
+    const auto t0 = std::chrono::steady_clock::now();
+    auto worker = [&] {
+        TelemetryRecorder rec;
+        for (long b; (b = next.fetch_add(1)) < batches;) {
+            rec.rows().clear();
+            for (long i = b * kBatch; i < std::min(matches, (b + 1) * kBatch); ++i) {
+                std::mt19937 rng((uint32_t)(seed * 1000003 + i));
+                TelemetryMatch m;
+                m.match = (uint32_t)i;
+                m.mode = modes[(size_t)i % modes.size()];
+                m.speed_mode = (long)(rng() % 100) < speed_pct;
+                m.ai_speed = 0.6 + 0.8 * std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+                m.seconds = seconds;
+                m.hz = (int)hz;
+                run_telemetry_match(m, rec);
+            }
+            std::unique_lock<std::mutex> lock(mtx);
+            turn.wait(lock, [&] { return written == b; });
+            ok = writer.append(rec.rows()) && ok;
+            ++written;
+            turn.notify_all();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker);
+    for (auto &t : pool) t.join();
+    ok = writer.close() && ok;
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (!ok) { std::fprintf(stderr, "%s: write failed\n", path); return 1; }
+    std::printf("%ld matches (%.0f simulated s each, %u threads) in %.2f s: %llu events, %zu row groups, %.2f MB (%.2f bytes/event)\n",
+                matches, seconds, threads, secs, (unsigned long long)writer.rows(), writer.groups(),
+                (double)writer.bytes() / 1e6, writer.rows() ? (double)writer.bytes() / (double)writer.rows() : 0.0);
+    return 0;
+}
+
+static int cmd_info(const char *path) {
+    TelemetryReader reader;
+    std::string err;
+    if (!reader.open(path, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    const auto &groups = reader.groups();
+    std::printf("%s: %llu rows in %zu row groups, %.2f MB (%.2f bytes/row)\n", path, (unsigned long long)reader.rows(),
+                groups.size(), (double)reader.file_bytes() / 1e6,
+                reader.rows() ? (double)reader.file_bytes() / (double)reader.rows() : 0.0);
+    std::printf("%-11s %12s %9s %7s %7s %14s %14s\n", "column", "bytes", "bits/row", "delta", "const", "min", "max");
+    for (size_t c = 0; c < kTelemetryColumns; ++c) {
+        uint64_t bytes = 0;
+        size_t delta = 0, constant = 0;
+        int32_t lo = std::numeric_limits<int32_t>::max(), hi = std::numeric_limits<int32_t>::min();
+        for (const TelemetryReader::Group &g : groups) {
+            const ColumnChunkInfo &info = g.chunks[c].info;
+            bytes += info.bytes;
+            delta += info.encoding == ColumnEncoding::Delta;
+            constant += info.bits == 0;
+            lo = std::min(lo, info.min);
+            hi = std::max(hi, info.max);
+        }
+        const double scale = kTelemetryColumnInfo[c].scale;
+        std::printf("%-11s %12llu %9.2f %7zu %7zu %14.3f %14.3f\n", kTelemetryColumnInfo[c].name,
+                    (unsigned long long)bytes, reader.rows() ? 8.0 * (double)bytes / (double)reader.rows() : 0.0,
+                    delta, constant, groups.empty() ? 0.0 : lo / scale, groups.empty() ? 0.0 : hi / scale);
+    }
+    return 0;
+}
+
+static double percentile(std::vector<int32_t> &v, double p) {
+    if (v.empty()) return 0.0;
+    size_t k = (size_t)(p * (double)(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + (std::ptrdiff_t)k, v.end());
+    return v[k];
+}
+
+static int cmd_query(const char *path, int argc, char **argv) {
+    TelemetryQuery q;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--scalar") == 0) { q.simd = false; continue; }
+        if (i + 1 >= argc) { usage(); return 2; }
+        const char *k = argv[i], *v = argv[++i];
+        if (std::strcmp(k, "--where") == 0) {
+            TelemetryPredicate p;
+            if (!parse_where(v, p)) { std::fprintf(stderr, "bad --where '%s'\n", v); return 2; }
+            q.where.push_back(p);
+        } else if (std::strcmp(k, "--group") == 0) {
+            if (!telemetry_column_by_name(v, q.group_by)) { std::fprintf(stderr, "unknown column '%s'\n", v); return 2; }
+            q.grouped = true;
+        } else if (std::strcmp(k, "--stat") == 0) {
+            if (!telemetry_column_by_name(v, q.value)) { std::fprintf(stderr, "unknown column '%s'\n", v); return 2; }
+        } else { usage(); return 2; }
+    }
+
+    TelemetryReader reader;
+    std::string err;
+    if (!reader.open(path, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    TelemetryQueryResult r;
+    const auto t0 = std::chrono::steady_clock::now();
+    if (!run_telemetry_query(reader, q, r, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    const double scale = kTelemetryColumnInfo[(size_t)q.value].scale;
+    std::printf("%-16s %10s %10s %10s %10s %10s %10s %10s\n", q.grouped ? kTelemetryColumnInfo[(size_t)q.group_by].name : "",
+                "count", "mean", "min", "p50", "p90", "p99", "max");
+    for (auto &kv : r.groups) {
+        TelemetryGroupResult &g = kv.second;
+        std::string label = "all";
+        if (q.grouped) {
+            const char *name = value_name(q.group_by, kv.first);
+            label = name ? name : std::to_string(kv.first / kTelemetryColumnInfo[(size_t)q.group_by].scale);
+        }
+        std::printf("%-16s %10llu %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n", label.c_str(), (unsigned long long)g.count,
+                    (double)g.sum / (double)g.count / scale, g.min / scale, percentile(g.values, 0.5) / scale,
+                    percentile(g.values, 0.9) / scale, percentile(g.values, 0.99) / scale, g.max / scale);
+    }
+    std::printf("\n%s filter: %llu of %llu rows matched; %zu of %zu row groups skipped by min/max; "
+                "%zu chunks, %.2f MB read; %.1f ms (%.0f M rows/s)\n",
+                q.simd ? "simd" : "scalar", (unsigned long long)r.rows_matched, (unsigned long long)reader.rows(),
+                r.groups_skipped, reader.groups().size(), r.chunks_read, (double)r.bytes_read / 1e6, ms,
+                ms > 0.0 ? (double)reader.rows() / ms / 1e3 : 0.0);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) { usage(); return 2; }
+    if (std::strcmp(argv[1], "record") == 0) return cmd_record(argv[2], argc - 3, argv + 3);
+    if (std::strcmp(argv[1], "info") == 0) return cmd_info(argv[2]);
+    if (std::strcmp(argv[1], "query") == 0) return cmd_query(argv[2], argc - 3, argv + 3);
+    usage();
+    return 2;
+}
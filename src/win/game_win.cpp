@@ -10,6 +10,7 @@
 #include <chrono>
 #include <thread>
 #include <optional>
+#include <memory>
 #include <algorithm>
 #include <cmath>
 #include <cwchar>
@@ -19,6 +20,13 @@
 #include <fstream>
 
 #include "../core/game_core.h"
+#include "../core/frame_pacer.h"
+#include "../core/state_stream.h"
+#include "../core/time_histogram.h"
+#include "../capture/frame_capture.h"
+#include "../capture/yuv.h"
+#include "../metrics/game_metrics.h"
+#include "../metrics/metrics_server.h"
 #include "highscores.h"
 #include "settings.h"
 #include "rendering/classic_renderer.h"
@@ -69,6 +77,8 @@ struct RecordingState {
     std::chrono::steady_clock::time_point startTime; // real time start for FPS calculation
     int framesAtLastCheck = 0;          // frames at last FPS check
     double realFps = 0.0;               // actual frames per second being recorded
+    StateStreamWriter states;           // GameState per captured frame (recording.pgs, for pong_rerender)
+    std::vector<std::string> panel;     // status panel lines (reused each frame)
 };
 
 static UINT query_dpi(HWND hwnd, int current) {
@@ -117,7 +127,7 @@ int run_win_pong(HINSTANCE inst, int show) {
     wchar_t exePath[MAX_PATH]; GetModuleFileNameW(nullptr, exePath, MAX_PATH);
     std::wstring exeDir = exePath; size_t slash = exeDir.find_last_of(L"/\\"); if (slash!=std::wstring::npos) exeDir = exeDir.substr(0, slash+1);
     SettingsManager settingsMgr; HighScores hsMgr; Settings settings = settingsMgr.load(exeDir + L"settings.json");
-    std::wstring hsPath = exeDir + L"highscores.json"; std::vector<HighScoreEntry> highs = hsMgr.load(hsPath, 10);
+    std::wstring hsPath = exeDir + L"highscores.log"; std::vector<HighScoreEntry> highs = hsMgr.load(hsPath, 10);
 
     GameSession session; session.core().reset();
     enum ControlMode { CTRL_KEYBOARD, CTRL_MOUSE }; enum RendererMode { R_CLASSIC, R_PATH }; enum AIDiff { AI_EASY, AI_NORMAL, AI_HARD };
@@ -135,22 +145,34 @@ int run_win_pong(HINSTANCE inst, int show) {
     // Renderers / HUD / State machine loop
     ClassicRenderer classic; PTRendererAdapter ptAdapter; HudOverlay hud;    
     RecordingState rec; // initialized inactive
+    // Writer threads + frame pool, reused across recordings; QOI compression scales with the threads
+    const int captureThreads = std::max(2, (int)std::thread::hardware_concurrency() - 1);
+    FrameCapture capture(captureThreads, captureThreads + 6);
+    // Optional metrics endpoint for kiosk monitoring (settings.json "metrics_port"); read at startup only
+    MetricsRegistry metricsRegistry; MetricsServer metricsServer(metricsRegistry); std::unique_ptr<GameMetrics> metrics;
+    if(settings.metrics_port > 0){
+        metrics.reset(new GameMetrics(metricsRegistry)); std::string metricsErr;
+        if(metricsServer.start((uint16_t)settings.metrics_port, metricsErr)) session.core().set_event_sink(metrics.get());
+        else { MessageBoxA(hwnd, metricsErr.c_str(), "Metrics", MB_OK|MB_ICONWARNING); metrics.reset(); }
+    }
     st.ui_mode = 1; // start in menu
     if(renderer==R_PATH) ptAdapter.resize(st.width, st.height); else classic.onResize(st.width, st.height);
-    auto last = std::chrono::steady_clock::now(); const double target=1.0/60.0; static int lastW=-1,lastH=-1;
+    FramePacer pacer(60.0); bool pacedLast = false; TimeHistogram photon; static int lastW=-1,lastH=-1;
     while (st.running) {
-        if (st.inputRouter) st.inputRouter->new_frame();
-        MSG msg; while (PeekMessage(&msg,nullptr,0,0,PM_REMOVE)) { TranslateMessage(&msg); DispatchMessage(&msg); }
-        auto now = std::chrono::steady_clock::now();
-        double dt = std::chrono::duration<double>(now-last).count();
+        double dt;
         if (!rec.active) {
-            if (dt < target) { std::this_thread::sleep_for(std::chrono::duration<double>(target-dt)); continue; }
-            last = now;
+            // Wait first so messages that arrived during the wait are handled this frame
+            if (!pacedLast) pacer.reset();
+            dt = pacer.wait();
+            pacedLast = true;
         } else {
             // In recording (render) mode we ignore real time and drive fixed simulation steps as fast as possible.
             dt = rec.fixedStep; // force fixed step
-            last = now; // keep message pump happy
+            pacedLast = false;
         }
+        if (st.inputRouter) st.inputRouter->new_frame();
+        MSG msg; while (PeekMessage(&msg,nullptr,0,0,PM_REMOVE)) { TranslateMessage(&msg); DispatchMessage(&msg); }
+        if (!st.running) break;
 
         int winW = st.width, winH = st.height;
         int dpi  = query_dpi(hwnd, st.dpi);
@@ -205,7 +227,19 @@ int run_win_pong(HINSTANCE inst, int show) {
                             wchar_t buf[128]; swprintf(buf,128,L"recording_%04d%02d%02d_%02d%02d%02d/", stime.wYear, stime.wMonth, stime.wDay, stime.wHour, stime.wMinute, stime.wSecond);
                             rec.dir = exeDir + buf;
                             std::error_code fec; std::filesystem::create_directories(rec.dir, fec);
-                            rec.active = true; rec.frameIndex = 0; rec.simTime = 0.0;
+                            CaptureOptions copt; copt.dir = std::filesystem::path(rec.dir); copt.fps = settings.recording_fps;
+                            copt.format = settings.recording_format==1 ? CaptureFormat::Y4m : settings.recording_format==2 ? CaptureFormat::Qoi
+                                : settings.recording_format>=3 ? CaptureFormat::Archive : CaptureFormat::Bmp;
+                            copt.archive_codec = settings.recording_format==4 ? ArchiveCodec::Qoi : ArchiveCodec::RawBgra;
+                            std::string capErr;
+                            // BMP/QOI/archive: pool sized for the larger of window and screen so a resize mid-recording still fits.
+                            // Y4M: the stream has the window's size; frames of another size are skipped.
+                            const bool cok = copt.format==CaptureFormat::Y4m ? capture.start(copt, winW, winH, capErr)
+                                : capture.start(copt, std::max(winW, GetSystemMetrics(SM_CXSCREEN)), std::max(winH, GetSystemMetrics(SM_CYSCREEN)), capErr);
+                            if(!cok) MessageBoxA(hwnd, capErr.c_str(), "Recording", MB_OK|MB_ICONWARNING);
+                            rec.active = cok; rec.frameIndex = 0; rec.simTime = 0.0;
+                            // The state stream is optional: if it cannot be created the pixels are still recorded
+                            if(cok) rec.states.open(copt.dir / "recording.pgs", settings.recording_fps, capErr);
                             rec.startTime = std::chrono::steady_clock::now();
                             rec.framesAtLastCheck = 0;
                             rec.realFps = 0.0;
@@ -239,8 +273,8 @@ int run_win_pong(HINSTANCE inst, int show) {
                 const InputState &is = st.inputRouter?st.inputRouter->get():InputState{};
                 int deleted=-1; bool delReq = is.just_pressed(VK_DELETE) || (is.click && (GetKeyState(VK_CONTROL)&0x8000));
                 scoresView.frame(st.memDC, winW, winH, dpi, is.mx, is.my, is.click, delReq, &deleted);
-                if(deleted>=0 && deleted < (int)highs.size()){ highs.erase(highs.begin()+deleted); hsMgr.save(hsPath, highs); }
-                if(is.just_pressed(VK_ESCAPE) || is.just_pressed(VK_RETURN)) { scoresOpen=false; st.ui_mode=1; hsMgr.save(hsPath, highs); }
+                if(deleted>=0 && deleted < (int)highs.size()){ hsMgr.remove(hsPath, highs[deleted].id); highs = hsMgr.load(hsPath, 10); }
+                if(is.just_pressed(VK_ESCAPE) || is.just_pressed(VK_RETURN)) { scoresOpen=false; st.ui_mode=1; }
             } else {
                 st.ui_mode=1; // fallback
             }
@@ -281,6 +315,10 @@ int run_win_pong(HINSTANCE inst, int show) {
             if (is.is_pressed(VK_DOWN)) session.core().move_right_by(120.0*dt);
         }
 
+        // Tag the update with this frame's oldest input so its latency can be measured at present
+        if (renderGameplay && (leftHuman || rightHuman) && st.inputRouter && st.inputRouter->get().event_ns)
+            session.core().mark_input(st.inputRouter->get().event_ns);
+
         // Configure AI enable flags inside core each frame so live menu changes apply on return to gameplay
         // Left AI active only in AI vs AI mode; Right AI active in modes 0 (1P vs AI) and 2 (AI vs AI)
     session.core().enable_left_ai(pmode == 2);               // left AI only in AI vs AI
@@ -297,8 +335,14 @@ int run_win_pong(HINSTANCE inst, int show) {
         }
         // Rendering
         if(renderGameplay){
+            // Back buffer pixels for the CPU rasterizer and HUD text (top-down DIB section)
+            const RasterTarget frameTarget{ st.backBuf ? st.backBuf->pixels() : nullptr, (std::min)(winW, st.backBuf ? st.backBuf->width() : 0),
+                                            (std::min)(winH, st.backBuf ? st.backBuf->height() : 0), st.backBuf ? st.backBuf->width() : 0 };
             if (renderer == R_PATH) {
                 ptAdapter.render(gs, settings, UIState{}, st.memDC);
+                GdiFlush(); // StretchDIBits must land before the HUD writes pixels
+            } else if (frameTarget.pixels) {
+                classic.render(gs, frameTarget, dpi);
             } else {
                 classic.render(gs, st.memDC, winW, winH, dpi);
             }
@@ -306,7 +350,8 @@ int run_win_pong(HINSTANCE inst, int show) {
             bool showHud = settings.hud_show_play!=0; // default for gameplay
             if(rec.active && settings.hud_show_record==0) showHud = false; // hide entirely while recording if user chose so
             if(showHud) {
-                hud.draw(gs, renderer==R_PATH?ptAdapter.stats():nullptr, st.memDC, winW, winH, dpi, highScore);
+                const FramePacerStats frameStats = pacer.stats();
+                hud.draw(gs, renderer==R_PATH?ptAdapter.stats():nullptr, frameTarget, dpi, highScore, &frameStats, &photon);
             }
             if(rec.active){
                 // Calculate actual recording FPS every second
@@ -318,23 +363,18 @@ int run_win_pong(HINSTANCE inst, int show) {
                     rec.framesAtLastCheck = rec.frameIndex;
                 }
                 
-                // Recording info panel to the right of standard HUD (HUD width ~280px)
-                int boxW = 260; int boxX = 300; int boxY = 0; int boxH = 150;
-                HBRUSH rb = CreateSolidBrush(RGB(8,8,12)); RECT rr{boxX,boxY,boxX+boxW,boxY+boxH}; FillRect(st.memDC,&rr,rb); DeleteObject(rb);
-                SetBkMode(st.memDC, TRANSPARENT); SetTextColor(st.memDC, RGB(255,80,80));
-                wchar_t recTxt[128]; swprintf(recTxt,128,L"RECORDING %dfps", rec.fps);
-                RECT r1{boxX+8,boxY+6,boxX+boxW-8,boxY+26}; DrawTextW(st.memDC, recTxt, -1, &r1, DT_LEFT|DT_TOP|DT_SINGLELINE);
+                // Recording info panel to the right of the standard HUD
+                auto add = [&](const char *fmt, auto... args){ char b[128]; std::snprintf(b, sizeof(b), fmt, args...); rec.panel.emplace_back(b); };
+                rec.panel.clear();
+                add("RECORDING %dfps", rec.fps);
                 int fpsDiv = rec.fps < 1 ? 1 : rec.fps;
                 double simSeconds = rec.frameIndex / (double)fpsDiv;
-                wchar_t meta[128]; swprintf(meta,128,L"Frames: %d", rec.frameIndex);
-                RECT r2{boxX+8,boxY+28,boxX+boxW-8,boxY+48}; DrawTextW(st.memDC, meta, -1, &r2, DT_LEFT|DT_TOP|DT_SINGLELINE);
-                wchar_t meta2[128]; swprintf(meta2,128,L"Sim Time: %.1fs", simSeconds);
-                RECT r3{boxX+8,boxY+48,boxX+boxW-8,boxY+68}; DrawTextW(st.memDC, meta2, -1, &r3, DT_LEFT|DT_TOP|DT_SINGLELINE);
+                add("Frames: %d", rec.frameIndex);
+                add("Sim Time: %.1fs", simSeconds);
                 
                 // Show actual recording FPS and time estimates
                 if(rec.realFps > 0.1){
-                    wchar_t fpsTxt[128]; swprintf(fpsTxt,128,L"Actual: %.1f fps", rec.realFps);
-                    RECT r4{boxX+8,boxY+68,boxX+boxW-8,boxY+88}; DrawTextW(st.memDC, fpsTxt, -1, &r4, DT_LEFT|DT_TOP|DT_SINGLELINE);
+                    add("Actual: %.1f fps", rec.realFps);
                     
                     // Duration-based progress
                     if(rec.duration > 0){
@@ -344,53 +384,48 @@ int run_win_pong(HINSTANCE inst, int show) {
                         double estSeconds = remaining / rec.realFps;
                         int mins = (int)(estSeconds / 60.0);
                         int secs = (int)(estSeconds) % 60;
-                        wchar_t estTxt[128]; swprintf(estTxt,128,L"Est. Remaining: %dm %ds", mins, secs);
-                        RECT r5{boxX+8,boxY+88,boxX+boxW-8,boxY+108}; DrawTextW(st.memDC, estTxt, -1, &r5, DT_LEFT|DT_TOP|DT_SINGLELINE);
+                        add("Est. Remaining: %dm %ds", mins, secs);
                         
                         int pct = targetFrames > 0 ? (rec.frameIndex * 100) / targetFrames : 0;
                         if(pct > 100) pct = 100;
-                        wchar_t pctTxt[128]; swprintf(pctTxt,128,L"Progress: %d%%", pct);
-                        RECT r6{boxX+8,boxY+108,boxX+boxW-8,boxY+128}; DrawTextW(st.memDC, pctTxt, -1, &r6, DT_LEFT|DT_TOP|DT_SINGLELINE);
+                        add("Progress: %d%%", pct);
                     } else {
-                        wchar_t unlimTxt[128]; swprintf(unlimTxt,128,L"Duration: Unlimited");
-                        RECT r5{boxX+8,boxY+88,boxX+boxW-8,boxY+108}; DrawTextW(st.memDC, unlimTxt, -1, &r5, DT_LEFT|DT_TOP|DT_SINGLELINE);
+                        add("Duration: Unlimited");
                     }
                 }
+                int boxX = showHud ? hud.panelRight() + iround(8*dpi/96.0) : 0;
+                hud.drawPanel(frameTarget, boxX, 0, dpi, rec.panel, 0xFF5050);
             }
         }
         // Menu or modal already drew into st.memDC; no HUD overlay in those modes.
 
         HDC hdc=GetDC(hwnd); BitBlt(hdc,0,0,winW,winH,st.memDC,0,0,SRCCOPY); ReleaseDC(hwnd,hdc);
+        hud.endFrame();
+        // Input-to-photon up to the blit (the compositor adds its own, unmeasured, frame)
+        if (renderGameplay && !rec.active && gs.input_ns)
+            photon.add_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count() - gs.input_ns);
+        if (metrics && renderGameplay && !rec.active) {
+            metrics->frame(dt, std::chrono::duration<double>(FramePacer::clock::now() - pacer.frame_start()).count(), pacer.missed_frames());
+            metrics->state(gs);
+            if (renderer == R_PATH && ptAdapter.stats()) metrics->render(*ptAdapter.stats());
+        }
 
         // Frame capture after present (use back buffer DC content)
         if(rec.active && renderGameplay){
-            // Capture BMP (BGRA 32-bit) and pad to even dimensions (H.264 yuv420p requires even w/h)
-            BITMAPINFO bmi{}; bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER); bmi.bmiHeader.biWidth = winW; bmi.bmiHeader.biHeight = winH; // bottom-up
-            bmi.bmiHeader.biPlanes = 1; bmi.bmiHeader.biBitCount = 32; bmi.bmiHeader.biCompression = BI_RGB;
-            std::vector<uint8_t> raw((size_t)winW * (size_t)winH * 4);
-            if(GetDIBits(st.memDC, st.backBuf->getBitmap(), 0, (UINT)winH, raw.data(), &bmi, DIB_RGB_COLORS)){
-                int recW = (winW & 1)? (winW+1): winW;
-                int recH = (winH & 1)? (winH+1): winH;
-                std::vector<uint8_t> pixels((size_t)recW * (size_t)recH * 4, 0);
-                // Copy existing rows; bottom-up order preserved. Extra column/row left black.
-                for(int y=0; y<winH; ++y){
-                    const uint8_t* srcRow = &raw[(size_t)y * winW * 4];
-                    uint8_t* dstRow = &pixels[(size_t)y * recW * 4];
-                    std::memcpy(dstRow, srcRow, (size_t)winW * 4);
-                }
-                // Construct file path
-                wchar_t fname[256]; swprintf(fname,256,L"frame_%06d.bmp", rec.frameIndex);
-                std::wstring fpath = rec.dir + fname;
-                uint32_t rowSize = recW * 4; // 4-byte aligned already
-                uint32_t pixelDataSize = rowSize * recH;
-                uint32_t fileSize = 14 + 40 + pixelDataSize;
-                std::ofstream ofs(fpath, std::ios::binary);
-                if(ofs){
-                    uint8_t fh[14]; std::memset(fh,0,14); fh[0]='B'; fh[1]='M'; *reinterpret_cast<uint32_t*>(fh+2)=fileSize; *reinterpret_cast<uint32_t*>(fh+10)=14+40; ofs.write((char*)fh,14);
-                    BITMAPINFOHEADER bih{}; bih.biSize=40; bih.biWidth=recW; bih.biHeight=recH; bih.biPlanes=1; bih.biBitCount=32; bih.biCompression=BI_RGB; bih.biSizeImage=pixelDataSize; ofs.write((char*)&bih,40);
-                    ofs.write((char*)pixels.data(), pixelDataSize);
+            // Copy the back buffer into a pooled slot; padding to even size and the BMP write happen on the capture threads
+            CaptureFrame *frame = capture.acquire();
+            if(frame){
+                BITMAPINFO bmi{}; bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER); bmi.bmiHeader.biWidth = winW; bmi.bmiHeader.biHeight = winH; // bottom-up
+                bmi.bmiHeader.biPlanes = 1; bmi.bmiHeader.biBitCount = 32; bmi.bmiHeader.biCompression = BI_RGB;
+                if(winW <= frame->width && winH <= frame->height &&
+                   GetDIBits(st.memDC, st.backBuf->getBitmap(), 0, (UINT)winH, frame->pixels, &bmi, DIB_RGB_COLORS)){
+                    frame->width = winW; frame->height = winH;
+                    capture.submit(frame);
+                    rec.states.write(gs);
+                    rec.frameIndex++;
+                } else {
+                    capture.release(frame);
                 }
-                rec.frameIndex++;
             }
         }
 
@@ -401,16 +436,44 @@ int run_win_pong(HINSTANCE inst, int show) {
             if(rec.frameIndex >= targetFrames) durationReached = true;
         }
         if(rec.active && (st.ui_mode != 0 || durationReached)){
-            // Write summary file
+            // Let the capture threads drain, then write the summary file
+            capture.finish();
+            rec.states.close();
+            const CaptureStats cs = capture.stats();
             std::wstring summary = rec.dir + L"recording_info.txt";
             std::ofstream s(summary);
             if(s){
                 s << "Frames: " << rec.frameIndex << "\n";
                 s << "FPS: " << rec.fps << "\n";
+                const char *fmtNames[] = { "BMP per frame", "Y4M (recording.y4m, yuv420p)", "QOI per frame (lossless)",
+                                           "Frame archive (recording.pfa, raw)", "Frame archive (recording.pfa, QOI)" };
+                const char *fmtName = fmtNames[settings.recording_format];
+                s << "Format: " << fmtName << "\n";
+                s << "Written: " << cs.frames << " frames, " << (cs.bytes >> 20) << " MB";
+                if(cs.failed) s << ", " << cs.failed << " failed";
+                s << "\n";
+                if(cs.write_ms > 0.0) s << "Disk throughput: " << (int)(cs.bytes / (cs.write_ms * 1e3)) << " MB/s per writer\n";
+                if(cs.frames && settings.recording_format==1) s << "YUV conversion: " << cs.encode_ms / (double)cs.frames << " ms/frame (" << yuv_simd_path() << ")\n";
+                if(settings.recording_format>=3) s << "Archive writes: " << (cs.direct_io ? "unbuffered (bypassing the file cache)" : "buffered") << "\n";
+                if(cs.frames && (settings.recording_format==2 || settings.recording_format==4)){
+                    s << "QOI encode: " << cs.encode_ms / (double)cs.frames << " ms/frame on " << captureThreads << " threads\n";
+                    if(cs.bytes) s << "Compression ratio: " << (double)cs.raw_bytes / (double)cs.bytes << ":1 vs BMP (" << (cs.raw_bytes >> 20) << " MB)\n";
+                }
+                if(rec.states.frames()) s << "GameState stream: recording.pgs (" << rec.states.frames() << " frames; re-render with pong_rerender)\n";
+                s << "Capture stalls: " << cs.stalls << " (" << (int)cs.stall_ms << " ms waiting for the disk)\n";
                 s << "Note: Frames padded to even dimensions for H.264 compatibility.\n";
                 s << "Suggested ffmpeg command (PowerShell):\n";
-                s << "ffmpeg -framerate " << rec.fps << " -i frame_%06d.bmp -c:v libx264 -pix_fmt yuv420p output.mp4\n";
-                s << "If you need HEVC: ffmpeg -framerate " << rec.fps << " -i frame_%06d.bmp -c:v libx265 -pix_fmt yuv420p10le output_hevc.mp4\n";
+                if(settings.recording_format==1){
+                    s << "ffmpeg -i recording.y4m -c:v libx264 output.mp4\n";
+                } else if(settings.recording_format>=3){
+                    s << "pong_archive y4m recording.pfa \"|ffmpeg -i - -c:v libx264 output.mp4\"\n";
+                    s << "Or export images: pong_archive bmp recording.pfa frames\n";
+                } else if(settings.recording_format==2){
+                    s << "ffmpeg -framerate " << rec.fps << " -i frame_%06d.qoi -c:v libx264 -pix_fmt yuv420p output.mp4\n";
+                } else {
+                    s << "ffmpeg -framerate " << rec.fps << " -i frame_%06d.bmp -c:v libx264 -pix_fmt yuv420p output.mp4\n";
+                    s << "If you need HEVC: ffmpeg -framerate " << rec.fps << " -i frame_%06d.bmp -c:v libx265 -pix_fmt yuv420p10le output_hevc.mp4\n";
+                }
             }
             rec.active = false;
             // Automatically turn off recording toggle so user must re-enable explicitly
@@ -418,5 +481,6 @@ int run_win_pong(HINSTANCE inst, int show) {
         }
     }
 
+    metricsServer.stop(); session.core().set_event_sink(nullptr);
     if(st.memDC && st.uiOldFont) SelectObject(st.memDC, st.uiOldFont); if(st.uiFont) DeleteObject(st.uiFont); delete st.inputRouter; delete st.backBuf; return 0; }
 
@@ -1,7 +1,7 @@
 #include "highscores.h"
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
-#include <sstream>
-#include <algorithm>
 #include <windows.h>
 
 static std::wstring utf8_to_wstring(const std::string &s) {
@@ -22,74 +22,69 @@ static std::string wstring_to_utf8(const std::wstring &s) {
     return out;
 }
 
-static std::wstring trim(const std::wstring &s) {
-    size_t a = 0; while (a < s.size() && iswspace(s[a])) ++a;
-    size_t b = s.size(); while (b > a && iswspace(s[b-1])) --b;
-    return s.substr(a, b - a);
+// Entries of the pre-log highscores.json, one {"name":"...","score":N} object per line
+static void import_legacy(const std::filesystem::path &json, ScoreBoard &board) {
+    std::ifstream ifs(json, std::ios::binary);
+    if (!ifs) return;
+    board.storage().set_durable(false);
+    std::string line;
+    while (std::getline(ifs, line)) {
+        size_t npos = line.find("\"name\"");
+        size_t spos = line.find("\"score\"");
+        if (npos == std::string::npos || spos == std::string::npos) continue;
+        size_t q1 = line.find('"', npos + 6);
+        if (q1 == std::string::npos) continue;
+        // Names were saved with quotes escaped as \"
+        std::string name;
+        size_t q = q1 + 1;
+        for (; q < line.size() && line[q] != '"'; ++q) {
+            if (line[q] == '\\' && q + 1 < line.size()) ++q;
+            name += line[q];
+        }
+        size_t colon = line.find(':', spos);
+        if (q >= line.size() || colon == std::string::npos) continue;
+        char *end = nullptr;
+        long score = std::strtol(line.c_str() + colon + 1, &end, 10);
+        if (end == line.c_str() + colon + 1) continue;
+        board.submit(name, (int32_t)score);
+    }
+    board.storage().flush(true);
+    board.storage().set_durable(true);
 }
 
-std::vector<HighScoreEntry> HighScores::load(const std::wstring &path, size_t maxEntries) {
+bool HighScores::open(const std::wstring &path) {
+    if (board.is_open() && openPath == path) return true;
+    openPath.clear();
+    const std::filesystem::path p(path);
+    const bool fresh = !std::filesystem::exists(p);
+    std::string err;
+    if (!board.open(p, err)) return false;
+    if (fresh) import_legacy(std::filesystem::path(p).replace_extension(L".json"), board);
+    openPath = path;
+    return true;
+}
+
+std::vector<HighScoreEntry> HighScores::top(size_t maxEntries) const {
     std::vector<HighScoreEntry> out;
-    std::ifstream ifs;
-    std::string p = wstring_to_utf8(path);
-    ifs.open(p, std::ios::binary);
-    if (!ifs) return out;
-    std::string raw;
-    while (std::getline(ifs, raw)) {
-        std::wstring line = utf8_to_wstring(raw);
-        line = trim(line);
-        if (line.empty()) continue;
-        // Very tiny JSON-ish parser expecting lines like: {"name":"Player","score":123}
-        size_t npos = line.find(L"\"name\"");
-        size_t spos = line.find(L"\"score\"");
-        if (npos==std::wstring::npos || spos==std::wstring::npos) continue;
-        size_t q1 = line.find(L'"', npos + 6);
-        size_t q2 = line.find(L'"', q1 + 1);
-        if (q1==std::wstring::npos || q2==std::wstring::npos) continue;
-        std::wstring name = line.substr(q1+1, q2-q1-1);
-        size_t colon = line.find(L':', spos);
-        if (colon==std::wstring::npos) continue;
-        size_t numStart = colon+1;
-        while (numStart < line.size() && iswspace(line[numStart])) ++numStart;
-        int score = 0;
-        try { score = std::stoi(std::wstring(line.begin()+numStart, line.end())); } catch(...) { continue; }
-        out.push_back({name, score});
-        if (out.size() >= maxEntries) break;
-    }
-    std::sort(out.begin(), out.end(), [](const HighScoreEntry &a, const HighScoreEntry &b){return a.score > b.score;});
-    if (out.size() > maxEntries) out.resize(maxEntries);
+    for (const ScoreEntry &e : board.top(maxEntries)) out.push_back({ utf8_to_wstring(e.name), e.score, e.id });
     return out;
 }
 
-bool HighScores::save(const std::wstring &path, const std::vector<HighScoreEntry> &list) {
-    std::ofstream ofs;
-    std::string p2 = wstring_to_utf8(path);
-    ofs.open(p2, std::ios::binary | std::ios::trunc);
-    if (!ofs) return false;
-    ofs << "[\n";
-    for (size_t i=0;i<list.size();++i) {
-        const auto &e = list[i];
-        // escape quotes in name
-        std::wstring name = e.name;
-        std::wstring esc;
-        for (wchar_t ch : name) {
-            if (ch == L'"') esc += L"\\\"";
-            else esc += ch;
-        }
-        std::string utf = wstring_to_utf8(esc);
-        ofs << "  {\"name\":\"" << utf << "\",\"score\":" << e.score << "}";
-        if (i+1<list.size()) ofs << ",";
-        ofs << "\n";
-    }
-    ofs << "]\n";
-    return true;
+std::vector<HighScoreEntry> HighScores::load(const std::wstring &path, size_t maxEntries) {
+    if (!open(path)) return {};
+    return top(maxEntries);
+}
+
+bool HighScores::remove(const std::wstring &path, uint64_t id) {
+    return open(path) && board.remove(id);
 }
 
 std::vector<HighScoreEntry> HighScores::add_and_get(const std::wstring &path, const std::wstring &name, int score, size_t maxEntries) {
-    auto list = load(path, maxEntries);
-    list.push_back({name, score});
-    std::sort(list.begin(), list.end(), [](const HighScoreEntry &a, const HighScoreEntry &b){return a.score > b.score;});
-    if (list.size() > maxEntries) list.resize(maxEntries);
-    save(path, list);
-    return list;
+    if (!open(path)) return {};
+    board.submit(wstring_to_utf8(name), score);
+    return top(maxEntries);
+}
+
+size_t HighScores::rank_of_score(const std::wstring &path, int score) {
+    return open(path) ? board.rank_of_score(score) : 0;
 }
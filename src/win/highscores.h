@@ -1,31 +1,38 @@
 /**
  * @file highscores.h
  * @brief High score tracking and persistence for Windows GUI version
- * 
- * This file defines structures and classes for managing player high scores
- * with persistent storage in JSON format.
+ *
+ * This file defines structures and classes for managing player high scores.
+ * Storage is the portable append-only score log (scores/score_board.h):
+ * a new score or a deletion is one appended record instead of a rewrite
+ * of the whole file, and the top of the table comes from an in-memory
+ * index that stays open between calls.
  */
 
 #pragma once
+#include "../scores/score_board.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 
 /**
  * @brief Single high score entry
- * 
+ *
  * Represents one entry in the high score table with player name and score.
  */
-struct HighScoreEntry { 
+struct HighScoreEntry {
     std::wstring name;  ///< Player name (Unicode support)
     int score;          ///< Player's score
+    uint64_t id = 0;    ///< Score log id, used to delete the entry (0 = not stored)
 };
 
 /**
  * @brief High score management class
- * 
- * Handles loading, saving, and updating high score lists with automatic
- * sorting and persistence to JSON files. Maintains a configurable number
- * of top scores and provides methods for adding new entries.
+ *
+ * Opens the score log on first use and keeps it open; later calls with
+ * the same path answer from memory. On the first open of a new log the
+ * entries of a legacy JSON table next to it (same name, .json extension)
+ * are imported.
  */
 class HighScores {
 public:
@@ -33,45 +40,59 @@ public:
      * @brief Default constructor
      */
     HighScores() = default;
-    
+
     /**
-     * @brief Load high scores from JSON file
-     * 
-     * Reads and parses high scores from the specified file. Returns
-     * an empty list if the file doesn't exist or cannot be parsed.
-     * Results are automatically sorted by score in descending order.
-     * 
-     * @param path Wide string path to the high scores JSON file
-     * @param maxEntries Maximum number of entries to load (default: 10)
+     * @brief Load high scores from the score log
+     *
+     * Opens (or creates) the log at the specified path. Returns an
+     * empty list if it cannot be opened.
+     * Results are sorted by score in descending order.
+     *
+     * @param path Wide string path to the high score log
+     * @param maxEntries Maximum number of entries to return (default: 10)
      * @return Vector of HighScoreEntry objects sorted by score
      */
     std::vector<HighScoreEntry> load(const std::wstring &path, size_t maxEntries = 10);
-    
+
     /**
-     * @brief Save high scores to JSON file
-     * 
-     * Serializes and writes the high score list to a JSON file.
-     * The list should already be sorted in the desired order.
-     * 
-     * @param path Wide string path where high scores should be saved
-     * @param list Vector of HighScoreEntry objects to save
-     * @return true if save was successful, false on error
+     * @brief Delete one high score
+     *
+     * Appends a deletion record for the entry; the log is compacted
+     * once deleted entries outweigh live ones.
+     *
+     * @param path Wide string path to the high score log
+     * @param id Id of the entry (HighScoreEntry::id)
+     * @return true if the entry existed and the deletion was stored
      */
-    bool save(const std::wstring &path, const std::vector<HighScoreEntry> &list);
-    
+    bool remove(const std::wstring &path, uint64_t id);
+
     /**
      * @brief Add new score and return updated list
-     * 
-     * Convenience method that loads existing scores, adds a new entry,
-     * sorts the list, trims to maximum entries, saves to disk, and
-     * returns the updated list. This is the primary method for
-     * recording new high scores.
-     * 
-     * @param path Wide string path to the high scores JSON file
+     *
+     * Appends the new entry to the log and returns the top of the
+     * table. This is the primary method for recording new high scores.
+     *
+     * @param path Wide string path to the high score log
      * @param name Player name for the new entry
      * @param score Player's score
-     * @param maxEntries Maximum entries to keep (default: 10)
+     * @param maxEntries Maximum entries to return (default: 10)
      * @return Updated and sorted high score list
      */
     std::vector<HighScoreEntry> add_and_get(const std::wstring &path, const std::wstring &name, int score, size_t maxEntries = 10);
+
+    /**
+     * @brief 1-based place @p score would take in the full table
+     *
+     * @param path Wide string path to the high score log
+     * @param score Score to rank
+     * @return Place, or 0 if the log cannot be opened
+     */
+    size_t rank_of_score(const std::wstring &path, int score);
+
+private:
+    bool open(const std::wstring &path);
+    std::vector<HighScoreEntry> top(size_t maxEntries) const;
+
+    ScoreBoard board{ 10 };
+    std::wstring openPath;  ///< Path of the open log (empty = none)
 };
@@ -1,6 +1,16 @@
 #include "input_router.h"
 #include <windowsx.h>
+#include <chrono>
 void InputRouter::handle(UINT m, WPARAM w, LPARAM l){
+    // Stamp the first input of the frame (key press, not auto-repeat; mouse) for input-to-photon latency
+    const bool fresh_key = (m == WM_KEYDOWN || m == WM_SYSKEYDOWN) && !(l & (1L << 30));
+    if (!state.event_ns && (fresh_key || m == WM_MOUSEMOVE || m == WM_LBUTTONDOWN)) {
+        // The loop pumps after the pacer wait, so stamp when the message was posted, not now.
+        // GetMessageTime() runs on the GetTickCount() clock; its age moves the steady-clock stamp back.
+        const LONG age_ms = (LONG)(GetTickCount() - (DWORD)GetMessageTime());
+        state.event_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (age_ms > 0) state.event_ns -= (long long)age_ms * 1000000;
+    }
     switch(m){
     case WM_MOUSEMOVE: state.mx = GET_X_LPARAM(l); state.my = GET_Y_LPARAM(l); break;
     case WM_LBUTTONDOWN: state.mdown=true; break;
@@ -28,6 +28,7 @@ struct InputState {
     bool mdown = false;          ///< Left mouse button is currently pressed
     int wheel = 0;               ///< Mouse wheel delta this frame
     bool click = false;          ///< Mouse was clicked this frame (edge event)
+    long long event_ns = 0;      ///< Steady-clock time the oldest key press / mouse event this frame was posted (0 = none)
     
     /**
      * @brief Advance to next frame by saving current state as previous
@@ -40,6 +41,7 @@ struct InputState {
             prev[i] = keys[i]; 
         click = false; 
         wheel = 0; 
+        event_ns = 0;
     }
     
     /**
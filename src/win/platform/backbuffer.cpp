@@ -1,3 +1,11 @@
 #include "backbuffer.h"
 BackBuffer::~BackBuffer(){ if(memDC){ SelectObject(memDC, oldBmp); DeleteObject(bmp); DeleteDC(memDC);} }
-void BackBuffer::resize(HDC screen, int w, int h){ if(memDC){ SelectObject(memDC, oldBmp); DeleteObject(bmp); DeleteDC(memDC);} W=w;H=h; memDC=CreateCompatibleDC(screen); bmp=CreateCompatibleBitmap(screen,W,H); oldBmp=(HBITMAP)SelectObject(memDC,bmp); }
+void BackBuffer::resize(HDC screen, int w, int h){
+	if(memDC){ SelectObject(memDC, oldBmp); DeleteObject(bmp); DeleteDC(memDC);} W=w;H=h; bits=nullptr;
+	memDC=CreateCompatibleDC(screen);
+	BITMAPINFO bi{}; bi.bmiHeader.biSize=sizeof(BITMAPINFOHEADER); bi.bmiHeader.biWidth=W; bi.bmiHeader.biHeight=-H; // top-down
+	bi.bmiHeader.biPlanes=1; bi.bmiHeader.biBitCount=32; bi.bmiHeader.biCompression=BI_RGB;
+	void* px=nullptr; bmp=CreateDIBSection(screen,&bi,DIB_RGB_COLORS,&px,nullptr,0);
+	if(bmp) bits=(uint32_t*)px; else bmp=CreateCompatibleBitmap(screen,W,H);
+	oldBmp=(HBITMAP)SelectObject(memDC,bmp);
+}
@@ -8,6 +8,7 @@
 
 #pragma once
 #include <windows.h>
+#include <cstdint>
 
 /**
  * @brief Off-screen GDI rendering buffer
@@ -18,6 +19,10 @@
  * to the off-screen buffer first, then copy the complete image
  * to the screen in a single operation.
  * 
+ * The bitmap is a top-down 32-bit DIB section, so besides GDI drawing
+ * through dc() its pixels can be written directly (classic rasterizer,
+ * HUD text). Call GdiFlush() between GDI calls and direct pixel access.
+ *
  * The buffer automatically manages its own device context and
  * handles cleanup of GDI resources when destroyed.
  */
@@ -61,10 +66,16 @@ public:
      */
     HDC dc() const { return memDC; }
     HBITMAP getBitmap() const { return bmp; }
+
+    /// @brief Top row of the 0x00RRGGBB pixels (rows are width() pixels apart), nullptr before resize()
+    uint32_t* pixels() const { return bits; }
+    int width() const { return W; }
+    int height() const { return H; }
     
 private:
     HDC memDC = nullptr;      ///< Memory device context for off-screen drawing
-    HBITMAP bmp = nullptr;    ///< Off-screen bitmap handle  
+    HBITMAP bmp = nullptr;    ///< Off-screen DIB section handle
+    uint32_t* bits = nullptr; ///< DIB section pixels (owned by bmp)
     HBITMAP oldBmp = nullptr; ///< Previously selected bitmap (for restoration)
     int W = 0;                ///< Current buffer width in pixels
     int H = 0;                ///< Current buffer height in pixels
@@ -1,65 +1,79 @@
 /**
  * @file classic_renderer.h
- * @brief Classic GDI-based renderer for Pong gameplay
+ * @brief Classic flat-look renderer for Pong gameplay
  * 
- * This file defines the ClassicRenderer class which provides fast,
- * traditional 2D graphics rendering using Windows GDI APIs.
+ * This file defines the ClassicRenderer class which draws the classic
+ * look with the portable CPU rasterizer (raster/classic_raster.h) and
+ * presents the frame to a GDI device context.
  */
 
 #pragma once
 #include <windows.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 struct GameState;
+struct RasterTarget;
+class ClassicRaster;
 
 /**
- * @brief Classic GDI renderer for Pong gameplay
+ * @brief Classic renderer for Pong gameplay
  * 
- * ClassicRenderer provides fast, traditional 2D graphics rendering
- * using Windows GDI APIs. It is stateless with respect to game logic
- * but caches GDI resources (pens, brushes) sized according to DPI
- * for optimal performance and visual quality.
- * 
- * The renderer creates crisp, pixel-perfect graphics suitable for
- * all systems and provides excellent performance with minimal
- * CPU usage compared to software ray tracing alternatives.
+ * ClassicRenderer rasterizes the scene into its own 32-bit top-down
+ * framebuffer with ClassicRaster (anti-aliased shapes, SIMD span fills,
+ * tiles shared by a few worker threads) and copies it to the target DC
+ * with a single SetDIBitsToDevice call. It is stateless with respect to
+ * game logic; the only per-frame GDI work is that one blit, so no pens
+ * or brushes are created or destroyed while playing.
  */
 class ClassicRenderer {
 public:
     /**
      * @brief Construct a new ClassicRenderer
      * 
-     * Initializes the renderer but does not create GDI resources.
-     * Resources are created lazily when first needed.
+     * Starts the rasterizer's tile workers; the framebuffer is
+     * allocated on the first resize or render.
      */
     ClassicRenderer();
     
     /**
-     * @brief Destroy the ClassicRenderer and clean up GDI resources
-     * 
-     * Releases all cached GDI objects including pens and brushes.
+     * @brief Destroy the ClassicRenderer and stop the tile workers
      */
     ~ClassicRenderer();
     
     /**
      * @brief Render the game state to the specified device context
      * 
-     * Draws the complete game scene including paddles, ball, scores,
-     * and playing field using GDI drawing operations. Automatically
-     * scales rendering based on DPI settings.
+     * Rasterizes the complete game scene (paddles, balls, obstacles,
+     * centre line) into the framebuffer and blits it to @p dc.
+     * Fixed-size elements scale with the DPI.
      * 
      * @param gameState Current game state containing positions and scores
-     * @param dc Windows device context for drawing operations
+     * @param dc Windows device context receiving the frame
      * @param winW Window width in pixels
      * @param winH Window height in pixels
      * @param dpi Current DPI setting for scaling calculations
      */
     void render(const GameState& gameState, HDC dc, int winW, int winH, int dpi);
+
+    /**
+     * @brief Rasterize the game state straight into a caller-owned framebuffer
+     * 
+     * Used with the back buffer's DIB section pixels, which skips the
+     * internal frame and the blit.
+     * 
+     * @param gameState Current game state
+     * @param target 32-bit framebuffer (0x00RRGGBB)
+     * @param dpi Current DPI setting for scaling calculations
+     */
+    void render(const GameState& gameState, const RasterTarget& target, int dpi);
     
     /**
      * @brief Handle window resize events
      * 
-     * Called when the window is resized. Currently a no-op but kept
-     * for future enhancements that might require resize handling.
+     * Reallocates the framebuffer and its DIB header for the new size
+     * (render() also does this when the size changes).
      * 
      * @param winW New window width in pixels
      * @param winH New window height in pixels
@@ -67,18 +81,8 @@ public:
     void onResize(int winW, int winH);
     
 private:
-    /**
-     * @brief Ensure GDI resources are created for the specified DPI
-     * 
-     * Creates or recreates GDI resources (pens, brushes) if the DPI
-     * has changed since last rendering. Resources are scaled appropriately
-     * for the current DPI setting.
-     * 
-     * @param dpi Current DPI setting
-     */
-    void ensureResources(int dpi);
-    
-    int cachedDpi = 0;         ///< Last DPI setting for which resources were created
-    HPEN penThin = nullptr;    ///< Thin pen for fine details and outlines
-    HPEN penGlow = nullptr;    ///< Thick pen for glow effects and emphasis
+    std::unique_ptr<ClassicRaster> raster; ///< Tile-parallel rasterizer (owns its worker threads)
+    std::vector<uint32_t> frame;           ///< Top-down 0x00RRGGBB framebuffer
+    BITMAPINFO bmi{};                      ///< 32-bit top-down DIB header for frame
+    int fbW = 0, fbH = 0;                  ///< Current framebuffer size
 };
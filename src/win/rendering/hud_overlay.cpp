@@ -1,53 +1,74 @@
 #include "hud_overlay.h"
 #include "../../core/game_core.h"
-#include "../soft_renderer.h"
-#include <string>
-#include <cwchar>
+#include "../../render/soft_renderer.h"
+#include "../../core/frame_pacer.h"
+#include "../../core/time_histogram.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdarg>
 
-static void drawText(HDC dc, const std::wstring& txt, int x, int y) {
-	RECT r{ x,y,x+1200,y+40 }; DrawTextW(dc, txt.c_str(), -1, &r, DT_LEFT|DT_TOP|DT_NOPREFIX|DT_SINGLELINE);
+static constexpr uint32_t kHudText = 0xE6E6E6;
+static constexpr uint32_t kHudBack = 0x08080C;
+static constexpr int kHudBackAlpha = 200; // semi-transparent panel (0..256)
+
+void HudOverlay::line(const char* fmt, ...) {
+	char buf[256];
+	va_list args; va_start(args, fmt); std::vsnprintf(buf, sizeof(buf), fmt, args); va_end(args);
+	lines.emplace_back(buf);
 }
 
-void HudOverlay::draw(const GameState& gs, const SRStats* stats, HDC dc, int w, int h, int dpi, int highScore) {
-	if(!dc) return;
+int HudOverlay::panel(const RasterTarget& target, int x, int y, int dpi, uint32_t color) {
 	double ui = (double)dpi/96.0;
-	int xPad = (int)(10*ui);
-	int yPad = xPad;
-	std::wstring score = std::to_wstring(gs.score_left) + L" - " + std::to_wstring(gs.score_right);
-	// Semi-transparent background for readability
-	HBRUSH back = CreateSolidBrush(RGB(8,8,12)); RECT bg{0,0,(int)(280*ui),(int)(140*ui)}; FillRect(dc,&bg,back); DeleteObject(back);
-	drawText(dc, score, xPad, yPad);
-	int lineH = (int)(18*ui + 0.5);
-	int line = 1;
+	text.set_height((int)(12*ui + 0.5));
+	int pad = (int)(8*ui + 0.5);
+	int lineH = text.height() + (int)(4*ui + 0.5);
+	int w = 0;
+	for (const std::string& l : lines) w = (std::max)(w, text.measure(l));
+	TextRenderer::fill(target, x, y, w + 2*pad, (int)lines.size()*lineH + 2*pad - (lineH - text.height()), kHudBack, kHudBackAlpha);
+	for (size_t i = 0; i < lines.size(); ++i) text.draw(target, x + pad, y + pad + (int)i*lineH, lines[i], color);
+	return w + 2*pad;
+}
+
+void HudOverlay::draw(const GameState& gs, const SRStats* stats, const RasterTarget& target, int dpi, int highScore,
+                      const FramePacerStats* frame, const TimeHistogram* latency) {
+	if(!target.pixels) return;
+	lines.clear();
+	line("%d - %d", gs.score_left, gs.score_right);
 	// Game mode line (requires GameMode enum names; rely on order in game_core.h)
-	std::wstring modeName = L"Classic";
-	// Heuristic: determine mode by presence of obstacles / extra paddles / multiple balls
-	if (gs.mode == GameMode::ThreeEnemies) modeName = L"Three Enemies";
-	else if (gs.mode == GameMode::Obstacles) modeName = L"Obstacles";
-	else if (gs.mode == GameMode::MultiBall) modeName = L"MultiBall";
-	drawText(dc, L"Mode: " + modeName, xPad, yPad + lineH*line++);
+	const char* modeName = "Classic";
+	if (gs.mode == GameMode::ThreeEnemies) modeName = "Three Enemies";
+	else if (gs.mode == GameMode::Obstacles) modeName = "Obstacles";
+	else if (gs.mode == GameMode::MultiBall) modeName = "MultiBall";
+	else if (gs.mode == GameMode::ObstaclesMulti) modeName = "Obstacles + MultiBall";
+	line("Mode: %s", modeName);
+	if(frame && frame->frames)
+		line("Frame p50 %.1f  p99 %.1f  max %.1f ms", frame->p50_ms, frame->p99_ms, frame->max_ms);
+	if(latency && latency->count())
+		line("Input->photon p50 %.1f  p99 %.1f ms", latency->percentile_ms(0.5), latency->percentile_ms(0.99));
 	if(stats){
-		wchar_t buf[256];
-		// Display FPS prominently
-		swprintf(buf,256,L"FPS: %.1f", stats->fps); drawText(dc, buf, xPad, yPad + lineH*line++);
-		// Add packet tracing mode indicator
-		std::wstring modeStr = L"";
-		if (stats->packetMode == 8) modeStr = L" [AVX 8-wide]";
-		else if (stats->packetMode == 4) modeStr = L" [SSE 4-wide]";
-		swprintf(buf,256,L"PT %.1fms | %d spp%s", stats->msTotal, stats->spp, modeStr.c_str()); drawText(dc, buf, xPad, yPad + lineH*line++);
-		swprintf(buf,256,L"Trace %.1f  Temp %.1f  Denoise %.1f", stats->msTrace, stats->msTemporal, stats->msDenoise); drawText(dc, buf, xPad, yPad + lineH*line++);
-		swprintf(buf,256,L"Upscale %.1f  Bnc %.1f", stats->msUpscale, stats->avgBounceDepth); drawText(dc, buf, xPad, yPad + lineH*line++);
-		// Extra diagnostics: internal resolution & first pixel sample (posted after tone map in adapter)
-		// We can't read pixel data here directly; adapter will overlay if zero. So just show internal dims.
-		swprintf(buf,256,L"Internal %dx%d", stats->internalW, stats->internalH); drawText(dc, buf, xPad, yPad + lineH*line++);
-		if(stats->projectedRays>0){
-			swprintf(buf,256,L"FanOut proj %lld exec %d%s", (long long)stats->projectedRays, stats->totalRays, stats->fanoutAborted?L" (ABORT)":L"");
-			drawText(dc, buf, xPad, yPad + lineH*line++);
-		}
+		line("FPS: %.1f", stats->fps);
+		// Packet tracing mode indicator
+		const char* modeStr = stats->packetMode == 8 ? " [AVX 8-wide]" : stats->packetMode == 4 ? " [SSE 4-wide]" : "";
+		line("PT %.1fms | %d spp%s", stats->msTotal, stats->spp, modeStr);
+		line("Trace %.1f  Temp %.1f  Denoise %.1f", stats->msTrace, stats->msTemporal, stats->msDenoise);
+		line("Upscale %.1f  Bnc %.1f", stats->msUpscale, stats->avgBounceDepth);
+		line("Internal %dx%d", stats->internalW, stats->internalH);
+		if(stats->projectedRays>0)
+			line("FanOut proj %lld exec %d%s", (long long)stats->projectedRays, stats->totalRays, stats->fanoutAborted?" (ABORT)":"");
 	}
+	lastRight = panel(target, 0, 0, dpi, kHudText);
+
 	// High score displayed on right side
-	std::wstring hs = L"High: " + std::to_wstring(highScore);
-	SIZE sz{0,0}; GetTextExtentPoint32W(dc, hs.c_str(), (int)hs.size(), &sz);
-	int xRight = w - sz.cx - xPad;
-	drawText(dc, hs, xRight, yPad);
+	double ui = (double)dpi/96.0;
+	int pad = (int)(8*ui + 0.5);
+	char hs[32]; std::snprintf(hs, sizeof(hs), "High: %d", highScore);
+	text.draw(target, target.width - text.measure(hs) - pad, pad, hs, kHudText);
+}
+
+void HudOverlay::drawPanel(const RasterTarget& target, int x, int y, int dpi, const std::vector<std::string>& panelLines, uint32_t color) {
+	if(!target.pixels || panelLines.empty()) return;
+	lines = panelLines;
+	panel(target, x, y, dpi, color);
 }
+
+void HudOverlay::endFrame() { text.end_frame(); }
@@ -7,11 +7,16 @@
  */
 
 #pragma once
-#include <windows.h>
+#include "../../raster/text_raster.h"
+#include <cstdint>
+#include <string>
+#include <vector>
 
 struct GameState; 
 struct SRStats; 
 struct UIState;
+struct FramePacerStats;
+class TimeHistogram;
 
 /**
  * @brief HUD overlay renderer for game information display
@@ -23,24 +28,47 @@ struct UIState;
  * - Performance statistics (when using path tracer)
  * - Frame timing information
  * 
- * The overlay uses GDI text rendering functions and automatically
- * scales with DPI settings for proper display on high-resolution monitors.
+ * Text is drawn with the portable glyph-atlas TextRenderer straight
+ * into a 32-bit framebuffer, so the overlay needs no GDI calls and looks
+ * the same in recordings; lines that did not change since the last
+ * frame reuse their cached glyph runs. Sizes scale with the DPI.
  */
 class HudOverlay {
 public:
     /**
-     * @brief Draw the HUD overlay on the specified device context
+     * @brief Draw the HUD overlay into a framebuffer
      * 
      * Renders all HUD elements including scores, performance statistics,
      * and other game information using the provided game state and metrics.
      * 
      * @param gs Current game state containing scores and game data
      * @param stats Optional performance statistics from software renderer (can be nullptr)
-     * @param dc Windows device context for drawing operations
-     * @param w Width of the drawing area in pixels
-     * @param h Height of the drawing area in pixels  
+     * @param target Framebuffer to draw into (e.g. the back buffer's pixels)
      * @param dpi Current DPI setting for scaling calculations
      * @param highScore Current high score to display
+     * @param frame Optional frame-time distribution from the loop's FramePacer (can be nullptr)
+     * @param latency Optional input-to-photon latency distribution (can be nullptr)
      */
-    void draw(const GameState& gs, const SRStats* stats, HDC dc, int w, int h, int dpi, int highScore);
+    void draw(const GameState& gs, const SRStats* stats, const RasterTarget& target, int dpi, int highScore,
+              const FramePacerStats* frame = nullptr, const TimeHistogram* latency = nullptr);
+
+    /**
+     * @brief Draw a boxed list of lines (e.g. the recording status) with its top-left corner at (x, y)
+     */
+    void drawPanel(const RasterTarget& target, int x, int y, int dpi, const std::vector<std::string>& lines, uint32_t color);
+
+    /// @brief Right edge of the panel drawn by the last draw() call (0 before the first)
+    int panelRight() const { return lastRight; }
+
+    /// @brief Call once per presented frame; trims the cached text runs
+    void endFrame();
+
+private:
+    void line(const char* fmt, ...);
+    /// @return Panel width in pixels
+    int panel(const RasterTarget& target, int x, int y, int dpi, uint32_t color);
+
+    TextRenderer text;              ///< Glyph atlas + cached runs
+    std::vector<std::string> lines; ///< Lines of the panel being drawn (reused)
+    int lastRight = 0;              ///< Width of the main HUD panel
 };
@@ -1,5 +1,5 @@
 #include "pt_renderer_adapter.h"
-#include "../soft_renderer.h"
+#include "../../render/soft_renderer.h"
 #include "../settings.h"
 #include "../../core/game_core.h"
 
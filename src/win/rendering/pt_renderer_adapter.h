@@ -9,7 +9,7 @@
 
 #pragma once
 #include <windows.h>
-#include "../soft_renderer.h" // for SRConfig, SRStats
+#include "../../render/soft_renderer.h" // for SRConfig, SRStats
 
 class SoftRenderer; 
 struct GameState; 
@@ -1,184 +1,278 @@
 #include "settings.h"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <filesystem>
 #include <fstream>
-#include <windows.h>
+#include <iterator>
 
-static std::string w_to_utf8(const std::wstring &s) {
-    if (s.empty()) return {};
-    int n = WideCharToMultiByte(CP_UTF8, 0, s.data(), (int)s.size(), NULL, 0, NULL, NULL);
-    std::string out; out.resize(n);
-    WideCharToMultiByte(CP_UTF8, 0, s.data(), (int)s.size(), &out[0], n, NULL, NULL);
-    return out;
+namespace {
+
+/// What load does with a value outside [lo, hi]
+enum class Range : uint8_t {
+    Any,    ///< No check
+    Clamp,  ///< Clamp into [lo, hi]
+    Reset,  ///< Restore the default
+    Flag    ///< Any non-zero value becomes 1
+};
+
+/// One persisted key
+struct Field {
+    std::string_view key;
+    int (*get)(const Settings &);
+    void (*set)(Settings &, int);
+    int lo, hi;
+    Range range;
+};
+
+#define PONG_INT(name, lo, hi, range) \
+    Field{ #name, [](const Settings &s) { return s.name; }, [](Settings &s, int v) { s.name = v; }, lo, hi, Range::range }
+#define PONG_ANY(name) PONG_INT(name, INT_MIN, INT_MAX, Any)
+#define PONG_MODE_FLAG(key, member) \
+    Field{ key, [](const Settings &s) { return s.mode_config.member ? 1 : 0; }, \
+           [](Settings &s, int v) { s.mode_config.member = v != 0; }, 0, 1, Range::Any }
+#define PONG_MODE_INT(key, member, lo, hi) \
+    Field{ key, [](const Settings &s) { return s.mode_config.member; }, \
+           [](Settings &s, int v) { s.mode_config.member = v; }, lo, hi, Range::Clamp }
+
+// Save order; load accepts any order
+constexpr Field kFields[] = {
+    PONG_ANY(control_mode),
+    PONG_ANY(ai),
+    PONG_ANY(renderer),
+    PONG_ANY(quality), // legacy
+    PONG_ANY(game_mode),
+    PONG_MODE_FLAG("gm_multiball", multiball),
+    PONG_MODE_INT("gm_multiball_count", multiball_count, 2, 5),
+    PONG_MODE_FLAG("gm_obstacles", obstacles),
+    PONG_MODE_FLAG("gm_obstacles_moving", obstacles_moving),
+    PONG_MODE_FLAG("gm_blackholes", blackholes),
+    PONG_MODE_FLAG("gm_blackholes_moving", blackholes_moving),
+    PONG_MODE_INT("gm_blackhole_count", blackhole_count, 1, 5),
+    PONG_MODE_FLAG("gm_three_enemies", three_enemies),
+    PONG_MODE_FLAG("gm_obstacles_gravity", obstacles_gravity),
+    PONG_MODE_FLAG("gm_blackholes_destroy_balls", blackholes_destroy_balls),
+    PONG_ANY(pt_rays_per_frame),
+    PONG_ANY(pt_max_bounces),
+    PONG_ANY(pt_internal_scale),
+    PONG_ANY(pt_roughness),
+    PONG_ANY(pt_emissive),
+    PONG_ANY(pt_paddle_emissive),
+    PONG_ANY(pt_force_4wide_simd),
+    PONG_ANY(pt_accum_alpha),
+    PONG_ANY(pt_denoise_strength),
+    PONG_ANY(pt_force_full_pixel_rays),
+    PONG_ANY(pt_use_ortho),
+    PONG_ANY(pt_rr_enable),
+    PONG_ANY(pt_rr_start_bounce),
+    PONG_ANY(pt_rr_min_prob_pct),
+    PONG_ANY(pt_fanout_enable),
+    PONG_ANY(pt_fanout_cap),
+    PONG_ANY(pt_fanout_abort),
+    PONG_INT(pt_soft_shadow_samples, 1, 64, Clamp),
+    PONG_INT(pt_light_radius_pct, 10, 500, Clamp),
+    PONG_INT(pt_pbr_enable, 0, 1, Flag),
+    PONG_ANY(recording_mode),
+    PONG_INT(player_mode, 0, 2, Reset),
+    PONG_INT(recording_fps, 15, 60, Clamp),
+    PONG_ANY(recording_duration),
+    PONG_INT(recording_format, 0, 4, Reset),
+    PONG_INT(physics_mode, 0, 1, Reset),
+    PONG_INT(speed_mode, 0, 1, Reset),
+    PONG_INT(hud_show_play, 0, 1, Flag),
+    PONG_INT(hud_show_record, 0, 1, Flag),
+    PONG_INT(metrics_port, 0, 65535, Reset),
+    PONG_ANY(pt_tile_size),
+    PONG_ANY(pt_use_blue_noise),
+    PONG_ANY(pt_use_cosine_weighted),
+    PONG_ANY(pt_use_stratified),
+    PONG_ANY(pt_use_halton),
+    PONG_ANY(pt_adaptive_shadows),
+    PONG_ANY(pt_use_bilateral),
+    PONG_ANY(pt_bilateral_sigma_space),
+    PONG_ANY(pt_bilateral_sigma_color),
+    PONG_ANY(pt_light_cull_distance),
+};
+constexpr size_t kFieldCount = sizeof(kFields) / sizeof(kFields[0]);
+
+#undef PONG_INT
+#undef PONG_ANY
+#undef PONG_MODE_FLAG
+#undef PONG_MODE_INT
+
+// ---- Perfect hash over the key names, built by the compiler ----
+
+constexpr uint32_t kFnvBasis = 2166136261u, kFnvPrime = 16777619u;
+constexpr size_t kSlots = 512;  ///< Power of two; sparse enough that a collision-free seed turns up within a few dozen tries
+
+constexpr uint32_t hash_step(uint32_t h, char c) { return (h ^ (uint8_t)c) * kFnvPrime; }
+constexpr uint32_t hash_key(std::string_view k, uint32_t seed) {
+    uint32_t h = kFnvBasis ^ seed;
+    for (char c : k) h = hash_step(h, c);
+    return h;
 }
 
-static std::wstring utf8_to_w(const std::string &s) {
-    if (s.empty()) return {};
-    int n = MultiByteToWideChar(CP_UTF8, 0, s.data(), (int)s.size(), NULL, 0);
-    std::wstring out; out.resize(n);
-    MultiByteToWideChar(CP_UTF8, 0, s.data(), (int)s.size(), &out[0], n);
-    return out;
+struct PerfectHash {
+    uint32_t seed = 0;
+    uint8_t slot[kSlots] = {};  ///< Field index + 1, 0 = no key
+};
+
+constexpr PerfectHash build_hash() {
+    static_assert(kFieldCount < 255, "slot indices are bytes");
+    for (uint32_t seed = 1; seed < 4096; ++seed) {
+        PerfectHash p{};
+        p.seed = seed;
+        bool ok = true;
+        for (size_t i = 0; i < kFieldCount && ok; ++i) {
+            uint8_t &s = p.slot[hash_key(kFields[i].key, seed) & (kSlots - 1)];
+            ok = s == 0;
+            s = (uint8_t)(i + 1);
+        }
+        if (ok) return p;
+    }
+    return PerfectHash{};
 }
 
-Settings SettingsManager::load(const std::wstring &path) {
+constexpr PerfectHash kHash = build_hash();
+static_assert(kHash.seed != 0, "no collision-free seed for the settings keys; grow kSlots");
+
+const Field *find_field(std::string_view key, uint32_t h) {
+    const uint8_t s = kHash.slot[h & (kSlots - 1)];
+    if (s == 0 || kFields[s - 1].key != key) return nullptr;
+    return &kFields[s - 1];
+}
+
+// ---- Single-pass tokenizer ----
+
+struct Cursor {
+    const char *p, *end;
+
+    void ws() { while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p; }
+    bool eat(char c) { ws(); if (p < end && *p == c) { ++p; return true; } return false; }
+
+    /// String after its opening quote; hashes it on the way. False if unterminated.
+    bool string(std::string_view &out, uint32_t &h, bool &escaped) {
+        const char *start = p;
+        h = kFnvBasis ^ kHash.seed;
+        escaped = false;
+        for (; p < end; ++p) {
+            if (*p == '"') { out = std::string_view(start, (size_t)(p - start)); ++p; return true; }
+            if (*p == '\\') { escaped = true; if (++p == end) break; }
+            h = hash_step(h, *p);
+        }
+        return false;
+    }
+
+    /// Integer part of a number, saturated to int; the fraction and exponent are skipped
+    bool number(int &out) {
+        const bool neg = p < end && *p == '-';
+        if (neg) ++p;
+        if (p == end || *p < '0' || *p > '9') return false;
+        int64_t v = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) v = std::min<int64_t>(v * 10 + (*p - '0'), (int64_t)INT_MAX + 1);
+        while (p < end && (*p == '.' || *p == 'e' || *p == 'E' || *p == '+' || *p == '-' || (*p >= '0' && *p <= '9'))) ++p;
+        out = (int)std::clamp<int64_t>(neg ? -v : v, INT_MIN, INT_MAX);
+        return true;
+    }
+
+    bool literal(std::string_view word) {
+        if ((size_t)(end - p) < word.size() || std::string_view(p, word.size()) != word) return false;
+        p += word.size();
+        return true;
+    }
+
+    /// Skip any value (string, number, literal, nested object or array)
+    bool skip() {
+        ws();
+        if (p == end) return false;
+        if (*p == '"') {
+            ++p;
+            std::string_view s; uint32_t h; bool e;
+            return string(s, h, e);
+        }
+        if (*p == '{' || *p == '[') {
+            int depth = 0;
+            for (; p < end; ++p) {
+                if (*p == '"') {
+                    ++p;
+                    std::string_view s; uint32_t h; bool e;
+                    if (!string(s, h, e)) return false;
+                    --p;
+                } else if (*p == '{' || *p == '[') {
+                    ++depth;
+                } else if ((*p == '}' || *p == ']') && --depth == 0) {
+                    ++p;
+                    return true;
+                }
+            }
+            return false;
+        }
+        // Number or literal: up to the next delimiter
+        const char *start = p;
+        while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') ++p;
+        return p > start;
+    }
+};
+
+} // namespace
+
+Settings SettingsManager::parse(std::string_view json) {
     Settings s; // defaults
-    std::string p = w_to_utf8(path);
-    std::ifstream ifs(p, std::ios::binary);
-    if (!ifs) return s;
-    std::string raw((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-
-    // Very small hand-rolled integer extractor: looks for "key" then ':' then optional whitespace then an integer (possibly multi-digit, optional leading minus though not used here)
-    auto extractInt = [&](const std::string &key, int &dst){
-        size_t pos = raw.find("\"" + key + "\"");
-        if (pos == std::string::npos) return;
-        pos = raw.find(':', pos);
-        if (pos == std::string::npos) return;
-        pos++;
-        while (pos < raw.size() && (raw[pos]==' '||raw[pos]=='\t')) pos++;
-        bool neg=false; if (pos<raw.size() && raw[pos]=='-'){ neg=true; pos++; }
-        long val=0; bool any=false;
-        while (pos < raw.size() && raw[pos]>='0' && raw[pos]<='9') { any=true; val = val*10 + (raw[pos]-'0'); pos++; }
-        if (!any) return; if (neg) val = -val; dst = (int)val;
-    };
-    extractInt("control_mode", s.control_mode);
-    extractInt("ai", s.ai);
-    extractInt("renderer", s.renderer);
-    extractInt("quality", s.quality);
-    extractInt("game_mode", s.game_mode);
-    
-    // Load game mode config (new system)
-    int temp_int = 0;
-    extractInt("gm_multiball", temp_int); s.mode_config.multiball = (temp_int != 0);
-    extractInt("gm_multiball_count", s.mode_config.multiball_count);
-    extractInt("gm_obstacles", temp_int); s.mode_config.obstacles = (temp_int != 0);
-    extractInt("gm_obstacles_moving", temp_int); s.mode_config.obstacles_moving = (temp_int != 0);
-    extractInt("gm_blackholes", temp_int); s.mode_config.blackholes = (temp_int != 0);
-    extractInt("gm_blackholes_moving", temp_int); s.mode_config.blackholes_moving = (temp_int != 0);
-    extractInt("gm_blackhole_count", s.mode_config.blackhole_count);
-    extractInt("gm_three_enemies", temp_int); s.mode_config.three_enemies = (temp_int != 0);
-    extractInt("gm_obstacles_gravity", temp_int); s.mode_config.obstacles_gravity = (temp_int != 0);
-    extractInt("gm_blackholes_destroy_balls", temp_int); s.mode_config.blackholes_destroy_balls = (temp_int != 0);
-    
-    // Validate game mode config
-    if(s.mode_config.multiball_count < 2) s.mode_config.multiball_count = 2;
-    if(s.mode_config.multiball_count > 5) s.mode_config.multiball_count = 5;
-    if(s.mode_config.blackhole_count < 1) s.mode_config.blackhole_count = 1;
-    if(s.mode_config.blackhole_count > 5) s.mode_config.blackhole_count = 5;
-    
-    extractInt("pt_rays_per_frame", s.pt_rays_per_frame);
-    extractInt("pt_max_bounces", s.pt_max_bounces);
-    extractInt("pt_internal_scale", s.pt_internal_scale);
-    extractInt("pt_roughness", s.pt_roughness);
-    extractInt("pt_emissive", s.pt_emissive);
-    extractInt("pt_paddle_emissive", s.pt_paddle_emissive);
-    extractInt("pt_force_4wide_simd", s.pt_force_4wide_simd);
-    extractInt("pt_accum_alpha", s.pt_accum_alpha);
-    extractInt("pt_denoise_strength", s.pt_denoise_strength);
-    extractInt("pt_force_full_pixel_rays", s.pt_force_full_pixel_rays);
-    extractInt("pt_use_ortho", s.pt_use_ortho);
-    extractInt("pt_rr_enable", s.pt_rr_enable);
-    extractInt("pt_rr_start_bounce", s.pt_rr_start_bounce);
-    extractInt("pt_rr_min_prob_pct", s.pt_rr_min_prob_pct);
-    extractInt("pt_fanout_enable", s.pt_fanout_enable);
-    extractInt("pt_fanout_cap", s.pt_fanout_cap);
-    extractInt("pt_fanout_abort", s.pt_fanout_abort);
-    // New soft shadow / PBR fields (backward compatible: defaults remain if not present)
-    extractInt("pt_soft_shadow_samples", s.pt_soft_shadow_samples);
-    extractInt("pt_light_radius_pct", s.pt_light_radius_pct);
-    extractInt("pt_pbr_enable", s.pt_pbr_enable);
-    // Phase 5: Advanced optimization settings
-    extractInt("pt_tile_size", s.pt_tile_size);
-    extractInt("pt_use_blue_noise", s.pt_use_blue_noise);
-    extractInt("pt_use_cosine_weighted", s.pt_use_cosine_weighted);
-    extractInt("pt_use_stratified", s.pt_use_stratified);
-    extractInt("pt_use_halton", s.pt_use_halton);
-    extractInt("pt_adaptive_shadows", s.pt_adaptive_shadows);
-    extractInt("pt_use_bilateral", s.pt_use_bilateral);
-    extractInt("pt_bilateral_sigma_space", s.pt_bilateral_sigma_space);
-    extractInt("pt_bilateral_sigma_color", s.pt_bilateral_sigma_color);
-    extractInt("pt_light_cull_distance", s.pt_light_cull_distance);
-    // Recording mode
-    extractInt("recording_mode", s.recording_mode);
-        extractInt("player_mode", s.player_mode);
-        extractInt("recording_fps", s.recording_fps);
-        extractInt("recording_duration", s.recording_duration);
-        extractInt("physics_mode", s.physics_mode);
-        extractInt("speed_mode", s.speed_mode);
-        extractInt("hud_show_play", s.hud_show_play);
-        extractInt("hud_show_record", s.hud_show_record);
-        if(s.physics_mode<0||s.physics_mode>1) s.physics_mode=1;
-        if(s.speed_mode<0||s.speed_mode>1) s.speed_mode=0;
-        s.hud_show_play = s.hud_show_play?1:0;
-        s.hud_show_record = s.hud_show_record?1:0;
-        if(s.recording_fps < 15) s.recording_fps = 15; else if(s.recording_fps > 60) s.recording_fps = 60;
-        if(s.player_mode < 0 || s.player_mode > 2) s.player_mode = 0;
-    // Defensive clamp after load
-    if(s.pt_soft_shadow_samples < 1) s.pt_soft_shadow_samples = 1; else if(s.pt_soft_shadow_samples > 64) s.pt_soft_shadow_samples = 64;
-    if(s.pt_light_radius_pct < 10) s.pt_light_radius_pct = 10; else if(s.pt_light_radius_pct > 500) s.pt_light_radius_pct = 500;
-    if(s.pt_pbr_enable!=0) s.pt_pbr_enable = 1;
+    Cursor c{ json.data(), json.data() + json.size() };
+    if (c.eat('{')) {
+        while (c.eat('"')) {
+            std::string_view key; uint32_t h; bool escaped;
+            if (!c.string(key, h, escaped) || !c.eat(':')) break;
+            const Field *f = escaped ? nullptr : find_field(key, h);
+            c.ws();
+            int v = 0;
+            if (f && c.number(v)) f->set(s, v);
+            else if (f && c.literal("true")) f->set(s, 1);
+            else if (f && c.literal("false")) f->set(s, 0);
+            else if (!c.skip()) break;
+            c.eat(','); // optional, so files with a missing comma still load
+        }
+    }
+    // Range checks apply to defaults and loaded values alike
+    const Settings defaults;
+    for (const Field &f : kFields) {
+        const int v = f.get(s);
+        switch (f.range) {
+        case Range::Any: break;
+        case Range::Clamp: f.set(s, std::clamp(v, f.lo, f.hi)); break;
+        case Range::Reset: if (v < f.lo || v > f.hi) f.set(s, f.get(defaults)); break;
+        case Range::Flag: f.set(s, v != 0 ? 1 : 0); break;
+        }
+    }
     return s;
 }
 
+std::string SettingsManager::serialize(const Settings &s) {
+    std::string out = "{\n";
+    for (size_t i = 0; i < kFieldCount; ++i) {
+        out += "  \"";
+        out += kFields[i].key;
+        out += "\": ";
+        out += std::to_string(kFields[i].get(s));
+        out += i + 1 < kFieldCount ? ",\n" : "\n";
+    }
+    out += "}\n";
+    return out;
+}
+
+size_t SettingsManager::key_count() { return kFieldCount; }
+
+Settings SettingsManager::load(const std::wstring &path) {
+    std::ifstream ifs(std::filesystem::path(path), std::ios::binary);
+    if (!ifs) return Settings{};
+    const std::string raw((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    return parse(raw);
+}
+
 bool SettingsManager::save(const std::wstring &path, const Settings &s) {
-    std::string p2 = w_to_utf8(path);
-    std::ofstream ofs(p2, std::ios::trunc | std::ios::binary);
+    std::ofstream ofs(std::filesystem::path(path), std::ios::trunc | std::ios::binary);
     if (!ofs) return false;
-    ofs << "{\n";
-    ofs << "  \"control_mode\": " << s.control_mode << ",\n";
-    ofs << "  \"ai\": " << s.ai << ",\n";
-    ofs << "  \"renderer\": " << s.renderer << ",\n";
-    ofs << "  \"quality\": " << s.quality << ",\n"; // legacy
-    ofs << "  \"game_mode\": " << s.game_mode << ",\n";
-    
-    // Save game mode config (new system)
-    ofs << "  \"gm_multiball\": " << (s.mode_config.multiball ? 1 : 0) << ",\n";
-    ofs << "  \"gm_multiball_count\": " << s.mode_config.multiball_count << ",\n";
-    ofs << "  \"gm_obstacles\": " << (s.mode_config.obstacles ? 1 : 0) << ",\n";
-    ofs << "  \"gm_obstacles_moving\": " << (s.mode_config.obstacles_moving ? 1 : 0) << ",\n";
-    ofs << "  \"gm_blackholes\": " << (s.mode_config.blackholes ? 1 : 0) << ",\n";
-    ofs << "  \"gm_blackholes_moving\": " << (s.mode_config.blackholes_moving ? 1 : 0) << ",\n";
-    ofs << "  \"gm_blackhole_count\": " << s.mode_config.blackhole_count << ",\n";
-    ofs << "  \"gm_three_enemies\": " << (s.mode_config.three_enemies ? 1 : 0) << ",\n";
-    ofs << "  \"gm_obstacles_gravity\": " << (s.mode_config.obstacles_gravity ? 1 : 0) << ",\n";
-    ofs << "  \"gm_blackholes_destroy_balls\": " << (s.mode_config.blackholes_destroy_balls ? 1 : 0) << ",\n";
-    
-    ofs << "  \"pt_rays_per_frame\": " << s.pt_rays_per_frame << ",\n";
-    ofs << "  \"pt_max_bounces\": " << s.pt_max_bounces << ",\n";
-    ofs << "  \"pt_internal_scale\": " << s.pt_internal_scale << ",\n";
-    ofs << "  \"pt_roughness\": " << s.pt_roughness << ",\n";
-    ofs << "  \"pt_emissive\": " << s.pt_emissive << ",\n";
-    ofs << "  \"pt_paddle_emissive\": " << s.pt_paddle_emissive << ",\n";
-    ofs << "  \"pt_force_4wide_simd\": " << s.pt_force_4wide_simd << ",\n";
-    ofs << "  \"pt_accum_alpha\": " << s.pt_accum_alpha << ",\n";
-    ofs << "  \"pt_denoise_strength\": " << s.pt_denoise_strength << ",\n";
-    ofs << "  \"pt_force_full_pixel_rays\": " << s.pt_force_full_pixel_rays << ",\n";
-    ofs << "  \"pt_use_ortho\": " << s.pt_use_ortho << ",\n";
-    ofs << "  \"pt_rr_enable\": " << s.pt_rr_enable << ",\n";
-    ofs << "  \"pt_rr_start_bounce\": " << s.pt_rr_start_bounce << ",\n";
-    ofs << "  \"pt_rr_min_prob_pct\": " << s.pt_rr_min_prob_pct << ",\n";
-    ofs << "  \"pt_fanout_enable\": " << s.pt_fanout_enable << ",\n";
-    ofs << "  \"pt_fanout_cap\": " << s.pt_fanout_cap << ",\n";
-    ofs << "  \"pt_fanout_abort\": " << s.pt_fanout_abort << ",\n";
-    ofs << "  \"pt_soft_shadow_samples\": " << s.pt_soft_shadow_samples << ",\n";
-    ofs << "  \"pt_light_radius_pct\": " << s.pt_light_radius_pct << ",\n";
-    ofs << "  \"pt_pbr_enable\": " << s.pt_pbr_enable << ",\n";
-    ofs << "  \"recording_mode\": " << s.recording_mode << "\n";
-        ofs << "  \"player_mode\": " << s.player_mode << ",\n";
-        ofs << "  \"recording_fps\": " << s.recording_fps << ",\n";
-        ofs << "  \"recording_duration\": " << s.recording_duration << ",\n";
-        ofs << "  \"physics_mode\": " << s.physics_mode << ",\n";
-        ofs << "  \"speed_mode\": " << s.speed_mode << ",\n";
-        ofs << "  \"hud_show_play\": " << s.hud_show_play << ",\n";
-        ofs << "  \"hud_show_record\": " << s.hud_show_record << ",\n";
-    // Phase 5: Save optimization settings
-    ofs << "  \"pt_tile_size\": " << s.pt_tile_size << ",\n";
-    ofs << "  \"pt_use_blue_noise\": " << s.pt_use_blue_noise << ",\n";
-    ofs << "  \"pt_use_cosine_weighted\": " << s.pt_use_cosine_weighted << ",\n";
-    ofs << "  \"pt_use_stratified\": " << s.pt_use_stratified << ",\n";
-    ofs << "  \"pt_use_halton\": " << s.pt_use_halton << ",\n";
-    ofs << "  \"pt_adaptive_shadows\": " << s.pt_adaptive_shadows << ",\n";
-    ofs << "  \"pt_use_bilateral\": " << s.pt_use_bilateral << ",\n";
-    ofs << "  \"pt_bilateral_sigma_space\": " << s.pt_bilateral_sigma_space << ",\n";
-    ofs << "  \"pt_bilateral_sigma_color\": " << s.pt_bilateral_sigma_color << ",\n";
-    ofs << "  \"pt_light_cull_distance\": " << s.pt_light_cull_distance << "\n";
-    ofs << "}\n";
-    return true;
+    const std::string json = serialize(s);
+    ofs.write(json.data(), (std::streamsize)json.size());
+    return (bool)ofs;
 }
@@ -3,11 +3,15 @@
  * @brief Settings persistence for Windows GUI version
  * 
  * This file defines the Settings structure and SettingsManager class
- * for saving and loading game configuration in JSON format.
+ * for saving and loading game configuration in JSON format. The code is
+ * portable (no Windows headers), so tools and benchmarks build it on
+ * every platform.
  */
 
 #pragma once
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include "game_mode_config.h"
 
 /**
@@ -56,11 +60,13 @@ struct Settings {
     // Recording
     int recording_fps = 60;            ///< Target recording FPS (15..60)
     int recording_duration = 60;       ///< Recording duration in seconds (10..3600, 0=unlimited)
+    int recording_format = 0;          ///< 0=BMP per frame, 1=single Y4M (yuv420p) stream, 2=QOI per frame, 3=raw frame archive, 4=QOI frame archive
     // Physics / HUD
     int physics_mode = 1;              ///< 0=Arcade physics, 1=Physically-based paddle bounce
     int speed_mode = 0;                ///< 1="I am Speed" mode: no max speed, auto-acceleration
     int hud_show_play = 1;             ///< 1=Show HUD during normal gameplay
     int hud_show_record = 1;           ///< 1=Show HUD overlays while recording
+    int metrics_port = 0;              ///< Serve Prometheus metrics on 127.0.0.1 at this port (0=off)
     // Phase 5: Advanced sampling and rendering optimizations
     int pt_tile_size = 16;             ///< Tile size for tile-based rendering (4-64, power of 2)
     int pt_use_blue_noise = 1;         ///< Use blue noise sampling (1=on, 0=white noise)
@@ -81,8 +87,12 @@ struct Settings {
  * @brief Manager class for settings persistence
  * 
  * Handles loading and saving game settings to/from JSON files.
- * Uses a simple custom JSON parser/serializer to avoid external
- * dependencies while providing human-readable configuration files.
+ * Every persisted key is one entry of a compile-time schema table
+ * (accessor, valid range, what to do when out of range). Loading is a
+ * single pass of a small JSON tokenizer; each key is hashed while it is
+ * scanned and dispatched through a perfect hash of the table, so the
+ * cost is linear in the file size however many keys exist. Unknown keys
+ * and nested values are skipped; a missing comma is tolerated.
  */
 class SettingsManager {
 public:
@@ -113,4 +123,11 @@ public:
      * @return true if save was successful, false on error
      */
     bool save(const std::wstring &path, const Settings &s);
+
+    /// @brief Parse settings JSON text (defaults for absent keys, then range checks)
+    static Settings parse(std::string_view json);
+    /// @brief Serialize every schema key as a JSON object, one key per line
+    static std::string serialize(const Settings &s);
+    /// @brief Number of keys in the schema
+    static size_t key_count();
 };